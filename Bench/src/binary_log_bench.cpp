@@ -0,0 +1,79 @@
+#define BENCHMARK_STATIC_DEFINE
+#include <benchmark/benchmark.h>
+
+#include <Tools/binary_log.hpp>
+#include <Tools/debug.hpp>
+
+#include <fmt/format.h>
+
+#include <filesystem>
+#include <string>
+
+// Time for the calling thread to log a message, formatted later by BinLogDecoder.
+// The text log is only compiled in debug builds or with CTP_LOGGING, and writes to stdout, so run with
+// --benchmark_out=<file> and stdout redirected to compare.
+
+namespace {
+
+std::string log_path() {
+	return (std::filesystem::temp_directory_path() / "ctp_binary_log_bench.bin").string();
+}
+
+} // namespace
+
+#define DO_THREADS() ThreadRange(1, 32)->UseRealTime()
+
+static void BinLog_Log(benchmark::State& state) {
+	if (state.thread_index() == 0)
+		ctp::binlog::open(log_path());
+	int entity = 1234;
+	double x = 10.5;
+	for (auto _ : state) {
+		ctpBinLogi("entity {} moved to ({}, {}, {}) after collision with entity {}", entity, x, -3.25, 7, 5678);
+		benchmark::DoNotOptimize(entity);
+		benchmark::DoNotOptimize(x);
+	}
+	state.SetItemsProcessed(state.iterations());
+	ctp::binlog::flush();
+	if (state.thread_index() == 0)
+		ctp::binlog::close();
+}
+BENCHMARK(BinLog_Log)->DO_THREADS();
+
+static void BinLog_LogString(benchmark::State& state) {
+	if (state.thread_index() == 0)
+		ctp::binlog::open(log_path());
+	const std::string name = "collision_volume_07";
+	for (auto _ : state)
+		ctpBinLogi("entity {} hit {}", 1234, name);
+	state.SetItemsProcessed(state.iterations());
+	ctp::binlog::flush();
+	if (state.thread_index() == 0)
+		ctp::binlog::close();
+}
+BENCHMARK(BinLog_LogString)->DO_THREADS();
+
+#if CTP_LOGGING
+static void Text_Log(benchmark::State& state) {
+	int entity = 1234;
+	double x = 10.5;
+	for (auto _ : state) {
+		ctpLog(fmt::format("entity {} moved to ({}, {}, {}) after collision with entity {}", entity, x, -3.25, 7, 5678));
+		benchmark::DoNotOptimize(entity);
+		benchmark::DoNotOptimize(x);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(Text_Log)->DO_THREADS();
+#endif // CTP_LOGGING
+
+// Cost of a disabled log
+static void BaseTime_Log(benchmark::State& state) {
+	int entity = 1234;
+	for (auto _ : state) {
+		ctpBinLogi("entity {}", entity);
+		benchmark::DoNotOptimize(entity);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BaseTime_Log)->DO_THREADS();
@@ -0,0 +1,142 @@
+#define BENCHMARK_STATIC_DEFINE
+#include <benchmark/benchmark.h>
+
+#include <Tools/BitEnum.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Per-entity render flags.
+enum class RenderFlag : std::uint32_t {
+	None = 0,
+	Visible = 1 << 0,
+	CastsShadow = 1 << 1,
+	Transparent = 1 << 2,
+	Animated = 1 << 3,
+	Dirty = 1 << 4,
+	Culled = 1 << 5,
+	Selected = 1 << 6,
+	Static = 1 << 7,
+};
+
+using Flags = ctp::BitEnum<RenderFlag>;
+
+class BitEnumFixture : public benchmark::Fixture {
+protected:
+	std::vector<Flags> flags_;
+	std::vector<std::uint32_t> indices_;
+	std::vector<std::uint64_t> bits_;
+public:
+	void SetUp(benchmark::State& state) override {
+		std::mt19937 rng{77};
+		std::uniform_int_distribution<std::uint32_t> dist{0, 0xFF};
+
+		const auto count = static_cast<std::size_t>(state.range(0));
+		flags_.clear();
+		for (std::size_t i = 0; i < count; ++i)
+			flags_.push_back(static_cast<RenderFlag>(dist(rng)));
+		indices_.assign(count, 0);
+		bits_.assign((count + 63) / 64, 0);
+	}
+};
+
+const Flags ShadowPass{RenderFlag::Visible, RenderFlag::CastsShadow};
+const Flags NeedsUpdate{RenderFlag::Animated, RenderFlag::Dirty};
+
+} // namespace
+
+#define DO_RANGE() Arg(1 << 20)
+
+// Count entities with any of the flags
+
+BENCHMARK_DEFINE_F(BitEnumFixture, Loop_CountAnyOf)(benchmark::State& state) {
+	for (auto _ : state) {
+		std::size_t count = 0;
+		for (const Flags f : flags_)
+			count += f.any_of(NeedsUpdate);
+		benchmark::DoNotOptimize(count);
+	}
+}
+BENCHMARK_REGISTER_F(BitEnumFixture, Loop_CountAnyOf)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(BitEnumFixture, Span_CountAnyOf)(benchmark::State& state) {
+	for (auto _ : state)
+		benchmark::DoNotOptimize(ctp::count_any_of(flags_, NeedsUpdate));
+}
+BENCHMARK_REGISTER_F(BitEnumFixture, Span_CountAnyOf)->DO_RANGE();
+
+// Collect indices of entities with all of the flags
+
+BENCHMARK_DEFINE_F(BitEnumFixture, Loop_SelectAllOf)(benchmark::State& state) {
+	for (auto _ : state) {
+		std::size_t count = 0;
+		for (std::size_t i = 0; i < flags_.size(); ++i) {
+			if (flags_[i].all_of(ShadowPass))
+				indices_[count++] = static_cast<std::uint32_t>(i);
+		}
+		benchmark::DoNotOptimize(count);
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK_REGISTER_F(BitEnumFixture, Loop_SelectAllOf)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(BitEnumFixture, Span_SelectAllOf)(benchmark::State& state) {
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(ctp::select_all_of(flags_, ShadowPass, std::span{indices_}));
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK_REGISTER_F(BitEnumFixture, Span_SelectAllOf)->DO_RANGE();
+
+// Bitmask of entities with all of the flags
+
+BENCHMARK_DEFINE_F(BitEnumFixture, Loop_SelectAllOfBits)(benchmark::State& state) {
+	for (auto _ : state) {
+		for (std::uint64_t& word : bits_)
+			word = 0;
+		for (std::size_t i = 0; i < flags_.size(); ++i)
+			bits_[i / 64] |= std::uint64_t{flags_[i].all_of(ShadowPass)} << (i % 64);
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK_REGISTER_F(BitEnumFixture, Loop_SelectAllOfBits)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(BitEnumFixture, Span_SelectAllOfBits)(benchmark::State& state) {
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(ctp::select_all_of(flags_, ShadowPass, std::span{bits_}));
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK_REGISTER_F(BitEnumFixture, Span_SelectAllOfBits)->DO_RANGE();
+
+// Clear a flag on every entity
+
+BENCHMARK_DEFINE_F(BitEnumFixture, Loop_UnsetAll)(benchmark::State& state) {
+	for (auto _ : state) {
+		for (Flags& f : flags_)
+			f.unset(RenderFlag::Dirty);
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK_REGISTER_F(BitEnumFixture, Loop_UnsetAll)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(BitEnumFixture, Span_UnsetAll)(benchmark::State& state) {
+	for (auto _ : state) {
+		ctp::unset_all(flags_, Flags{RenderFlag::Dirty});
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK_REGISTER_F(BitEnumFixture, Span_UnsetAll)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(BitEnumFixture, BaseTime_Sum)(benchmark::State& state) {
+	for (auto _ : state) {
+		std::uint32_t sum = 0;
+		for (const Flags f : flags_)
+			sum += f.underlying();
+		benchmark::DoNotOptimize(sum);
+	}
+}
+BENCHMARK_REGISTER_F(BitEnumFixture, BaseTime_Sum)->DO_RANGE();
@@ -0,0 +1,275 @@
+#define BENCHMARK_STATIC_DEFINE
+#include <benchmark/benchmark.h>
+
+#include <Tools/charconv.hpp>
+
+#include "perf_counters_fixture.hpp"
+
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Numbers converted per iteration.
+constexpr std::size_t BatchSize = 1024;
+constexpr auto BatchItems = static_cast<std::int64_t>(BatchSize);
+
+// Long enough for every number.
+using Buffer = std::array<char, 32>;
+
+class CharconvFixture : public ctp::bench::PerfCountersFixture {
+protected:
+	std::vector<std::int64_t> ints_;
+	std::vector<double> doubles_;
+	// The shortest text of each, null terminated for the C functions.
+	std::vector<std::string> intTexts_;
+	std::vector<std::string> doubleTexts_;
+public:
+	// The arg is the number of significant digits of each number.
+	void SetUp(benchmark::State& state) override {
+		const auto digits = static_cast<int>(state.range(0));
+		std::mt19937_64 rng{static_cast<std::uint64_t>(digits)};
+		std::uint64_t low = 1;
+		for (int i = 1; i < digits; ++i)
+			low *= 10;
+		std::uniform_int_distribution<std::uint64_t> mantissas{low, low * 10 - 1};
+		std::uniform_int_distribution<int> exponents{-30, 30};
+
+		ints_.clear();
+		doubles_.clear();
+		intTexts_.clear();
+		doubleTexts_.clear();
+		Buffer buffer;
+		for (std::size_t i = 0; i < BatchSize; ++i) {
+			const auto mantissa = mantissas(rng);
+			const bool negative = rng() % 2 != 0;
+			ints_.push_back(negative ? -static_cast<std::int64_t>(mantissa) : static_cast<std::int64_t>(mantissa));
+			intTexts_.emplace_back(buffer.data(), std::to_chars(buffer.data(), buffer.data() + buffer.size(), ints_.back()).ptr);
+
+			// The nearest double to mantissa * 10^exponent, which has at most as many digits.
+			const auto text = std::to_string(mantissa) + 'e' + std::to_string(exponents(rng) - digits);
+			double value = 0;
+			std::from_chars(text.data(), text.data() + text.size(), value);
+			doubles_.push_back(negative ? -value : value);
+			doubleTexts_.emplace_back(buffer.data(), std::to_chars(buffer.data(), buffer.data() + buffer.size(), doubles_.back()).ptr);
+		}
+	}
+
+	// ToChars
+
+	template <class T>
+	void RunStdToChars(benchmark::State& state, const std::vector<T>& values) {
+		Buffer buffer;
+		for (auto _ : state) {
+			for (const T value : values) {
+				benchmark::DoNotOptimize(std::to_chars(buffer.data(), buffer.data() + buffer.size(), value).ptr);
+				benchmark::ClobberMemory();
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * BatchItems);
+	}
+
+	template <class T>
+	void RunCTPToChars(benchmark::State& state, const std::vector<T>& values) {
+		ctp::ToCharsConverter<T> converter;
+		for (auto _ : state) {
+			for (const T value : values) {
+				benchmark::DoNotOptimize(converter(value).data());
+				benchmark::ClobberMemory();
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * BatchItems);
+	}
+
+	// Into a string that has to make room first.
+	template <class T>
+	void RunCTPAppendToChars(benchmark::State& state, const std::vector<T>& values) {
+		ctp::small_string<32> str;
+		for (auto _ : state) {
+			for (const T value : values) {
+				str.clear();
+				ctp::AppendChars(str, value);
+				benchmark::DoNotOptimize(str.data());
+				benchmark::ClobberMemory();
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * BatchItems);
+	}
+
+	// FromChars
+
+	template <class T>
+	void RunStdFromChars(benchmark::State& state, const std::vector<std::string>& texts) {
+		for (auto _ : state) {
+			for (const std::string& text : texts) {
+				T value{};
+				std::from_chars(text.data(), text.data() + text.size(), value);
+				benchmark::DoNotOptimize(value);
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * BatchItems);
+	}
+
+	template <class T>
+	void RunCTPFromChars(benchmark::State& state, const std::vector<std::string>& texts) {
+		constexpr ctp::FromCharsParser<T> parser;
+		for (auto _ : state) {
+			for (const std::string& text : texts) {
+				T value{};
+				parser.parse(text.data(), text.data() + text.size(), value);
+				benchmark::DoNotOptimize(value);
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * BatchItems);
+	}
+
+	// strtoll or strtod, which need the null terminator.
+	template <class T>
+	void RunCFromChars(benchmark::State& state, const std::vector<std::string>& texts) {
+		for (auto _ : state) {
+			for (const std::string& text : texts) {
+				if constexpr (std::is_integral_v<T>)
+					benchmark::DoNotOptimize(std::strtoll(text.c_str(), nullptr, 10));
+				else
+					benchmark::DoNotOptimize(std::strtod(text.c_str(), nullptr));
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * BatchItems);
+	}
+
+	// Measure the loop over the inputs.
+	template <class Input>
+	void RunBaseTime(benchmark::State& state, const std::vector<Input>& inputs) {
+		for (auto _ : state) {
+			for (const Input& input : inputs) {
+				benchmark::DoNotOptimize(&input);
+				benchmark::ClobberMemory();
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * BatchItems);
+	}
+};
+
+// Columns of numbers of mixed lengths, like telemetry exports.
+template <class T>
+class FormatIntegersFixture : public ctp::bench::PerfCountersFixture {
+protected:
+	std::vector<T> values_;
+	std::vector<char> buffer_;
+public:
+	void SetUp(benchmark::State& state) override {
+		std::mt19937_64 rng{42};
+		values_.clear();
+		for (std::int64_t i = 0; i < state.range(0); ++i) {
+			const auto bits = rng() >> (rng() % 64);
+			values_.push_back(rng() % 2 != 0 ? static_cast<T>(bits) : static_cast<T>(0 - static_cast<T>(bits)));
+		}
+		buffer_.resize(values_.size() * (ctp::max_char_digits_10_v<T> + 1));
+	}
+
+	void RunStd(benchmark::State& state) {
+		for (auto _ : state) {
+			char* out = buffer_.data();
+			char* const last = buffer_.data() + buffer_.size();
+			for (const T value : values_) {
+				out = std::to_chars(out, last, value).ptr;
+				*out++ = ',';
+			}
+			benchmark::DoNotOptimize(out);
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	void RunCTP(benchmark::State& state) {
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(ctp::format_integers(std::span<const T>{values_}, ',', std::span<char>{buffer_}));
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	// Into a new string each time, which includes sizing it.
+	void RunCTPString(benchmark::State& state) {
+		for (auto _ : state) {
+			ctp::small_string<32> str;
+			ctp::format_integers(std::span<const T>{values_}, ',', str);
+			benchmark::DoNotOptimize(str.data());
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	// Measure the loop over the values.
+	void RunBaseTime(benchmark::State& state) {
+		for (auto _ : state) {
+			for (const T& value : values_)
+				benchmark::DoNotOptimize(&value);
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+};
+
+using FormatInt32Fixture = FormatIntegersFixture<std::int32_t>;
+using FormatInt64Fixture = FormatIntegersFixture<std::int64_t>;
+
+} // namespace
+
+// Short, medium, long, and the most a double needs to round-trip.
+#define DO_RANGE() Arg(4)->Arg(8)->Arg(12)->Arg(17)
+
+#define CHARCONV_BENCH(Label, Op, Type, Inputs) \
+	BENCHMARK_DEFINE_F(CharconvFixture, Label##_##Op##Type)(benchmark::State& state) { Run##Label##Op<Type>(state, Inputs); } \
+	BENCHMARK_REGISTER_F(CharconvFixture, Label##_##Op##Type)->DO_RANGE();
+
+#define CHARCONV_BASE_TIME(Op, Type, Inputs) \
+	BENCHMARK_DEFINE_F(CharconvFixture, BaseTime_##Op##Type)(benchmark::State& state) { RunBaseTime(state, Inputs); } \
+	BENCHMARK_REGISTER_F(CharconvFixture, BaseTime_##Op##Type)->DO_RANGE();
+
+using Int = std::int64_t;
+using Double = double;
+
+// ToChars
+
+CHARCONV_BENCH(Std, ToChars, Int, ints_)
+CHARCONV_BENCH(CTP, ToChars, Int, ints_)
+CHARCONV_BENCH(CTPAppend, ToChars, Int, ints_)
+CHARCONV_BASE_TIME(ToChars, Int, ints_)
+
+CHARCONV_BENCH(Std, ToChars, Double, doubles_)
+CHARCONV_BENCH(CTP, ToChars, Double, doubles_)
+CHARCONV_BENCH(CTPAppend, ToChars, Double, doubles_)
+CHARCONV_BASE_TIME(ToChars, Double, doubles_)
+
+// FromChars
+
+CHARCONV_BENCH(Std, FromChars, Int, intTexts_)
+CHARCONV_BENCH(CTP, FromChars, Int, intTexts_)
+CHARCONV_BENCH(C, FromChars, Int, intTexts_)
+CHARCONV_BASE_TIME(FromChars, Int, intTexts_)
+
+CHARCONV_BENCH(Std, FromChars, Double, doubleTexts_)
+CHARCONV_BENCH(CTP, FromChars, Double, doubleTexts_)
+CHARCONV_BENCH(C, FromChars, Double, doubleTexts_)
+CHARCONV_BASE_TIME(FromChars, Double, doubleTexts_)
+
+// Bulk formatting
+
+#define FORMAT_INTEGERS_BENCH(Fixture, Label, Type) \
+	BENCHMARK_DEFINE_F(Fixture, Label##_Format##Type)(benchmark::State& state) { Run##Label(state); } \
+	BENCHMARK_REGISTER_F(Fixture, Label##_Format##Type)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+
+FORMAT_INTEGERS_BENCH(FormatInt32Fixture, Std, Int32)
+FORMAT_INTEGERS_BENCH(FormatInt32Fixture, CTP, Int32)
+FORMAT_INTEGERS_BENCH(FormatInt32Fixture, CTPString, Int32)
+FORMAT_INTEGERS_BENCH(FormatInt32Fixture, BaseTime, Int32)
+
+FORMAT_INTEGERS_BENCH(FormatInt64Fixture, Std, Int64)
+FORMAT_INTEGERS_BENCH(FormatInt64Fixture, CTP, Int64)
+FORMAT_INTEGERS_BENCH(FormatInt64Fixture, CTPString, Int64)
+FORMAT_INTEGERS_BENCH(FormatInt64Fixture, BaseTime, Int64)
@@ -0,0 +1,124 @@
+#define BENCHMARK_STATIC_DEFINE
+#include <benchmark/benchmark.h>
+
+#include <Tools/enum_reflection.hpp>
+
+#include <random>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// Something like what a save file would store.
+enum class ItemKind {
+	None,
+	Sword, Axe, Mace, Spear, Bow, Crossbow, Staff, Wand, Dagger,
+	Helmet, Chestplate, Gauntlets, Greaves, Boots, Shield,
+	Ring, Amulet, Trinket,
+	HealthPotion, ManaPotion, StaminaPotion, Elixir, Antidote,
+	Scroll, Tome, Map, Key, Lockpick, Torch,
+	Ore, Ingot, Gem, Herb, Hide, Leather, Cloth, Wood,
+	Arrow = 60, Bolt, Quiver,
+	QuestItem = 100,
+};
+
+constexpr std::int64_t Conversions = 1 << 20;
+
+class EnumConvertFixture : public benchmark::Fixture {
+protected:
+	std::vector<ItemKind> values_;
+	std::vector<std::string_view> names_;
+	std::vector<ctp::zstring_view> namesOut_;
+	std::vector<ItemKind> valuesOut_;
+public:
+	void SetUp(benchmark::State& state) override {
+		const auto& vals = ctp::enums::values<ItemKind>();
+		std::mt19937 rng{77};
+		std::uniform_int_distribution<std::size_t> dist{0, vals.size() - 1};
+		const auto count = static_cast<std::size_t>(state.range(0));
+		values_.resize(count);
+		names_.resize(count);
+		namesOut_.resize(count);
+		valuesOut_.resize(count);
+		for (std::size_t i = 0; i < count; ++i) {
+			values_[i] = vals[dist(rng)];
+			names_[i] = ctp::enums::name(values_[i]);
+		}
+	}
+};
+
+} // namespace
+
+#define DO_RANGE() Arg(Conversions)
+
+// To string
+
+BENCHMARK_DEFINE_F(EnumConvertFixture, Single_ToString)(benchmark::State& state) {
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < values_.size(); ++i)
+			namesOut_[i] = ctp::enums::name(values_[i]);
+		benchmark::DoNotOptimize(namesOut_.data());
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK_REGISTER_F(EnumConvertFixture, Single_ToString)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(EnumConvertFixture, Bulk_ToString)(benchmark::State& state) {
+	for (auto _ : state) {
+		ctp::enums::names_of<ItemKind>(values_, namesOut_.begin());
+		benchmark::DoNotOptimize(namesOut_.data());
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK_REGISTER_F(EnumConvertFixture, Bulk_ToString)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(EnumConvertFixture, Packed_ToString)(benchmark::State& state) {
+	const ctp::enums::packed_names_view packed{ctp::enums::packed_names<ItemKind>};
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < values_.size(); ++i)
+			namesOut_[i] = packed[ctp::enums::index(values_[i])];
+		benchmark::DoNotOptimize(namesOut_.data());
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK_REGISTER_F(EnumConvertFixture, Packed_ToString)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(EnumConvertFixture, BaseTime_ToString)(benchmark::State& state) {
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < values_.size(); ++i)
+			valuesOut_[i] = values_[i];
+		benchmark::DoNotOptimize(valuesOut_.data());
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK_REGISTER_F(EnumConvertFixture, BaseTime_ToString)->DO_RANGE();
+
+// From string
+
+BENCHMARK_DEFINE_F(EnumConvertFixture, Single_FromString)(benchmark::State& state) {
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < names_.size(); ++i)
+			valuesOut_[i] = *ctp::enums::try_cast<ItemKind>(names_[i]);
+		benchmark::DoNotOptimize(valuesOut_.data());
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK_REGISTER_F(EnumConvertFixture, Single_FromString)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(EnumConvertFixture, Bulk_FromString)(benchmark::State& state) {
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(ctp::enums::parse_all<ItemKind>(names_, valuesOut_));
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK_REGISTER_F(EnumConvertFixture, Bulk_FromString)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(EnumConvertFixture, BaseTime_FromString)(benchmark::State& state) {
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < names_.size(); ++i)
+			valuesOut_[i] = static_cast<ItemKind>(names_[i].size());
+		benchmark::DoNotOptimize(valuesOut_.data());
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK_REGISTER_F(EnumConvertFixture, BaseTime_FromString)->DO_RANGE();
@@ -0,0 +1,122 @@
+#define BENCHMARK_STATIC_DEFINE
+#include <benchmark/benchmark.h>
+
+#include <Tools/enum_dispatch.hpp>
+#include <Tools/enum_map.hpp>
+
+#include <bit>
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Instructions for a toy interpreter.
+enum class Op {
+	Add, Sub, Mul, Xor, Or, And, Shl, Shr,
+	Inc, Dec, Neg, Not, Rotl, Rotr, Swap, Nop,
+};
+
+// Each op does a little work, different enough that they can't be merged into one.
+template <Op op>
+constexpr unsigned apply(unsigned acc, unsigned arg) noexcept {
+	if constexpr (op == Op::Add) return acc + arg;
+	else if constexpr (op == Op::Sub) return acc - arg;
+	else if constexpr (op == Op::Mul) return acc * (arg | 1);
+	else if constexpr (op == Op::Xor) return acc ^ arg;
+	else if constexpr (op == Op::Or) return acc | (arg & 0xF0);
+	else if constexpr (op == Op::And) return acc & (arg | 0xFFFF0000u);
+	else if constexpr (op == Op::Shl) return acc << (arg & 7);
+	else if constexpr (op == Op::Shr) return acc >> (arg & 7);
+	else if constexpr (op == Op::Inc) return acc + 1;
+	else if constexpr (op == Op::Dec) return acc - 1;
+	else if constexpr (op == Op::Neg) return 0u - acc;
+	else if constexpr (op == Op::Not) return ~acc;
+	else if constexpr (op == Op::Rotl) return std::rotl(acc, static_cast<int>(arg & 31));
+	else if constexpr (op == Op::Rotr) return std::rotr(acc, static_cast<int>(arg & 31));
+	else if constexpr (op == Op::Swap) return (acc >> 16) | (acc << 16);
+	else return acc;
+}
+
+unsigned apply_switch(Op op, unsigned acc, unsigned arg) noexcept {
+#define CASE(name) case Op::name: return apply<Op::name>(acc, arg)
+	switch (op) {
+		CASE(Add); CASE(Sub); CASE(Mul); CASE(Xor); CASE(Or); CASE(And); CASE(Shl); CASE(Shr);
+		CASE(Inc); CASE(Dec); CASE(Neg); CASE(Not); CASE(Rotl); CASE(Rotr); CASE(Swap); CASE(Nop);
+	}
+#undef CASE
+	return acc;
+}
+
+using OpFunction = std::function<unsigned(unsigned, unsigned)>;
+
+class EnumDispatchFixture : public benchmark::Fixture {
+protected:
+	std::vector<Op> ops_;
+	std::vector<unsigned> args_;
+	ctp::enum_map<Op, OpFunction> functions_{OpFunction{}};
+public:
+	void SetUp(benchmark::State& state) override {
+		const auto& vals = ctp::enums::values<Op>();
+		std::mt19937 rng{77};
+		std::uniform_int_distribution<std::size_t> dist{0, vals.size() - 1};
+
+		const auto count = static_cast<std::size_t>(state.range(0));
+		ops_.clear();
+		args_.clear();
+		for (std::size_t i = 0; i < count; ++i) {
+			ops_.push_back(vals[dist(rng)]);
+			args_.push_back(static_cast<unsigned>(rng()));
+		}
+		for (const Op op : vals)
+			functions_[op] = ctp::enum_dispatch(op, []<Op O>() { return OpFunction{&apply<O>}; });
+	}
+};
+
+} // namespace
+
+#define DO_RANGE() Range(64, 4096)
+
+// Run a random program
+
+BENCHMARK_DEFINE_F(EnumDispatchFixture, Switch_Run)(benchmark::State& state) {
+	for (auto _ : state) {
+		unsigned acc = 1;
+		for (std::size_t i = 0; i < ops_.size(); ++i)
+			acc = apply_switch(ops_[i], acc, args_[i]);
+		benchmark::DoNotOptimize(acc);
+	}
+}
+BENCHMARK_REGISTER_F(EnumDispatchFixture, Switch_Run)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(EnumDispatchFixture, EnumMapFunction_Run)(benchmark::State& state) {
+	for (auto _ : state) {
+		unsigned acc = 1;
+		for (std::size_t i = 0; i < ops_.size(); ++i)
+			acc = functions_[ops_[i]](acc, args_[i]);
+		benchmark::DoNotOptimize(acc);
+	}
+}
+BENCHMARK_REGISTER_F(EnumDispatchFixture, EnumMapFunction_Run)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(EnumDispatchFixture, EnumDispatch_Run)(benchmark::State& state) {
+	for (auto _ : state) {
+		unsigned acc = 1;
+		for (std::size_t i = 0; i < ops_.size(); ++i) {
+			const unsigned arg = args_[i];
+			acc = ctp::enum_dispatch(ops_[i], [acc, arg]<Op O>() { return apply<O>(acc, arg); });
+		}
+		benchmark::DoNotOptimize(acc);
+	}
+}
+BENCHMARK_REGISTER_F(EnumDispatchFixture, EnumDispatch_Run)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(EnumDispatchFixture, BaseTime_Run)(benchmark::State& state) {
+	for (auto _ : state) {
+		unsigned acc = 1;
+		for (std::size_t i = 0; i < ops_.size(); ++i)
+			acc += static_cast<unsigned>(ops_[i]) ^ args_[i];
+		benchmark::DoNotOptimize(acc);
+	}
+}
+BENCHMARK_REGISTER_F(EnumDispatchFixture, BaseTime_Run)->DO_RANGE();
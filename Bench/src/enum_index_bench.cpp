@@ -0,0 +1,188 @@
+#define BENCHMARK_STATIC_DEFINE
+#include <benchmark/benchmark.h>
+
+#include <Tools/enum_reflection.hpp>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+// Eight values starting at base, step apart.
+#define ENUM_GROUP(name, base, step) \
+	name##0 = (base), name##1 = (base) + (step), name##2 = (base) + 2 * (step), name##3 = (base) + 3 * (step), \
+	name##4 = (base) + 4 * (step), name##5 = (base) + 5 * (step), name##6 = (base) + 6 * (step), name##7 = (base) + 7 * (step)
+
+// 64 values spread over a wide range. Picks simd_compare.
+enum class SparseSmall {
+	ENUM_GROUP(A, 0, 100),
+	ENUM_GROUP(B, 800, 100),
+	ENUM_GROUP(C, 1600, 100),
+	ENUM_GROUP(D, 2400, 100),
+	ENUM_GROUP(E, 3200, 100),
+	ENUM_GROUP(F, 4000, 100),
+	ENUM_GROUP(G, 4800, 100),
+	ENUM_GROUP(H, 5600, 100),
+};
+
+// 128 values in clusters, like protocol opcodes grouped by system. Picks radix_table.
+enum class Clustered {
+	ENUM_GROUP(Login, 0x000, 1),
+	ENUM_GROUP(Chat, 0x080, 1),
+	ENUM_GROUP(Move, 0x100, 1),
+	ENUM_GROUP(Combat, 0x180, 1),
+	ENUM_GROUP(Item, 0x200, 1),
+	ENUM_GROUP(Trade, 0x280, 1),
+	ENUM_GROUP(Quest, 0x300, 1),
+	ENUM_GROUP(Guild, 0x380, 1),
+	ENUM_GROUP(Mail, 0x400, 1),
+	ENUM_GROUP(Auction, 0x480, 1),
+	ENUM_GROUP(Party, 0x500, 1),
+	ENUM_GROUP(Pet, 0x580, 1),
+	ENUM_GROUP(Craft, 0x600, 1),
+	ENUM_GROUP(Map, 0x680, 1),
+	ENUM_GROUP(Admin, 0x700, 1),
+	ENUM_GROUP(Debug, 0x780, 1),
+};
+
+// 128 values evenly spread out. Picks radix_table, but every block is used.
+enum class Spread {
+	ENUM_GROUP(A, 0, 15),
+	ENUM_GROUP(B, 120, 15),
+	ENUM_GROUP(C, 240, 15),
+	ENUM_GROUP(D, 360, 15),
+	ENUM_GROUP(E, 480, 15),
+	ENUM_GROUP(F, 600, 15),
+	ENUM_GROUP(G, 720, 15),
+	ENUM_GROUP(H, 840, 15),
+	ENUM_GROUP(I, 960, 15),
+	ENUM_GROUP(J, 1080, 15),
+	ENUM_GROUP(K, 1200, 15),
+	ENUM_GROUP(L, 1320, 15),
+	ENUM_GROUP(M, 1440, 15),
+	ENUM_GROUP(N, 1560, 15),
+	ENUM_GROUP(O, 1680, 15),
+	ENUM_GROUP(P, 1800, 15),
+};
+
+#undef ENUM_GROUP
+
+} // namespace
+
+CTP_CUSTOM_ENUM_MIN_MAX(SparseSmall, 0, 6300)
+CTP_CUSTOM_ENUM_MIN_MAX(Clustered, 0, 0x800)
+CTP_CUSTOM_ENUM_MIN_MAX(Spread, 0, 1920)
+
+namespace {
+
+static_assert(ctp::enums::detail::index_strategy_v<SparseSmall> == ctp::enums::index_strategy::simd_compare);
+static_assert(ctp::enums::detail::index_strategy_v<Clustered> == ctp::enums::index_strategy::radix_table);
+static_assert(ctp::enums::detail::index_strategy_v<Spread> == ctp::enums::index_strategy::radix_table);
+
+template <ctp::enums::Enum E>
+class EnumIndexFixture : public benchmark::Fixture {
+protected:
+	std::vector<E> lookups_;
+public:
+	void SetUp(benchmark::State& state) override {
+		const auto& vals = ctp::enums::values<E>();
+		std::mt19937 rng{77};
+		std::uniform_int_distribution<std::size_t> dist{0, vals.size() - 1};
+		lookups_.clear();
+		for (std::int64_t i = 0; i < state.range(0); ++i)
+			lookups_.push_back(vals[dist(rng)]);
+	}
+
+	template <ctp::enums::index_strategy Strategy>
+	void Run(benchmark::State& state) {
+		for (auto _ : state) {
+			std::size_t sum = 0;
+			for (const E e : lookups_)
+				sum += ctp::enums::detail::index_with_strategy<Strategy>(e);
+			benchmark::DoNotOptimize(sum);
+		}
+	}
+
+	void RunMagicEnum(benchmark::State& state) {
+		for (auto _ : state) {
+			std::size_t sum = 0;
+			for (const E e : lookups_)
+				sum += *ctp::enums::try_get_index(e);
+			benchmark::DoNotOptimize(sum);
+		}
+	}
+
+	// Measure iterating the lookups.
+	void RunBaseTime(benchmark::State& state) {
+		for (auto _ : state) {
+			std::size_t sum = 0;
+			for (const E e : lookups_)
+				sum += static_cast<std::size_t>(std::to_underlying(e));
+			benchmark::DoNotOptimize(sum);
+		}
+	}
+};
+
+using SparseSmallFixture = EnumIndexFixture<SparseSmall>;
+using ClusteredFixture = EnumIndexFixture<Clustered>;
+using SpreadFixture = EnumIndexFixture<Spread>;
+
+} // namespace
+
+#define DO_RANGE() Range(64, 4096)
+
+using enum ctp::enums::index_strategy;
+
+// Sparse, small
+
+BENCHMARK_DEFINE_F(SparseSmallFixture, MagicEnum_IndexSparseSmall)(benchmark::State& state) { RunMagicEnum(state); }
+BENCHMARK_REGISTER_F(SparseSmallFixture, MagicEnum_IndexSparseSmall)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(SparseSmallFixture, Linear_IndexSparseSmall)(benchmark::State& state) { Run<linear_search>(state); }
+BENCHMARK_REGISTER_F(SparseSmallFixture, Linear_IndexSparseSmall)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(SparseSmallFixture, Binary_IndexSparseSmall)(benchmark::State& state) { Run<binary_search>(state); }
+BENCHMARK_REGISTER_F(SparseSmallFixture, Binary_IndexSparseSmall)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(SparseSmallFixture, Simd_IndexSparseSmall)(benchmark::State& state) { Run<simd_compare>(state); }
+BENCHMARK_REGISTER_F(SparseSmallFixture, Simd_IndexSparseSmall)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(SparseSmallFixture, Radix_IndexSparseSmall)(benchmark::State& state) { Run<radix_table>(state); }
+BENCHMARK_REGISTER_F(SparseSmallFixture, Radix_IndexSparseSmall)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(SparseSmallFixture, BaseTime_IndexSparseSmall)(benchmark::State& state) { RunBaseTime(state); }
+BENCHMARK_REGISTER_F(SparseSmallFixture, BaseTime_IndexSparseSmall)->DO_RANGE();
+
+// Clustered
+
+BENCHMARK_DEFINE_F(ClusteredFixture, MagicEnum_IndexClustered)(benchmark::State& state) { RunMagicEnum(state); }
+BENCHMARK_REGISTER_F(ClusteredFixture, MagicEnum_IndexClustered)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(ClusteredFixture, Linear_IndexClustered)(benchmark::State& state) { Run<linear_search>(state); }
+BENCHMARK_REGISTER_F(ClusteredFixture, Linear_IndexClustered)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(ClusteredFixture, Binary_IndexClustered)(benchmark::State& state) { Run<binary_search>(state); }
+BENCHMARK_REGISTER_F(ClusteredFixture, Binary_IndexClustered)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(ClusteredFixture, Radix_IndexClustered)(benchmark::State& state) { Run<radix_table>(state); }
+BENCHMARK_REGISTER_F(ClusteredFixture, Radix_IndexClustered)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(ClusteredFixture, BaseTime_IndexClustered)(benchmark::State& state) { RunBaseTime(state); }
+BENCHMARK_REGISTER_F(ClusteredFixture, BaseTime_IndexClustered)->DO_RANGE();
+
+// Spread
+
+BENCHMARK_DEFINE_F(SpreadFixture, MagicEnum_IndexSpread)(benchmark::State& state) { RunMagicEnum(state); }
+BENCHMARK_REGISTER_F(SpreadFixture, MagicEnum_IndexSpread)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(SpreadFixture, Linear_IndexSpread)(benchmark::State& state) { Run<linear_search>(state); }
+BENCHMARK_REGISTER_F(SpreadFixture, Linear_IndexSpread)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(SpreadFixture, Binary_IndexSpread)(benchmark::State& state) { Run<binary_search>(state); }
+BENCHMARK_REGISTER_F(SpreadFixture, Binary_IndexSpread)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(SpreadFixture, Radix_IndexSpread)(benchmark::State& state) { Run<radix_table>(state); }
+BENCHMARK_REGISTER_F(SpreadFixture, Radix_IndexSpread)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(SpreadFixture, BaseTime_IndexSpread)(benchmark::State& state) { RunBaseTime(state); }
+BENCHMARK_REGISTER_F(SpreadFixture, BaseTime_IndexSpread)->DO_RANGE();
@@ -0,0 +1,257 @@
+#define BENCHMARK_STATIC_DEFINE
+#include <benchmark/benchmark.h>
+
+#include <Tools/BitEnum.hpp>
+#include <Tools/enum_map.hpp>
+#include <Tools/enum_set.hpp>
+
+#include <bit>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Flag enum, so BitEnum can be compared too.
+enum class Flag : std::uint8_t {
+	F0 = 1 << 0,
+	F1 = 1 << 1,
+	F2 = 1 << 2,
+	F3 = 1 << 3,
+	F4 = 1 << 4,
+	F5 = 1 << 5,
+	F6 = 1 << 6,
+	F7 = 1 << 7,
+};
+
+// Too many values for flags.
+enum class Permission {
+	P0, P1, P2, P3, P4, P5, P6, P7, P8, P9,
+	P10, P11, P12, P13, P14, P15, P16, P17, P18, P19,
+	P20, P21, P22, P23, P24, P25, P26, P27, P28, P29,
+	P30, P31, P32, P33, P34, P35, P36, P37, P38, P39,
+};
+
+// The byte per value layout enum_map<E, bool> used to have.
+template <class E>
+using byte_map = ctp::enum_map<E, std::uint8_t>;
+
+// A capability table for each entity, all randomly filled, and some random queries.
+template <class E>
+class EnumSetFixture : public benchmark::Fixture {
+protected:
+	std::vector<byte_map<E>> byteMaps_;
+	std::vector<ctp::enum_map<E, bool>> bitMaps_;
+	std::vector<ctp::enum_set<E>> sets_;
+	std::vector<E> queries_;
+	ctp::enum_set<E> mask_;
+public:
+	void SetUp(benchmark::State& state) override {
+		const auto& vals = ctp::enums::values<E>();
+		std::mt19937 rng{77};
+		std::bernoulli_distribution coin;
+		std::uniform_int_distribution<std::size_t> dist{0, vals.size() - 1};
+
+		const auto count = static_cast<std::size_t>(state.range(0));
+		byteMaps_.assign(count, byte_map<E>{0});
+		bitMaps_.assign(count, ctp::enum_map<E, bool>{false});
+		sets_.assign(count, ctp::enum_set<E>{});
+		queries_.clear();
+		for (std::size_t i = 0; i < count; ++i) {
+			for (const E e : vals) {
+				if (coin(rng)) {
+					byteMaps_[i][e] = 1;
+					bitMaps_[i][e] = true;
+					sets_[i].insert(e);
+				}
+			}
+			queries_.push_back(vals[dist(rng)]);
+		}
+		mask_.clear();
+		for (const E e : vals) {
+			if (coin(rng))
+				mask_.insert(e);
+		}
+	}
+};
+
+class FlagFixture : public EnumSetFixture<Flag> {
+protected:
+	std::vector<ctp::BitEnum<Flag>> bitEnums_;
+public:
+	void SetUp(benchmark::State& state) override {
+		EnumSetFixture<Flag>::SetUp(state);
+		bitEnums_.clear();
+		for (const auto& set : sets_)
+			bitEnums_.push_back(set.to_flags());
+	}
+};
+
+using PermissionFixture = EnumSetFixture<Permission>;
+
+} // namespace
+
+#define DO_RANGE() Range(64, 4096)
+
+// Flag, contains
+
+BENCHMARK_DEFINE_F(FlagFixture, ByteMap_ContainsFlag)(benchmark::State& state) {
+	for (auto _ : state) {
+		std::size_t count = 0;
+		for (std::size_t i = 0; i < queries_.size(); ++i)
+			count += byteMaps_[i][queries_[i]] != 0;
+		benchmark::DoNotOptimize(count);
+	}
+}
+BENCHMARK_REGISTER_F(FlagFixture, ByteMap_ContainsFlag)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(FlagFixture, BitMap_ContainsFlag)(benchmark::State& state) {
+	for (auto _ : state) {
+		std::size_t count = 0;
+		for (std::size_t i = 0; i < queries_.size(); ++i)
+			count += bitMaps_[i][queries_[i]];
+		benchmark::DoNotOptimize(count);
+	}
+}
+BENCHMARK_REGISTER_F(FlagFixture, BitMap_ContainsFlag)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(FlagFixture, EnumSet_ContainsFlag)(benchmark::State& state) {
+	for (auto _ : state) {
+		std::size_t count = 0;
+		for (std::size_t i = 0; i < queries_.size(); ++i)
+			count += sets_[i].contains(queries_[i]);
+		benchmark::DoNotOptimize(count);
+	}
+}
+BENCHMARK_REGISTER_F(FlagFixture, EnumSet_ContainsFlag)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(FlagFixture, BitEnum_ContainsFlag)(benchmark::State& state) {
+	for (auto _ : state) {
+		std::size_t count = 0;
+		for (std::size_t i = 0; i < queries_.size(); ++i)
+			count += bitEnums_[i].any_of(queries_[i]);
+		benchmark::DoNotOptimize(count);
+	}
+}
+BENCHMARK_REGISTER_F(FlagFixture, BitEnum_ContainsFlag)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(FlagFixture, BaseTime_ContainsFlag)(benchmark::State& state) {
+	for (auto _ : state) {
+		std::size_t count = 0;
+		for (std::size_t i = 0; i < queries_.size(); ++i)
+			count += static_cast<std::size_t>(queries_[i]);
+		benchmark::DoNotOptimize(count);
+	}
+}
+BENCHMARK_REGISTER_F(FlagFixture, BaseTime_ContainsFlag)->DO_RANGE();
+
+// Flag, intersect every table with a mask and count what is left
+
+BENCHMARK_DEFINE_F(FlagFixture, ByteMap_IntersectCountFlag)(benchmark::State& state) {
+	for (auto _ : state) {
+		std::size_t count = 0;
+		for (auto& map : byteMaps_) {
+			for (const Flag e : ctp::enums::values<Flag>()) {
+				map[e] = static_cast<std::uint8_t>(map[e] & mask_.contains(e));
+				count += map[e];
+			}
+		}
+		benchmark::DoNotOptimize(count);
+	}
+}
+BENCHMARK_REGISTER_F(FlagFixture, ByteMap_IntersectCountFlag)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(FlagFixture, EnumSet_IntersectCountFlag)(benchmark::State& state) {
+	for (auto _ : state) {
+		std::size_t count = 0;
+		for (auto& set : sets_) {
+			set &= mask_;
+			count += set.size();
+		}
+		benchmark::DoNotOptimize(count);
+	}
+}
+BENCHMARK_REGISTER_F(FlagFixture, EnumSet_IntersectCountFlag)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(FlagFixture, BitEnum_IntersectCountFlag)(benchmark::State& state) {
+	const ctp::BitEnum<Flag> mask = mask_.to_flags();
+	for (auto _ : state) {
+		std::size_t count = 0;
+		for (auto& flags : bitEnums_) {
+			flags &= mask;
+			count += static_cast<std::size_t>(std::popcount(flags.underlying()));
+		}
+		benchmark::DoNotOptimize(count);
+	}
+}
+BENCHMARK_REGISTER_F(FlagFixture, BitEnum_IntersectCountFlag)->DO_RANGE();
+
+// Permission, contains
+
+BENCHMARK_DEFINE_F(PermissionFixture, ByteMap_ContainsPermission)(benchmark::State& state) {
+	for (auto _ : state) {
+		std::size_t count = 0;
+		for (std::size_t i = 0; i < queries_.size(); ++i)
+			count += byteMaps_[i][queries_[i]] != 0;
+		benchmark::DoNotOptimize(count);
+	}
+}
+BENCHMARK_REGISTER_F(PermissionFixture, ByteMap_ContainsPermission)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(PermissionFixture, BitMap_ContainsPermission)(benchmark::State& state) {
+	for (auto _ : state) {
+		std::size_t count = 0;
+		for (std::size_t i = 0; i < queries_.size(); ++i)
+			count += bitMaps_[i][queries_[i]];
+		benchmark::DoNotOptimize(count);
+	}
+}
+BENCHMARK_REGISTER_F(PermissionFixture, BitMap_ContainsPermission)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(PermissionFixture, EnumSet_ContainsPermission)(benchmark::State& state) {
+	for (auto _ : state) {
+		std::size_t count = 0;
+		for (std::size_t i = 0; i < queries_.size(); ++i)
+			count += sets_[i].contains(queries_[i]);
+		benchmark::DoNotOptimize(count);
+	}
+}
+BENCHMARK_REGISTER_F(PermissionFixture, EnumSet_ContainsPermission)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(PermissionFixture, BaseTime_ContainsPermission)(benchmark::State& state) {
+	for (auto _ : state) {
+		std::size_t count = 0;
+		for (std::size_t i = 0; i < queries_.size(); ++i)
+			count += static_cast<std::size_t>(queries_[i]);
+		benchmark::DoNotOptimize(count);
+	}
+}
+BENCHMARK_REGISTER_F(PermissionFixture, BaseTime_ContainsPermission)->DO_RANGE();
+
+// Permission, intersect every table with a mask and count what is left
+
+BENCHMARK_DEFINE_F(PermissionFixture, ByteMap_IntersectCountPermission)(benchmark::State& state) {
+	for (auto _ : state) {
+		std::size_t count = 0;
+		for (auto& map : byteMaps_) {
+			for (const Permission e : ctp::enums::values<Permission>()) {
+				map[e] = static_cast<std::uint8_t>(map[e] & mask_.contains(e));
+				count += map[e];
+			}
+		}
+		benchmark::DoNotOptimize(count);
+	}
+}
+BENCHMARK_REGISTER_F(PermissionFixture, ByteMap_IntersectCountPermission)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(PermissionFixture, EnumSet_IntersectCountPermission)(benchmark::State& state) {
+	for (auto _ : state) {
+		std::size_t count = 0;
+		for (auto& set : sets_) {
+			set &= mask_;
+			count += set.size();
+		}
+		benchmark::DoNotOptimize(count);
+	}
+}
+BENCHMARK_REGISTER_F(PermissionFixture, EnumSet_IntersectCountPermission)->DO_RANGE();
@@ -0,0 +1,173 @@
+#define BENCHMARK_STATIC_DEFINE
+#include <benchmark/benchmark.h>
+
+#include <Tools/fixed_point.hpp>
+
+#include "perf_counters_fixture.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace {
+
+// Values per iteration.
+constexpr std::size_t BatchSize = 4096;
+constexpr auto BatchItems = static_cast<std::int64_t>(BatchSize);
+
+// Fixed-point the way it's usually first written, dividing by the scale and going through double.
+template <typename I, int FracBits>
+struct NaiveFixed {
+	static constexpr double Scale = static_cast<double>(std::int64_t{1} << FracBits);
+	I raw = 0;
+
+	friend NaiveFixed operator*(const NaiveFixed lhs, const NaiveFixed rhs) noexcept {
+		if constexpr (sizeof(I) <= 4)
+			return {static_cast<I>(static_cast<std::int64_t>(lhs.raw) * rhs.raw / (std::int64_t{1} << FracBits))};
+		else
+			return {static_cast<I>(static_cast<double>(lhs.raw) * static_cast<double>(rhs.raw) / Scale)};
+	}
+	friend NaiveFixed operator/(const NaiveFixed lhs, const NaiveFixed rhs) noexcept {
+		if constexpr (sizeof(I) <= 4)
+			return {static_cast<I>(static_cast<std::int64_t>(lhs.raw) * (std::int64_t{1} << FracBits) / rhs.raw)};
+		else
+			return {static_cast<I>(static_cast<double>(lhs.raw) / static_cast<double>(rhs.raw) * Scale)};
+	}
+	friend NaiveFixed sqrt(const NaiveFixed x) noexcept {
+		return {static_cast<I>(std::sqrt(static_cast<double>(x.raw) / Scale) * Scale)};
+	}
+	friend NaiveFixed reciprocal(const NaiveFixed x) noexcept {
+		return {static_cast<I>(Scale / static_cast<double>(x.raw) * Scale)};
+	}
+};
+
+// The same positive values, between 1/16 and 256, as floats, naive fixed-point and fixed_point.
+template <typename Fixed>
+class FixedPointFixture : public ctp::bench::PerfCountersFixture {
+protected:
+	using I = typename Fixed::value_type;
+	using Naive = NaiveFixed<I, Fixed::frac_bits>;
+
+	std::vector<float> floatLhs_, floatRhs_, floatOut_;
+	std::vector<Naive> naiveLhs_, naiveRhs_, naiveOut_;
+	std::vector<Fixed> lhs_, rhs_, out_;
+public:
+	void SetUp(benchmark::State&) override {
+		std::mt19937 rng{3};
+		std::uniform_real_distribution<float> dist{0.0625f, 256.0f};
+		floatLhs_.clear();
+		floatRhs_.clear();
+		naiveLhs_.clear();
+		naiveRhs_.clear();
+		lhs_.clear();
+		rhs_.clear();
+		for (std::size_t i = 0; i < BatchSize; ++i) {
+			lhs_.emplace_back(dist(rng));
+			rhs_.emplace_back(dist(rng));
+			floatLhs_.push_back(static_cast<float>(lhs_.back()));
+			floatRhs_.push_back(static_cast<float>(rhs_.back()));
+			naiveLhs_.push_back({lhs_.back().raw()});
+			naiveRhs_.push_back({rhs_.back().raw()});
+		}
+		floatOut_.assign(BatchSize, 0.0f);
+		naiveOut_.assign(BatchSize, Naive{});
+		out_.assign(BatchSize, Fixed{});
+	}
+
+	template <typename T, typename Op>
+	void RunBinary(benchmark::State& state, const std::vector<T>& lhs, const std::vector<T>& rhs, std::vector<T>& out, Op op) {
+		for (auto _ : state) {
+			for (std::size_t i = 0; i < BatchSize; ++i)
+				out[i] = op(lhs[i], rhs[i]);
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * BatchItems);
+	}
+
+	template <typename T, typename Op>
+	void RunUnary(benchmark::State& state, const std::vector<T>& in, std::vector<T>& out, Op op) {
+		for (auto _ : state) {
+			for (std::size_t i = 0; i < BatchSize; ++i)
+				out[i] = op(in[i]);
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * BatchItems);
+	}
+
+	// Multiply
+
+	void RunFloatMultiply(benchmark::State& state) { RunBinary(state, floatLhs_, floatRhs_, floatOut_, [](float l, float r) { return l * r; }); }
+	void RunNaiveMultiply(benchmark::State& state) { RunBinary(state, naiveLhs_, naiveRhs_, naiveOut_, [](Naive l, Naive r) { return l * r; }); }
+	void RunCTPMultiply(benchmark::State& state) { RunBinary(state, lhs_, rhs_, out_, [](Fixed l, Fixed r) { return l * r; }); }
+
+	void RunCTPBatchMultiply(benchmark::State& state) {
+		for (auto _ : state) {
+			ctp::multiply_values<Fixed>(lhs_, rhs_, out_);
+			benchmark::DoNotOptimize(out_.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * BatchItems);
+	}
+
+	// Divide
+
+	void RunFloatDivide(benchmark::State& state) { RunBinary(state, floatLhs_, floatRhs_, floatOut_, [](float l, float r) { return l / r; }); }
+	void RunNaiveDivide(benchmark::State& state) { RunBinary(state, naiveLhs_, naiveRhs_, naiveOut_, [](Naive l, Naive r) { return l / r; }); }
+	void RunCTPDivide(benchmark::State& state) { RunBinary(state, lhs_, rhs_, out_, [](Fixed l, Fixed r) { return l / r; }); }
+
+	// Sqrt
+
+	void RunFloatSqrt(benchmark::State& state) { RunUnary(state, floatLhs_, floatOut_, [](float x) { return std::sqrt(x); }); }
+	void RunNaiveSqrt(benchmark::State& state) { RunUnary(state, naiveLhs_, naiveOut_, [](Naive x) { return sqrt(x); }); }
+	void RunCTPSqrt(benchmark::State& state) { RunUnary(state, lhs_, out_, [](Fixed x) { return ctp::fast_sqrt(x); }); }
+
+	// Reciprocal
+
+	void RunFloatReciprocal(benchmark::State& state) { RunUnary(state, floatLhs_, floatOut_, [](float x) { return 1.0f / x; }); }
+	void RunNaiveReciprocal(benchmark::State& state) { RunUnary(state, naiveLhs_, naiveOut_, [](Naive x) { return reciprocal(x); }); }
+	void RunCTPReciprocal(benchmark::State& state) { RunUnary(state, lhs_, out_, [](Fixed x) { return ctp::fast_reciprocal(x); }); }
+
+	// Measure the loops over the values, for the categories with one or two inputs.
+	void RunBaseTimeBinary(benchmark::State& state) { RunBinary(state, lhs_, rhs_, out_, [](Fixed l, Fixed) { return l; }); }
+	void RunBaseTimeUnary(benchmark::State& state) { RunUnary(state, lhs_, out_, [](Fixed x) { return x; }); }
+};
+
+using Q16Fixture = FixedPointFixture<ctp::q16_16>;
+using Q32Fixture = FixedPointFixture<ctp::q32_32>;
+
+} // namespace
+
+// Categories are per type, since base-times are matched to them by name alone.
+#define FIXED_POINT_BENCH(Fixture, Type, Label, Op) \
+	BENCHMARK_DEFINE_F(Fixture, Label##_##Op##Type)(benchmark::State& state) { Run##Label##Op(state); } \
+	BENCHMARK_REGISTER_F(Fixture, Label##_##Op##Type);
+
+#define FIXED_POINT_BASE_TIME(Fixture, Type, Op, Inputs) \
+	BENCHMARK_DEFINE_F(Fixture, BaseTime_##Op##Type)(benchmark::State& state) { RunBaseTime##Inputs(state); } \
+	BENCHMARK_REGISTER_F(Fixture, BaseTime_##Op##Type);
+
+#define FIXED_POINT_BENCHES(Fixture, Type) \
+	FIXED_POINT_BENCH(Fixture, Type, Float, Multiply) \
+	FIXED_POINT_BENCH(Fixture, Type, Naive, Multiply) \
+	FIXED_POINT_BENCH(Fixture, Type, CTP, Multiply) \
+	FIXED_POINT_BENCH(Fixture, Type, CTPBatch, Multiply) \
+	FIXED_POINT_BASE_TIME(Fixture, Type, Multiply, Binary) \
+	FIXED_POINT_BENCH(Fixture, Type, Float, Divide) \
+	FIXED_POINT_BENCH(Fixture, Type, Naive, Divide) \
+	FIXED_POINT_BENCH(Fixture, Type, CTP, Divide) \
+	FIXED_POINT_BASE_TIME(Fixture, Type, Divide, Binary) \
+	FIXED_POINT_BENCH(Fixture, Type, Float, Sqrt) \
+	FIXED_POINT_BENCH(Fixture, Type, Naive, Sqrt) \
+	FIXED_POINT_BENCH(Fixture, Type, CTP, Sqrt) \
+	FIXED_POINT_BASE_TIME(Fixture, Type, Sqrt, Unary) \
+	FIXED_POINT_BENCH(Fixture, Type, Float, Reciprocal) \
+	FIXED_POINT_BENCH(Fixture, Type, Naive, Reciprocal) \
+	FIXED_POINT_BENCH(Fixture, Type, CTP, Reciprocal) \
+	FIXED_POINT_BASE_TIME(Fixture, Type, Reciprocal, Unary)
+
+FIXED_POINT_BENCHES(Q16Fixture, Q16)
+FIXED_POINT_BENCHES(Q32Fixture, Q32)
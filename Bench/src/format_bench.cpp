@@ -0,0 +1,174 @@
+#define BENCHMARK_STATIC_DEFINE
+#include <benchmark/benchmark.h>
+
+#include <Tools/format.hpp>
+
+#include "perf_counters_fixture.hpp"
+
+#include <fmt/compile.h>
+#include <fmt/format.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <format>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Messages formatted per iteration.
+constexpr std::size_t BatchSize = 1024;
+constexpr auto BatchItems = static_cast<std::int64_t>(BatchSize);
+
+// A log line: "{} took {} ms ({} items)".
+struct LogArgs {
+	ctp::fixed_string<16> name;
+	double ms = 0;
+	std::int32_t items = 0;
+};
+
+// An asset key: "{}/{}_{}.bin".
+struct KeyArgs {
+	ctp::fixed_string<16> folder;
+	std::uint32_t id = 0;
+	std::uint16_t lod = 0;
+};
+
+class FormatFixture : public ctp::bench::PerfCountersFixture {
+protected:
+	std::vector<LogArgs> logs_;
+	std::vector<KeyArgs> keys_;
+public:
+	void SetUp(benchmark::State&) override {
+		std::mt19937 rng{7};
+		constexpr const char* Names[] = {"load", "decompress", "upload", "bake_lightmaps"};
+		constexpr const char* Folders[] = {"meshes", "textures", "sounds", "anims"};
+		logs_.clear();
+		keys_.clear();
+		for (std::size_t i = 0; i < BatchSize; ++i) {
+			logs_.push_back({Names[rng() % 4], static_cast<double>(rng() % 100000) / 100, static_cast<std::int32_t>(rng() % 5000)});
+			keys_.push_back({Folders[rng() % 4], static_cast<std::uint32_t>(rng()), static_cast<std::uint16_t>(rng() % 8)});
+		}
+	}
+
+	// Log lines
+
+	void RunStdLog(benchmark::State& state) {
+		for (auto _ : state) {
+			for (const LogArgs& log : logs_) {
+				auto str = std::format("{} took {} ms ({} items)", std::string_view{log.name}, log.ms, log.items);
+				benchmark::DoNotOptimize(str.data());
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * BatchItems);
+	}
+
+	void RunFmtLog(benchmark::State& state) {
+		for (auto _ : state) {
+			for (const LogArgs& log : logs_) {
+				auto str = fmt::format(FMT_COMPILE("{} took {} ms ({} items)"), std::string_view{log.name}, log.ms, log.items);
+				benchmark::DoNotOptimize(str.data());
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * BatchItems);
+	}
+
+	void RunSnprintfLog(benchmark::State& state) {
+		char buffer[64];
+		for (auto _ : state) {
+			for (const LogArgs& log : logs_) {
+				benchmark::DoNotOptimize(std::snprintf(buffer, sizeof(buffer), "%.*s took %g ms (%d items)", static_cast<int>(log.name.size()), log.name.data(), log.ms, log.items));
+				benchmark::ClobberMemory();
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * BatchItems);
+	}
+
+	void RunCTPLog(benchmark::State& state) {
+		for (auto _ : state) {
+			for (const LogArgs& log : logs_) {
+				auto str = ctp::format<"{} took {} ms ({} items)">(log.name, log.ms, log.items);
+				benchmark::DoNotOptimize(str.data());
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * BatchItems);
+	}
+
+	// Asset keys
+
+	void RunStdKey(benchmark::State& state) {
+		for (auto _ : state) {
+			for (const KeyArgs& key : keys_) {
+				auto str = std::format("{}/{}_{}.bin", std::string_view{key.folder}, key.id, key.lod);
+				benchmark::DoNotOptimize(str.data());
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * BatchItems);
+	}
+
+	void RunFmtKey(benchmark::State& state) {
+		for (auto _ : state) {
+			for (const KeyArgs& key : keys_) {
+				auto str = fmt::format(FMT_COMPILE("{}/{}_{}.bin"), std::string_view{key.folder}, key.id, key.lod);
+				benchmark::DoNotOptimize(str.data());
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * BatchItems);
+	}
+
+	void RunSnprintfKey(benchmark::State& state) {
+		char buffer[64];
+		for (auto _ : state) {
+			for (const KeyArgs& key : keys_) {
+				benchmark::DoNotOptimize(std::snprintf(buffer, sizeof(buffer), "%.*s/%u_%u.bin", static_cast<int>(key.folder.size()), key.folder.data(), key.id, static_cast<unsigned>(key.lod)));
+				benchmark::ClobberMemory();
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * BatchItems);
+	}
+
+	void RunCTPKey(benchmark::State& state) {
+		for (auto _ : state) {
+			for (const KeyArgs& key : keys_) {
+				auto str = ctp::format<"{}/{}_{}.bin">(key.folder, key.id, key.lod);
+				benchmark::DoNotOptimize(str.data());
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * BatchItems);
+	}
+
+	// Measure the loop over the arguments.
+	template <class Args>
+	void RunBaseTime(benchmark::State& state, const std::vector<Args>& args) {
+		for (auto _ : state) {
+			for (const Args& arg : args) {
+				benchmark::DoNotOptimize(&arg);
+				benchmark::ClobberMemory();
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * BatchItems);
+	}
+};
+
+} // namespace
+
+#define FORMAT_BENCH(Label, Op) \
+	BENCHMARK_DEFINE_F(FormatFixture, Label##_##Op)(benchmark::State& state) { Run##Label##Op(state); } \
+	BENCHMARK_REGISTER_F(FormatFixture, Label##_##Op);
+
+#define FORMAT_BASE_TIME(Op, Inputs) \
+	BENCHMARK_DEFINE_F(FormatFixture, BaseTime_##Op)(benchmark::State& state) { RunBaseTime(state, Inputs); } \
+	BENCHMARK_REGISTER_F(FormatFixture, BaseTime_##Op);
+
+FORMAT_BENCH(Std, Log)
+FORMAT_BENCH(Fmt, Log)
+FORMAT_BENCH(Snprintf, Log)
+FORMAT_BENCH(CTP, Log)
+FORMAT_BASE_TIME(Log, logs_)
+
+FORMAT_BENCH(Std, Key)
+FORMAT_BENCH(Fmt, Key)
+FORMAT_BENCH(Snprintf, Key)
+FORMAT_BENCH(CTP, Key)
+FORMAT_BASE_TIME(Key, keys_)
@@ -0,0 +1,111 @@
+#define BENCHMARK_STATIC_DEFINE
+#include <benchmark/benchmark.h>
+
+#include <Tools/debug.hpp>
+
+#include <string_view>
+
+// Logs go to stdout along with the console reporter, so run with --benchmark_out=<file>
+// and stdout redirected to a file or the null device.
+// Log is only compiled in debug builds, or with CTP_LOGGING.
+
+#if CTP_LOGGING
+
+namespace {
+
+constexpr std::string_view Message = "entity 1234 moved to (10.5, -3.25, 7) after collision with entity 5678";
+
+} // namespace
+
+#define DO_THREADS() ThreadRange(1, 32)->UseRealTime()
+
+// Time for the calling thread to log a message
+
+static void Sync_Log(benchmark::State& state) {
+	for (auto _ : state)
+		ctpLog(Message);
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(Sync_Log)->DO_THREADS();
+
+static void Async_Log(benchmark::State& state) {
+	if (state.thread_index() == 0)
+		ctp::debug::StartAsyncLogging();
+	for (auto _ : state)
+		ctpLog(Message);
+	state.SetItemsProcessed(state.iterations());
+	if (state.thread_index() == 0)
+		ctp::debug::StopAsyncLogging();
+}
+BENCHMARK(Async_Log)->DO_THREADS();
+
+// Time until the messages are written out
+
+static void Sync_LogFlushed(benchmark::State& state) {
+	for (auto _ : state) {
+		for (int i = 0; i < 64; ++i)
+			ctpLog(Message);
+		ctp::debug::FlushLog();
+	}
+	state.SetItemsProcessed(state.iterations() * 64);
+}
+BENCHMARK(Sync_LogFlushed)->DO_THREADS();
+
+static void Async_LogFlushed(benchmark::State& state) {
+	if (state.thread_index() == 0)
+		ctp::debug::StartAsyncLogging();
+	for (auto _ : state) {
+		for (int i = 0; i < 64; ++i)
+			ctpLog(Message);
+		ctp::debug::FlushLog();
+	}
+	state.SetItemsProcessed(state.iterations() * 64);
+	if (state.thread_index() == 0)
+		ctp::debug::StopAsyncLogging();
+}
+BENCHMARK(Async_LogFlushed)->DO_THREADS();
+
+// Time for the calling thread to skip a log.
+// Logs below CTP_LOG_LEVEL compile to nothing, the same as BaseTime, so these are all filtered at run time.
+
+// A log below the level given to SetLogLevel.
+static void RuntimeLevel_Filtered(benchmark::State& state) {
+	if (state.thread_index() == 0)
+		ctp::debug::SetLogLevel(ctp::debug::Stream::Error);
+	for (auto _ : state)
+		ctpLogw(Message);
+	state.SetItemsProcessed(state.iterations());
+	if (state.thread_index() == 0)
+		ctp::debug::SetLogLevel(ctp::debug::Stream::Log);
+}
+BENCHMARK(RuntimeLevel_Filtered)->DO_THREADS();
+
+static void Once_Filtered(benchmark::State& state) {
+	for (auto _ : state)
+		ctpLogOnce(Message);
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(Once_Filtered)->DO_THREADS();
+
+static void EveryN_Filtered(benchmark::State& state) {
+	for (auto _ : state)
+		ctpLogEveryN(1u << 20, Message);
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(EveryN_Filtered)->DO_THREADS();
+
+static void RateLimited_Filtered(benchmark::State& state) {
+	for (auto _ : state)
+		ctpLogRateLimited(1, 1, Message);
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(RateLimited_Filtered)->DO_THREADS();
+
+static void BaseTime_Filtered(benchmark::State& state) {
+	for (auto _ : state)
+		benchmark::DoNotOptimize(Message.data());
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BaseTime_Filtered)->DO_THREADS();
+
+#endif // CTP_LOGGING
@@ -0,0 +1,129 @@
+#define BENCHMARK_STATIC_DEFINE
+#include <benchmark/benchmark.h>
+
+#include <Tools/page_allocator.hpp>
+#include <Tools/small_vector.hpp>
+#include <Tools/trivial_allocator_adapter.hpp>
+
+#include "perf_counters_fixture.hpp"
+
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <type_traits>
+#include <utility>
+
+namespace {
+
+using Item = std::uint64_t;
+
+using StdAllocator = ctp::trivial_init_allocator<Item>;
+using HugeAllocator = ctp::trivial_init_allocator<Item, ctp::huge_page_allocator<Item>>;
+using NumaAllocator = ctp::trivial_init_allocator<Item, ctp::numa_local_allocator<Item>>;
+
+// Random accesses per iteration.
+constexpr std::size_t Accesses = 1 << 16;
+constexpr auto AccessItems = static_cast<std::int64_t>(Accesses);
+
+template <typename Alloc>
+Alloc MakeAllocator() {
+	if constexpr (std::is_same_v<Alloc, NumaAllocator>)
+		return NumaAllocator{ctp::numa_local_allocator<Item>::current()};
+	else
+		return Alloc{};
+}
+
+// Counts TLB misses in place of the default branch and L1 misses, to stay within what can be counted at once.
+constexpr std::array Events{
+	ctp::perf_event::cycles,
+	ctp::perf_event::instructions,
+	ctp::perf_event::llc_misses,
+	ctp::perf_event::dtlb_misses,
+};
+
+// A large table accessed at random, which misses the TLB on almost every access with normal pages.
+// range(0) is the log2 of the number of items.
+template <typename Alloc>
+class PageAllocatorFixture : public ctp::bench::PerfCountersFixture {
+protected:
+	ctp::small_vector<Item, 1, Alloc> table_{MakeAllocator<Alloc>()};
+	std::size_t mask_ = 0;
+public:
+	PageAllocatorFixture() noexcept : PerfCountersFixture{Events} {}
+
+	void SetUp(benchmark::State& state) override {
+		const std::size_t size = std::size_t{1} << state.range(0);
+		mask_ = size - 1;
+		if (table_.size() == size)
+			return;
+		table_.clear();
+		table_.shrink_to_fit();
+		table_.resize(size);
+		// A single cycle through every item, for chasing.
+		std::iota(table_.begin(), table_.end(), Item{0});
+		std::mt19937_64 rng{7};
+		for (std::size_t i = size - 1; i > 0; --i)
+			std::swap(table_[i], table_[rng() % i]);
+	}
+
+	// Independent reads, so limited by how many misses can be outstanding.
+	void RunGather(benchmark::State& state) {
+		std::uint64_t index = 1;
+		for (auto _ : state) {
+			Item sum = 0;
+			for (std::size_t i = 0; i < Accesses; ++i) {
+				index = index * 6364136223846793005ull + 1442695040888963407ull;
+				sum += table_[(index >> 20) & mask_];
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+		state.SetItemsProcessed(state.iterations() * AccessItems);
+	}
+
+	// Each read depends on the last, so limited by the latency of a miss, including the page walk.
+	void RunChase(benchmark::State& state) {
+		Item index = 0;
+		for (auto _ : state) {
+			for (std::size_t i = 0; i < Accesses; ++i)
+				index = table_[index];
+			benchmark::DoNotOptimize(index);
+		}
+		state.SetItemsProcessed(state.iterations() * AccessItems);
+	}
+
+	// Measure the loop generating the indices, for Gather.
+	void RunBaseTime(benchmark::State& state) {
+		std::uint64_t index = 1;
+		for (auto _ : state) {
+			std::uint64_t sum = 0;
+			for (std::size_t i = 0; i < Accesses; ++i) {
+				index = index * 6364136223846793005ull + 1442695040888963407ull;
+				sum += (index >> 20) & mask_;
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+		state.SetItemsProcessed(state.iterations() * AccessItems);
+	}
+};
+
+using StdFixture = PageAllocatorFixture<StdAllocator>;
+using HugeFixture = PageAllocatorFixture<HugeAllocator>;
+using NumaFixture = PageAllocatorFixture<NumaAllocator>;
+
+} // namespace
+
+// 32 MB and 256 MB of items.
+#define PAGE_ALLOCATOR_BENCH(Fixture, Label, Op) \
+	BENCHMARK_DEFINE_F(Fixture, Label##_##Op)(benchmark::State& state) { Run##Op(state); } \
+	BENCHMARK_REGISTER_F(Fixture, Label##_##Op)->Arg(22)->Arg(25);
+
+PAGE_ALLOCATOR_BENCH(StdFixture, Std, Gather)
+PAGE_ALLOCATOR_BENCH(HugeFixture, Huge, Gather)
+PAGE_ALLOCATOR_BENCH(NumaFixture, Numa, Gather)
+PAGE_ALLOCATOR_BENCH(StdFixture, Std, Chase)
+PAGE_ALLOCATOR_BENCH(HugeFixture, Huge, Chase)
+PAGE_ALLOCATOR_BENCH(NumaFixture, Numa, Chase)
+
+BENCHMARK_DEFINE_F(StdFixture, BaseTime_Gather)(benchmark::State& state) { RunBaseTime(state); }
+BENCHMARK_REGISTER_F(StdFixture, BaseTime_Gather)->Arg(22)->Arg(25);
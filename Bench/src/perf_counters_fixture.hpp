@@ -0,0 +1,42 @@
+#ifndef INCLUDE_CTP_BENCH_PERF_COUNTERS_FIXTURE_HPP
+#define INCLUDE_CTP_BENCH_PERF_COUNTERS_FIXTURE_HPP
+
+#include <benchmark/benchmark.h>
+
+#include <Tools/perf_counters.hpp>
+
+#include <span>
+#include <string>
+
+namespace ctp::bench {
+
+// Fixture that reports hardware counters per iteration as user counters, named after the perf_event.
+// Counts everything between SetUp and TearDown, so compare against a BaseTime_ benchmark of the same fixture.
+// Counters that can't be read are left out. Derived fixtures may count other events than the defaults.
+class PerfCountersFixture : public benchmark::Fixture {
+public:
+	explicit PerfCountersFixture(const std::span<const perf_event> events = DefaultPerfEvents) noexcept : events_{events} {}
+
+	void Run(benchmark::State& state) override {
+		this->SetUp(state);
+		{
+			perf_counters counters{events_};
+			counters.start();
+			this->BenchmarkCase(state);
+			counters.stop();
+
+			for (const perf_event event : AllPerfEvents) {
+				if (const auto value = counters.value(event))
+					state.counters[std::string{name(event)}] = benchmark::Counter(static_cast<double>(*value), benchmark::Counter::kAvgIterations);
+			}
+		}
+		this->TearDown(state);
+	}
+
+private:
+	std::span<const perf_event> events_;
+};
+
+} // ctp::bench
+
+#endif // INCLUDE_CTP_BENCH_PERF_COUNTERS_FIXTURE_HPP
@@ -0,0 +1,120 @@
+#define BENCHMARK_STATIC_DEFINE
+#include <benchmark/benchmark.h>
+
+#include <Tools/pool_allocator.hpp>
+#include <Tools/small_vector.hpp>
+#include <Tools/trivial_allocator_adapter.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// small_vectors that spill out of local storage, allocating from the heap (malloc, through std::allocator)
+// or from the thread's pool. Churn frees on the thread that allocated, Handoff mostly on another thread.
+
+namespace {
+
+using MallocVector = ctp::small_vector<int, 8, ctp::trivial_init_allocator<int>>;
+using PoolVector = ctp::small_vector<int, 8, ctp::trivial_init_allocator<int, ctp::pool_allocator<int>>>;
+
+// Vectors per iteration.
+constexpr std::size_t BatchSize = 64;
+constexpr auto BatchItems = static_cast<std::int64_t>(BatchSize);
+// Most vectors spill, a few fit, some grow a few times.
+constexpr std::uint32_t MaxSize = 64;
+
+// Sizes differ per thread, and per iteration.
+struct SizeSequence {
+	std::uint32_t state;
+
+	std::uint32_t next() noexcept {
+		state = state * 1664525u + 1013904223u;
+		return (state >> 16) % MaxSize;
+	}
+};
+
+template <class Vector>
+void Fill(std::vector<Vector>& batch, SizeSequence& sizes) {
+	batch.resize(BatchSize);
+	for (Vector& values : batch) {
+		const std::uint32_t size = sizes.next();
+		for (std::uint32_t i = 0; i < size; ++i)
+			values.push_back(static_cast<int>(i));
+	}
+}
+
+template <class Vector>
+std::int64_t Sum(const std::vector<Vector>& batch) {
+	std::int64_t sum = 0;
+	for (const Vector& values : batch) {
+		if (!values.empty())
+			sum += values.back();
+	}
+	return sum;
+}
+
+template <class Vector>
+void RunChurn(benchmark::State& state) {
+	SizeSequence sizes{static_cast<std::uint32_t>(state.thread_index())};
+	std::vector<Vector> batch;
+	for (auto _ : state) {
+		Fill(batch, sizes);
+		benchmark::DoNotOptimize(Sum(batch));
+		batch.clear();
+	}
+	state.SetItemsProcessed(state.iterations() * BatchItems);
+}
+
+// Where threads leave their batch and take the last one left, normally another thread's.
+template <class Vector>
+struct Mailbox {
+	static inline std::mutex Mutex;
+	static inline std::vector<Vector> Slot;
+};
+
+template <class Vector>
+void RunHandoff(benchmark::State& state) {
+	SizeSequence sizes{static_cast<std::uint32_t>(state.thread_index())};
+	std::vector<Vector> batch;
+	for (auto _ : state) {
+		Fill(batch, sizes);
+		benchmark::DoNotOptimize(Sum(batch));
+		{
+			std::scoped_lock lock{Mailbox<Vector>::Mutex};
+			std::swap(batch, Mailbox<Vector>::Slot);
+		}
+		batch.clear();
+	}
+	state.SetItemsProcessed(state.iterations() * BatchItems);
+}
+
+} // namespace
+
+#define DO_THREADS() ThreadRange(1, 8)->UseRealTime()
+
+static void Malloc_Churn(benchmark::State& state) { RunChurn<MallocVector>(state); }
+BENCHMARK(Malloc_Churn)->DO_THREADS();
+
+static void Pool_Churn(benchmark::State& state) { RunChurn<PoolVector>(state); }
+BENCHMARK(Pool_Churn)->DO_THREADS();
+
+static void Malloc_Handoff(benchmark::State& state) { RunHandoff<MallocVector>(state); }
+BENCHMARK(Malloc_Handoff)->DO_THREADS();
+
+static void Pool_Handoff(benchmark::State& state) { RunHandoff<PoolVector>(state); }
+BENCHMARK(Pool_Handoff)->DO_THREADS();
+
+// Measure generating the sizes, without any vectors.
+static void BaseTime_Churn(benchmark::State& state) {
+	SizeSequence sizes{static_cast<std::uint32_t>(state.thread_index())};
+	for (auto _ : state) {
+		std::int64_t sum = 0;
+		for (std::size_t i = 0; i < BatchSize; ++i)
+			sum += sizes.next();
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * BatchItems);
+}
+BENCHMARK(BaseTime_Churn)->DO_THREADS();
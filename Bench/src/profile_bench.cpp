@@ -0,0 +1,73 @@
+#define BENCHMARK_STATIC_DEFINE
+#include <benchmark/benchmark.h>
+
+#include <Tools/profile.hpp>
+
+#include <cstdint>
+#include <sstream>
+
+// Cost of recording zones. With CTP_PROFILING off, CTP_PROFILE_ZONE compiles to nothing, the same as BaseTime.
+
+// Zones are cleared every so often, so the cost doesn't include faulting in new memory.
+// Each thread records to its own buffer, so there is nothing shared to measure with more threads.
+
+namespace {
+
+constexpr std::uint32_t ClearEvery = 1 << 16;
+
+} // namespace
+
+static void Zone_Record(benchmark::State& state) {
+	ctp::profile::clear();
+	std::uint32_t value = 0;
+	for (auto _ : state) {
+		const auto zone = ctp::profile::zone("zone");
+		if (++value % ClearEvery == 0)
+			ctp::profile::clear();
+		benchmark::DoNotOptimize(value);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(Zone_Record);
+
+static void ZoneNested_Record(benchmark::State& state) {
+	ctp::profile::clear();
+	std::uint32_t value = 0;
+	for (auto _ : state) {
+		const auto outer = ctp::profile::zone("outer");
+		{
+			const auto inner = ctp::profile::zone("inner");
+			if (++value % ClearEvery == 0)
+				ctp::profile::clear();
+			benchmark::DoNotOptimize(value);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(ZoneNested_Record);
+
+static void BaseTime_Record(benchmark::State& state) {
+	std::uint32_t value = 0;
+	for (auto _ : state) {
+		if (++value % ClearEvery == 0)
+			benchmark::DoNotOptimize(value);
+		benchmark::DoNotOptimize(value);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BaseTime_Record);
+
+// Time to export a million zones
+static void Trace_Export(benchmark::State& state) {
+	ctp::profile::clear();
+	for (int i = 0; i < 1'000'000; ++i)
+		const auto zone = ctp::profile::zone("export");
+	for (auto _ : state) {
+		std::ostringstream out;
+		ctp::profile::write_chrome_trace(out);
+		benchmark::DoNotOptimize(out.tellp());
+	}
+	ctp::profile::clear();
+	state.SetItemsProcessed(state.iterations() * 1'000'000);
+}
+BENCHMARK(Trace_Export)->Unit(benchmark::kMillisecond);
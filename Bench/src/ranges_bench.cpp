@@ -3,12 +3,14 @@
 
 #include <Tools/ranges/erase.hpp>
 
+#include "perf_counters_fixture.hpp"
+
 #include <string>
 #include <vector>
 
 namespace {
 
-class EraseFixture : public benchmark::Fixture {
+class EraseFixture : public ctp::bench::PerfCountersFixture {
 protected:
 	std::vector<int> vec_;
 public:
@@ -20,7 +22,7 @@ public:
 	}
 };
 
-class EraseFixtureString : public benchmark::Fixture {
+class EraseFixtureString : public ctp::bench::PerfCountersFixture {
 protected:
 	std::vector<std::string> vec_;
 public:
@@ -38,7 +40,7 @@ struct LargeClass {
 	std::string str;
 	char buff[128]{0};
 };
-class EraseFixtureLargeClass : public benchmark::Fixture {
+class EraseFixtureLargeClass : public ctp::bench::PerfCountersFixture {
 protected:
 	std::vector<LargeClass> vec_;
 public:
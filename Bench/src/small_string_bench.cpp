@@ -0,0 +1,181 @@
+#define BENCHMARK_STATIC_DEFINE
+#include <benchmark/benchmark.h>
+
+#include <Tools/small_string.hpp>
+
+#include "perf_counters_fixture.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace {
+
+// Longest string benchmarked, which the fixed_string has to hold.
+constexpr std::size_t MaxLength = 64;
+
+using StdString = std::string;
+using Small16 = ctp::small_string<16>;
+using Small24 = ctp::small_string<24>;
+using Small32 = ctp::small_string<32>;
+using ZSmall16 = ctp::small_zstring<16>;
+using ZSmall24 = ctp::small_zstring<24>;
+using ZSmall32 = ctp::small_zstring<32>;
+using Fixed64 = ctp::fixed_string<MaxLength>;
+
+class SmallStringFixture : public ctp::bench::PerfCountersFixture {
+protected:
+	std::string text_;
+	// Quarters of the text, to append.
+	std::string_view pieces_[4];
+	// The end of the text, which only occurs there.
+	std::string_view needle_;
+public:
+	void SetUp(benchmark::State& state) override {
+		const auto length = static_cast<std::size_t>(state.range(0));
+		text_.clear();
+		for (std::size_t i = 0; i < length; ++i)
+			text_ += static_cast<char>('a' + i % 26);
+		text_.back() = '#';
+
+		for (std::size_t i = 0; i < 4; ++i)
+			pieces_[i] = std::string_view{text_}.substr(length * i / 4, length * (i + 1) / 4 - length * i / 4);
+		needle_ = std::string_view{text_}.substr(length - std::min<std::size_t>(length, 4));
+	}
+
+	template <class String>
+	void RunConstruct(benchmark::State& state) {
+		const char* const literal = text_.c_str();
+		for (auto _ : state) {
+			String str{literal};
+			benchmark::DoNotOptimize(str.data());
+		}
+	}
+
+	// Grows from empty, so crosses into large mode as real strings do.
+	template <class String>
+	void RunAppend(benchmark::State& state) {
+		for (auto _ : state) {
+			String str;
+			for (const std::string_view piece : pieces_)
+				str += piece;
+			benchmark::DoNotOptimize(str.data());
+		}
+	}
+
+	template <class String>
+	void RunConcat(benchmark::State& state) {
+		const String first{std::string_view{text_}.substr(0, text_.size() / 2)};
+		const String second{std::string_view{text_}.substr(text_.size() / 2)};
+		for (auto _ : state) {
+			String str{first};
+			str += std::string_view{second};
+			benchmark::DoNotOptimize(str.data());
+		}
+	}
+
+	template <class String>
+	void RunFind(benchmark::State& state) {
+		const String str{text_};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(str.find(needle_));
+		}
+	}
+
+	// Equal strings, so every character is compared.
+	template <class String>
+	void RunCompare(benchmark::State& state) {
+		const String lhs{text_};
+		const String rhs{text_};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(lhs.compare(std::string_view{rhs}));
+		}
+	}
+
+	template <class String>
+	void RunSubstr(benchmark::State& state) {
+		const String str{text_};
+		for (auto _ : state) {
+			const auto sub = str.substr(str.size() / 4, str.size() / 2);
+			benchmark::DoNotOptimize(sub.data());
+		}
+	}
+
+	template <class String>
+	void RunCopy(benchmark::State& state) {
+		const String str{text_};
+		for (auto _ : state) {
+			String copy{str};
+			benchmark::DoNotOptimize(copy.data());
+		}
+	}
+
+	template <class String>
+	void RunMove(benchmark::State& state) {
+		String str{text_};
+		for (auto _ : state) {
+			String moved{std::move(str)};
+			str = std::move(moved);
+			benchmark::DoNotOptimize(str.data());
+		}
+	}
+
+	template <class String>
+	void RunHash(benchmark::State& state) {
+		const String str{text_};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(std::hash<String>{}(str));
+		}
+	}
+
+	// Measure finding the length of the literal, which every string has to do as well.
+	void RunBaseTimeLength(benchmark::State& state) {
+		const char* const literal = text_.c_str();
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(literal);
+			benchmark::DoNotOptimize(std::strlen(literal));
+		}
+	}
+
+	// Measure the benchmark loop.
+	void RunBaseTimeLoop(benchmark::State& state) {
+		for (auto _ : state)
+			benchmark::DoNotOptimize(text_.data());
+	}
+};
+
+} // namespace
+
+// Either side of each small size, and of the small size of std::string in libstdc++ and MSVC (15) and libc++ (22).
+#define DO_RANGE() Arg(8)->Arg(15)->Arg(16)->Arg(17)->Arg(23)->Arg(24)->Arg(25)->Arg(32)->Arg(33)->Arg(MaxLength)
+
+#define SMALL_STRING_BENCH(Label, Op) \
+	BENCHMARK_DEFINE_F(SmallStringFixture, Label##_##Op)(benchmark::State& state) { Run##Op<Label>(state); } \
+	BENCHMARK_REGISTER_F(SmallStringFixture, Label##_##Op)->DO_RANGE();
+
+// Every string doing Op, with a base-time of the work they all share.
+#define SMALL_STRING_OP(Op, BaseTime) \
+	SMALL_STRING_BENCH(StdString, Op) \
+	SMALL_STRING_BENCH(Small16, Op) \
+	SMALL_STRING_BENCH(Small24, Op) \
+	SMALL_STRING_BENCH(Small32, Op) \
+	SMALL_STRING_BENCH(ZSmall16, Op) \
+	SMALL_STRING_BENCH(ZSmall24, Op) \
+	SMALL_STRING_BENCH(ZSmall32, Op) \
+	SMALL_STRING_BENCH(Fixed64, Op) \
+	BENCHMARK_DEFINE_F(SmallStringFixture, BaseTime_##Op)(benchmark::State& state) { RunBaseTime##BaseTime(state); } \
+	BENCHMARK_REGISTER_F(SmallStringFixture, BaseTime_##Op)->DO_RANGE();
+
+SMALL_STRING_OP(Construct, Length)
+SMALL_STRING_OP(Append, Loop)
+SMALL_STRING_OP(Concat, Loop)
+SMALL_STRING_OP(Find, Loop)
+SMALL_STRING_OP(Compare, Loop)
+SMALL_STRING_OP(Substr, Loop)
+SMALL_STRING_OP(Copy, Loop)
+SMALL_STRING_OP(Move, Loop)
+SMALL_STRING_OP(Hash, Loop)
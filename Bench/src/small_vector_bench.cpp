@@ -0,0 +1,298 @@
+#define BENCHMARK_STATIC_DEFINE
+#include <benchmark/benchmark.h>
+
+#include <Tools/small_vector.hpp>
+
+#include "perf_counters_fixture.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Other small vectors, when their libraries are available.
+#if __has_include(<boost/container/small_vector.hpp>)
+#define CTP_BENCH_BOOST 1
+#include <boost/container/small_vector.hpp>
+#else
+#define CTP_BENCH_BOOST 0
+#endif
+
+#if __has_include(<absl/container/inlined_vector.h>)
+#define CTP_BENCH_ABSL 1
+#include <absl/container/inlined_vector.h>
+#else
+#define CTP_BENCH_ABSL 0
+#endif
+
+namespace {
+
+// Items in local storage. The sizes benchmarked are below it, at it, one past it, and well past it.
+constexpr std::size_t SmallCapacity = 16;
+constexpr std::size_t MaxSize = 512;
+
+// Longer than any std::string's local buffer, so each one allocates.
+constexpr std::size_t StringSize = 32;
+
+struct LargePod {
+	LargePod() = default;
+	explicit LargePod(const std::size_t value) : id{value}, payload{} {}
+
+	std::uint64_t id;
+	std::array<std::byte, 120> payload;
+};
+static_assert(sizeof(LargePod) == 128 && std::is_trivially_copyable_v<LargePod> && std::is_trivially_default_constructible_v<LargePod>);
+
+template <class T>
+T MakeValue(const std::size_t i) {
+	if constexpr (std::is_same_v<T, std::string>)
+		return std::string(StringSize, static_cast<char>('a' + i % 26));
+	else
+		return static_cast<T>(i);
+}
+
+// Constructs the value MakeValue(i) makes in place.
+template <class Container>
+void EmplaceValue(Container& container, const std::size_t i) {
+	using T = typename Container::value_type;
+	if constexpr (std::is_same_v<T, std::string>)
+		container.emplace_back(StringSize, static_cast<char>('a' + i % 26));
+	else if constexpr (std::is_same_v<T, LargePod>)
+		container.emplace_back(i);
+	else
+		container.emplace_back(static_cast<T>(i));
+}
+
+template <class T>
+std::size_t Weigh(const T& value) {
+	if constexpr (std::is_same_v<T, std::string>)
+		return value.size() + static_cast<std::size_t>(value.front());
+	else if constexpr (std::is_same_v<T, LargePod>)
+		return value.id;
+	else
+		return static_cast<std::size_t>(value);
+}
+
+template <class T>
+class SmallVectorFixture : public ctp::bench::PerfCountersFixture {
+protected:
+	std::vector<T> values_;
+public:
+	using StdVector = std::vector<T>;
+	using CtpVector = ctp::small_vector<T, SmallCapacity>;
+	using CtpStaticVector = ctp::static_vector<T, MaxSize>;
+#if CTP_BENCH_BOOST
+	using BoostVector = boost::container::small_vector<T, SmallCapacity>;
+#endif
+#if CTP_BENCH_ABSL
+	using AbslVector = absl::InlinedVector<T, SmallCapacity>;
+#endif
+
+	void SetUp(benchmark::State& state) override {
+		values_.clear();
+		for (std::int64_t i = 0; i < state.range(0); ++i)
+			values_.push_back(MakeValue<T>(static_cast<std::size_t>(i)));
+	}
+
+	// Each of these starts from an empty container, so they cross from small to large mode as the real ones do.
+
+	template <class Container>
+	void RunPushBack(benchmark::State& state) {
+		for (auto _ : state) {
+			Container container;
+			for (const T& value : values_)
+				container.push_back(value);
+			benchmark::DoNotOptimize(container.data());
+		}
+	}
+
+	template <class Container>
+	void RunEmplace(benchmark::State& state) {
+		for (auto _ : state) {
+			Container container;
+			for (std::size_t i = 0; i < values_.size(); ++i)
+				EmplaceValue(container, i);
+			benchmark::DoNotOptimize(container.data());
+		}
+	}
+
+	template <class Container>
+	void RunInsertMiddle(benchmark::State& state) {
+		for (auto _ : state) {
+			Container container;
+			for (const T& value : values_)
+				container.insert(container.begin() + static_cast<std::ptrdiff_t>(container.size() / 2), value);
+			benchmark::DoNotOptimize(container.data());
+		}
+	}
+
+	template <class Container>
+	void RunCopy(benchmark::State& state) {
+		const Container source(values_.begin(), values_.end());
+		for (auto _ : state) {
+			Container copy{source};
+			benchmark::DoNotOptimize(copy.data());
+		}
+	}
+
+	template <class Container>
+	void RunResize(benchmark::State& state) {
+		for (auto _ : state) {
+			Container container;
+			container.resize(values_.size());
+			benchmark::DoNotOptimize(container.data());
+		}
+	}
+
+	// These keep one container at its size, so they don't measure allocating it.
+
+	template <class Container>
+	void RunErase(benchmark::State& state) {
+		Container container(values_.begin(), values_.end());
+		for (auto _ : state) {
+			// Put the erased item back at the end, so the size stays the same.
+			const auto middle = container.begin() + static_cast<std::ptrdiff_t>(container.size() / 2);
+			T value = std::move(*middle);
+			container.erase(middle);
+			container.push_back(std::move(value));
+			benchmark::DoNotOptimize(container.data());
+		}
+	}
+
+	template <class Container>
+	void RunMove(benchmark::State& state) {
+		Container container(values_.begin(), values_.end());
+		for (auto _ : state) {
+			Container moved{std::move(container)};
+			container = std::move(moved);
+			benchmark::DoNotOptimize(container.data());
+		}
+	}
+
+	template <class Container>
+	void RunSwap(benchmark::State& state) {
+		Container a(values_.begin(), values_.end());
+		Container b(values_.rbegin(), values_.rend());
+		for (auto _ : state) {
+			a.swap(b);
+			benchmark::DoNotOptimize(a.data());
+			benchmark::DoNotOptimize(b.data());
+		}
+	}
+
+	template <class Container>
+	void RunAssign(benchmark::State& state) {
+		Container container(values_.begin(), values_.end());
+		for (auto _ : state) {
+			container.assign(values_.begin(), values_.end());
+			benchmark::DoNotOptimize(container.data());
+		}
+	}
+
+	template <class Container>
+	void RunIterate(benchmark::State& state) {
+		const Container container(values_.begin(), values_.end());
+		for (auto _ : state) {
+			std::size_t sum = 0;
+			for (const T& value : container)
+				sum += Weigh(value);
+			benchmark::DoNotOptimize(sum);
+		}
+	}
+
+	// Measure copying the items, which every container has to do as well.
+	void RunBaseTimeCopyValues(benchmark::State& state) {
+		for (auto _ : state) {
+			for (const T& value : values_) {
+				T copy{value};
+				benchmark::DoNotOptimize(copy);
+			}
+		}
+	}
+
+	// Measure making the items, which every container has to do as well.
+	void RunBaseTimeMakeValues(benchmark::State& state) {
+		for (auto _ : state) {
+			for (std::size_t i = 0; i < values_.size(); ++i) {
+				T value = MakeValue<T>(i);
+				benchmark::DoNotOptimize(value);
+			}
+		}
+	}
+
+	// Measure moving one item out and back.
+	void RunBaseTimeMoveValue(benchmark::State& state) {
+		for (auto _ : state) {
+			T& middle = values_[values_.size() / 2];
+			T value = std::move(middle);
+			middle = std::move(value);
+			benchmark::DoNotOptimize(values_.data());
+		}
+	}
+
+	// Measure the benchmark loop.
+	void RunBaseTimeLoop(benchmark::State& state) {
+		for (auto _ : state)
+			benchmark::DoNotOptimize(values_.data());
+	}
+};
+
+using SmallVectorIntFixture = SmallVectorFixture<int>;
+using SmallVectorStringFixture = SmallVectorFixture<std::string>;
+using SmallVectorLargePodFixture = SmallVectorFixture<LargePod>;
+
+} // namespace
+
+#define DO_RANGE() Arg(SmallCapacity / 2)->Arg(SmallCapacity)->Arg(SmallCapacity + 1)->Arg(64)->Arg(MaxSize)
+
+#define SMALL_VECTOR_BENCH(Fixture, Label, Container, Op, Type) \
+	BENCHMARK_DEFINE_F(Fixture, Label##_##Op##Type)(benchmark::State& state) { Run##Op<Container>(state); } \
+	BENCHMARK_REGISTER_F(Fixture, Label##_##Op##Type)->DO_RANGE();
+
+#if CTP_BENCH_BOOST
+#define SMALL_VECTOR_BOOST_BENCH(Fixture, Op, Type) SMALL_VECTOR_BENCH(Fixture, Boost, BoostVector, Op, Type)
+#else
+#define SMALL_VECTOR_BOOST_BENCH(Fixture, Op, Type)
+#endif
+
+#if CTP_BENCH_ABSL
+#define SMALL_VECTOR_ABSL_BENCH(Fixture, Op, Type) SMALL_VECTOR_BENCH(Fixture, Absl, AbslVector, Op, Type)
+#else
+#define SMALL_VECTOR_ABSL_BENCH(Fixture, Op, Type)
+#endif
+
+// Every container doing Op, with a base-time of the work they all share.
+#define SMALL_VECTOR_OP(Fixture, Op, Type, BaseTime) \
+	SMALL_VECTOR_BENCH(Fixture, Std, StdVector, Op, Type) \
+	SMALL_VECTOR_BENCH(Fixture, CTP, CtpVector, Op, Type) \
+	SMALL_VECTOR_BENCH(Fixture, CTPStatic, CtpStaticVector, Op, Type) \
+	SMALL_VECTOR_BOOST_BENCH(Fixture, Op, Type) \
+	SMALL_VECTOR_ABSL_BENCH(Fixture, Op, Type) \
+	BENCHMARK_DEFINE_F(Fixture, BaseTime_##Op##Type)(benchmark::State& state) { RunBaseTime##BaseTime(state); } \
+	BENCHMARK_REGISTER_F(Fixture, BaseTime_##Op##Type)->DO_RANGE();
+
+#define SMALL_VECTOR_OPS(Fixture, Type) \
+	SMALL_VECTOR_OP(Fixture, PushBack, Type, CopyValues) \
+	SMALL_VECTOR_OP(Fixture, Emplace, Type, MakeValues) \
+	SMALL_VECTOR_OP(Fixture, InsertMiddle, Type, CopyValues) \
+	SMALL_VECTOR_OP(Fixture, Erase, Type, MoveValue) \
+	SMALL_VECTOR_OP(Fixture, Copy, Type, CopyValues) \
+	SMALL_VECTOR_OP(Fixture, Move, Type, Loop) \
+	SMALL_VECTOR_OP(Fixture, Swap, Type, Loop) \
+	SMALL_VECTOR_OP(Fixture, Assign, Type, CopyValues) \
+	SMALL_VECTOR_OP(Fixture, Iterate, Type, Loop) \
+	SMALL_VECTOR_OP(Fixture, Resize, Type, Loop)
+
+// ints
+
+SMALL_VECTOR_OPS(SmallVectorIntFixture, Int)
+
+// strings
+
+SMALL_VECTOR_OPS(SmallVectorStringFixture, Str)
+
+// Large PODs
+
+SMALL_VECTOR_OPS(SmallVectorLargePodFixture, LargePod)
@@ -0,0 +1,161 @@
+#define BENCHMARK_STATIC_DEFINE
+#include <benchmark/benchmark.h>
+
+#include <Tools/enum_map.hpp>
+#include <Tools/sparse_enum_map.hpp>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+// Ten consecutive values starting at base.
+#define ENUM_GROUP(name, base) \
+	name##0 = (base), name##1, name##2, name##3, name##4, name##5, name##6, name##7, name##8, name##9
+
+// 400 message types, like a network protocol where each system only handles a few.
+enum class Message {
+	ENUM_GROUP(A, 0), ENUM_GROUP(B, 10), ENUM_GROUP(C, 20), ENUM_GROUP(D, 30), ENUM_GROUP(E, 40),
+	ENUM_GROUP(F, 50), ENUM_GROUP(G, 60), ENUM_GROUP(H, 70), ENUM_GROUP(I, 80), ENUM_GROUP(J, 90),
+	ENUM_GROUP(K, 100), ENUM_GROUP(L, 110), ENUM_GROUP(M, 120), ENUM_GROUP(N, 130), ENUM_GROUP(O, 140),
+	ENUM_GROUP(P, 150), ENUM_GROUP(Q, 160), ENUM_GROUP(R, 170), ENUM_GROUP(S, 180), ENUM_GROUP(T, 190),
+	ENUM_GROUP(U, 200), ENUM_GROUP(V, 210), ENUM_GROUP(W, 220), ENUM_GROUP(X, 230), ENUM_GROUP(Y, 240),
+	ENUM_GROUP(Z, 250), ENUM_GROUP(AA, 260), ENUM_GROUP(AB, 270), ENUM_GROUP(AC, 280), ENUM_GROUP(AD, 290),
+	ENUM_GROUP(AE, 300), ENUM_GROUP(AF, 310), ENUM_GROUP(AG, 320), ENUM_GROUP(AH, 330), ENUM_GROUP(AI, 340),
+	ENUM_GROUP(AJ, 350), ENUM_GROUP(AK, 360), ENUM_GROUP(AL, 370), ENUM_GROUP(AM, 380), ENUM_GROUP(AN, 390),
+};
+
+#undef ENUM_GROUP
+
+} // namespace
+
+CTP_CUSTOM_ENUM_MIN_MAX(Message, 0, 400)
+
+namespace {
+
+static_assert(ctp::enums::size<Message>() == 400);
+
+using Handler = int(*)(int);
+
+int handle_add(int x) { return x + 1; }
+int handle_mul(int x) { return x * 3; }
+
+// Handlers registered by each system.
+constexpr std::size_t HandlersPerSystem = 20;
+
+// A handler table for each system, each with a few random handlers, and random messages to dispatch.
+class SparseEnumMapFixture : public benchmark::Fixture {
+protected:
+	std::vector<ctp::enum_map<Message, Handler>> denseMaps_;
+	std::vector<ctp::sparse_enum_map<Message, Handler>> sparseMaps_;
+	std::vector<Message> queries_;
+public:
+	void SetUp(benchmark::State& state) override {
+		const auto& vals = ctp::enums::values<Message>();
+		std::mt19937 rng{77};
+		std::uniform_int_distribution<std::size_t> dist{0, vals.size() - 1};
+		std::bernoulli_distribution coin;
+
+		const auto count = static_cast<std::size_t>(state.range(0));
+		denseMaps_.assign(count, ctp::enum_map<Message, Handler>{nullptr});
+		sparseMaps_.assign(count, ctp::sparse_enum_map<Message, Handler>{});
+		queries_.clear();
+		for (std::size_t i = 0; i < count; ++i) {
+			sparseMaps_[i].reserve(HandlersPerSystem);
+			for (std::size_t h = 0; h < HandlersPerSystem; ++h) {
+				const Message msg = vals[dist(rng)];
+				const Handler handler = coin(rng) ? &handle_add : &handle_mul;
+				denseMaps_[i][msg] = handler;
+				sparseMaps_[i].insert_or_assign(msg, handler);
+			}
+			queries_.push_back(vals[dist(rng)]);
+		}
+	}
+};
+
+} // namespace
+
+#define DO_RANGE() Range(64, 4096)
+
+// Bytes one handler table takes, including what it allocates.
+
+BENCHMARK_DEFINE_F(SparseEnumMapFixture, EnumMap_Footprint)(benchmark::State& state) {
+	for (auto _ : state)
+		benchmark::DoNotOptimize(denseMaps_.data());
+	state.counters["Bytes"] = static_cast<double>(sizeof(ctp::enum_map<Message, Handler>));
+}
+BENCHMARK_REGISTER_F(SparseEnumMapFixture, EnumMap_Footprint)->Arg(64);
+
+BENCHMARK_DEFINE_F(SparseEnumMapFixture, SparseEnumMap_Footprint)(benchmark::State& state) {
+	for (auto _ : state)
+		benchmark::DoNotOptimize(sparseMaps_.data());
+	std::size_t bytes = 0;
+	for (const auto& map : sparseMaps_)
+		bytes += sizeof(map) + map.values().capacity() * sizeof(Handler);
+	state.counters["Bytes"] = static_cast<double>(bytes) / static_cast<double>(sparseMaps_.size());
+}
+BENCHMARK_REGISTER_F(SparseEnumMapFixture, SparseEnumMap_Footprint)->Arg(64);
+
+// Look up a random message in every table, and call the handler if there is one
+
+BENCHMARK_DEFINE_F(SparseEnumMapFixture, EnumMap_Lookup)(benchmark::State& state) {
+	for (auto _ : state) {
+		int sum = 0;
+		for (std::size_t i = 0; i < queries_.size(); ++i) {
+			if (const Handler handler = denseMaps_[i][queries_[i]])
+				sum += handler(sum);
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+}
+BENCHMARK_REGISTER_F(SparseEnumMapFixture, EnumMap_Lookup)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(SparseEnumMapFixture, SparseEnumMap_Lookup)(benchmark::State& state) {
+	for (auto _ : state) {
+		int sum = 0;
+		for (std::size_t i = 0; i < queries_.size(); ++i) {
+			if (const Handler* handler = sparseMaps_[i].try_get(queries_[i]))
+				sum += (*handler)(sum);
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+}
+BENCHMARK_REGISTER_F(SparseEnumMapFixture, SparseEnumMap_Lookup)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(SparseEnumMapFixture, BaseTime_Lookup)(benchmark::State& state) {
+	for (auto _ : state) {
+		int sum = 0;
+		for (std::size_t i = 0; i < queries_.size(); ++i)
+			sum += static_cast<int>(queries_[i]);
+		benchmark::DoNotOptimize(sum);
+	}
+}
+BENCHMARK_REGISTER_F(SparseEnumMapFixture, BaseTime_Lookup)->DO_RANGE();
+
+// Call every registered handler in every table
+
+BENCHMARK_DEFINE_F(SparseEnumMapFixture, EnumMap_Iterate)(benchmark::State& state) {
+	for (auto _ : state) {
+		int sum = 0;
+		for (const auto& map : denseMaps_) {
+			for (const auto [msg, handler] : map) {
+				if (handler)
+					sum += handler(sum);
+			}
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+}
+BENCHMARK_REGISTER_F(SparseEnumMapFixture, EnumMap_Iterate)->DO_RANGE();
+
+BENCHMARK_DEFINE_F(SparseEnumMapFixture, SparseEnumMap_Iterate)(benchmark::State& state) {
+	for (auto _ : state) {
+		int sum = 0;
+		for (const auto& map : sparseMaps_) {
+			for (const auto [msg, handler] : map)
+				sum += handler(sum);
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+}
+BENCHMARK_REGISTER_F(SparseEnumMapFixture, SparseEnumMap_Iterate)->DO_RANGE();
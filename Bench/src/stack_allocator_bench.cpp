@@ -0,0 +1,149 @@
+#define BENCHMARK_STATIC_DEFINE
+#include <benchmark/benchmark.h>
+
+#include <Tools/small_string.hpp>
+#include <Tools/small_vector.hpp>
+#include <Tools/stack_allocator.hpp>
+#include <Tools/trivial_allocator_adapter.hpp>
+
+#include "perf_counters_fixture.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Routines that build scratch containers, which spill past their local storage, to the heap (Heap), to a
+// stack_arena (Stack), or to std::pmr over a stack buffer (Pmr), as debug.cpp used to.
+
+namespace {
+
+// Calls of the routine per iteration.
+constexpr std::size_t Calls = 256;
+constexpr auto CallItems = static_cast<std::int64_t>(Calls);
+constexpr std::size_t ArenaBytes = 1024;
+
+using Arena = ctp::stack_arena<ArenaBytes>;
+template <typename T>
+using ArenaAllocator = ctp::trivial_init_allocator<T, ctp::stack_allocator<T, Arena>>;
+
+class StackAllocatorFixture : public ctp::bench::PerfCountersFixture {
+protected:
+	std::vector<int> values_;
+	std::vector<std::string> words_;
+public:
+	void SetUp(benchmark::State&) override {
+		std::mt19937 rng{5};
+		values_.resize(4096);
+		for (int& value : values_)
+			value = static_cast<int>(rng() % 1000);
+		words_.clear();
+		for (std::size_t i = 0; i < 64; ++i)
+			words_.emplace_back(rng() % 12 + 1, static_cast<char>('a' + i % 26));
+	}
+
+	// The median of the values in a window that pass a filter, of which there are up to 128.
+	template <class Vector, class... AllocatorArgs>
+	int Median(const std::size_t call, AllocatorArgs&&... allocatorArgs) const {
+		Vector scratch{allocatorArgs...};
+		const std::size_t begin = call * 13 % (values_.size() - 128);
+		const int threshold = static_cast<int>(call * 7 % 1000);
+		for (std::size_t i = begin; i < begin + 128; ++i) {
+			if (values_[i] >= threshold)
+				scratch.push_back(values_[i]);
+		}
+		if (scratch.empty())
+			return 0;
+		std::nth_element(scratch.begin(), scratch.begin() + scratch.size() / 2, scratch.end());
+		return scratch[scratch.size() / 2];
+	}
+
+	// Joins a few words into a message, the way a log line is built. Between 8 and 100 or so chars.
+	template <class String, class... AllocatorArgs>
+	std::size_t Join(const std::size_t call, AllocatorArgs&&... allocatorArgs) const {
+		String scratch{allocatorArgs...};
+		const std::size_t count = call % 8 + 1;
+		for (std::size_t i = 0; i < count; ++i) {
+			scratch += std::string_view{words_[(call + i * 5) % words_.size()]};
+			scratch += ' ';
+		}
+		return scratch.size() + static_cast<std::size_t>(scratch[0]);
+	}
+
+	template <class Routine>
+	void RunCalls(benchmark::State& state, Routine routine) {
+		for (auto _ : state) {
+			std::size_t sum = 0;
+			for (std::size_t call = 0; call < Calls; ++call)
+				sum += static_cast<std::size_t>(routine(call));
+			benchmark::DoNotOptimize(sum);
+		}
+		state.SetItemsProcessed(state.iterations() * CallItems);
+	}
+
+	// Median
+
+	void RunHeapMedian(benchmark::State& state) {
+		RunCalls(state, [this](const std::size_t call) { return Median<ctp::small_vector<int, 8>>(call); });
+	}
+	void RunStackMedian(benchmark::State& state) {
+		RunCalls(state, [this](const std::size_t call) {
+			Arena arena;
+			return Median<ctp::small_vector<int, 8, ArenaAllocator<int>>>(call, arena);
+		});
+	}
+	void RunPmrMedian(benchmark::State& state) {
+		RunCalls(state, [this](const std::size_t call) {
+			std::array<std::byte, ArenaBytes> buffer;
+			std::pmr::monotonic_buffer_resource resource{buffer.data(), buffer.size()};
+			return Median<std::pmr::vector<int>>(call, &resource);
+		});
+	}
+
+	// Join
+
+	void RunHeapJoin(benchmark::State& state) {
+		RunCalls(state, [this](const std::size_t call) { return Join<ctp::small_string<16>>(call); });
+	}
+	void RunStackJoin(benchmark::State& state) {
+		RunCalls(state, [this](const std::size_t call) {
+			Arena arena;
+			return Join<ctp::small_string<16, ArenaAllocator<char>>>(call, arena);
+		});
+	}
+	void RunPmrJoin(benchmark::State& state) {
+		RunCalls(state, [this](const std::size_t call) {
+			std::array<std::byte, ArenaBytes> buffer;
+			std::pmr::monotonic_buffer_resource resource{buffer.data(), buffer.size()};
+			return Join<std::pmr::string>(call, &resource);
+		});
+	}
+
+	// Measure the loop over the calls, the same for both.
+	void RunBaseTime(benchmark::State& state) {
+		RunCalls(state, [this](const std::size_t call) { return values_[call]; });
+	}
+	void RunBaseTimeMedian(benchmark::State& state) { RunBaseTime(state); }
+	void RunBaseTimeJoin(benchmark::State& state) { RunBaseTime(state); }
+};
+
+} // namespace
+
+#define STACK_ALLOCATOR_BENCH(Label, Op) \
+	BENCHMARK_DEFINE_F(StackAllocatorFixture, Label##_##Op)(benchmark::State& state) { Run##Label##Op(state); } \
+	BENCHMARK_REGISTER_F(StackAllocatorFixture, Label##_##Op);
+
+STACK_ALLOCATOR_BENCH(Heap, Median)
+STACK_ALLOCATOR_BENCH(Stack, Median)
+STACK_ALLOCATOR_BENCH(Pmr, Median)
+STACK_ALLOCATOR_BENCH(Heap, Join)
+STACK_ALLOCATOR_BENCH(Stack, Join)
+STACK_ALLOCATOR_BENCH(Pmr, Join)
+
+STACK_ALLOCATOR_BENCH(BaseTime, Median)
+STACK_ALLOCATOR_BENCH(BaseTime, Join)
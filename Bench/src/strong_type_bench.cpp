@@ -0,0 +1,170 @@
+#define BENCHMARK_STATIC_DEFINE
+#include <benchmark/benchmark.h>
+
+#include <Tools/StrongType.hpp>
+
+#include "perf_counters_fixture.hpp"
+
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace {
+
+struct Meters : ctp::StrongType<Meters, float>, ctp::Arithmetic { using StrongType::StrongType, StrongType::operator=; };
+struct Ticks : ctp::StrongType<Ticks, std::int32_t>, ctp::Arithmetic { using StrongType::StrongType, StrongType::operator=; };
+
+// The same values as raw numbers and as StrongTypes.
+template <typename S>
+class StrongTypeFixture : public ctp::bench::PerfCountersFixture {
+protected:
+	using T = typename S::value_type;
+
+	std::vector<T> rawLhs_;
+	std::vector<T> rawRhs_;
+	std::vector<T> rawOut_;
+	std::vector<S> lhs_;
+	std::vector<S> rhs_;
+	std::vector<S> out_;
+public:
+	void SetUp(benchmark::State& state) override {
+		std::mt19937 rng{11};
+		const auto count = static_cast<std::size_t>(state.range(0));
+		rawLhs_.clear();
+		rawRhs_.clear();
+		lhs_.clear();
+		rhs_.clear();
+		for (std::size_t i = 0; i < count; ++i) {
+			rawLhs_.push_back(static_cast<T>(rng() % 1000));
+			rawRhs_.push_back(static_cast<T>(rng() % 1000));
+			lhs_.emplace_back(rawLhs_.back());
+			rhs_.emplace_back(rawRhs_.back());
+		}
+		rawOut_.assign(count, T{});
+		out_.assign(count, S{T{}});
+	}
+
+	// Sum
+
+	// Several partial sums, like sum_values, so floats can vectorize too.
+	void RunRawSum(benchmark::State& state) {
+		for (auto _ : state) {
+			T lanes[8]{};
+			std::size_t i = 0;
+			for (; i + 8 <= rawLhs_.size(); i += 8) {
+				for (std::size_t j = 0; j < 8; ++j)
+					lanes[j] += rawLhs_[i + j];
+			}
+			for (; i < rawLhs_.size(); ++i)
+				lanes[0] += rawLhs_[i];
+			T sum{};
+			for (const T lane : lanes)
+				sum += lane;
+			benchmark::DoNotOptimize(sum);
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	// The loop a StrongType would usually get.
+	void RunLoopSum(benchmark::State& state) {
+		for (auto _ : state) {
+			S sum{T{}};
+			for (const S& value : lhs_)
+				sum += value;
+			benchmark::DoNotOptimize(sum);
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	void RunCTPSum(benchmark::State& state) {
+		for (auto _ : state)
+			benchmark::DoNotOptimize(ctp::sum_values(std::span<const S>{lhs_}));
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	// Add
+
+	void RunRawAdd(benchmark::State& state) {
+		for (auto _ : state) {
+			for (std::size_t i = 0; i < rawOut_.size(); ++i)
+				rawOut_[i] = static_cast<T>(rawLhs_[i] + rawRhs_[i]);
+			benchmark::DoNotOptimize(rawOut_.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	void RunLoopAdd(benchmark::State& state) {
+		for (auto _ : state) {
+			for (std::size_t i = 0; i < out_.size(); ++i)
+				out_[i] = lhs_[i] + rhs_[i];
+			benchmark::DoNotOptimize(out_.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	void RunCTPAdd(benchmark::State& state) {
+		for (auto _ : state) {
+			ctp::add_values<S>(lhs_, rhs_, out_);
+			benchmark::DoNotOptimize(out_.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	// Max
+
+	void RunRawMax(benchmark::State& state) {
+		for (auto _ : state) {
+			T max = rawLhs_[0];
+			for (const T value : rawLhs_)
+				max = max < value ? value : max;
+			benchmark::DoNotOptimize(max);
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	void RunLoopMax(benchmark::State& state) {
+		for (auto _ : state) {
+			S max = lhs_[0];
+			for (const S& value : lhs_)
+				max = max < value ? value : max;
+			benchmark::DoNotOptimize(max);
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	void RunCTPMax(benchmark::State& state) {
+		for (auto _ : state)
+			benchmark::DoNotOptimize(ctp::max_value(std::span<const S>{lhs_}));
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+};
+
+using MetersFixture = StrongTypeFixture<Meters>;
+using TicksFixture = StrongTypeFixture<Ticks>;
+
+} // namespace
+
+// In cache, and in memory.
+#define DO_RANGE() Arg(4096)->Arg(1 << 22)
+
+#define STRONG_TYPE_BENCH(Fixture, Label, Op) \
+	BENCHMARK_DEFINE_F(Fixture, Label##_##Op)(benchmark::State& state) { Run##Label##Op(state); } \
+	BENCHMARK_REGISTER_F(Fixture, Label##_##Op)->DO_RANGE();
+
+#define STRONG_TYPE_BENCHES(Fixture) \
+	STRONG_TYPE_BENCH(Fixture, Raw, Sum) \
+	STRONG_TYPE_BENCH(Fixture, Loop, Sum) \
+	STRONG_TYPE_BENCH(Fixture, CTP, Sum) \
+	STRONG_TYPE_BENCH(Fixture, Raw, Add) \
+	STRONG_TYPE_BENCH(Fixture, Loop, Add) \
+	STRONG_TYPE_BENCH(Fixture, CTP, Add) \
+	STRONG_TYPE_BENCH(Fixture, Raw, Max) \
+	STRONG_TYPE_BENCH(Fixture, Loop, Max) \
+	STRONG_TYPE_BENCH(Fixture, CTP, Max)
+
+STRONG_TYPE_BENCHES(MetersFixture)
+STRONG_TYPE_BENCHES(TicksFixture)
@@ -17,6 +17,7 @@ Metrics = [
     "bytes_per_second",
     "items_per_second",
     "iterations",
+    "change",
 ]
 Transforms = {
     "": lambda x: x,
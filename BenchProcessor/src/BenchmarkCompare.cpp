@@ -0,0 +1,286 @@
+#include "BenchmarkCompare.hpp"
+
+#include "BenchmarkFiles.hpp"
+#include "BenchmarkResultsParse.hpp"
+#include "BenchmarkStatistics.hpp"
+#include "MappedFile.hpp"
+
+#include <fmt/format.h>
+
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string_view>
+#include <unordered_map>
+
+using namespace std::literals;
+
+namespace {
+
+using bench_compare::CompareOptions;
+
+constexpr auto Usage = "Usage: BenchmarkProcessor --compare <baseline> <contender>... [--threshold 0.05] [--alpha 0.05] [--resamples 2000] [--out <file.csv|file.json>]\n"sv;
+
+// Fewer repetitions than this can't show a significant difference at the usual levels.
+constexpr std::size_t MinRepetitions = 5;
+
+struct Run {
+	bench_parse::MappedFile file;
+	bench_parse::ResultsFormat format = bench_parse::ResultsFormat::CSV;
+	// The file name without directory or extension.
+	std::string name;
+	// Benchmarks in the order they were run.
+	std::vector<std::string_view> benchmarks;
+	// Cpu times of each repetition, in nanoseconds.
+	std::unordered_map<std::string_view, std::vector<double>> samples;
+};
+
+struct Comparison {
+	double change = 0;
+	bench_stats::Interval interval;
+	double pValue = 1;
+	bool significant = false;
+	bool regression = false;
+};
+
+struct ResultLine {
+	std::string name;
+	std::string label;
+	std::string_view category;
+	const Run* run = nullptr;
+	std::size_t samples = 0;
+	double median = 0;
+	double mad = 0;
+	std::optional<Comparison> comparison;
+};
+
+bool ReadRun(const std::string& fileName, Run& run) {
+	run.file = bench_parse::MappedFile{fileName};
+	if (!run.file.IsOpen()) {
+		std::cerr << "Failed to open file [" << fileName << "].\n";
+		return false;
+	}
+	run.name = bench_files::RunName(fileName);
+
+	bench_parse::ResultsHeader header;
+	const bool parsed = bench_parse::ParseResults(run.file.View(), header, [&run](const bench_parse::ResultRow& row, std::span<const bench_parse::CounterValue>) {
+		if (row.aggregate || row.errorOccurred || row.cpuTimeText.empty())
+			return;
+		auto& samples = run.samples[row.name];
+		if (samples.empty())
+			run.benchmarks.push_back(row.name);
+		samples.push_back(row.cpuTime * bench_parse::NanosecondsPer(row.timeUnit));
+	});
+	run.format = header.format;
+
+	if (!parsed)
+		std::cerr << "Document is corrupted, or does not have correct format (see file [" << fileName << "]).\n";
+	return parsed;
+}
+
+ResultLine MakeLine(const Run& run, const std::string_view benchmark, const std::vector<double>& samples) {
+	ResultLine line;
+	bench_parse::AppendUnescaped(line.name, benchmark, run.format);
+	const auto metaData = bench_parse::GetTestMetaData(benchmark);
+	// Runs are separate labels, so the grapher draws them side by side.
+	bench_parse::AppendUnescaped(line.label, metaData.label.empty() ? benchmark : metaData.label, run.format);
+	line.label += fmt::format(" ({})", run.name);
+	line.category = metaData.category;
+	line.run = &run;
+	line.samples = samples.size();
+	auto sorted = samples;
+	line.median = bench_stats::Median(sorted);
+	line.mad = bench_stats::MedianAbsoluteDeviation(samples, line.median);
+	return line;
+}
+
+void AppendJsonText(std::string& out, const std::string_view text) {
+	out += '"';
+	for (const char c : text) {
+		switch (c) {
+		case '"': out += "\\\""sv; break;
+		case '\\': out += "\\\\"sv; break;
+		case '\n': out += "\\n"sv; break;
+		case '\t': out += "\\t"sv; break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20)
+				fmt::format_to(std::back_inserter(out), "\\u{:04x}", static_cast<unsigned>(c));
+			else
+				out += c;
+		}
+	}
+	out += '"';
+}
+
+std::string WriteCsv(const std::vector<ResultLine>& lines) {
+	std::string out = "name,label,category,run,samples,cpu_time,mad,change,ci_low,ci_high,p_value,significant,regression\n";
+	for (const auto& line : lines) {
+		bench_parse::AppendCsvText(out, line.name);
+		out += ',';
+		bench_parse::AppendCsvText(out, line.label);
+		out += ',';
+		out += line.category;
+		out += ',';
+		bench_parse::AppendCsvText(out, line.run->name);
+		fmt::format_to(std::back_inserter(out), ",{},{},{}", line.samples, line.median, line.mad);
+		if (const auto& comparison = line.comparison) {
+			fmt::format_to(std::back_inserter(out), ",{},{},{},{},{},{}\n", comparison->change, comparison->interval.low, comparison->interval.high,
+				comparison->pValue, comparison->significant, comparison->regression);
+		} else {
+			out += ",,,,,,\n"sv;
+		}
+	}
+	return out;
+}
+
+// Like the benchmark JSON reporter, so the grapher reads it the same way.
+std::string WriteJson(const std::vector<ResultLine>& lines) {
+	std::string out = "{\n  \"benchmarks\": [";
+	bool first = true;
+	for (const auto& line : lines) {
+		out += first ? "\n    {\"name\": "sv : ",\n    {\"name\": "sv;
+		first = false;
+		AppendJsonText(out, line.name);
+		out += ", \"label\": "sv;
+		AppendJsonText(out, line.label);
+		out += ", \"category\": "sv;
+		AppendJsonText(out, line.category);
+		out += ", \"run\": "sv;
+		AppendJsonText(out, line.run->name);
+		fmt::format_to(std::back_inserter(out), ", \"samples\": {}, \"cpu_time\": {}, \"mad\": {}", line.samples, line.median, line.mad);
+		if (const auto& comparison = line.comparison) {
+			fmt::format_to(std::back_inserter(out), ", \"change\": {}, \"ci_low\": {}, \"ci_high\": {}, \"p_value\": {}, \"significant\": {}, \"regression\": {}",
+				comparison->change, comparison->interval.low, comparison->interval.high, comparison->pValue, comparison->significant, comparison->regression);
+		}
+		out += '}';
+	}
+	out += "\n  ]\n}\n"sv;
+	return out;
+}
+
+bool ParseOption(const std::string_view text, double& value) {
+	const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+	return ec == std::errc{} && ptr == text.data() + text.size();
+}
+
+bool ParseOption(const std::string_view text, std::size_t& value) {
+	const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+	return ec == std::errc{} && ptr == text.data() + text.size();
+}
+
+} // namespace
+
+namespace bench_compare {
+
+std::optional<CompareOptions> ParseCompareOptions(const std::span<const char* const> args) {
+	CompareOptions options;
+
+	for (std::size_t i = 0; i < args.size(); ++i) {
+		const std::string_view arg = args[i];
+		if (!arg.starts_with("--"sv)) {
+			options.files.emplace_back(arg);
+			continue;
+		}
+
+		if (i + 1 == args.size()) {
+			std::cerr << "Missing value of [" << arg << "].\n" << Usage;
+			return std::nullopt;
+		}
+		const std::string_view value = args[++i];
+
+		bool valid = true;
+		if (arg == "--threshold"sv)
+			valid = ParseOption(value, options.threshold);
+		else if (arg == "--alpha"sv)
+			valid = ParseOption(value, options.alpha) && options.alpha > 0 && options.alpha < 1;
+		else if (arg == "--resamples"sv)
+			valid = ParseOption(value, options.resamples);
+		else if (arg == "--out"sv)
+			options.outFile = value;
+		else
+			valid = false;
+
+		if (!valid) {
+			std::cerr << "Invalid option [" << arg << ' ' << value << "].\n" << Usage;
+			return std::nullopt;
+		}
+	}
+
+	if (options.files.size() < 2) {
+		std::cerr << "Need a baseline and at least one file to compare to it.\n" << Usage;
+		return std::nullopt;
+	}
+
+	if (options.outFile.empty()) {
+		options.outFile = options.files.front();
+		if (const auto extPos = options.outFile.rfind('.'); extPos != std::string::npos)
+			options.outFile.erase(extPos);
+		options.outFile.append("_compare.csv"sv);
+	}
+
+	return options;
+}
+
+int Compare(const CompareOptions& options) {
+	std::vector<Run> runs(options.files.size());
+	for (std::size_t i = 0; i < runs.size(); ++i) {
+		if (!ReadRun(options.files[i], runs[i]))
+			return 2;
+	}
+
+	const Run& baseline = runs.front();
+	std::vector<ResultLine> lines;
+	std::size_t regressions = 0;
+	bool tooFewRepetitions = false;
+
+	fmt::print("{:<60} {:>12} {:>12} {:>9} {:>21} {:>8}\n", "Benchmark", "Baseline ns", "Median ns", "Change", "Interval", "p");
+
+	for (const auto benchmark : baseline.benchmarks) {
+		const auto& baselineSamples = baseline.samples.at(benchmark);
+		lines.push_back(MakeLine(baseline, benchmark, baselineSamples));
+		const double baselineMedian = lines.back().median;
+
+		for (std::size_t i = 1; i < runs.size(); ++i) {
+			const auto it = runs[i].samples.find(benchmark);
+			if (it == runs[i].samples.end())
+				continue;
+
+			const auto& samples = it->second;
+			auto& line = lines.emplace_back(MakeLine(runs[i], benchmark, samples));
+			tooFewRepetitions |= samples.size() < MinRepetitions || baselineSamples.size() < MinRepetitions;
+
+			Comparison comparison;
+			comparison.change = baselineMedian != 0 ? line.median / baselineMedian - 1 : 0;
+			comparison.interval = bench_stats::BootstrapChangeInterval(baselineSamples, samples, 1 - options.alpha, options.resamples);
+			comparison.pValue = bench_stats::MannWhitneyU(baselineSamples, samples);
+			comparison.significant = comparison.pValue < options.alpha;
+			comparison.regression = comparison.significant && comparison.change > options.threshold;
+			line.comparison = comparison;
+
+			regressions += comparison.regression;
+			fmt::print("{:<60} {:>12.3f} {:>12.3f} {:>+8.2f}% [{:>+8.2f}%, {:>+8.2f}%] {:>8.4f}{}\n", line.name, baselineMedian, line.median,
+				comparison.change * 100, comparison.interval.low * 100, comparison.interval.high * 100, comparison.pValue,
+				comparison.regression ? " REGRESSION"sv : comparison.significant ? " significant"sv : ""sv);
+		}
+	}
+
+	if (tooFewRepetitions)
+		std::cerr << "Some benchmarks have fewer than " << MinRepetitions << " repetitions, too few to be significant. Run with --benchmark_repetitions.\n";
+
+	const auto out = options.outFile.ends_with(".json"sv) ? WriteJson(lines) : WriteCsv(lines);
+	std::ofstream outFile{options.outFile, std::ios::out | std::ios::trunc};
+	if (!outFile.is_open()) {
+		std::cerr << "Failed to open out file [" << options.outFile << "]\n.";
+		return 3;
+	}
+	outFile.write(out.data(), static_cast<std::streamsize>(out.size()));
+
+	if (regressions > 0) {
+		std::cerr << regressions << " significant regression(s) above " << options.threshold * 100 << "%.\n";
+		return 1;
+	}
+	return 0;
+}
+
+} // bench_compare
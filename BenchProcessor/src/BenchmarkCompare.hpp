@@ -0,0 +1,33 @@
+#ifndef INCLUDE_CTP_BENCHMARK_PROCESSOR_COMPARE_HPP
+#define INCLUDE_CTP_BENCHMARK_PROCESSOR_COMPARE_HPP
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+// Compare repetitions of benchmarks between runs, to catch regressions.
+namespace bench_compare {
+
+struct CompareOptions {
+	// The first is the baseline, the others are each compared to it.
+	std::vector<std::string> files;
+	// Written as JSON if it ends in .json, otherwise as CSV. Defaults to the baseline name with "_compare.csv".
+	std::string outFile;
+	// Smallest relative change in median cpu time that counts as a regression.
+	double threshold = 0.05;
+	// Significance level of the Mann-Whitney U test, and one minus the confidence of the intervals.
+	double alpha = 0.05;
+	std::size_t resamples = 2000;
+};
+
+// From the arguments after --compare. Prints usage and returns empty if they're wrong.
+std::optional<CompareOptions> ParseCompareOptions(std::span<const char* const> args);
+
+// Returns the exit code, 1 if any benchmark regressed significantly, otherwise 0.
+int Compare(const CompareOptions& options);
+
+} // bench_compare
+
+#endif // INCLUDE_CTP_BENCHMARK_PROCESSOR_COMPARE_HPP
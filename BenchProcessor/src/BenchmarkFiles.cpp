@@ -0,0 +1,100 @@
+#include "BenchmarkFiles.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+using namespace std::literals;
+
+namespace {
+
+namespace fs = std::filesystem;
+
+// Appends the results files of a directory that match the pattern, sorted by name.
+bool AppendMatches(const fs::path& directory, const std::string_view pattern, std::vector<std::string>& files) {
+	std::error_code error;
+	std::vector<std::string> matches;
+	for (const auto& entry : fs::directory_iterator{directory, error}) {
+		if (!entry.is_regular_file(error) || !bench_files::IsResultsFile(entry.path().string()))
+			continue;
+		if (bench_files::MatchesPattern(entry.path().filename().string(), pattern))
+			matches.push_back(entry.path().string());
+	}
+	if (error) {
+		std::cerr << "Failed to read directory [" << directory.string() << "]: " << error.message() << ".\n";
+		return false;
+	}
+
+	std::ranges::sort(matches);
+	files.insert(files.end(), std::make_move_iterator(matches.begin()), std::make_move_iterator(matches.end()));
+	return !matches.empty();
+}
+
+} // namespace
+
+namespace bench_files {
+
+bool MatchesPattern(std::string_view name, std::string_view pattern) {
+	// Where to retry from when the last * should match more.
+	std::size_t starPattern = std::string_view::npos;
+	std::size_t starName = 0;
+	std::size_t n = 0;
+	std::size_t p = 0;
+	while (n < name.size()) {
+		if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+			++n;
+			++p;
+		} else if (p < pattern.size() && pattern[p] == '*') {
+			starPattern = p++;
+			starName = n;
+		} else if (starPattern != std::string_view::npos) {
+			p = starPattern + 1;
+			n = ++starName;
+		} else {
+			return false;
+		}
+	}
+	while (p < pattern.size() && pattern[p] == '*')
+		++p;
+	return p == pattern.size();
+}
+
+std::string RunName(const std::string& fileName) {
+	return fs::path{fileName}.replace_extension().generic_string();
+}
+
+bool IsResultsFile(const std::string& fileName) {
+	const fs::path path{fileName};
+	const auto extension = path.extension();
+	if (extension != ".csv" && extension != ".json")
+		return false;
+
+	// Outputs of earlier runs, which often sit next to the results.
+	const auto stem = path.stem().string();
+	return !stem.ends_with("_processed"sv) && !stem.ends_with("_compare"sv);
+}
+
+bool ExpandInputs(const std::span<const std::string> inputs, std::vector<std::string>& files) {
+	for (const auto& input : inputs) {
+		const fs::path path{input};
+		const auto fileName = path.filename().string();
+
+		bool found = false;
+		if (fileName.find_first_of("*?"sv) != std::string::npos) {
+			found = AppendMatches(path.has_parent_path() ? path.parent_path() : fs::path{"."}, fileName, files);
+		} else if (std::error_code error; fs::is_directory(path, error)) {
+			found = AppendMatches(path, "*"sv, files);
+		} else if (fs::exists(path, error)) {
+			files.push_back(input);
+			found = true;
+		}
+
+		if (!found) {
+			std::cerr << "No results files found for [" << input << "].\n";
+			return false;
+		}
+	}
+	return true;
+}
+
+} // bench_files
@@ -0,0 +1,28 @@
+#ifndef INCLUDE_CTP_BENCHMARK_PROCESSOR_FILES_HPP
+#define INCLUDE_CTP_BENCHMARK_PROCESSOR_FILES_HPP
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Finding and naming the results files given on the command line.
+namespace bench_files {
+
+// Wildcards are * and ?.
+bool MatchesPattern(std::string_view name, std::string_view pattern);
+
+// The path as given without extension, which tells apart the same results from different machines or runs.
+std::string RunName(const std::string& fileName);
+
+// If the file is named like results, rather than an output the processor wrote.
+bool IsResultsFile(const std::string& fileName);
+
+// Expands each input into results files: a directory gives its .csv and .json files, and wildcards in the file name
+// give the files they match, either way sorted by name and skipping files the processor wrote. Returns false, after
+// printing why, if an input doesn't exist or matches nothing.
+bool ExpandInputs(std::span<const std::string> inputs, std::vector<std::string>& files);
+
+} // bench_files
+
+#endif // INCLUDE_CTP_BENCHMARK_PROCESSOR_FILES_HPP
@@ -0,0 +1,587 @@
+#include "BenchmarkHistory.hpp"
+
+#include "BenchmarkFiles.hpp"
+#include "BenchmarkResultsParse.hpp"
+#include "BenchmarkStatistics.hpp"
+#include "MappedFile.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <unordered_map>
+
+using namespace std::literals;
+
+namespace {
+
+using bench_history::Point;
+using bench_history::Series;
+
+constexpr auto Usage =
+	"Usage: BenchmarkProcessor --history add <store> <results>... [--date <date>]\n"
+	"       BenchmarkProcessor --history query <store> [--name <pattern>] [--days <n>] [--from <date>] [--to <date>] [--out <file.csv>]\n"sv;
+
+constexpr auto Magic = "CTPBHST1"sv;
+// Magic, series count, reserved, directory offset.
+constexpr std::size_t HeaderBytes = 24;
+
+/* -------------------- encoding -------------------- */
+
+void PutU32(std::string& out, const std::uint32_t value) {
+	for (int shift = 0; shift < 32; shift += 8)
+		out += static_cast<char>(value >> shift);
+}
+
+void PutU64(std::string& out, const std::uint64_t value) {
+	for (int shift = 0; shift < 64; shift += 8)
+		out += static_cast<char>(value >> shift);
+}
+
+void PutVarint(std::string& out, std::uint64_t value) {
+	while (value >= 0x80) {
+		out += static_cast<char>(value | 0x80);
+		value >>= 7;
+	}
+	out += static_cast<char>(value);
+}
+
+std::uint64_t ZigZag(const std::int64_t value) {
+	return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+std::int64_t UnZigZag(const std::uint64_t value) {
+	return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+std::uint64_t Bits(const double value) {
+	std::uint64_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+double FromBits(const std::uint64_t bits) {
+	double value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+class ByteReader {
+public:
+	explicit ByteReader(const std::string_view data, const std::size_t pos = 0) : data_{data}, pos_{pos} {
+		if (pos_ > data_.size())
+			failed_ = true;
+	}
+
+	bool Failed() const noexcept { return failed_; }
+
+	std::uint64_t Fixed(const std::size_t bytes) noexcept {
+		if (!Has(bytes))
+			return 0;
+		std::uint64_t value = 0;
+		for (std::size_t i = 0; i < bytes; ++i)
+			value |= std::uint64_t{static_cast<unsigned char>(data_[pos_ + i])} << (8 * i);
+		pos_ += bytes;
+		return value;
+	}
+
+	std::uint64_t Varint() noexcept {
+		std::uint64_t value = 0;
+		for (int shift = 0; shift < 64; shift += 7) {
+			if (!Has(1))
+				return 0;
+			const auto byte = static_cast<unsigned char>(data_[pos_++]);
+			value |= std::uint64_t{byte & 0x7Fu} << shift;
+			if (byte < 0x80)
+				return value;
+		}
+		failed_ = true;
+		return 0;
+	}
+
+	std::string_view Bytes(const std::size_t size) noexcept {
+		if (!Has(size))
+			return {};
+		const auto bytes = data_.substr(pos_, size);
+		pos_ += size;
+		return bytes;
+	}
+
+private:
+	bool Has(const std::size_t bytes) noexcept {
+		if (data_.size() - pos_ < bytes)
+			failed_ = true;
+		return !failed_;
+	}
+
+	std::string_view data_;
+	std::size_t pos_ = 0;
+	bool failed_ = false;
+};
+
+/* ---------------------- store --------------------- */
+
+struct DirectoryEntry {
+	std::string_view name;
+	std::uint32_t pointCount = 0;
+	std::int64_t firstTime = 0;
+	std::int64_t lastTime = 0;
+	std::uint64_t dataOffset = 0;
+	std::uint64_t dataSize = 0;
+};
+
+// Sorted by name. Views the store's data.
+bool ReadDirectory(const std::string_view data, std::vector<DirectoryEntry>& directory) {
+	ByteReader header{data};
+	if (header.Bytes(Magic.size()) != Magic)
+		return false;
+	const auto seriesCount = header.Fixed(4);
+	header.Fixed(4);
+	const auto directoryOffset = header.Fixed(8);
+	if (header.Failed() || directoryOffset > data.size())
+		return false;
+
+	ByteReader reader{data, static_cast<std::size_t>(directoryOffset)};
+	directory.resize(static_cast<std::size_t>(seriesCount));
+	for (auto& entry : directory) {
+		entry.name = reader.Bytes(static_cast<std::size_t>(reader.Fixed(4)));
+		entry.pointCount = static_cast<std::uint32_t>(reader.Fixed(4));
+		entry.firstTime = static_cast<std::int64_t>(reader.Fixed(8));
+		entry.lastTime = static_cast<std::int64_t>(reader.Fixed(8));
+		entry.dataOffset = reader.Fixed(8);
+		entry.dataSize = reader.Fixed(8);
+		if (reader.Failed() || entry.dataOffset > data.size() || entry.dataSize > data.size() - entry.dataOffset)
+			return false;
+	}
+	return true;
+}
+
+bool DecodeSeries(const std::string_view data, const DirectoryEntry& entry, std::vector<Point>& points) {
+	ByteReader reader{data.substr(static_cast<std::size_t>(entry.dataOffset), static_cast<std::size_t>(entry.dataSize))};
+	points.resize(entry.pointCount);
+
+	std::int64_t time = 0;
+	for (auto& point : points) {
+		time += UnZigZag(reader.Varint());
+		point.time = time;
+	}
+
+	std::uint64_t bits = 0;
+	for (auto& point : points) {
+		bits ^= reader.Varint();
+		point.cpuTime = FromBits(bits);
+	}
+
+	bits = 0;
+	for (auto& point : points) {
+		bits ^= reader.Varint();
+		point.realTime = FromBits(bits);
+	}
+
+	return !reader.Failed();
+}
+
+void EncodeSeries(std::string& out, const std::vector<Point>& points) {
+	std::int64_t time = 0;
+	for (const auto& point : points) {
+		PutVarint(out, ZigZag(point.time - time));
+		time = point.time;
+	}
+
+	std::uint64_t bits = 0;
+	for (const auto& point : points) {
+		PutVarint(out, Bits(point.cpuTime) ^ bits);
+		bits = Bits(point.cpuTime);
+	}
+
+	bits = 0;
+	for (const auto& point : points) {
+		PutVarint(out, Bits(point.realTime) ^ bits);
+		bits = Bits(point.realTime);
+	}
+}
+
+// Expects the series sorted by name, with points sorted by time.
+std::string EncodeStore(const std::vector<Series>& series) {
+	std::string out;
+	out += Magic;
+	PutU32(out, static_cast<std::uint32_t>(series.size()));
+	PutU32(out, 0);
+	PutU64(out, 0); // Directory offset, once known.
+
+	std::vector<std::pair<std::uint64_t, std::uint64_t>> locations;
+	locations.reserve(series.size());
+	for (const auto& s : series) {
+		const auto offset = out.size();
+		EncodeSeries(out, s.points);
+		locations.emplace_back(offset, out.size() - offset);
+	}
+
+	const auto directoryOffset = out.size();
+	for (std::size_t i = 0; i < series.size(); ++i) {
+		const auto& s = series[i];
+		PutU32(out, static_cast<std::uint32_t>(s.name.size()));
+		out += s.name;
+		PutU32(out, static_cast<std::uint32_t>(s.points.size()));
+		PutU64(out, static_cast<std::uint64_t>(s.points.empty() ? 0 : s.points.front().time));
+		PutU64(out, static_cast<std::uint64_t>(s.points.empty() ? 0 : s.points.back().time));
+		PutU64(out, locations[i].first);
+		PutU64(out, locations[i].second);
+	}
+
+	std::string directoryOffsetBytes;
+	PutU64(directoryOffsetBytes, directoryOffset);
+	out.replace(HeaderBytes - 8, 8, directoryOffsetBytes);
+	return out;
+}
+
+/* ---------------------- runs ---------------------- */
+
+std::int64_t Now() {
+	return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::string FormatTime(const std::int64_t time) {
+	const std::chrono::sys_seconds seconds{std::chrono::seconds{time}};
+	const auto days = std::chrono::floor<std::chrono::days>(seconds);
+	const std::chrono::year_month_day date{days};
+	const std::chrono::hh_mm_ss clock{seconds - days};
+	return fmt::format("{:04}-{:02}-{:02}T{:02}:{:02}:{:02}Z", static_cast<int>(date.year()), static_cast<unsigned>(date.month()), static_cast<unsigned>(date.day()),
+		clock.hours().count(), clock.minutes().count(), clock.seconds().count());
+}
+
+struct RunSamples {
+	std::vector<double> cpuTimes;
+	std::vector<double> realTimes;
+	// From a _median aggregate, used when only aggregates were reported.
+	std::optional<std::pair<double, double>> reportedMedian;
+};
+
+// A point per benchmark of a results file, at the median of its repetitions.
+bool ReadRunPoints(const std::string& fileName, const std::optional<std::int64_t> time, std::vector<std::pair<std::string, Point>>& points) {
+	const bench_parse::MappedFile file{fileName};
+	if (!file.IsOpen()) {
+		std::cerr << "Failed to open file [" << fileName << "].\n";
+		return false;
+	}
+
+	std::vector<std::string_view> order;
+	std::unordered_map<std::string_view, RunSamples> runs;
+	bench_parse::ResultsHeader header;
+	const bool parsed = bench_parse::ParseResults(file.View(), header, [&](const bench_parse::ResultRow& row, std::span<const bench_parse::CounterValue>) {
+		if (row.errorOccurred || row.cpuTimeText.empty())
+			return;
+
+		auto name = row.name;
+		if (row.aggregate) {
+			if (!name.ends_with("_median"sv))
+				return;
+			name.remove_suffix("_median"sv.size());
+		}
+
+		auto [it, added] = runs.try_emplace(name);
+		if (added)
+			order.push_back(name);
+
+		const double unit = bench_parse::NanosecondsPer(row.timeUnit);
+		if (row.aggregate) {
+			it->second.reportedMedian.emplace(row.cpuTime * unit, row.realTime * unit);
+		} else {
+			it->second.cpuTimes.push_back(row.cpuTime * unit);
+			it->second.realTimes.push_back(row.realTime * unit);
+		}
+	});
+
+	if (!parsed) {
+		std::cerr << "Document is corrupted, or does not have correct format (see file [" << fileName << "]).\n";
+		return false;
+	}
+
+	Point point;
+	if (time)
+		point.time = *time;
+	else if (const auto date = bench_history::ParseDate(header.date))
+		point.time = *date;
+	else
+		point.time = Now();
+
+	for (const auto name : order) {
+		auto& samples = runs.at(name);
+		if (!samples.cpuTimes.empty()) {
+			point.cpuTime = bench_stats::Median(samples.cpuTimes);
+			point.realTime = bench_stats::Median(samples.realTimes);
+		} else if (samples.reportedMedian) {
+			std::tie(point.cpuTime, point.realTime) = *samples.reportedMedian;
+		} else {
+			continue;
+		}
+
+		std::string unescapedName;
+		bench_parse::AppendUnescaped(unescapedName, name, header.format);
+		points.emplace_back(std::move(unescapedName), point);
+	}
+	return true;
+}
+
+bool ParseOption(const std::string_view text, std::int64_t& value) {
+	const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+	return ec == std::errc{} && ptr == text.data() + text.size();
+}
+
+} // namespace
+
+namespace bench_history {
+
+std::optional<std::int64_t> ParseDate(const std::string_view date) {
+	const auto number = [date](const std::size_t pos, const std::size_t size) -> std::optional<int> {
+		int value = 0;
+		if (pos + size > date.size())
+			return std::nullopt;
+		const auto [ptr, ec] = std::from_chars(date.data() + pos, date.data() + pos + size, value);
+		if (ec != std::errc{} || ptr != date.data() + pos + size)
+			return std::nullopt;
+		return value;
+	};
+
+	const auto year = number(0, 4);
+	const auto month = number(5, 2);
+	const auto day = number(8, 2);
+	if (!year || !month || !day || date[4] != '-' || date[7] != '-')
+		return std::nullopt;
+
+	const std::chrono::year_month_day ymd{std::chrono::year{*year}, std::chrono::month{static_cast<unsigned>(*month)}, std::chrono::day{static_cast<unsigned>(*day)}};
+	if (!ymd.ok())
+		return std::nullopt;
+	std::int64_t seconds = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::sys_days{ymd}.time_since_epoch()).count();
+
+	if (date.size() == 10)
+		return seconds;
+
+	const auto hours = number(11, 2);
+	const auto minutes = number(14, 2);
+	const auto secs = number(17, 2);
+	if ((date[10] != 'T' && date[10] != ' ') || !hours || !minutes || !secs)
+		return std::nullopt;
+	seconds += *hours * 3600 + *minutes * 60 + *secs;
+
+	// Local times give their offset from UTC.
+	if (date.size() >= 25 && (date[19] == '+' || date[19] == '-')) {
+		const auto offsetHours = number(20, 2);
+		const auto offsetMinutes = number(23, 2);
+		if (!offsetHours || !offsetMinutes)
+			return std::nullopt;
+		const int offset = *offsetHours * 3600 + *offsetMinutes * 60;
+		seconds -= date[19] == '+' ? offset : -offset;
+	}
+	return seconds;
+}
+
+std::optional<std::vector<Series>> Select(const std::string& storeFile, const Query& query) {
+	const bench_parse::MappedFile file{storeFile};
+	if (!file.IsOpen()) {
+		std::cerr << "Failed to open history [" << storeFile << "].\n";
+		return std::nullopt;
+	}
+
+	std::vector<DirectoryEntry> directory;
+	if (!ReadDirectory(file.View(), directory)) {
+		std::cerr << "History [" << storeFile << "] is corrupted.\n";
+		return std::nullopt;
+	}
+
+	// Names are sorted, so only those starting with the pattern's literal prefix need matching.
+	const auto prefix = std::string_view{query.namePattern}.substr(0, query.namePattern.find_first_of("*?"sv));
+	auto it = std::ranges::lower_bound(directory, prefix, {}, &DirectoryEntry::name);
+
+	std::vector<Series> result;
+	for (; it != directory.end() && it->name.starts_with(prefix); ++it) {
+		if (it->lastTime < query.from || it->firstTime > query.to || !bench_files::MatchesPattern(it->name, query.namePattern))
+			continue;
+
+		Series series;
+		series.name = it->name;
+		if (!DecodeSeries(file.View(), *it, series.points)) {
+			std::cerr << "History [" << storeFile << "] is corrupted.\n";
+			return std::nullopt;
+		}
+		std::erase_if(series.points, [&query](const Point& point) { return point.time < query.from || point.time > query.to; });
+		if (!series.points.empty())
+			result.push_back(std::move(series));
+	}
+	return result;
+}
+
+bool AppendResults(const std::string& storeFile, const std::span<const std::string> resultsFiles, const std::optional<std::int64_t> time) {
+	std::vector<Series> series;
+	if (std::filesystem::exists(storeFile)) {
+		auto existing = Select(storeFile, {});
+		if (!existing)
+			return false;
+		series = std::move(*existing);
+	}
+
+	std::vector<std::pair<std::string, Point>> points;
+	for (const auto& resultsFile : resultsFiles) {
+		if (!ReadRunPoints(resultsFile, time, points))
+			return false;
+	}
+
+	std::unordered_map<std::string_view, std::size_t> indices;
+	for (std::size_t i = 0; i < series.size(); ++i)
+		indices.emplace(series[i].name, i);
+
+	// Indices view names in series, so add new series after looking up all the points.
+	std::vector<std::pair<std::string, std::vector<Point>>> added;
+	for (auto& [name, point] : points) {
+		std::vector<Point>* target;
+		if (const auto it = indices.find(name); it != indices.end()) {
+			target = &series[it->second].points;
+		} else {
+			const auto existing = std::ranges::find(added, name, &std::pair<std::string, std::vector<Point>>::first);
+			target = existing != added.end() ? &existing->second : &added.emplace_back(std::move(name), std::vector<Point>{}).second;
+		}
+
+		const auto at = std::ranges::lower_bound(*target, point.time, {}, &Point::time);
+		if (at != target->end() && at->time == point.time)
+			*at = point;
+		else
+			target->insert(at, point);
+	}
+	indices.clear();
+	for (auto& [name, seriesPoints] : added)
+		series.push_back({std::move(name), std::move(seriesPoints)});
+	std::ranges::sort(series, {}, &Series::name);
+
+	const auto data = EncodeStore(series);
+	const auto tempFile = storeFile + ".tmp";
+	{
+		std::ofstream out{tempFile, std::ios::out | std::ios::binary | std::ios::trunc};
+		if (!out.is_open()) {
+			std::cerr << "Failed to open out file [" << tempFile << "].\n";
+			return false;
+		}
+		out.write(data.data(), static_cast<std::streamsize>(data.size()));
+		if (!out) {
+			std::cerr << "Failed to write [" << tempFile << "].\n";
+			return false;
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::rename(tempFile, storeFile, error);
+	if (error) {
+		std::cerr << "Failed to replace history [" << storeFile << "]: " << error.message() << ".\n";
+		return false;
+	}
+	return true;
+}
+
+std::string ExportCsv(const std::span<const Series> series) {
+	std::string out = "name,iterations,real_time,cpu_time,time_unit,bytes_per_second,items_per_second,label,error_occurred,error_message,category,date\n";
+	for (const auto& s : series) {
+		const auto metaData = bench_parse::GetTestMetaData(s.name);
+		for (const auto& point : s.points) {
+			bench_parse::AppendCsvText(out, s.name);
+			fmt::format_to(std::back_inserter(out), ",,{},{},ns,,,", point.realTime, point.cpuTime);
+			bench_parse::AppendCsvText(out, metaData.label);
+			out += ",,,"sv;
+			out += metaData.category;
+			out += ',';
+			out += FormatTime(point.time);
+			out += '\n';
+		}
+	}
+	return out;
+}
+
+int RunHistoryCommand(const std::span<const char* const> args) {
+	if (args.size() < 2) {
+		std::cerr << Usage;
+		return 2;
+	}
+
+	const std::string_view command = args[0];
+	const std::string storeFile = args[1];
+	std::vector<std::string> files;
+	std::optional<std::int64_t> date;
+	Query query;
+	std::string outFile;
+
+	for (std::size_t i = 2; i < args.size(); ++i) {
+		const std::string_view arg = args[i];
+		if (!arg.starts_with("--"sv)) {
+			files.emplace_back(arg);
+			continue;
+		}
+
+		if (i + 1 == args.size()) {
+			std::cerr << "Missing value of [" << arg << "].\n" << Usage;
+			return 2;
+		}
+		const std::string_view value = args[++i];
+
+		bool valid = true;
+		if (arg == "--date"sv) {
+			date = ParseDate(value);
+			valid = date.has_value();
+		} else if (arg == "--name"sv) {
+			query.namePattern = value;
+		} else if (arg == "--days"sv) {
+			std::int64_t days = 0;
+			valid = ParseOption(value, days);
+			query.from = Now() - days * 24 * 60 * 60;
+		} else if (arg == "--from"sv || arg == "--to"sv) {
+			const auto time = ParseDate(value);
+			valid = time.has_value();
+			(arg == "--from"sv ? query.from : query.to) = time.value_or(0);
+		} else if (arg == "--out"sv) {
+			outFile = value;
+		} else {
+			valid = false;
+		}
+
+		if (!valid) {
+			std::cerr << "Invalid option [" << arg << ' ' << value << "].\n" << Usage;
+			return 2;
+		}
+	}
+
+	if (command == "add"sv) {
+		if (files.empty()) {
+			std::cerr << "Need results files to add.\n" << Usage;
+			return 2;
+		}
+		return AppendResults(storeFile, files, date) ? 0 : 2;
+	}
+
+	if (command != "query"sv) {
+		std::cerr << "Unknown history command [" << command << "].\n" << Usage;
+		return 2;
+	}
+
+	const auto series = Select(storeFile, query);
+	if (!series)
+		return 2;
+
+	const auto csv = ExportCsv(*series);
+	if (outFile.empty()) {
+		std::cout.write(csv.data(), static_cast<std::streamsize>(csv.size()));
+		return 0;
+	}
+
+	std::ofstream out{outFile, std::ios::out | std::ios::trunc};
+	if (!out.is_open()) {
+		std::cerr << "Failed to open out file [" << outFile << "]\n.";
+		return 3;
+	}
+	out.write(csv.data(), static_cast<std::streamsize>(csv.size()));
+	return 0;
+}
+
+} // bench_history
@@ -0,0 +1,62 @@
+#ifndef INCLUDE_CTP_BENCHMARK_PROCESSOR_HISTORY_HPP
+#define INCLUDE_CTP_BENCHMARK_PROCESSOR_HISTORY_HPP
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Store of benchmark results over time, so trends don't need every old results file re-parsed.
+//
+// One file holds a series per benchmark run name (which includes any args), with a point per run. Names are only
+// stored once, in a directory sorted by name that also has the time range and location of each series, so a query
+// only decodes the series it selects. A series stores its columns one after the other: times as varint deltas, then
+// cpu and real times as the bits of each double XORed with the previous one, as varints, since successive runs share
+// most of their leading bits.
+// Appending rewrites the file, which is small next to the results it replaces.
+namespace bench_history {
+
+struct Point {
+	// Seconds since the Unix epoch.
+	std::int64_t time = 0;
+	// Nanoseconds.
+	double cpuTime = 0;
+	double realTime = 0;
+};
+
+struct Series {
+	std::string name;
+	// In time order, at most one per time.
+	std::vector<Point> points;
+};
+
+struct Query {
+	// Wildcards are * and ?.
+	std::string namePattern = "*";
+	// Inclusive, in seconds since the Unix epoch.
+	std::int64_t from = std::numeric_limits<std::int64_t>::min();
+	std::int64_t to = std::numeric_limits<std::int64_t>::max();
+};
+
+// Seconds since the Unix epoch of a date like "2024-01-31" or "2024-01-31T12:00:00+01:00".
+std::optional<std::int64_t> ParseDate(std::string_view date);
+
+// Add the runs of results files, by the date each says it ran, or the time given. A run replaces any earlier
+// point at the same time, so adding a file again changes nothing. Creates the store if it doesn't exist.
+bool AppendResults(const std::string& storeFile, std::span<const std::string> resultsFiles, std::optional<std::int64_t> time = std::nullopt);
+
+// The points of every series matching the query, or empty if the store can't be read.
+std::optional<std::vector<Series>> Select(const std::string& storeFile, const Query& query);
+
+// In the processed CSV schema, with a date column.
+std::string ExportCsv(std::span<const Series> series);
+
+// Runs the arguments after --history. Returns the exit code.
+int RunHistoryCommand(std::span<const char* const> args);
+
+} // bench_history
+
+#endif // INCLUDE_CTP_BENCHMARK_PROCESSOR_HISTORY_HPP
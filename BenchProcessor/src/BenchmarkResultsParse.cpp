@@ -4,101 +4,536 @@
 #include <array>
 #include <charconv>
 #include <iostream>
+#include <utility>
 
 using namespace std::literals;
 
-namespace bench_parse {
+namespace {
+
+using namespace bench_parse;
+
+enum class Column : std::uint8_t {
+	Name,
+	Iterations,
+	RealTime,
+	CpuTime,
+	TimeUnit,
+	BytesPerSecond,
+	ItemsPerSecond,
+	Label,
+	ErrorOccurred,
+	ErrorMessage,
+	RunType,
+	// Reported, but not kept.
+	Other,
+	Counter,
+};
+
+constexpr std::pair<std::string_view, Column> KnownColumns[]{
+	{"name"sv, Column::Name},
+	{"iterations"sv, Column::Iterations},
+	{"real_time"sv, Column::RealTime},
+	{"cpu_time"sv, Column::CpuTime},
+	{"time_unit"sv, Column::TimeUnit},
+	{"bytes_per_second"sv, Column::BytesPerSecond},
+	{"items_per_second"sv, Column::ItemsPerSecond},
+	{"label"sv, Column::Label},
+	{"error_occurred"sv, Column::ErrorOccurred},
+	{"error_message"sv, Column::ErrorMessage},
+	{"run_type"sv, Column::RunType},
+	// Only in JSON.
+	{"family_index"sv, Column::Other},
+	{"per_family_instance_index"sv, Column::Other},
+	{"run_name"sv, Column::Other},
+	{"repetitions"sv, Column::Other},
+	{"repetition_index"sv, Column::Other},
+	{"threads"sv, Column::Other},
+	{"aggregate_name"sv, Column::Other},
+	{"aggregate_unit"sv, Column::Other},
+	{"big_o"sv, Column::Other},
+	{"rms"sv, Column::Other},
+};
+
+struct ColumnInfo {
+	Column column = Column::Other;
+	std::uint32_t counterIndex = 0;
+};
+
+std::uint32_t CounterIndex(ResultsHeader& header, const std::string_view name) {
+	const auto it = std::ranges::find(header.counterNames, name);
+	if (it != header.counterNames.end())
+		return static_cast<std::uint32_t>(it - header.counterNames.begin());
+	header.counterNames.push_back(name);
+	return static_cast<std::uint32_t>(header.counterNames.size() - 1);
+}
+
+// Anything that isn't a known field is a user counter.
+ColumnInfo FindColumn(ResultsHeader& header, const std::string_view name) {
+	for (const auto& [columnName, column] : KnownColumns) {
+		if (columnName == name)
+			return {column};
+	}
+	return {Column::Counter, CounterIndex(header, name)};
+}
+
+std::optional<double> ParseNumber(const std::string_view text) {
+	double value = 0;
+	const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+	if (text.empty() || ec != std::errc{} || ptr != text.data() + text.size())
+		return std::nullopt;
+	return value;
+}
+
+void SetField(ResultRow& row, std::vector<CounterValue>& counters, const ColumnInfo info, const std::string_view value) {
+	switch (info.column) {
+	case Column::Name: row.name = value; break;
+	case Column::Iterations: row.iterations = value; break;
+	case Column::RealTime:
+		row.realTimeText = value;
+		row.realTime = ParseNumber(value).value_or(0);
+		break;
+	case Column::CpuTime:
+		row.cpuTimeText = value;
+		row.cpuTime = ParseNumber(value).value_or(0);
+		break;
+	case Column::TimeUnit: row.timeUnit = value; break;
+	case Column::BytesPerSecond: row.bytesPerSecond = value; break;
+	case Column::ItemsPerSecond: row.itemsPerSecond = value; break;
+	case Column::Label: row.label = value; break;
+	case Column::ErrorOccurred: row.errorOccurred = value == "true"sv; break;
+	case Column::ErrorMessage: row.errorMessage = value; break;
+	case Column::RunType: row.aggregate = value == "aggregate"sv; break;
+	case Column::Other: break;
+	case Column::Counter:
+		if (const auto number = ParseNumber(value))
+			counters.push_back({info.counterIndex, *number, value});
+		break;
+	}
+}
+
+/* ---------------------- CSV ----------------------- */
+
+// Reads the field at pos, without any quotes, leaving pos at the delimiter after it.
+std::string_view NextCsvField(const std::string_view text, std::size_t& pos) {
+	if (pos < text.size() && text[pos] == '"') {
+		const std::size_t start = ++pos;
+		while (true) {
+			pos = text.find('"', pos);
+			if (pos == std::string_view::npos) {
+				pos = text.size();
+				return text.substr(start);
+			}
+			// Quotes are escaped by doubling them.
+			if (pos + 1 < text.size() && text[pos + 1] == '"') {
+				pos += 2;
+				continue;
+			}
+			return text.substr(start, pos++ - start);
+		}
+	}
+
+	const std::size_t start = pos;
+	while (pos < text.size() && text[pos] != ',' && text[pos] != '\n' && text[pos] != '\r')
+		++pos;
+	return text.substr(start, pos - start);
+}
 
-std::size_t RecursiveFind(std::string_view str, std::string_view toFind, std::size_t timesToFind) {
+void SkipLine(const std::string_view text, std::size_t& pos) {
+	pos = text.find('\n', pos);
+	pos = pos == std::string_view::npos ? text.size() : pos + 1;
+}
+
+// CSV doesn't say which runs are aggregates, but their names end with the statistic.
+bool IsCsvAggregate(const std::string_view name) {
+	return name.ends_with("_mean"sv) || name.ends_with("_median"sv) || name.ends_with("_stddev"sv) || name.ends_with("_cv"sv);
+}
+
+bool ParseCsv(const std::string_view text, ResultsHeader& header, const RowCallback& onRow) {
+	std::vector<ColumnInfo> columns;
+	ResultRow row;
+	std::vector<CounterValue> counters;
+
+	// Context lines come before the header, when written with --benchmark_out. The first is the date.
 	std::size_t pos = 0;
-	for (; (timesToFind > 0) && (pos != std::string_view::npos) && (pos + 1 < str.size()); --timesToFind)
-		pos = str.find(toFind, pos + 1);
-	return pos;
+	if (!text.empty() && text[0] >= '0' && text[0] <= '9') {
+		SkipLine(text, pos);
+		header.date = text.substr(0, pos);
+		while (!header.date.empty() && (header.date.back() == '\n' || header.date.back() == '\r'))
+			header.date.remove_suffix(1);
+	}
+
+	while (pos < text.size()) {
+		if (text.substr(pos).starts_with("name,"sv)) {
+			columns.clear();
+			while (true) {
+				columns.push_back(FindColumn(header, NextCsvField(text, pos)));
+				if (pos >= text.size() || text[pos] != ',')
+					break;
+				++pos;
+			}
+			SkipLine(text, pos);
+			continue;
+		}
+
+		// Benchmark names are always quoted, anything else is other output.
+		if (text[pos] != '"' || columns.empty()) {
+			SkipLine(text, pos);
+			continue;
+		}
+
+		row = {};
+		counters.clear();
+		for (std::size_t column = 0;; ++column) {
+			const auto field = NextCsvField(text, pos);
+			if (column < columns.size() && !field.empty())
+				SetField(row, counters, columns[column], field);
+			if (pos >= text.size() || text[pos] != ',')
+				break;
+			++pos;
+		}
+		SkipLine(text, pos);
+		row.aggregate = IsCsvAggregate(row.name);
+		onRow(row, counters);
+	}
+
+	if (columns.empty()) {
+		std::cerr << "ParseCsv - Didn't find header.\n";
+		return false;
+	}
+	return true;
 }
-std::size_t RecursiveFind(std::string_view str, char toFind, std::size_t timesToFind) {
-	return RecursiveFind(str, std::string_view{&toFind, 1}, timesToFind);
+
+/* ---------------------- JSON ---------------------- */
+
+class JsonScanner {
+public:
+	explicit JsonScanner(const std::string_view text) : text_{text} {}
+
+	bool Failed() const noexcept { return failed_; }
+
+	// Consumes the next token if it's c.
+	bool Consume(const char c) noexcept {
+		SkipWhitespace();
+		if (pos_ < text_.size() && text_[pos_] == c) {
+			++pos_;
+			return true;
+		}
+		return false;
+	}
+
+	void Expect(const char c) noexcept {
+		if (!Consume(c))
+			failed_ = true;
+	}
+
+	char Peek() noexcept {
+		SkipWhitespace();
+		return pos_ < text_.size() ? text_[pos_] : '\0';
+	}
+
+	// The string without quotes, still escaped.
+	std::string_view String() noexcept {
+		if (!Consume('"')) {
+			failed_ = true;
+			return {};
+		}
+		const std::size_t start = pos_;
+		while (pos_ < text_.size() && text_[pos_] != '"')
+			pos_ += text_[pos_] == '\\' ? 2 : 1;
+		if (pos_ >= text_.size()) {
+			failed_ = true;
+			return {};
+		}
+		return text_.substr(start, pos_++ - start);
+	}
+
+	// A number, true, false or null.
+	std::string_view Scalar() noexcept {
+		SkipWhitespace();
+		const std::size_t start = pos_;
+		while (pos_ < text_.size() && !IsDelimiter(text_[pos_]))
+			++pos_;
+		if (pos_ == start)
+			failed_ = true;
+		return text_.substr(start, pos_ - start);
+	}
+
+	void SkipValue() noexcept {
+		const char c = Peek();
+		if (c == '"') {
+			String();
+		} else if (c == '{' || c == '[') {
+			++pos_;
+			for (std::size_t depth = 1; depth > 0 && pos_ < text_.size();) {
+				switch (text_[pos_]) {
+				case '"': String(); continue;
+				case '{': case '[': ++depth; break;
+				case '}': case ']': --depth; break;
+				default: break;
+				}
+				++pos_;
+			}
+		} else {
+			Scalar();
+		}
+	}
+
+private:
+	static bool IsDelimiter(const char c) noexcept {
+		return c == ',' || c == '}' || c == ']' || c == ' ' || c == '\n' || c == '\r' || c == '\t';
+	}
+
+	void SkipWhitespace() noexcept {
+		while (pos_ < text_.size() && (text_[pos_] == ' ' || text_[pos_] == '\n' || text_[pos_] == '\r' || text_[pos_] == '\t'))
+			++pos_;
+	}
+
+	std::string_view text_;
+	std::size_t pos_ = 0;
+	bool failed_ = false;
+};
+
+void ParseJsonBenchmark(JsonScanner& json, ResultsHeader& header, ResultRow& row, std::vector<CounterValue>& counters) {
+	json.Expect('{');
+	if (json.Consume('}'))
+		return;
+
+	do {
+		const auto key = json.String();
+		json.Expect(':');
+		const char next = json.Peek();
+		if (next == '{' || next == '[') {
+			json.SkipValue();
+			continue;
+		}
+
+		const auto value = next == '"' ? json.String() : json.Scalar();
+		const auto info = FindColumn(header, key);
+		// Counters are numbers, so drop unknown strings rather than make them counters.
+		if (info.column == Column::Counter && next == '"')
+			continue;
+		SetField(row, counters, info, value);
+	} while (json.Consume(',') && !json.Failed());
+
+	json.Expect('}');
 }
 
-GetTimeResult GetCPUTime(const std::string_view line) {
-	GetTimeResult result;
+void ParseJsonContext(JsonScanner& json, ResultsHeader& header) {
+	json.Expect('{');
+	if (json.Consume('}'))
+		return;
 
-	// real_time is the 3rd field.
-	auto startComma = RecursiveFind(line, ","sv, 3);
-	if (startComma == std::string_view::npos) {
-		std::cerr << "GetCPUTime - Didn't find start comma.\n";
-		return result;
+	do {
+		const auto key = json.String();
+		json.Expect(':');
+		if (key == "date"sv && json.Peek() == '"')
+			header.date = json.String();
+		else
+			json.SkipValue();
+	} while (json.Consume(',') && !json.Failed());
+
+	json.Expect('}');
+}
+
+bool ParseJson(const std::string_view text, ResultsHeader& header, const RowCallback& onRow) {
+	JsonScanner json{text};
+	bool foundBenchmarks = false;
+	ResultRow row;
+	std::vector<CounterValue> counters;
+
+	json.Expect('{');
+	if (!json.Consume('}')) {
+		do {
+			const auto key = json.String();
+			json.Expect(':');
+			if (key == "context"sv) {
+				ParseJsonContext(json, header);
+				continue;
+			}
+			if (key != "benchmarks"sv) {
+				json.SkipValue();
+				continue;
+			}
+
+			foundBenchmarks = true;
+			json.Expect('[');
+			if (json.Consume(']'))
+				continue;
+			do {
+				row = {};
+				counters.clear();
+				ParseJsonBenchmark(json, header, row, counters);
+				if (!json.Failed())
+					onRow(row, counters);
+			} while (json.Consume(',') && !json.Failed());
+			json.Expect(']');
+		} while (json.Consume(',') && !json.Failed());
+		json.Expect('}');
 	}
-	++startComma; // Skip comma.
 
-	const auto endComma = line.find(',', startComma);
-	if (endComma == std::string_view::npos) {
-		std::cerr << "GetCPUTime - Didn't find end comma.\n";
-		return result;
+	if (json.Failed()) {
+		std::cerr << "ParseJson - Malformed JSON.\n";
+		return false;
+	}
+	if (!foundBenchmarks) {
+		std::cerr << "ParseJson - Didn't find benchmarks.\n";
+		return false;
 	}
+	return true;
+}
 
-	double time = 0;
-	const auto [ptr, ec] = std::from_chars(line.data() + startComma, line.data() + endComma, time);
-	if (ec == std::errc{}) {
-		result.startPos = startComma;
-		result.endPos = endComma;
-		result.value = time;
-		return result;
+void AppendUtf8(std::string& out, const std::uint32_t codePoint) {
+	if (codePoint < 0x80) {
+		out += static_cast<char>(codePoint);
+	} else if (codePoint < 0x800) {
+		out += static_cast<char>(0xC0 | (codePoint >> 6));
+		out += static_cast<char>(0x80 | (codePoint & 0x3F));
+	} else if (codePoint < 0x10000) {
+		out += static_cast<char>(0xE0 | (codePoint >> 12));
+		out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+		out += static_cast<char>(0x80 | (codePoint & 0x3F));
+	} else {
+		out += static_cast<char>(0xF0 | (codePoint >> 18));
+		out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+		out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+		out += static_cast<char>(0x80 | (codePoint & 0x3F));
 	}
+}
 
-	std::cerr << "GetCPUTime - Didn't find start comma.\n";
+std::uint32_t ParseHex4(const std::string_view value, const std::size_t pos) {
+	std::uint32_t result = 0;
+	if (pos + 4 <= value.size())
+		std::from_chars(value.data() + pos, value.data() + pos + 4, result, 16);
 	return result;
 }
 
-void OverwriteCPUTime(std::string& line, double newTime, std::optional<std::pair<std::size_t, std::size_t>> timeStartEnd) {
-	std::size_t currentStart = 0;
-	std::size_t currentEnd = 0;
-	if (timeStartEnd) {
-		std::tie(currentStart, currentEnd) = *timeStartEnd;
-	} else {
-		const auto info = GetCPUTime(line);
-		currentStart = info.startPos;
-		currentEnd = info.endPos;
+// Quotes are doubled for CSV.
+void AppendUnescapedJson(std::string& out, const std::string_view value, const bool csv) {
+	const auto quote = csv ? "\"\""sv : "\""sv;
+	for (std::size_t i = 0; i < value.size(); ++i) {
+		if (value[i] != '\\' || i + 1 == value.size()) {
+			out += value[i] == '"' ? quote : std::string_view{&value[i], 1};
+			continue;
+		}
+
+		switch (value[++i]) {
+		case '"': out += quote; break;
+		case 'b': out += '\b'; break;
+		case 'f': out += '\f'; break;
+		case 'n': out += '\n'; break;
+		case 'r': out += '\r'; break;
+		case 't': out += '\t'; break;
+		case 'u': {
+			std::uint32_t codePoint = ParseHex4(value, i + 1);
+			i += 4;
+			// Surrogate pairs.
+			if (codePoint >= 0xD800 && codePoint < 0xDC00 && value.substr(i + 1, 2) == "\\u"sv) {
+				const std::uint32_t low = ParseHex4(value, i + 3);
+				if (low >= 0xDC00 && low < 0xE000) {
+					codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+					i += 6;
+				}
+			}
+			AppendUtf8(out, codePoint);
+			break;
+		}
+		default: out += value[i]; break;
+		}
 	}
+}
 
-	line.erase(currentStart, currentEnd - currentStart);
+} // namespace
 
-	std::array<char, 100> chars;
-	auto [ptr, ec] = std::to_chars(chars.data(), chars.data() + 100, newTime);
+namespace bench_parse {
 
-	if (ec != std::errc{}) {
-		std::cerr << "OverwriteCPUTime - value too large.\n";
+bool ParseResults(const std::string_view text, ResultsHeader& header, const RowCallback& onRow) {
+	header = {};
+
+	const auto start = text.find_first_not_of(" \t\r\n"sv);
+	header.format = start != std::string_view::npos && text[start] == '{' ? ResultsFormat::JSON : ResultsFormat::CSV;
+
+	return header.format == ResultsFormat::JSON ? ParseJson(text, header, onRow) : ParseCsv(text, header, onRow);
+}
+
+void AppendCsvString(std::string& out, const std::string_view value, const ResultsFormat format) {
+	if (value.empty())
+		return;
+
+	out += '"';
+	// CSV fields are already escaped.
+	if (format == ResultsFormat::CSV)
+		out += value;
+	else
+		AppendUnescapedJson(out, value, true);
+	out += '"';
+}
+
+void AppendUnescaped(std::string& out, const std::string_view value, const ResultsFormat format) {
+	if (format == ResultsFormat::JSON) {
+		AppendUnescapedJson(out, value, false);
 		return;
 	}
 
-	const auto str = std::string_view{chars.data(), ptr};
+	for (std::size_t i = 0; i < value.size(); ++i) {
+		out += value[i];
+		// Skip the second of doubled quotes.
+		if (value[i] == '"' && i + 1 < value.size() && value[i + 1] == '"')
+			++i;
+	}
+}
 
-	line.insert(currentStart, str);
+void AppendCsvText(std::string& out, const std::string_view text) {
+	out += '"';
+	for (const char c : text) {
+		if (c == '"')
+			out += '"';
+		out += c;
+	}
+	out += '"';
 }
 
-GetStringResult GetFixtureTestName(const std::string_view line) {
+void AppendNumber(std::string& out, const double value) {
+	std::array<char, 64> chars;
+	const auto [ptr, ec] = std::to_chars(chars.data(), chars.data() + chars.size(), value);
+	if (ec != std::errc{}) {
+		std::cerr << "AppendNumber - value too large.\n";
+		return;
+	}
+	out.append(chars.data(), ptr);
+}
+
+double NanosecondsPer(const std::string_view timeUnit) {
+	if (timeUnit == "us"sv)
+		return 1e3;
+	if (timeUnit == "ms"sv)
+		return 1e6;
+	if (timeUnit == "s"sv)
+		return 1e9;
+	return 1;
+}
+
+GetStringResult GetFixtureTestName(const std::string_view name) {
 	GetStringResult result;
 
-	auto nameStart = line.find('/');
+	auto nameStart = name.find('/');
 	if (nameStart == std::string_view::npos) {
 		std::cerr << "GetFixtureTestName - Didn't find start slash.\n";
 		return result;
 	}
 	++nameStart; // Skip slash.
 
-	const auto nameEnd = line.find_first_of("/\"", nameStart);
-	if (nameStart == std::string_view::npos) {
-		std::cerr << "GetFixtureTestName - Didn't find end slash or quote.\n";
-		return result;
-	}
+	auto nameEnd = name.find('/', nameStart);
+	if (nameEnd == std::string_view::npos)
+		nameEnd = name.size();
 
 	result.startPos = nameStart;
-	result.value = line.substr(nameStart, nameEnd - nameStart);
+	result.value = name.substr(nameStart, nameEnd - nameStart);
 	return result;
 }
 
-GetStringResult GetFixtureTestNameSuffix(const std::string_view line, std::optional<GetStringResult> fixtureTestName, const char delimiter) {
+GetStringResult GetFixtureTestNameSuffix(const std::string_view name, std::optional<GetStringResult> fixtureTestName, const char delimiter) {
 	if (!fixtureTestName)
-		fixtureTestName = GetFixtureTestName(line);
+		fixtureTestName = GetFixtureTestName(name);
 
 	GetStringResult result;
 
@@ -109,12 +544,25 @@ GetStringResult GetFixtureTestNameSuffix(const std::string_view line, std::optio
 	}
 
 	// Include any range/arg info.
-	auto testNameEnd = line.find('\"', result.startPos);
+	result.value = name.substr(result.startPos);
+	return result;
+}
+
+TestMetaData GetTestMetaData(const std::string_view name) {
+	TestMetaData result;
+
+	const auto testName = GetFixtureTestName(name);
+	if (testName.value.empty())
+		return result;
+	result.suffix = GetFixtureTestNameSuffix(name, testName).value;
 
-	if (testNameEnd == std::string_view::npos) [[unlikely]]
-		testNameEnd = fixtureTestName->startPos + fixtureTestName->value.size();
+	// The category is the test name suffix without any arg info.
+	result.category = testName.value;
+	while (!result.suffix.starts_with(result.category))
+		result.category.remove_prefix(1);
+	if (result.category.size() < testName.value.size())
+		result.label = testName.value.substr(0, testName.value.size() - result.category.size() - 1);
 
-	result.value = line.substr(result.startPos, testNameEnd - result.startPos);
 	return result;
 }
 
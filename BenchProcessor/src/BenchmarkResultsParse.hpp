@@ -1,24 +1,74 @@
 #ifndef INCLUDE_CTP_BENCHMARK_PROCESSOR_RESULTS_PARSE_HPP
 #define INCLUDE_CTP_BENCHMARK_PROCESSOR_RESULTS_PARSE_HPP
 
+#include <cstdint>
+#include <functional>
 #include <optional>
+#include <span>
 #include <string_view>
 #include <string>
+#include <vector>
 
-// Parse CSV results of google benchmark.
+// Parse CSV and JSON results of google benchmark.
 namespace bench_parse {
 
-std::size_t RecursiveFind(std::string_view str, std::string_view toFind, std::size_t timesToFind);
-std::size_t RecursiveFind(std::string_view str, char toFind, std::size_t timesToFind);
+enum class ResultsFormat : std::uint8_t {
+	CSV,
+	JSON,
+};
 
-struct GetTimeResult {
-	std::size_t startPos = 0;
-	std::size_t endPos = 0;
+// A user counter of a run. Names are in ResultsHeader::counterNames.
+struct CounterValue {
+	std::uint32_t nameIndex = 0;
 	double value = 0;
+	std::string_view text;
+};
+
+// A benchmark run. Fields view the parsed text as written, so strings keep the escaping of ResultsHeader::format,
+// and fields the run didn't report are empty.
+struct ResultRow {
+	std::string_view name;
+	std::string_view iterations;
+	std::string_view realTimeText;
+	std::string_view cpuTimeText;
+	std::string_view timeUnit;
+	std::string_view bytesPerSecond;
+	std::string_view itemsPerSecond;
+	std::string_view label;
+	std::string_view errorMessage;
+	double realTime = 0;
+	double cpuTime = 0;
+	bool errorOccurred = false;
+	// Mean, median etc. of repetitions. For CSV, known from the name.
+	bool aggregate = false;
+};
+
+struct ResultsHeader {
+	ResultsFormat format = ResultsFormat::CSV;
+	// Every user counter seen so far.
+	std::vector<std::string_view> counterNames;
+	// When the run started, like "2024-01-31T12:00:00+00:00". Empty if the output didn't say.
+	std::string_view date;
 };
 
-GetTimeResult GetCPUTime(std::string_view line);
-void OverwriteCPUTime(std::string& line, double newTime, std::optional<std::pair<std::size_t,std::size_t>> timeStartEnd = {});
+// Called for each run, with the counters it reported. The row and span are reused for the next run, but what they
+// view is in the parsed text.
+using RowCallback = std::function<void(const ResultRow& row, std::span<const CounterValue> counters)>;
+
+// Parse the output of a run in one pass, detecting the format, without keeping any rows.
+// Returns false if the text isn't benchmark output.
+bool ParseResults(std::string_view text, ResultsHeader& header, const RowCallback& onRow);
+
+// Append a string field of the results as a quoted CSV field, or nothing if it's empty.
+void AppendCsvString(std::string& out, std::string_view value, ResultsFormat format);
+// Append a string field of the results without any escaping.
+void AppendUnescaped(std::string& out, std::string_view value, ResultsFormat format);
+// Append unescaped text as a quoted CSV field.
+void AppendCsvText(std::string& out, std::string_view text);
+void AppendNumber(std::string& out, double value);
+
+// Nanoseconds in a ResultRow::timeUnit, to compare times reported in different units.
+double NanosecondsPer(std::string_view timeUnit);
 
 struct GetStringResult {
 	std::size_t startPos = 0;
@@ -26,9 +76,19 @@ struct GetStringResult {
 };
 
 // Assumes format like "FixtureName/TestName</Arg>"
-GetStringResult GetFixtureTestName(std::string_view line);
+GetStringResult GetFixtureTestName(std::string_view name);
 // Gets the test name suffix, separated by the delimieter, including any range/arg info.
-GetStringResult GetFixtureTestNameSuffix(std::string_view line, std::optional<GetStringResult> fixtureTestName = std::nullopt, char delimiter = '_');
+GetStringResult GetFixtureTestNameSuffix(std::string_view name, std::optional<GetStringResult> fixtureTestName = std::nullopt, char delimiter = '_');
+
+struct TestMetaData {
+	std::string_view label;
+	std::string_view category;
+	// The category with any range/arg info, matching base-times to tests.
+	std::string_view suffix;
+};
+
+// Label and category from a name like "FixtureName/Label_Category</Arg>". Empty if the name isn't like that.
+TestMetaData GetTestMetaData(std::string_view name);
 
 } // bench_parse
 
@@ -0,0 +1,151 @@
+#include "BenchmarkStatistics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Up to C(40, 20) arrangements, which doubles count exactly.
+constexpr std::size_t MaxExactSampleSize = 20;
+
+// Ways to order n1 samples of a and n2 of b so a wins u pairs, for each u.
+std::vector<double> ExactUFrequencies(const std::size_t n1, const std::size_t n2) {
+	// counts[i] holds the frequencies for i samples of a, and the samples of b so far.
+	std::vector<std::vector<double>> counts(n1 + 1);
+	for (std::size_t i = 0; i <= n1; ++i)
+		counts[i].assign(n1 * n2 + 1, 0.0);
+	for (auto& frequencies : counts)
+		frequencies[0] = 1;
+
+	for (std::size_t j = 1; j <= n2; ++j) {
+		// The largest sample is either from b, winning nothing, or from a, winning all j pairs.
+		for (std::size_t i = 1; i <= n1; ++i) {
+			for (std::size_t u = i * j; u >= j; --u)
+				counts[i][u] += counts[i - 1][u - j];
+		}
+	}
+	return std::move(counts[n1]);
+}
+
+double MedianOfResample(std::span<const double> samples, std::vector<double>& resample, std::mt19937_64& rng) {
+	std::uniform_int_distribution<std::size_t> pick{0, samples.size() - 1};
+	resample.resize(samples.size());
+	for (auto& value : resample)
+		value = samples[pick(rng)];
+	return bench_stats::Median(resample);
+}
+
+} // namespace
+
+namespace bench_stats {
+
+double Median(const std::span<double> samples) {
+	if (samples.empty())
+		return 0;
+
+	const auto mid = samples.begin() + static_cast<std::ptrdiff_t>(samples.size() / 2);
+	std::nth_element(samples.begin(), mid, samples.end());
+	if (samples.size() % 2 != 0)
+		return *mid;
+
+	const double below = *std::max_element(samples.begin(), mid);
+	return (below + *mid) / 2;
+}
+
+double MedianAbsoluteDeviation(const std::span<const double> samples, const double median) {
+	std::vector<double> deviations;
+	deviations.reserve(samples.size());
+	for (const double value : samples)
+		deviations.push_back(std::abs(value - median));
+	return Median(deviations);
+}
+
+Interval BootstrapChangeInterval(const std::span<const double> baseline, const std::span<const double> contender, const double confidence, const std::size_t resamples, const std::uint64_t seed) {
+	if (baseline.empty() || contender.empty() || resamples == 0)
+		return {};
+
+	std::mt19937_64 rng{seed};
+	std::vector<double> resample;
+	std::vector<double> changes;
+	changes.reserve(resamples);
+	for (std::size_t i = 0; i < resamples; ++i) {
+		const double baselineMedian = MedianOfResample(baseline, resample, rng);
+		const double contenderMedian = MedianOfResample(contender, resample, rng);
+		if (baselineMedian != 0)
+			changes.push_back(contenderMedian / baselineMedian - 1);
+	}
+	if (changes.empty())
+		return {};
+
+	std::ranges::sort(changes);
+	const double tail = (1 - confidence) / 2;
+	const auto at = [&changes](const double quantile) {
+		const auto index = static_cast<std::size_t>(quantile * static_cast<double>(changes.size() - 1) + 0.5);
+		return changes[std::min(index, changes.size() - 1)];
+	};
+	return {at(tail), at(1 - tail)};
+}
+
+double MannWhitneyU(const std::span<const double> a, const std::span<const double> b) {
+	const std::size_t n1 = a.size();
+	const std::size_t n2 = b.size();
+	if (n1 == 0 || n2 == 0)
+		return 1;
+
+	// Rank both samples together, averaging the ranks of ties.
+	std::vector<std::pair<double, bool>> all;
+	all.reserve(n1 + n2);
+	for (const double value : a)
+		all.emplace_back(value, true);
+	for (const double value : b)
+		all.emplace_back(value, false);
+	std::ranges::sort(all, {}, &std::pair<double, bool>::first);
+
+	double rankSumA = 0;
+	double tieTerm = 0;
+	for (std::size_t i = 0; i < all.size();) {
+		std::size_t j = i;
+		while (j < all.size() && all[j].first == all[i].first)
+			++j;
+		const double rank = static_cast<double>(i + j + 1) / 2;
+		for (std::size_t k = i; k < j; ++k) {
+			if (all[k].second)
+				rankSumA += rank;
+		}
+		const double ties = static_cast<double>(j - i);
+		tieTerm += ties * ties * ties - ties;
+		i = j;
+	}
+
+	const double u = rankSumA - static_cast<double>(n1 * (n1 + 1)) / 2;
+
+	if (tieTerm == 0 && n1 <= MaxExactSampleSize && n2 <= MaxExactSampleSize) {
+		const auto frequencies = ExactUFrequencies(n1, n2);
+		double total = 0;
+		double atMost = 0;
+		double atLeast = 0;
+		for (std::size_t i = 0; i < frequencies.size(); ++i) {
+			total += frequencies[i];
+			if (static_cast<double>(i) <= u)
+				atMost += frequencies[i];
+			if (static_cast<double>(i) >= u)
+				atLeast += frequencies[i];
+		}
+		return std::min(1.0, 2 * std::min(atMost, atLeast) / total);
+	}
+
+	const double n = static_cast<double>(n1 + n2);
+	const double mean = static_cast<double>(n1 * n2) / 2;
+	const double variance = static_cast<double>(n1 * n2) / 12 * ((n + 1) - tieTerm / (n * (n - 1)));
+	if (variance <= 0)
+		return 1;
+
+	// With continuity correction.
+	const double z = std::max(0.0, std::abs(u - mean) - 0.5) / std::sqrt(variance);
+	return std::min(1.0, std::erfc(z / std::sqrt(2.0)));
+}
+
+} // bench_stats
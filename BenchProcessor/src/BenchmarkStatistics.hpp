@@ -0,0 +1,31 @@
+#ifndef INCLUDE_CTP_BENCHMARK_PROCESSOR_STATISTICS_HPP
+#define INCLUDE_CTP_BENCHMARK_PROCESSOR_STATISTICS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// Robust statistics for comparing repetitions of benchmarks.
+namespace bench_stats {
+
+// Reorders the samples. Zero if there are none.
+double Median(std::span<double> samples);
+// Median of the absolute deviations from the median, unscaled.
+double MedianAbsoluteDeviation(std::span<const double> samples, double median);
+
+struct Interval {
+	double low = 0;
+	double high = 0;
+};
+
+// Percentile bootstrap interval of the relative change in median, median(contender) / median(baseline) - 1.
+// Seeded, so the same samples give the same interval.
+Interval BootstrapChangeInterval(std::span<const double> baseline, std::span<const double> contender, double confidence, std::size_t resamples, std::uint64_t seed = 0);
+
+// Two-sided p-value of the Mann-Whitney U test, that neither sample tends to be larger than the other.
+// Exact for small samples without ties, otherwise the normal approximation with tie correction.
+double MannWhitneyU(std::span<const double> a, std::span<const double> b);
+
+} // bench_stats
+
+#endif // INCLUDE_CTP_BENCHMARK_PROCESSOR_STATISTICS_HPP
@@ -0,0 +1,115 @@
+#include "MappedFile.hpp"
+
+#include <Tools/config.hpp>
+
+#if CTP_WINDOWS
+#include <Tools/windows.hpp>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <utility>
+
+namespace bench_parse {
+
+MappedFile::MappedFile(const std::string& fileName) {
+#if CTP_WINDOWS
+	const HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return;
+
+	LARGE_INTEGER size{};
+	if (!GetFileSizeEx(file, &size)) {
+		CloseHandle(file);
+		return;
+	}
+
+	size_ = static_cast<std::size_t>(size.QuadPart);
+	if (size_ == 0) {
+		CloseHandle(file);
+		open_ = true;
+		return;
+	}
+
+	// The view keeps the mapping alive, so the handles aren't needed after mapping.
+	const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (!mapping) {
+		size_ = 0;
+		return;
+	}
+
+	data_ = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	CloseHandle(mapping);
+	if (!data_) {
+		size_ = 0;
+		return;
+	}
+#else
+	const int fd = ::open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd == -1)
+		return;
+
+	struct stat info{};
+	if (fstat(fd, &info) != 0) {
+		::close(fd);
+		return;
+	}
+
+	size_ = static_cast<std::size_t>(info.st_size);
+	if (size_ == 0) {
+		::close(fd);
+		open_ = true;
+		return;
+	}
+
+	// The mapping keeps the file alive, so the descriptor isn't needed after mapping.
+	void* const data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (data == MAP_FAILED) {
+		size_ = 0;
+		return;
+	}
+
+	madvise(data, size_, MADV_SEQUENTIAL);
+	data_ = static_cast<const char*>(data);
+#endif
+	open_ = true;
+}
+
+MappedFile::~MappedFile() {
+	Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+	: data_{std::exchange(other.data_, nullptr)}
+	, size_{std::exchange(other.size_, 0)}
+	, open_{std::exchange(other.open_, false)} {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+	if (this != &other) {
+		Close();
+		data_ = std::exchange(other.data_, nullptr);
+		size_ = std::exchange(other.size_, 0);
+		open_ = std::exchange(other.open_, false);
+	}
+	return *this;
+}
+
+void MappedFile::Close() noexcept {
+	if (data_) {
+#if CTP_WINDOWS
+		UnmapViewOfFile(data_);
+#else
+		munmap(const_cast<char*>(data_), size_);
+#endif
+	}
+	data_ = nullptr;
+	size_ = 0;
+	open_ = false;
+}
+
+} // bench_parse
@@ -0,0 +1,33 @@
+#ifndef INCLUDE_CTP_BENCHMARK_PROCESSOR_MAPPED_FILE_HPP
+#define INCLUDE_CTP_BENCHMARK_PROCESSOR_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace bench_parse {
+
+// Read-only view of a whole file, mapped into memory. Views into it stay valid when it's moved.
+class MappedFile {
+public:
+	MappedFile() = default;
+	explicit MappedFile(const std::string& fileName);
+	~MappedFile();
+
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+
+	bool IsOpen() const noexcept { return open_; }
+	std::string_view View() const noexcept { return {data_, size_}; }
+
+private:
+	void Close() noexcept;
+
+	const char* data_ = nullptr;
+	std::size_t size_ = 0;
+	bool open_ = false;
+};
+
+} // bench_parse
+
+#endif // INCLUDE_CTP_BENCHMARK_PROCESSOR_MAPPED_FILE_HPP
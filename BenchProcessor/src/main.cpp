@@ -1,182 +1,383 @@
+#include "BenchmarkCompare.hpp"
+#include "BenchmarkFiles.hpp"
+#include "BenchmarkHistory.hpp"
 #include "BenchmarkResultsParse.hpp"
+#include "MappedFile.hpp"
+
+#include <Tools/perf_counters.hpp>
+
+#include <fmt/format.h>
 
 #include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 
 using namespace std::literals;
 
 namespace {
 
+constexpr auto Usage =
+	"Usage: BenchmarkProcessor <results> [<out.csv> | --out <out.csv>]\n"
+	"       BenchmarkProcessor <results|directory|pattern>... [--merge <out.csv>] [--jobs <n>]\n"sv;
+
 constexpr auto BaseTimeBenchPrefix = "BaseTime_"sv;
 
 struct BaseTimeInfo {
-	std::string line;
 	std::string_view suffix;
-	double cpuTime = 0;
+	bench_parse::ResultRow row;
+	std::vector<bench_parse::CounterValue> counters;
 };
 
 struct FileContents {
-	std::vector<std::string> document;
+	std::string fileName;
+	bench_parse::MappedFile file;
+	bench_parse::ResultsHeader header;
 	std::vector<BaseTimeInfo> baseTimeInfos;
-	std::optional<std::size_t> labelFieldIndex;
+	// Per counter name, if it's a hardware counter from ctp::perf_counters, adjusted by base-times like the cpu time.
+	std::vector<bool> adjustCounters;
+	// Per counter name, its column among the counters of the output, which merges those of several files.
+	std::vector<std::size_t> counterColumns;
 };
 
-[[nodiscard]] FileContents ParseFile(const std::string& fileName) {
-	std::ifstream file{fileName};
-	if (!file.is_open()) {
-		std::cerr << "Failed to open file [" << fileName << "].\n";
-		std::terminate();
-	}
+struct Options {
+	std::vector<std::string> inputs;
+	// Only when processing a single file, otherwise each is written next to its input.
+	std::string outFile;
+	// Writes the results of all files to this one, with a run column, instead of one per input.
+	std::string mergeFile;
+	std::size_t jobs = std::max(1u, std::thread::hardware_concurrency());
+};
 
+// Finds the base-times and counters, which ProcessFile needs before it can write any row.
+[[nodiscard]] std::optional<FileContents> ParseFile(const std::string& fileName) {
 	FileContents fileContents;
+	fileContents.fileName = fileName;
 
-	fileContents.document.reserve(100);
-	fileContents.baseTimeInfos.reserve(20);
+	// Each message in one write, as files are parsed in parallel.
+	fileContents.file = bench_parse::MappedFile{fileName};
+	if (!fileContents.file.IsOpen()) {
+		fmt::print(stderr, "Failed to open file [{}].\n", fileName);
+		return std::nullopt;
+	}
 
-	std::string line;
-	while (file >> line) {
-		if (line.empty())
-			continue;
+	const bool parsed = bench_parse::ParseResults(fileContents.file.View(), fileContents.header, [&](const bench_parse::ResultRow& row, const std::span<const bench_parse::CounterValue> counters) {
+		const auto testName = bench_parse::GetFixtureTestName(row.name);
+		if (!testName.value.starts_with(BaseTimeBenchPrefix))
+			return;
 
-		// Quick-and-dirty check for a test case label.
-		if (line[0] == '\"') {
-			const auto [pos, testName] = bench_parse::GetFixtureTestName(line);
-			if (testName.starts_with(BaseTimeBenchPrefix)) {
-				auto& info = fileContents.baseTimeInfos.emplace_back();
-				info.line = std::move(line);
-				info.suffix = bench_parse::GetFixtureTestNameSuffix(info.line).value;
-				info.cpuTime = bench_parse::GetCPUTime(info.line).value;
-			}
-		} else if (const auto pos = line.find("label"sv); pos != std::string::npos) {
-			fileContents.labelFieldIndex = std::count(line.begin(), line.begin() + pos, ',');
-		}
+		// Repetitions use the first run.
+		const auto suffix = bench_parse::GetFixtureTestNameSuffix(row.name, testName).value;
+		if (std::ranges::find(fileContents.baseTimeInfos, suffix, &BaseTimeInfo::suffix) == fileContents.baseTimeInfos.end())
+			fileContents.baseTimeInfos.push_back({suffix, row, {counters.begin(), counters.end()}});
+	});
+
+	if (!parsed) {
+		fmt::print(stderr, "Document is corrupted, or does not have correct format (see file [{}]).\n", fileName);
+		return std::nullopt;
+	}
 
-		if (!line.empty())
-			fileContents.document.push_back(std::move(line));
+	for (const auto counterName : fileContents.header.counterNames) {
+		fileContents.adjustCounters.push_back(std::ranges::any_of(ctp::AllPerfEvents, [counterName](const ctp::perf_event event) {
+			return ctp::name(event) == counterName;
+		}));
 	}
 
 	return fileContents;
 }
 
-void SetTestMetaData(std::string& line, const std::string_view testName, const std::string_view testNameSuffix, const std::optional<std::size_t> labelField) {
-	bool labelFieldSet = false;
-	std::size_t labelPos;
-	if (labelField) {
-		labelPos = bench_parse::RecursiveFind(line, ',', *labelField);
+// Gives the counters of a file their columns, adding any the output doesn't have yet.
+void AddCounterColumns(FileContents& fileContents, std::vector<std::string>& counterNames) {
+	for (const auto counterName : fileContents.header.counterNames) {
+		std::string name;
+		bench_parse::AppendUnescaped(name, counterName, fileContents.header.format);
+		auto it = std::ranges::find(counterNames, name);
+		if (it == counterNames.end())
+			it = counterNames.insert(it, std::move(name));
+		fileContents.counterColumns.push_back(static_cast<std::size_t>(it - counterNames.begin()));
+	}
+}
 
-		if (labelPos == std::string::npos) {
-			std::cerr << "Document is corrupted, or does not have correct format (see line [" << line << "]).\n";
-			std::terminate();
-		}
+void AppendHeader(std::string& out, const std::span<const std::string> counterNames, const bool runColumn) {
+	out += "name,iterations,real_time,cpu_time,time_unit,bytes_per_second,items_per_second,label,error_occurred,error_message"sv;
+	for (const auto& counterName : counterNames) {
+		out += ',';
+		bench_parse::AppendCsvText(out, counterName);
+	}
+	out += runColumn ? ",category,run\n"sv : ",category\n"sv;
+}
 
-		++labelPos; // Skip the comma.
+void AppendRow(std::string& out, const FileContents& fileContents, const std::size_t counterColumnCount, const std::string_view run, const bench_parse::ResultRow& row, const std::span<const bench_parse::CounterValue> counters) {
+	const auto format = fileContents.header.format;
+	const auto& baseTimeInfos = fileContents.baseTimeInfos;
+
+	const auto [label, category, testNameSuffix] = bench_parse::GetTestMetaData(row.name);
+
+	const auto it = testNameSuffix.empty() ? baseTimeInfos.end() : std::ranges::find(baseTimeInfos, testNameSuffix, &BaseTimeInfo::suffix);
+	const BaseTimeInfo* const baseTime = it != baseTimeInfos.end() ? &*it : nullptr;
+
+	bench_parse::AppendCsvString(out, row.name, format);
+	out += ',';
+	out += row.iterations;
+	out += ',';
+	out += row.realTimeText;
+	out += ',';
+	if (baseTime && !row.cpuTimeText.empty() && !baseTime->row.cpuTimeText.empty())
+		bench_parse::AppendNumber(out, row.cpuTime - baseTime->row.cpuTime);
+	else
+		out += row.cpuTimeText;
+	out += ',';
+	out += row.timeUnit;
+	out += ',';
+	out += row.bytesPerSecond;
+	out += ',';
+	out += row.itemsPerSecond;
+	out += ',';
+
+	if (!row.label.empty())
+		bench_parse::AppendCsvString(out, row.label, format);
+	else
+		bench_parse::AppendCsvString(out, label, bench_parse::ResultsFormat::CSV);
+	out += ',';
+	if (row.errorOccurred)
+		out += "true"sv;
+	out += ',';
+	bench_parse::AppendCsvString(out, row.errorMessage, format);
+
+	// Counters are left empty when they weren't available, so only adjust those both runs have.
+	const auto counterColumn = [&fileContents](const bench_parse::CounterValue& counter) { return fileContents.counterColumns[counter.nameIndex]; };
+	for (std::size_t column = 0; column < counterColumnCount; ++column) {
+		out += ',';
+		const auto counter = std::ranges::find(counters, column, counterColumn);
+		if (counter == counters.end())
+			continue;
 
-		labelFieldSet = labelPos != line.size() && line[labelPos] != ',';
-	} else {
-		line += ',';
-		labelPos = line.size();
+		if (baseTime && fileContents.adjustCounters[counter->nameIndex]) {
+			const auto baseCounter = std::ranges::find(baseTime->counters, counter->nameIndex, &bench_parse::CounterValue::nameIndex);
+			if (baseCounter != baseTime->counters.end()) {
+				bench_parse::AppendNumber(out, counter->value - baseCounter->value);
+				continue;
+			}
+		}
+		out += counter->text;
 	}
 
-	// The category is the test name suffix without any arg info.
-	auto category_view = testName;
-	while (!testNameSuffix.starts_with(category_view))
-		category_view.remove_prefix(1);
+	out += ',';
+	out += category;
+	if (!run.empty()) {
+		out += ',';
+		bench_parse::AppendCsvText(out, run);
+	}
+	out += '\n';
+}
 
-	// Copy view data before potentially reallocating line.
-	const auto category = std::string{category_view};
-	const auto label = std::string{testName.substr(0, testName.size() - category.size() - 1)};
+// Subtract any matching base-times from test times, and fill in the label field and category field.
+void ProcessFile(std::string& out, const FileContents& fileContents, const std::size_t counterColumnCount, const std::string_view run) {
+	out.reserve(out.size() + fileContents.file.View().size() + fileContents.file.View().size() / 8);
 
-	line.reserve(line.size() + testName.size() * 2);
+	// Counters are found in the same order as ParseFile found them.
+	bench_parse::ResultsHeader header;
+	bench_parse::ParseResults(fileContents.file.View(), header, [&](const bench_parse::ResultRow& row, const std::span<const bench_parse::CounterValue> counters) {
+		AppendRow(out, fileContents, counterColumnCount, run, row, counters);
+	});
+}
 
-	if (!labelFieldSet) {
-		line.insert(labelPos, label);
+bool WriteFile(const std::string& fileName, const std::string_view text) {
+	std::ofstream out{fileName, std::ios::out | std::ios::binary | std::ios::trunc};
+	if (!out.is_open()) {
+		fmt::print(stderr, "Failed to open out file [{}].\n", fileName);
+		return false;
 	}
+	out.write(text.data(), static_cast<std::streamsize>(text.size()));
+	return true;
+}
 
-	line += ',';
-	line.append(category);
+std::string ProcessedFileName(std::string fileName) {
+	if (const auto extPos = fileName.rfind('.'); extPos != std::string::npos)
+		fileName.erase(extPos, fileName.size() - extPos);
+	fileName.append("_processed.csv"sv);
+	return fileName;
 }
 
-void ProcessFile(FileContents& fileContents) {
-	auto& baseTimeInfos = fileContents.baseTimeInfos;
+// Calls work(i) for each i below count, on up to jobs threads, taking the next index as each finishes.
+template <typename Work>
+void ForEachParallel(const std::size_t count, const std::size_t jobs, const Work& work) {
+	std::atomic<std::size_t> next = 0;
+	const auto worker = [&] {
+		for (std::size_t i = next++; i < count; i = next++)
+			work(i);
+	};
+
+	std::vector<std::jthread> threads;
+	for (std::size_t i = 1; i < std::min(jobs, count); ++i)
+		threads.emplace_back(worker);
+	worker();
+}
 
-	// Subtract any matching base-times from test times. Add label field if it doesn't exist, and category field.
-	for (auto& line : fileContents.document) {
-		if (line[0] != '\"') {
-			if (!fileContents.labelFieldIndex)
-				line.append(",label"sv);
-			line.append(",category"sv);
-			continue;
+// Each file to its own processed file. Returns the exit code.
+int ProcessEach(const std::vector<std::string>& files, const Options& options) {
+	std::vector<std::string> outFiles;
+	for (const auto& file : files)
+		outFiles.push_back(options.outFile.empty() ? ProcessedFileName(file) : options.outFile);
+
+	// Files are processed in parallel, so two writing the same output would lose one of them.
+	std::vector<std::size_t> order(files.size());
+	for (std::size_t i = 0; i < order.size(); ++i)
+		order[i] = i;
+	std::ranges::stable_sort(order, {}, [&outFiles](const std::size_t i) -> const std::string& { return outFiles[i]; });
+	const auto same = std::ranges::adjacent_find(order, {}, [&outFiles](const std::size_t i) -> const std::string& { return outFiles[i]; });
+	if (same != order.end()) {
+		std::cerr << "Both [" << files[same[0]] << "] and [" << files[same[1]] << "] would be processed into ["
+			<< outFiles[same[0]] << "]. Process them separately, or use --merge.\n";
+		return 2;
+	}
+
+	std::atomic<int> exitCode = 0;
+	ForEachParallel(files.size(), options.jobs, [&](const std::size_t i) {
+		auto fileContents = ParseFile(files[i]);
+		if (!fileContents) {
+			exitCode = 2;
+			return;
 		}
 
-		std::decay_t<decltype(baseTimeInfos)>::const_iterator it;
+		std::vector<std::string> counterNames;
+		AddCounterColumns(*fileContents, counterNames);
 
-		// Modify line with metadata.
-		{
-			const auto testName = bench_parse::GetFixtureTestName(line);
-			const auto testNameSuffix = bench_parse::GetFixtureTestNameSuffix(line, testName).value;
+		std::string processed;
+		AppendHeader(processed, counterNames, false);
+		ProcessFile(processed, *fileContents, counterNames.size(), {});
 
-			if (testNameSuffix.empty())
-				continue;
+		const auto& outFile = outFiles[i];
+		if (!WriteFile(outFile, processed)) {
+			exitCode = 3;
+			return;
+		}
+		fmt::print("Processed [{}] into [{}].\n", files[i], outFile);
+	});
+	return exitCode;
+}
 
-			it = std::ranges::find(baseTimeInfos, testNameSuffix, &BaseTimeInfo::suffix);
+// All files into one, in the order given, with a run column. Returns the exit code.
+int ProcessMerged(const std::vector<std::string>& files, const Options& options) {
+	std::vector<std::optional<FileContents>> contents(files.size());
+	ForEachParallel(files.size(), options.jobs, [&](const std::size_t i) { contents[i] = ParseFile(files[i]); });
+	if (std::ranges::any_of(contents, [](const auto& fileContents) { return !fileContents; }))
+		return 2;
 
-			SetTestMetaData(line, testName.value, testNameSuffix, fileContents.labelFieldIndex);
-		}
+	// The columns need every file's counters before any row is written.
+	std::vector<std::string> counterNames;
+	for (auto& fileContents : contents)
+		AddCounterColumns(*fileContents, counterNames);
+
+	std::ofstream out{options.mergeFile, std::ios::out | std::ios::binary | std::ios::trunc};
+	if (!out.is_open()) {
+		fmt::print(stderr, "Failed to open out file [{}].\n", options.mergeFile);
+		return 3;
+	}
+
+	std::string header;
+	AppendHeader(header, counterNames, true);
+	out.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+	// A batch per thread at a time, written in order, so only that many outputs are held at once.
+	std::vector<std::string> parts(std::min(options.jobs, files.size()));
+	for (std::size_t batch = 0; batch < files.size(); batch += parts.size()) {
+		const auto batchSize = std::min(parts.size(), files.size() - batch);
+		ForEachParallel(batchSize, options.jobs, [&](const std::size_t i) {
+			parts[i].clear();
+			ProcessFile(parts[i], *contents[batch + i], counterNames.size(), bench_files::RunName(files[batch + i]));
+		});
+		for (std::size_t i = 0; i < batchSize; ++i)
+			out.write(parts[i].data(), static_cast<std::streamsize>(parts[i].size()));
+	}
 
-		if (it == baseTimeInfos.end())
+	fmt::print("Merged {} files into [{}].\n", files.size(), options.mergeFile);
+	return 0;
+}
+
+std::optional<Options> ParseOptions(const std::span<const char* const> args) {
+	Options options;
+	for (std::size_t i = 0; i < args.size(); ++i) {
+		const std::string_view arg = args[i];
+		if (!arg.starts_with("--"sv)) {
+			options.inputs.emplace_back(arg);
 			continue;
+		}
 
-		const BaseTimeInfo& BaseTimeInfo = *it;
+		if (i + 1 == args.size()) {
+			std::cerr << "Missing value of [" << arg << "].\n" << Usage;
+			return std::nullopt;
+		}
+		const std::string_view value = args[++i];
+
+		bool valid = true;
+		if (arg == "--merge"sv) {
+			options.mergeFile = value;
+		} else if (arg == "--out"sv) {
+			options.outFile = value;
+		} else if (arg == "--jobs"sv) {
+			const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), options.jobs);
+			valid = ec == std::errc{} && ptr == value.data() + value.size() && options.jobs > 0;
+		} else {
+			valid = false;
+		}
 
-		const auto lineTimeInfo = bench_parse::GetCPUTime(line);
+		if (!valid) {
+			std::cerr << "Invalid option [" << arg << ' ' << value << "].\n" << Usage;
+			return std::nullopt;
+		}
+	}
 
-		const auto adjustedTime = lineTimeInfo.value - BaseTimeInfo.cpuTime;
+	if (!options.outFile.empty() && (options.inputs.size() != 1 || !options.mergeFile.empty())) {
+		std::cerr << "--out takes a single input, without --merge.\n" << Usage;
+		return std::nullopt;
+	}
 
-		bench_parse::OverwriteCPUTime(line, adjustedTime, std::make_pair(lineTimeInfo.startPos, lineTimeInfo.endPos));
+	// The original form, one file and where to write it, as long as that isn't a directory or pattern to read.
+	// An existing file named like results is processed as a second input, rather than overwritten.
+	if (args.size() == 2 && options.inputs.size() == 2 && options.inputs[1].find_first_of("*?"sv) == std::string::npos
+		&& !std::filesystem::is_directory(options.inputs[1])
+		&& !(std::filesystem::exists(options.inputs[1]) && bench_files::IsResultsFile(options.inputs[1]))) {
+		options.outFile = std::move(options.inputs[1]);
+		options.inputs.pop_back();
 	}
+
+	return options;
 }
 
 } // namespace
 
 int main(int argc, char* argv[])
 {
-	std::string fileName;
-	if (argc >= 2) {
-		fileName = argv[1];
-	} else {
-		std::cout << "Provide file name: ";
-		std::cin >> fileName;
-	}
-
-	auto fileContents = ParseFile(fileName);
-
-	ProcessFile(fileContents);
-
-	if (argc > 2) {
-		fileName = argv[2];
-	} else {
-		if (const auto extPos = fileName.rfind('.'); extPos != std::string::npos)
-			fileName.erase(extPos, fileName.size() - extPos);
-		fileName.append("_processed.csv"sv);
+	if (argc >= 2 && argv[1] == "--compare"sv) {
+		const auto options = bench_compare::ParseCompareOptions({argv + 2, argv + argc});
+		return options ? bench_compare::Compare(*options) : 2;
 	}
+	if (argc >= 2 && argv[1] == "--history"sv)
+		return bench_history::RunHistoryCommand({argv + 2, argv + argc});
 
-	std::ofstream out{fileName, std::ios::out | std::ios::trunc};
-
-	if (!out.is_open()) {
-		for (const auto& line : fileContents.document)
-			std::cout << line << '\n';
+	auto options = ParseOptions({argv + 1, argv + argc});
+	if (!options)
+		return 2;
 
-		std::cerr << "Failed to open out file [" << fileName << "]\n.";
-		return 3;
+	if (options->inputs.empty()) {
+		std::string fileName;
+		std::cout << "Provide file name: ";
+		std::cin >> fileName;
+		options->inputs.push_back(std::move(fileName));
 	}
 
-	for (const auto& line : fileContents.document) {
-		std::cout << line << '\n';
-		out << line << '\n';
-	}
+	std::vector<std::string> files;
+	if (!bench_files::ExpandInputs(options->inputs, files))
+		return 2;
 
-	return 0;
+	return options->mergeFile.empty() ? ProcessEach(files, *options) : ProcessMerged(files, *options);
 }
@@ -0,0 +1,36 @@
+#include <Tools/binary_log.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace std::literals;
+
+// Renders a binary log as text. Writes to the second argument if given, otherwise to stdout.
+
+int main(int argc, char* argv[])
+{
+	std::string fileName;
+	if (argc >= 2) {
+		fileName = argv[1];
+	} else {
+		std::cout << "Provide file name: ";
+		std::cin >> fileName;
+	}
+
+	std::ofstream out;
+	if (argc > 2) {
+		out.open(argv[2], std::ios::out | std::ios::trunc);
+		if (!out.is_open()) {
+			std::cerr << "Failed to open out file [" << argv[2] << "].\n";
+			return 3;
+		}
+	}
+
+	if (!ctp::binlog::decode_file(fileName, out.is_open() ? out : std::cout)) {
+		std::cerr << "File [" << fileName << "] is missing, or not a valid binary log.\n";
+		return 2;
+	}
+
+	return 0;
+}
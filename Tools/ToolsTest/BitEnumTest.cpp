@@ -1,6 +1,8 @@
 #include <catch.hpp>
 #include <Tools/BitEnum.hpp>
+#include <array>
 #include <cstdint>
+#include <vector>
 
 namespace ctp {
 namespace {
@@ -112,3 +114,84 @@ TEST_CASE("BitEnum operations.", "[BitEnum]")
 		}
 	}
 }
+
+namespace {
+template <typename U>
+struct SpanTestEnum {
+	enum class type : U {
+		none = 0,
+		a = 0b0001,
+		b = 0b0010,
+		c = 0b0100,
+		high = U{1} << (sizeof(U) * 8 - 1),
+	};
+};
+
+// Check the span operations against testing each flag on its own, for a size that leaves a partial block.
+template <typename U>
+void check_span_operations() {
+	using E = typename SpanTestEnum<U>::type;
+	using namespace ctp;
+	constexpr std::size_t Count = 150;
+
+	std::vector<BitEnum<E>> flags;
+	for (std::size_t i = 0; i < Count; ++i) {
+		BitEnum<E> f;
+		if (i % 2 == 0) f.set(E::a);
+		if (i % 3 == 0) f.set(E::b);
+		if (i % 5 == 0) f.set(E::high);
+		flags.push_back(f);
+	}
+
+	const BitEnum mask{E::a, E::high};
+	std::vector<std::uint32_t> anyIndices;
+	std::vector<std::uint32_t> allIndices;
+	for (std::size_t i = 0; i < Count; ++i) {
+		if (flags[i].any_of(mask)) anyIndices.push_back(static_cast<std::uint32_t>(i));
+		if (flags[i].all_of(mask)) allIndices.push_back(static_cast<std::uint32_t>(i));
+	}
+
+	CHECK(anyIndices.size() == count_any_of(flags, mask));
+	CHECK(allIndices.size() == count_all_of(flags, mask));
+	CHECK(0 == count_any_of(flags, BitEnum{E::c}));
+	CHECK(Count == count_all_of(flags, BitEnum<E>{}));
+
+	std::vector<std::uint32_t> indices(Count);
+	indices.resize(select_any_of(flags, mask, std::span{indices}));
+	CHECK(anyIndices == indices);
+	indices.resize(Count);
+	indices.resize(select_all_of(flags, mask, std::span{indices}));
+	CHECK(allIndices == indices);
+
+	std::array<std::uint64_t, (Count + 63) / 64> bits{};
+	CHECK(allIndices.size() == select_all_of(flags, mask, std::span{bits}));
+	for (std::size_t i = 0; i < Count; ++i)
+		CHECK(((bits[i / 64] >> (i % 64)) & 1) == flags[i].all_of(mask));
+
+	set_all(flags, BitEnum{E::c});
+	CHECK(Count == count_all_of(flags, BitEnum{E::c}));
+	unset_all(flags, BitEnum{E::a, E::c});
+	CHECK(0 == count_any_of(flags, BitEnum{E::a, E::c}));
+	CHECK((Count + 2) / 3 == count_any_of(flags, BitEnum{E::b}));
+}
+
+constexpr bool span_operations_constexpr() {
+	using namespace ctp;
+	std::array<BitEnum<TestEnum>, 3> flags{BitEnum{TestEnum::one}, BitEnum{TestEnum::one, TestEnum::two}, BitEnum<TestEnum>{}};
+	std::array<std::uint32_t, 3> indices{};
+	set_all(flags, BitEnum{TestEnum::three});
+	return count_any_of(flags, BitEnum{TestEnum::two}) == 1
+		&& count_all_of(flags, BitEnum{TestEnum::one, TestEnum::three}) == 2
+		&& select_all_of(flags, BitEnum{TestEnum::one}, std::span{indices}) == 2
+		&& indices[0] == 0 && indices[1] == 1;
+}
+static_assert(span_operations_constexpr());
+} // namespace
+
+TEST_CASE("BitEnum span operations.", "[BitEnum]")
+{
+	check_span_operations<std::uint8_t>();
+	check_span_operations<std::uint16_t>();
+	check_span_operations<std::uint32_t>();
+	check_span_operations<std::uint64_t>();
+}
@@ -1,5 +1,11 @@
+#include <catch.hpp>
+
 #include <Tools/StrongType.hpp>
+
+#include <array>
 #include <cstdint>
+#include <span>
+#include <vector>
 
 namespace ctp::detail {
 namespace {
@@ -461,5 +467,100 @@ static_assert(func(IndexOne{2}) == 2);
 static_assert(TestIndexOperator{}[IndexOne{2}] == 2);
 
 } // index_type_test
+namespace span_test {
+struct Meters : StrongType<Meters, float>, Arithmetic { using StrongType::StrongType, StrongType::operator=; };
+struct Ticks : StrongType<Ticks, std::int32_t>, Arithmetic { using StrongType::StrongType, StrongType::operator=; };
+struct Handle : StrongType<Handle, std::uint16_t>, InvalidValue {
+	using StrongType::StrongType, StrongType::operator=;
+	static constexpr std::uint16_t invalid_value = 0;
+};
+struct IndexOne : IndexType<IndexOne, std::size_t> { using IndexType::IndexType; };
+struct NotValueLayout : StrongType<NotValueLayout, std::int32_t> {
+	using StrongType::StrongType, StrongType::operator=;
+	std::int32_t extra = 0;
+};
+
+static_assert(ValueLayoutStrongType<Meters>);
+static_assert(ValueLayoutStrongType<const Meters>);
+static_assert(ValueLayoutStrongType<Ticks>);
+static_assert(ValueLayoutStrongType<Handle>);
+static_assert(ValueLayoutStrongType<IndexOne>);
+static_assert(!ValueLayoutStrongType<NotValueLayout>);
+static_assert(!ValueLayoutStrongType<int>);
+
+static_assert(std::is_same_v<decltype(as_values(std::span<Meters>{})), std::span<float>>);
+static_assert(std::is_same_v<decltype(as_values(std::declval<std::span<const Meters, 4>>())), std::span<const float, 4>>);
+static_assert(std::is_same_v<decltype(as_strong<Ticks>(std::span<const std::int32_t>{})), std::span<const Ticks>>);
+
+template <typename T> using test_sum = decltype(sum_values(std::span<const T>{}));
+template <typename T> using test_min = decltype(min_value(std::span<const T>{}));
+template <typename T> using test_scale = decltype(scale_values<T>({}, {}, std::span<T>{}));
+
+static_assert(is_detected_v<test_sum, Meters>);
+static_assert(!is_detected_v<test_sum, Handle>); // Not Summable.
+static_assert(is_detected_v<test_min, Handle>);
+static_assert(!is_detected_v<test_scale, Handle>); // Not Multipliable.
+
+constexpr bool span_operations_constexpr() {
+	std::array<Ticks, 5> ticks{Ticks{3}, Ticks{-1}, Ticks{4}, Ticks{1}, Ticks{5}};
+	std::array<Ticks, 5> out{};
+	add_values<Ticks>(ticks, ticks, out);
+	subtract_values<Ticks>(out, ticks, out);
+	scale_values<Ticks>(out, 2, out);
+	return sum_values(std::span{ticks}) == Ticks{12}
+		&& min_value(std::span{ticks}) == Ticks{-1}
+		&& max_value(std::span{ticks}) == Ticks{5}
+		&& out[1] == Ticks{-2} && out[4] == Ticks{10};
+}
+static_assert(span_operations_constexpr());
+
+// Check the span operations against a loop over the values, for sizes around the number of lanes.
+template <typename S>
+void check_span_operations(const std::size_t count) {
+	using T = typename S::value_type;
+	std::vector<S> lhs;
+	std::vector<S> rhs;
+	for (std::size_t i = 0; i < count; ++i) {
+		lhs.emplace_back(static_cast<T>((i * 7) % 23) - static_cast<T>(11));
+		rhs.emplace_back(static_cast<T>((i * 5) % 17));
+	}
+	const std::span<const T> values = as_values(std::span<const S>{lhs});
+	CHECK(values.data() == &lhs.data()->value);
+	CHECK(values.size() == count);
+	CHECK(as_strong<S>(values).data() == lhs.data());
+
+	T sum{};
+	T min = values[0];
+	T max = values[0];
+	for (const T value : values) {
+		sum += value;
+		min = value < min ? value : min;
+		max = value > max ? value : max;
+	}
+	CHECK(sum_values(std::span{lhs}) == S{sum});
+	CHECK(min_value(std::span{lhs}) == S{min});
+	CHECK(max_value(std::span{lhs}) == S{max});
+
+	std::vector<S> out(count);
+	add_values<S>(lhs, rhs, out);
+	for (std::size_t i = 0; i < count; ++i)
+		CHECK(out[i] == lhs[i] + rhs[i]);
+	subtract_values<S>(out, rhs, out);
+	CHECK(out == lhs);
+	scale_values<S>(lhs, T{3}, out);
+	for (std::size_t i = 0; i < count; ++i)
+		CHECK(out[i] == lhs[i] * S{T{3}});
+}
+
+} // span_test
 } // namespace
 } // ctp::detail
+
+TEST_CASE("StrongType span operations.", "[StrongType]")
+{
+	using namespace ctp::detail::span_test;
+	for (const std::size_t count : {1, 15, 16, 17, 100}) {
+		check_span_operations<Meters>(count);
+		check_span_operations<Ticks>(count);
+	}
+}
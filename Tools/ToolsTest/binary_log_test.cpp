@@ -0,0 +1,112 @@
+#include <catch.hpp>
+
+#include <Tools/binary_log.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace ctp;
+
+namespace {
+
+enum class Colour : std::uint8_t {
+	Red = 3,
+};
+
+std::string log_path(const char* name) {
+	return (std::filesystem::temp_directory_path() / name).string();
+}
+
+void log_in_both(const int file) {
+	ctpBinLogi("in both {}", file);
+}
+
+// Destroyed after the thread's log buffer, when constructed before it.
+struct LogsOnExit {
+	~LogsOnExit() { ctpBinLogi("dropped on exit"); }
+};
+
+} // namespace
+
+TEST_CASE("binary log format checks", "[Tools][binary_log]") {
+	static_assert(0 == binlog::detail::count_fields("no fields"));
+	static_assert(2 == binlog::detail::count_fields("{} and {:>4}"));
+	static_assert(1 == binlog::detail::count_fields("{{escaped}} {}"));
+
+	static_assert(binlog::arg_type::i32 == binlog::detail::arg_type_of<short>());
+	static_assert(binlog::arg_type::u64 == binlog::detail::arg_type_of<std::uint64_t>());
+	static_assert(binlog::arg_type::u32 == binlog::detail::arg_type_of<Colour>());
+	static_assert(binlog::arg_type::f64 == binlog::detail::arg_type_of<float>());
+	static_assert(binlog::arg_type::string == binlog::detail::arg_type_of<const char*>());
+	static_assert(binlog::arg_type::string == binlog::detail::arg_type_of<std::string>());
+	static_assert(binlog::arg_type::pointer == binlog::detail::arg_type_of<int*>());
+}
+
+TEST_CASE("binary log round trip", "[Tools][binary_log]") {
+	const auto path = log_path("ctp_binary_log_test.bin");
+
+	// Disabled until opened.
+	ctpBinLogi("dropped");
+
+	REQUIRE(binlog::open(path));
+	for (int i = 0; i < 3; ++i)
+		ctpBinLogi("loop {}", i);
+	const std::string name = "entity";
+	ctpBinLogw("{} {} at ({:.1f}, {}) {} {}", name, 42u, 1.25, -7LL, Colour::Red, true);
+	ctpBinLoge("char {} and {{braces}}", 'x');
+
+	log_in_both(1);
+
+	std::thread other{[] {
+		static thread_local LogsOnExit logsOnExit;
+		ctpBinLogi("from thread {}", std::string_view{"two"});
+	}};
+	other.join();
+	binlog::close();
+
+	// Disabled after closing.
+	ctpBinLogi("dropped");
+
+	std::ostringstream out;
+	REQUIRE(binlog::decode_file(path, out));
+	const std::string text = out.str();
+
+	CHECK(text.find("dropped") == std::string::npos);
+	CHECK(text.find("Info  ") != std::string::npos);
+	CHECK(text.find("binary_log_test.cpp(") != std::string::npos);
+	CHECK(text.find("loop 0\n") < text.find("loop 1\n"));
+	CHECK(text.find("loop 1\n") < text.find("loop 2\n"));
+	CHECK(text.find("Warn  ") != std::string::npos);
+	CHECK(text.find("entity 42 at (1.2, -7) 3 true\n") != std::string::npos);
+	CHECK(text.find("ERROR") != std::string::npos);
+	CHECK(text.find("char x and {braces}\n") != std::string::npos);
+	CHECK(text.find("from thread two\n") != std::string::npos);
+	CHECK(text.find("in both 1\n") != std::string::npos);
+
+	// Reopening starts a new file, where sites keep their ids.
+	REQUIRE(binlog::open(path));
+	ctpBinLogi("second {}", 2);
+	log_in_both(2);
+	binlog::close();
+
+	out.str({});
+	REQUIRE(binlog::decode_file(path, out));
+	CHECK(out.str().find("loop") == std::string::npos);
+	CHECK(out.str().find("second 2\n") != std::string::npos);
+	CHECK(out.str().find("in both 1\n") == std::string::npos);
+	CHECK(out.str().find("in both 2\n") != std::string::npos);
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("binary log rejects bad data", "[Tools][binary_log]") {
+	std::ostringstream out;
+	CHECK_FALSE(binlog::decode(std::span<const char>{}, out));
+
+	const std::string garbage = "not a binary log at all";
+	CHECK_FALSE(binlog::decode(garbage, out));
+	CHECK(out.str().empty());
+}
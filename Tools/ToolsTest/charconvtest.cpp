@@ -3,6 +3,13 @@
 #include <Tools/test/catch_test_helpers.hpp>
 #include <Tools/charconv.hpp>
 
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
 using namespace std::literals;
 
 namespace ctp {
@@ -49,3 +56,273 @@ TEST_CASE("Charconv conversion helpers.", "[charconv]")
 	TEST_CONSTEXPR bool RunConstexpr = test();
 	test();
 }
+
+TEST_CASE("Charconv floating point conversion.", "[charconv]")
+{
+	using namespace ctp;
+
+	auto test = [] {
+		constexpr auto str = ToConstantString<0.1>();
+		CTP_CHECK(str == "0.1"sv);
+		CTP_CHECK(ToConstantString<1.5f>() == "1.5"sv);
+
+		// Fixed or scientific, whichever is shorter.
+		CTP_CHECK(ToCharsConverter(0.0) == "0"sv);
+		CTP_CHECK(ToCharsConverter(-0.0) == "-0"sv);
+		CTP_CHECK(ToCharsConverter(100.0) == "100"sv);
+		CTP_CHECK(ToCharsConverter(123456.0) == "123456"sv);
+		CTP_CHECK(ToCharsConverter(0.001) == "0.001"sv);
+		CTP_CHECK(ToCharsConverter(1e-7) == "1e-07"sv);
+		CTP_CHECK(ToCharsConverter(1e22) == "1e+22"sv);
+		CTP_CHECK(ToCharsConverter(1.2345e300) == "1.2345e+300"sv);
+		CTP_CHECK(ToCharsConverter(123400000.0) == "123400000"sv);
+
+		// Limits.
+		CTP_CHECK(ToCharsConverter(std::numeric_limits<double>::max()) == "1.7976931348623157e+308"sv);
+		CTP_CHECK(ToCharsConverter(std::numeric_limits<double>::min()) == "2.2250738585072014e-308"sv);
+		CTP_CHECK(ToCharsConverter(std::numeric_limits<double>::denorm_min()) == "5e-324"sv);
+		CTP_CHECK(ToCharsConverter(-std::numeric_limits<double>::lowest()) == "1.7976931348623157e+308"sv);
+		CTP_CHECK(ToCharsConverter(std::numeric_limits<double>::infinity()) == "inf"sv);
+		CTP_CHECK(ToCharsConverter(-std::numeric_limits<float>::infinity()) == "-inf"sv);
+		CTP_CHECK(ToCharsConverter(std::numeric_limits<float>::max()) == "3.4028235e+38"sv);
+		CTP_CHECK(ToCharsConverter(std::numeric_limits<float>::denorm_min()) == "1e-45"sv);
+
+		// Large integers are written exactly.
+		CTP_CHECK(ToCharsConverter(18446744073709551616.0) == "18446744073709551616"sv);
+		CTP_CHECK(ToCharsConverter(9007199254740993.0) == "9007199254740992"sv);
+
+		auto converter = ToCharsConverter{2.5f};
+		CTP_CHECK(converter == "2.5"sv);
+		CTP_CHECK(converter(0.3f) == "0.3"sv);
+
+		return true;
+	};
+
+	TEST_CONSTEXPR bool RunConstexpr = test();
+	test();
+}
+
+TEST_CASE("Charconv floating point conversion matches std::to_chars.", "[charconv]")
+{
+	using namespace ctp;
+
+	std::mt19937_64 rng{1234};
+	auto check = [](const auto value) {
+		std::array<char, 64> expected;
+		const auto expectedEnd = std::to_chars(expected.data(), expected.data() + expected.size(), value).ptr;
+		std::array<char, 64> exact;
+		const auto exactEnd = charconv_detail::shortest_to_chars_exact(exact.data(), value);
+		CHECK(std::string_view{exact.data(), exactEnd} == std::string_view{expected.data(), expectedEnd});
+	};
+
+	for (int i = 0; i < 10000; ++i) {
+		const auto value = std::bit_cast<double>(rng());
+		if (!std::isnan(value))
+			check(value);
+		const auto single = std::bit_cast<float>(static_cast<std::uint32_t>(rng()));
+		if (!std::isnan(single))
+			check(single);
+	}
+	for (int exponent = -320; exponent <= 300; exponent += 10) {
+		for (const double mantissa : {1.0, 1.5, 2.0, 9.999999999999999})
+			check(mantissa * std::pow(10.0, exponent));
+	}
+}
+
+TEST_CASE("Charconv append.", "[charconv]")
+{
+	using namespace ctp;
+
+	auto test = [] {
+		// Room for the longest number, so it's written in place.
+		fixed_string<64> fixed{"x="};
+		AppendChars(fixed, -12);
+		fixed += ',';
+		AppendChars(fixed, 0.25);
+		CTP_CHECK(fixed == "x=-12,0.25"sv);
+
+		// Not enough room for the longest number, but enough for this one.
+		small_string<8> small{"x="};
+		AppendChars(small, 1.5);
+		CTP_CHECK(small == "x=1.5"sv);
+
+		return true;
+	};
+
+	TEST_CONSTEXPR bool RunConstexpr = test();
+	test();
+}
+
+TEST_CASE("Charconv integer parsing.", "[charconv]")
+{
+	using namespace ctp;
+
+	auto test = [] {
+		constexpr FromCharsParser<std::int32_t> parseInt;
+		CTP_CHECK(parseInt("0"sv) == 0);
+		CTP_CHECK(parseInt("-0"sv) == 0);
+		CTP_CHECK(parseInt("123"sv) == 123);
+		CTP_CHECK(parseInt("-123456789"sv) == -123456789);
+		CTP_CHECK(parseInt("2147483647"sv) == std::numeric_limits<std::int32_t>::max());
+		CTP_CHECK(parseInt("-2147483648"sv) == std::numeric_limits<std::int32_t>::min());
+		CTP_CHECK(parseInt("00000000000000000000000000000042"sv) == 42);
+		CTP_CHECK_FALSE(parseInt("2147483648"sv));
+		CTP_CHECK_FALSE(parseInt("-2147483649"sv));
+		CTP_CHECK_FALSE(parseInt(""sv));
+		CTP_CHECK_FALSE(parseInt("-"sv));
+		CTP_CHECK_FALSE(parseInt("+1"sv));
+		CTP_CHECK_FALSE(parseInt(" 1"sv));
+		CTP_CHECK_FALSE(parseInt("12a"sv));
+
+		constexpr FromCharsParser<std::uint64_t> parseU64;
+		CTP_CHECK(parseU64("12345678901234567"sv) == 12345678901234567u);
+		CTP_CHECK(parseU64("18446744073709551615"sv) == std::numeric_limits<std::uint64_t>::max());
+		CTP_CHECK_FALSE(parseU64("18446744073709551616"sv));
+		CTP_CHECK_FALSE(parseU64("99999999999999999999"sv));
+		CTP_CHECK_FALSE(parseU64("100000000000000000000"sv));
+		CTP_CHECK_FALSE(parseU64("-1"sv));
+
+		CTP_CHECK(FromCharsParser<std::int8_t>{}("-128"sv) == std::int8_t{-128});
+		CTP_CHECK_FALSE(FromCharsParser<std::int8_t>{}("128"sv));
+
+		// Like std::from_chars, it stops at the first char that isn't part of the number.
+		constexpr auto text = "1234567890123,5"sv;
+		std::int64_t value = 0;
+		const auto [ptr, ec] = FromCharsParser<std::int64_t>{}.parse(text.data(), text.data() + text.size(), value);
+		CTP_CHECK(ec == std::errc{});
+		CTP_CHECK(ptr == text.data() + 13);
+		CTP_CHECK(value == 1234567890123);
+
+		// Out of range still consumes the number, and leaves the value alone.
+		constexpr auto tooBig = "300 "sv;
+		std::uint8_t byte = 7;
+		const auto result = FromCharsParser<std::uint8_t>{}.parse(tooBig.data(), tooBig.data() + tooBig.size(), byte);
+		CTP_CHECK(result.ec == std::errc::result_out_of_range);
+		CTP_CHECK(result.ptr == tooBig.data() + 3);
+		CTP_CHECK(byte == 7);
+
+		return true;
+	};
+
+	TEST_CONSTEXPR bool RunConstexpr = test();
+	test();
+}
+
+TEST_CASE("Charconv parsing matches std::from_chars.", "[charconv]")
+{
+	using namespace ctp;
+
+	auto check = [](const std::string_view text) {
+		auto checkType = [text]<typename T>(T) {
+			T expected{7};
+			const auto expectedResult = std::from_chars(text.data(), text.data() + text.size(), expected);
+			T actual{7};
+			const auto actualResult = FromCharsParser<T>{}.parse(text.data(), text.data() + text.size(), actual);
+			INFO(text);
+			CHECK(actualResult.ec == expectedResult.ec);
+			CHECK(actualResult.ptr == expectedResult.ptr);
+			CHECK(std::memcmp(&actual, &expected, sizeof(T)) == 0);
+		};
+		checkType(std::int64_t{});
+		checkType(std::uint32_t{});
+		checkType(0.0);
+		checkType(0.0f);
+	};
+
+	for (const auto text : {"0"sv, "-0"sv, "1."sv, ".5"sv, "."sv, "-.e1"sv, "1e"sv, "1e+"sv, "1e-5x"sv, "1E5"sv, "0x10"sv,
+			"inf"sv, "-infinity"sv, "nan"sv, "1e400"sv, "1e-400"sv, "4.9406564584124654e-324"sv, "2.4703282292062327e-324"sv,
+			"2.2250738585072011e-308"sv, "9007199254740993"sv, "1.00000000000000000000000001"sv, "123456789012345678901234567890"sv,
+			"0.000000000000000000000000000001"sv, "3.4028235e38"sv, "3.4028236e38"sv, "1.17549435e-38"sv, "7.038531e-26"sv}) {
+		check(text);
+	}
+
+	std::mt19937_64 rng{5678};
+	for (int i = 0; i < 10000; ++i) {
+		std::string text;
+		if (rng() % 2 != 0)
+			text += '-';
+		const auto digits = static_cast<std::size_t>(rng() % 24) + 1;
+		for (std::size_t j = 0; j < digits; ++j)
+			text += static_cast<char>('0' + rng() % 10);
+		if (rng() % 2 != 0)
+			text.insert(text.size() - rng() % digits, 1, '.');
+		if (rng() % 2 != 0) {
+			text += rng() % 2 != 0 ? "e-" : "e";
+			text += std::to_string(rng() % 400);
+		}
+		check(text);
+	}
+
+	// Shortest strings round-trip.
+	for (int i = 0; i < 10000; ++i) {
+		const auto value = std::bit_cast<double>(rng());
+		if (std::isnan(value))
+			continue;
+		const ToCharsConverter converter{value};
+		CHECK(std::bit_cast<std::uint64_t>(FromCharsParser<double>{}(converter.view()).value()) == std::bit_cast<std::uint64_t>(value));
+	}
+}
+
+TEST_CASE("Charconv bulk integer formatting.", "[charconv]")
+{
+	using namespace ctp;
+
+	// Every length, both signs, and the limits.
+	std::vector<std::int64_t> values{0, std::numeric_limits<std::int64_t>::min(), std::numeric_limits<std::int64_t>::max()};
+	std::int64_t power = 1;
+	for (int digits = 1; digits <= 18; ++digits, power *= 10) {
+		values.push_back(power);
+		values.push_back(power * 10 - 1);
+		values.push_back(-power);
+		values.push_back(-(power * 10 - 1));
+	}
+	std::mt19937_64 rng{91011};
+	for (int i = 0; i < 1000; ++i)
+		values.push_back(static_cast<std::int64_t>(rng() >> (rng() % 64)));
+
+	auto expected = [](const auto& numbers, const char separator) {
+		std::string text;
+		for (const auto value : numbers) {
+			if (!text.empty())
+				text += separator;
+			text += std::to_string(value);
+		}
+		return text;
+	};
+
+	const auto span = std::span<const std::int64_t>{values};
+	const auto text = expected(values, ',');
+	CHECK(format_integers_size(span) == text.size());
+
+	// An exact buffer, so the end is written without room to spare.
+	std::string buffer(text.size(), '\0');
+	CHECK(format_integers(span, ',', std::span<char>{buffer}) == buffer.data() + buffer.size());
+	CHECK(buffer == text);
+
+	std::vector<std::uint64_t> unsignedValues{0, 1, 9, 10, std::numeric_limits<std::uint64_t>::max()};
+	for (int i = 0; i < 1000; ++i)
+		unsignedValues.push_back(rng() >> (rng() % 64));
+	std::string unsignedText = "values:";
+	format_integers(std::span<const std::uint64_t>{unsignedValues}, ' ', unsignedText);
+	CHECK(unsignedText == "values:" + expected(unsignedValues, ' '));
+
+	const std::vector<std::int32_t> smallValues{std::numeric_limits<std::int32_t>::min(), -1, 0, 7, 42, std::numeric_limits<std::int32_t>::max()};
+	small_string<8> small;
+	format_integers(std::span<const std::int32_t>{smallValues}, ';', small);
+	CHECK(small == "-2147483648;-1;0;7;42;2147483647"sv);
+
+	// Narrow negative values promote to int when negated, so their magnitude must not sign extend.
+	const std::vector<std::int8_t> bytes{std::numeric_limits<std::int8_t>::min(), -100, -1, 0, 1, std::numeric_limits<std::int8_t>::max()};
+	std::string byteText;
+	format_integers(std::span<const std::int8_t>{bytes}, ',', byteText);
+	CHECK(format_integers_size(std::span<const std::int8_t>{bytes}) == byteText.size());
+	CHECK(byteText == "-128,-100,-1,0,1,127"sv);
+
+	const std::vector<std::int16_t> shorts{std::numeric_limits<std::int16_t>::min(), -1000, -1, 0, 1, std::numeric_limits<std::int16_t>::max()};
+	std::string shortText;
+	format_integers(std::span<const std::int16_t>{shorts}, ',', shortText);
+	CHECK(format_integers_size(std::span<const std::int16_t>{shorts}) == shortText.size());
+	CHECK(shortText == "-32768,-1000,-1,0,1,32767"sv);
+
+	CHECK(format_integers_size(std::span<const int>{}) == 0);
+}
@@ -0,0 +1,74 @@
+#include <catch.hpp>
+
+#include <Tools/debug.hpp>
+
+#if CTP_LOGGING
+
+using namespace ctp;
+
+TEST_CASE("debug log levels", "[Tools][debug]") {
+	static_assert(debug::IsLogCompiledIn(debug::Stream::Error) || CTP_LOG_LEVEL > 2);
+
+	CHECK(debug::Stream::Log == debug::GetLogLevel());
+	CHECK(debug::IsLogEnabled(debug::Stream::Log));
+
+	debug::SetLogLevel(debug::Stream::Warn);
+	CHECK_FALSE(debug::IsLogEnabled(debug::Stream::Log));
+	CHECK(debug::IsLogEnabled(debug::Stream::Warn));
+	CHECK(debug::IsLogEnabled(debug::Stream::Error));
+
+	debug::SetLogLevel(debug::Stream::Error);
+	CHECK_FALSE(debug::IsLogEnabled(debug::Stream::Warn));
+	CHECK(debug::IsLogEnabled(debug::Stream::Error));
+
+	debug::SetLogLevel(debug::Stream::Log);
+	CHECK(debug::IsLogEnabled(debug::Stream::Log));
+}
+
+TEST_CASE("debug rate limiter", "[Tools][debug]") {
+	constexpr std::int64_t Second = 1'000'000'000;
+
+	SECTION("burst") {
+		// 10 a second, bursts of 3.
+		debug::RateLimiter limiter{10, 3};
+		const std::int64_t start = 50 * Second;
+		CHECK(limiter.TryAcquire(start));
+		CHECK(limiter.TryAcquire(start));
+		CHECK(limiter.TryAcquire(start));
+		CHECK_FALSE(limiter.TryAcquire(start));
+		CHECK_FALSE(limiter.TryAcquire(start + Second / 20));
+
+		// A token per 100ms.
+		CHECK(limiter.TryAcquire(start + Second / 10));
+		CHECK_FALSE(limiter.TryAcquire(start + Second / 10));
+
+		// Refills up to the burst size.
+		const std::int64_t later = start + 10 * Second;
+		int acquired = 0;
+		for (int i = 0; i < 10; ++i)
+			acquired += limiter.TryAcquire(later);
+		CHECK(3 == acquired);
+	}
+
+	SECTION("no burst") {
+		debug::RateLimiter limiter{1, 1};
+		CHECK(limiter.TryAcquire(0));
+		CHECK_FALSE(limiter.TryAcquire(Second - 1));
+		CHECK(limiter.TryAcquire(Second));
+		CHECK_FALSE(limiter.TryAcquire(Second));
+
+		// Zero burst is treated as one.
+		debug::RateLimiter zero{1, 0};
+		CHECK(zero.TryAcquire(0));
+		CHECK_FALSE(zero.TryAcquire(0));
+	}
+
+	SECTION("clock") {
+		debug::RateLimiter limiter{1, 2};
+		CHECK(limiter.TryAcquire());
+		CHECK(limiter.TryAcquire());
+		CHECK_FALSE(limiter.TryAcquire());
+	}
+}
+
+#endif // CTP_LOGGING
@@ -0,0 +1,80 @@
+#include <catch.hpp>
+
+#include <Tools/test/catch_test_helpers.hpp>
+
+#include <Tools/enum_dispatch.hpp>
+
+#include <string_view>
+
+using namespace ctp;
+
+namespace {
+
+enum class E1 {
+	One,
+	Two,
+	Three,
+	Four,
+};
+
+enum class Sparse {
+	NegTen = -10,
+	One = 1,
+	Five = 5,
+	Twenty = 20,
+};
+
+template <Sparse S>
+constexpr int times_two() { return static_cast<int>(S) * 2; }
+
+struct Counter {
+	int calls = 0;
+	int sum = 0;
+
+	template <Sparse V>
+	constexpr void operator()() {
+		++calls;
+		sum += static_cast<int>(V);
+	}
+};
+
+} // namespace
+
+TEST_CASE("enum_dispatch calls the instantiation for the value", "[Tools][enum_dispatch]") {
+	auto test = [] {
+		for (const E1 e : enums::values<E1>()) {
+			// The value is a template argument, so can be used in constant expressions.
+			const auto index = enum_dispatch(e, []<E1 V>() { return std::integral_constant<std::size_t, enums::index<V>()>::value; });
+			CTP_CHECK(enums::index(e) == index);
+		}
+		for (const Sparse e : enums::values<Sparse>())
+			CTP_CHECK((static_cast<int>(e) * 2 == enum_dispatch(e, []<Sparse V>() { return times_two<V>(); })));
+
+		CTP_CHECK(("Three" == enum_dispatch(E1::Three, []<E1 V>() -> std::string_view { return enums::name(V); })));
+		return true;
+	};
+
+	TEST_CONSTEXPR bool RunConstexpr = test();
+	test();
+}
+
+TEST_CASE("enum_dispatch visitor state", "[Tools][enum_dispatch]") {
+	auto test = [] {
+		// Mutable visitors are passed through by reference.
+		Counter counter;
+		enum_dispatch(Sparse::Five, counter);
+		enum_dispatch(Sparse::NegTen, counter);
+		enum_dispatch(Sparse::Twenty, counter);
+		CTP_CHECK(3 == counter.calls);
+		CTP_CHECK(15 == counter.sum);
+
+		// Return a reference through the visitor.
+		int values[4]{};
+		enum_dispatch(E1::Two, [&values]<E1 V>() -> int& { return values[enums::index<V>()]; }) = 5;
+		CTP_CHECK(5 == values[1]);
+		return true;
+	};
+
+	TEST_CONSTEXPR bool RunConstexpr = test();
+	test();
+}
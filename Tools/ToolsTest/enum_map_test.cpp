@@ -4,6 +4,7 @@
 
 #include <Tools/enum_map.hpp>
 
+#include <cstdint>
 #include <string>
 
 using namespace ctp;
@@ -376,6 +377,18 @@ TEST_CASE("indexible_enum_map", "[Tools][enum_map]") {
 		CTP_CHECK(mv[E1::One] == 3);
 		CTP_CHECK(mv[1] == 4);
 		CTP_CHECK(mv[E1::Three] == 1);
+
+		indexible_enum_map<E2, bool> bits{enum_default(false), std::pair{E2::Ten, true}};
+		CTP_CHECK(!bits[0]);
+		CTP_CHECK(bits[2]);
+		CTP_CHECK(bits.at(2));
+		bits[3] = true;
+		CTP_CHECK(bits[E2::Twenty]);
+		bits[E2::Ten] = false;
+		const auto& constBits = bits;
+		CTP_CHECK(!constBits[2]);
+		CTP_CHECK(constBits[3]);
+		CTP_CHECK(constBits.at(E2::Twenty));
 		return true;
 	};
 
@@ -560,3 +573,153 @@ TEST_CASE("Enum map with an enum that has gaps", "[Tools][enum_map]") {
 	TEST_CONSTEXPR bool RunConstexpr = test();
 	test();
 }
+
+TEST_CASE("Enum map bool", "[Tools][enum_map]") {
+	static_assert(sizeof(enum_map<E2, bool>) == sizeof(std::uint64_t));
+
+	auto test = [] {
+		{
+			enum_map<E2, bool> map{false};
+			CTP_CHECK(!map[E2::One]);
+			CTP_CHECK(!map[E2::Twenty]);
+
+			map[E2::Five] = true;
+			map[E2::Twenty] = true;
+			CTP_CHECK(!map[E2::One]);
+			CTP_CHECK(map[E2::Five]);
+			CTP_CHECK(!map[E2::Ten]);
+			CTP_CHECK(map[E2::Twenty]);
+
+			map[E2::Five] = false;
+			CTP_CHECK(!map[E2::Five]);
+			map[E2::One] = map[E2::Twenty];
+			CTP_CHECK(map[E2::One]);
+
+			const auto& constMap = map;
+			CTP_CHECK(constMap[E2::One]);
+			CTP_CHECK(!constMap[E2::Ten]);
+			CTP_CHECK(2 == constMap.as_set().size());
+		}
+		{
+			const enum_map<E1, bool> map(
+				enum_arg<E1::One>(true),
+				enum_arg<E1::Two>(false),
+				enum_arg<E1::Three>(true));
+
+			CTP_CHECK(map[E1::One]);
+			CTP_CHECK(!map[E1::Two]);
+			CTP_CHECK(map[E1::Three]);
+		}
+		{
+			const enum_map<E1, bool> map(enum_default(true), enum_arg<E1::Two>(false));
+			CTP_CHECK(map[E1::One]);
+			CTP_CHECK(!map[E1::Two]);
+			CTP_CHECK(map[E1::Three]);
+		}
+		{
+			const enum_map<E2, bool> map{enum_default(false), std::pair{E2::Ten, true}};
+			CTP_CHECK(!map[E2::One]);
+			CTP_CHECK(map[E2::Ten]);
+		}
+		{
+			enum_map<E1, bool> map{true};
+			map.fill(false);
+			CTP_CHECK(map.as_set().empty());
+			CTP_CHECK((map == enum_map<E1, bool>{enum_set<E1>{}}));
+			map.as_set().insert(E1::Two);
+			CTP_CHECK(map[E1::Two]);
+		}
+		{
+			const enum_map<E1, bool> a(enum_default(false), enum_arg<E1::Three>(true));
+			enum_map<E1, bool> b = a;
+			CTP_CHECK(std::is_eq(a <=> b));
+			CTP_CHECK(a <= b);
+			CTP_CHECK_FALSE(a < b);
+
+			// Compared in key order, so an earlier key decides over a later one.
+			b[E1::Three] = false;
+			b[E1::Two] = true;
+			CTP_CHECK(a < b);
+			CTP_CHECK(b > a);
+			CTP_CHECK(a != b);
+
+			b[E1::Two] = false;
+			CTP_CHECK(a > b);
+			CTP_CHECK(b <= a);
+		}
+		return true;
+	};
+
+	TEST_CONSTEXPR bool RunConstexpr = test();
+	test();
+}
+
+TEST_CASE("Enum map bool has the enum_map API", "[Tools][enum_map]") {
+	auto test = [] {
+		const std::allocator<bool> alloc;
+		enum_map<E2, bool> map(alloc, enum_default(false), std::pair{E2::Five, true}, std::pair{E2::Twenty, true});
+		CTP_CHECK(!map[E2::One]);
+		CTP_CHECK(map[E2::Five]);
+		CTP_CHECK((enum_map<E1, bool>{alloc, true}[E1::Two]));
+		CTP_CHECK((enum_map<E1, bool>{alloc, enum_arg<E1::One>(false), enum_arg<E1::Two>(true), enum_arg<E1::Three>(false)}[E1::Two]));
+
+		CTP_CHECK(map.last()->first == E2::Twenty);
+		CTP_CHECK(map.find(E2::Five)->first == E2::Five);
+		CTP_CHECK(map.find(E2::Five)->second);
+		map.find(E2::Ten)->second = true;
+		CTP_CHECK(map[E2::Ten]);
+		CTP_CHECK(map.lower_bound(E2::Ten) == map.find(E2::Ten));
+		CTP_CHECK(map.upper_bound(E2::Ten) == map.find(E2::Twenty));
+		const auto [first, last] = map.equal_range(E2::Twenty);
+		CTP_CHECK(first == map.last());
+		CTP_CHECK(last == map.end());
+
+		const bool expected[]{false, true, true, true};
+		std::size_t i = 0;
+		for (const bool value : map.values())
+			CTP_CHECK(value == expected[i++]);
+		CTP_CHECK(i == 4);
+
+		map.data()[0] = true;
+		CTP_CHECK(map[E2::One]);
+		const auto& constMap = map;
+		CTP_CHECK(constMap.data()[1]);
+		CTP_CHECK(*constMap.data());
+
+		// Other allocators copy and compare, though the bits never use them.
+		enum_map<E2, bool, std::allocator<char>> other{map};
+		CTP_CHECK(other == map);
+		CTP_CHECK(map == other);
+		other[E2::One] = false;
+		CTP_CHECK(other < map);
+		CTP_CHECK(map != other);
+		other = map;
+		CTP_CHECK(std::is_eq(other <=> map));
+		return true;
+	};
+
+	TEST_CONSTEXPR bool RunConstexpr = test();
+	test();
+}
+
+TEST_CASE("Enum map bool iteration", "[Tools][enum_map]") {
+	auto test = [] {
+		enum_map<E2, bool> map{enum_default(false), std::pair{E2::Five, true}};
+
+		std::size_t i = 0;
+		for (auto [key, value] : map) {
+			CTP_CHECK((key == enum_map<E2, bool>::keys()[i++]));
+			// Flip every value through the proxy.
+			value = !value;
+		}
+		CTP_CHECK((enum_map<E2, bool>::size() == i));
+
+		const auto& constMap = map;
+		for (const auto [key, value] : constMap)
+			CTP_CHECK(value == (key != E2::Five));
+		return true;
+	};
+
+	TEST_CONSTEXPR bool RunConstexpr = test();
+	test();
+}
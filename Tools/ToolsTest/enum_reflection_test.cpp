@@ -5,6 +5,7 @@
 #include <Tools/test/catch_test_helpers.hpp>
 
 #include <array>
+#include <cstdint>
 
 using namespace ctp;
 using namespace std::literals;
@@ -928,6 +929,172 @@ TEST_CASE("enum_reflection index(value)", "[Tools][enum_reflection]") {
 	test();
 }
 
+namespace {
+
+// Too sparse for a lookup table.
+enum class RadixTableEnum {
+	Neg32 = -32,
+	Neg30 = -30,
+	Neg28 = -28,
+	Neg26 = -26,
+	Neg24 = -24,
+	Neg22 = -22,
+	Neg20 = -20,
+	Neg18 = -18,
+	Neg16 = -16,
+	Neg14 = -14,
+	Neg12 = -12,
+	Neg10 = -10,
+	Neg8 = -8,
+	Neg6 = -6,
+	Neg4 = -4,
+	Neg2 = -2,
+	Pos0 = 0,
+	Pos2 = 2,
+	Pos4 = 4,
+	Pos6 = 6,
+	Pos8 = 8,
+	Pos10 = 10,
+	Pos12 = 12,
+	Pos14 = 14,
+	Pos16 = 16,
+	Pos18 = 18,
+	Pos20 = 20,
+	Pos22 = 22,
+	Pos24 = 24,
+	Pos26 = 26,
+	Pos28 = 28,
+	Pos30 = 30,
+	Pos32 = 32,
+	Pos34 = 34,
+	Pos36 = 36,
+	Pos38 = 38,
+	Pos40 = 40,
+	Pos42 = 42,
+	Pos44 = 44,
+	Pos46 = 46,
+	Pos48 = 48,
+	Pos50 = 50,
+	Pos52 = 52,
+	Pos54 = 54,
+	Pos56 = 56,
+	Pos58 = 58,
+	Pos60 = 60,
+	Pos62 = 62,
+	Pos64 = 64,
+	Pos66 = 66,
+	Pos68 = 68,
+	Pos70 = 70,
+	Pos72 = 72,
+	Pos74 = 74,
+	Pos76 = 76,
+	Pos78 = 78,
+	Pos80 = 80,
+	Pos82 = 82,
+	Pos84 = 84,
+	Pos86 = 86,
+	Pos88 = 88,
+	Pos90 = 90,
+	Pos92 = 92,
+	Pos94 = 94,
+	Pos96 = 96,
+	Pos98 = 98,
+	Pos100 = 100,
+	Pos102 = 102,
+	Pos104 = 104,
+	Pos106 = 106,
+};
+
+// Small enough for any strategy, but binary search is forced.
+enum class ForcedBinarySearch {
+	Zero = 0,
+	Two = 2,
+	Four = 4,
+	Eight = 8,
+	Sixteen = 16,
+	ThirtyTwo = 32,
+	SixtyFour = 64,
+	OneTwentyEight = 128,
+};
+
+// Small enough for any strategy, but simd_compare is forced.
+enum class SmallUnderlying : std::int8_t {
+	NegThirtyTwo = -32,
+	NegSixteen = -16,
+	NegOne = -1,
+	Zero = 0,
+	Seven = 7,
+	Nineteen = 19,
+	FiftyFive = 55,
+	OneHundred = 100,
+	OneTwentySeven = 127,
+};
+
+// Check every strategy that is possible for the enum gives the same index.
+template <enums::Enum E>
+constexpr bool check_index_strategies() {
+	using enum enums::index_strategy;
+	const auto& vals = enums::values<E>();
+	for (std::size_t i = 0; i < vals.size(); ++i) {
+		CTP_CHECK(i == enums::index(vals[i]));
+		CTP_CHECK(i == enums::detail::index_with_strategy<linear_search>(vals[i]));
+		CTP_CHECK(i == enums::detail::index_with_strategy<binary_search>(vals[i]));
+		CTP_CHECK(i == enums::detail::index_with_strategy<radix_table>(vals[i]));
+		if constexpr (enums::detail::is_simd_compare_possible<E>())
+			CTP_CHECK(i == enums::detail::index_with_strategy<simd_compare>(vals[i]));
+		if constexpr (enums::detail::value_range_entries<E>() <= 255)
+			CTP_CHECK(i == enums::detail::index_with_strategy<lookup_table>(vals[i]));
+	}
+	return true;
+}
+
+} // namespace
+
+template<>
+struct ctp::enums::enum_traits<ForcedBinarySearch> {
+	static constexpr index_strategy force_index_strategy = index_strategy::binary_search;
+};
+
+template<>
+struct ctp::enums::enum_traits<SmallUnderlying> {
+	static constexpr index_strategy force_index_strategy = index_strategy::simd_compare;
+};
+
+TEST_CASE("enum_reflection index strategies", "[Tools][enum_reflection]") {
+	using enum enums::index_strategy;
+	static_assert(enums::detail::index_strategy_v<NonContiguous> == linear_search);
+	static_assert(enums::detail::index_strategy_v<LookupTableEnum> == lookup_table);
+	static_assert(enums::detail::index_strategy_v<ForceEnabledLookupTable> == lookup_table);
+	static_assert(enums::detail::index_strategy_v<TooSparseForLookupTable> == radix_table);
+	static_assert(enums::detail::index_strategy_v<WideRange> == radix_table);
+	static_assert(enums::detail::index_strategy_v<SmallUnderlying> == simd_compare);
+	static_assert(enums::detail::index_strategy_v<RadixTableEnum> == radix_table);
+	static_assert(enums::detail::index_strategy_v<ForcedBinarySearch> == binary_search);
+
+	auto test = [] {
+		check_index_strategies<NonContiguous>();
+		check_index_strategies<LookupTableEnum>();
+		check_index_strategies<WideRange>();
+		check_index_strategies<PositiveOffset>();
+		check_index_strategies<NegativeOffset>();
+		check_index_strategies<TooSparseForLookupTable>();
+		check_index_strategies<SmallUnderlying>();
+		check_index_strategies<RadixTableEnum>();
+		check_index_strategies<ForcedBinarySearch>();
+
+		CTP_CHECK(0 == enums::index(RadixTableEnum::Neg32));
+		CTP_CHECK(16 == enums::index(RadixTableEnum::Pos0));
+		CTP_CHECK(69 == enums::index(RadixTableEnum::Pos106));
+		CTP_CHECK(0 == enums::index(ForcedBinarySearch::Zero));
+		CTP_CHECK(5 == enums::index(ForcedBinarySearch::ThirtyTwo));
+		CTP_CHECK(7 == enums::index(ForcedBinarySearch::OneTwentyEight));
+		return true;
+	};
+
+	TEST_CONSTEXPR bool RunConstexpr = test();
+	test();
+}
+
 TEST_CASE("enum_reflection try_get_index(value)", "[Tools][enum_reflection]") {
 	auto test = [] {
 		CTP_CHECK(std::nullopt == enums::try_get_index(RangeLimited::One));
@@ -940,3 +1107,113 @@ TEST_CASE("enum_reflection try_get_index(value)", "[Tools][enum_reflection]") {
 	TEST_CONSTEXPR bool RunConstexpr = test();
 	test();
 }
+
+TEST_CASE("enum_reflection names_of", "[Tools][enum_reflection]") {
+	auto test = [] {
+		{
+			constexpr std::array vals = {Contiguous::Three, Contiguous::NegOne, Contiguous{4}, Contiguous::One};
+			std::array<zstring_view, 4> out;
+			CTP_CHECK(out.end() == enums::names_of<Contiguous>(vals, out.begin()));
+			constexpr std::array expected = {"Three"_zv, "NegOne"_zv, ""_zv, "One"_zv};
+			CTP_CHECK(expected == out);
+		}
+		{
+			constexpr std::array vals = {NonContiguous::One, NonContiguous{0}, NonContiguous::NegOne, NonContiguous{-5}, NonContiguous::Three};
+			std::array<zstring_view, 5> out;
+			enums::names_of<NonContiguous>(vals, out.begin());
+			constexpr std::array expected = {"One"_zv, ""_zv, "NegOne"_zv, ""_zv, "Three"_zv};
+			CTP_CHECK(expected == out);
+		}
+		{
+			constexpr std::array vals = {RadixTableEnum::Pos106, RadixTableEnum{-31}, RadixTableEnum::Neg32, RadixTableEnum{108}, RadixTableEnum{-34}};
+			std::array<zstring_view, 5> out;
+			enums::names_of<RadixTableEnum>(vals, out.begin());
+			constexpr std::array expected = {"Pos106"_zv, ""_zv, "Neg32"_zv, ""_zv, ""_zv};
+			CTP_CHECK(expected == out);
+		}
+		{
+			constexpr std::array vals = {SmallUnderlying::OneTwentySeven, SmallUnderlying{1}, SmallUnderlying::NegThirtyTwo};
+			std::array<zstring_view, 3> out;
+			enums::names_of<SmallUnderlying>(vals, out.begin());
+			constexpr std::array expected = {"OneTwentySeven"_zv, ""_zv, "NegThirtyTwo"_zv};
+			CTP_CHECK(expected == out);
+		}
+		return true;
+	};
+
+	TEST_CONSTEXPR bool RunConstexpr = test();
+	test();
+}
+
+TEST_CASE("enum_reflection parse_all", "[Tools][enum_reflection]") {
+	auto test = [] {
+		{
+			constexpr std::array names = {"Two"sv, "NegOne"sv, "Three"sv};
+			std::array<Contiguous, 3> out{};
+			CTP_CHECK(3 == enums::parse_all<Contiguous>(names, out));
+			constexpr std::array expected = {Contiguous::Two, Contiguous::NegOne, Contiguous::Three};
+			CTP_CHECK(expected == out);
+		}
+		{
+			constexpr std::array names = {"Three"sv, "Zero"sv, "One"sv};
+			std::array<NonContiguous, 3> out{};
+			CTP_CHECK(1 == enums::parse_all<NonContiguous>(names, out));
+			CTP_CHECK(NonContiguous::Three == out[0]);
+		}
+		{
+			constexpr std::array names = {"Two"sv, "TwoNumberTwo"sv};
+			std::array<Overlap, 2> out{};
+			CTP_CHECK(1 == enums::parse_all<Overlap>(names, out));
+		}
+		{
+			constexpr std::array names = {"Pos106"sv, "Neg32"sv, "Pos0"sv, ""sv};
+			std::array<RadixTableEnum, 4> out{};
+			CTP_CHECK(3 == enums::parse_all<RadixTableEnum>(names, out));
+			CTP_CHECK(RadixTableEnum::Pos106 == out[0]);
+			CTP_CHECK(RadixTableEnum::Neg32 == out[1]);
+			CTP_CHECK(RadixTableEnum::Pos0 == out[2]);
+		}
+		{
+			// Round trip every name.
+			std::array<RadixTableEnum, enums::size<RadixTableEnum>()> out{};
+			std::array<std::string_view, enums::size<RadixTableEnum>()> names;
+			for (std::size_t i = 0; i < names.size(); ++i)
+				names[i] = enums::names<RadixTableEnum>()[i];
+			CTP_CHECK(names.size() == enums::parse_all<RadixTableEnum>(names, out));
+			CTP_CHECK(enums::values<RadixTableEnum>() == out);
+		}
+		return true;
+	};
+
+	TEST_CONSTEXPR bool RunConstexpr = test();
+	test();
+}
+
+TEST_CASE("enum_reflection packed_names", "[Tools][enum_reflection]") {
+	auto test = [] {
+		{
+			const auto& packed = enums::packed_names<NonContiguous>;
+			constexpr std::array<std::uint32_t, 4> expected = {0, 7, 11, 17};
+			CTP_CHECK(expected == packed.offsets);
+			CTP_CHECK("NegOne\0One\0Three\0"sv == std::string_view(packed.blob.data(), packed.blob.size()));
+
+			const enums::packed_names_view view{packed};
+			CTP_CHECK(3 == view.size());
+			CTP_CHECK("NegOne"_zv == view[0]);
+			CTP_CHECK("One"_zv == view[1]);
+			CTP_CHECK("Three"_zv == view[2]);
+		}
+		{
+			const auto& packed = enums::packed_names<RadixTableEnum>;
+			const enums::packed_names_view view{packed.offsets, packed.blob.data()};
+			CTP_CHECK(enums::size<RadixTableEnum>() == view.size());
+			for (std::size_t i = 0; i < view.size(); ++i)
+				CTP_CHECK(enums::names<RadixTableEnum>()[i] == view[i]);
+		}
+		CTP_CHECK(0 == enums::packed_names_view{}.size());
+		return true;
+	};
+
+	TEST_CONSTEXPR bool RunConstexpr = test();
+	test();
+}
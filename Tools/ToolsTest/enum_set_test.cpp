@@ -0,0 +1,186 @@
+#include <catch.hpp>
+
+#include <Tools/test/catch_test_helpers.hpp>
+
+#include <Tools/enum_set.hpp>
+
+#include <array>
+#include <cstdint>
+
+using namespace ctp;
+
+namespace {
+
+enum class E1 {
+	One,
+	Two,
+	Three,
+	Four,
+};
+
+enum class Sparse {
+	NegTen = -10,
+	One = 1,
+	Five = 5,
+	Twenty = 20,
+};
+
+// More values than fit in one word.
+enum class Large {
+	V0, V1, V2, V3, V4, V5, V6, V7, V8, V9,
+	V10, V11, V12, V13, V14, V15, V16, V17, V18, V19,
+	V20, V21, V22, V23, V24, V25, V26, V27, V28, V29,
+	V30, V31, V32, V33, V34, V35, V36, V37, V38, V39,
+	V40, V41, V42, V43, V44, V45, V46, V47, V48, V49,
+	V50, V51, V52, V53, V54, V55, V56, V57, V58, V59,
+	V60, V61, V62, V63, V64, V65, V66, V67, V68, V69,
+};
+
+enum class Flags : std::uint8_t {
+	None = 0,
+	Read = 0b0001,
+	Write = 0b0010,
+	Exec = 0b0100,
+	ReadWrite = Read | Write,
+};
+
+static_assert(enum_set<E1>::NumWords == 1);
+static_assert(enum_set<Large>::NumWords == 2);
+static_assert(sizeof(enum_set<Large>) == 2 * sizeof(std::uint64_t));
+
+} // namespace
+
+TEST_CASE("enum_set insert and erase", "[Tools][enum_set]") {
+	auto test = [] {
+		enum_set<Sparse> set;
+		CTP_CHECK(set.empty());
+		CTP_CHECK(0 == set.size());
+
+		CTP_CHECK(set.insert(Sparse::Five));
+		CTP_CHECK(!set.insert(Sparse::Five));
+		CTP_CHECK(set.insert(Sparse::NegTen));
+		CTP_CHECK(2 == set.size());
+		CTP_CHECK(set.contains(Sparse::NegTen));
+		CTP_CHECK(!set.contains(Sparse::One));
+		CTP_CHECK(set.contains(Sparse::Five));
+		CTP_CHECK(0 == set.count(Sparse::Twenty));
+
+		CTP_CHECK(1 == set.erase(Sparse::NegTen));
+		CTP_CHECK(0 == set.erase(Sparse::NegTen));
+		CTP_CHECK(!set.contains(Sparse::NegTen));
+
+		set.flip(Sparse::One);
+		set.flip(Sparse::Five);
+		CTP_CHECK(set.contains(Sparse::One));
+		CTP_CHECK(!set.contains(Sparse::Five));
+
+		set.clear();
+		CTP_CHECK(set.empty());
+		return true;
+	};
+
+	TEST_CONSTEXPR bool RunConstexpr = test();
+	test();
+}
+
+TEST_CASE("enum_set set operations", "[Tools][enum_set]") {
+	auto test = [] {
+		const enum_set<E1> a{E1::One, E1::Two};
+		const enum_set<E1> b{E1::Two, E1::Three};
+
+		CTP_CHECK(((a | b) == enum_set<E1>{E1::One, E1::Two, E1::Three}));
+		CTP_CHECK((a & b) == enum_set<E1>{E1::Two});
+		CTP_CHECK((a - b) == enum_set<E1>{E1::One});
+		CTP_CHECK(((a ^ b) == enum_set<E1>{E1::One, E1::Three}));
+		CTP_CHECK((~a == enum_set<E1>{E1::Three, E1::Four}));
+		CTP_CHECK(4 == enum_set<E1>::all().size());
+		CTP_CHECK(enum_set<E1>{}.size() == (~enum_set<E1>::all()).size());
+
+		CTP_CHECK(a.intersects(b));
+		CTP_CHECK(!a.intersects(enum_set<E1>{E1::Four}));
+		CTP_CHECK(enum_set<E1>{E1::Two}.is_subset_of(a));
+		CTP_CHECK(!b.is_subset_of(a));
+		CTP_CHECK(enum_set<E1>{}.is_subset_of(a));
+		return true;
+	};
+
+	TEST_CONSTEXPR bool RunConstexpr = test();
+	test();
+}
+
+TEST_CASE("enum_set multiple words", "[Tools][enum_set]") {
+	auto test = [] {
+		enum_set<Large> set{Large::V0, Large::V63, Large::V64, Large::V69};
+		CTP_CHECK(4 == set.size());
+		CTP_CHECK(set.contains(Large::V63));
+		CTP_CHECK(set.contains(Large::V64));
+		CTP_CHECK(!set.contains(Large::V65));
+
+		// Complement must not set bits past the last value.
+		CTP_CHECK(66 == (~set).size());
+		CTP_CHECK(70 == enum_set<Large>::all().size());
+		CTP_CHECK(0 == (enum_set<Large>::all() - set - ~set).size());
+		return true;
+	};
+
+	TEST_CONSTEXPR bool RunConstexpr = test();
+	test();
+}
+
+TEST_CASE("enum_set iteration", "[Tools][enum_set]") {
+	auto test = [] {
+		{
+			const enum_set<Large> set{Large::V69, Large::V2, Large::V64, Large::V63};
+			constexpr std::array expected = {Large::V2, Large::V63, Large::V64, Large::V69};
+			std::size_t i = 0;
+			for (const Large e : set) {
+				CTP_CHECK(i < expected.size());
+				CTP_CHECK(expected[i++] == e);
+			}
+			CTP_CHECK(expected.size() == i);
+		}
+		{
+			// Only values in the second word.
+			const enum_set<Large> set{Large::V66};
+			CTP_CHECK(Large::V66 == *set.begin());
+			CTP_CHECK(++set.begin() == set.end());
+		}
+		{
+			const enum_set<Sparse> set{Sparse::Twenty, Sparse::NegTen};
+			auto it = set.begin();
+			CTP_CHECK(Sparse::NegTen == *it++);
+			CTP_CHECK(Sparse::Twenty == *it++);
+			CTP_CHECK(it == set.end());
+		}
+		CTP_CHECK(enum_set<Sparse>{}.begin() == enum_set<Sparse>{}.end());
+		return true;
+	};
+
+	TEST_CONSTEXPR bool RunConstexpr = test();
+	test();
+}
+
+TEST_CASE("enum_set BitEnum interop", "[Tools][enum_set]") {
+	auto test = [] {
+		{
+			const auto set = enum_set<Flags>::from_flags(BitEnum{Flags::Read, Flags::Exec});
+			CTP_CHECK((set == enum_set<Flags>{Flags::Read, Flags::Exec}));
+			CTP_CHECK((BitEnum{Flags::Read, Flags::Exec} == set.to_flags()));
+		}
+		{
+			// Values with more than one bit are included when all their bits are set.
+			const auto set = enum_set<Flags>::from_flags(BitEnum{Flags::Read, Flags::Write});
+			CTP_CHECK((set == enum_set<Flags>{Flags::Read, Flags::Write, Flags::ReadWrite}));
+			CTP_CHECK(BitEnum{Flags::ReadWrite} == set.to_flags());
+		}
+		{
+			// Zero values are never included.
+			CTP_CHECK(enum_set<Flags>::from_flags(BitEnum<Flags>{}).empty());
+			CTP_CHECK(BitEnum<Flags>{} == enum_set<Flags>{Flags::None}.to_flags());
+		}
+		return true;
+	};
+
+	TEST_CONSTEXPR bool RunConstexpr = test();
+	test();
+}
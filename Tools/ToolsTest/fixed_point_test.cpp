@@ -0,0 +1,207 @@
+#include <catch.hpp>
+
+#include <Tools/test/catch_test_helpers.hpp>
+#include <Tools/fixed_point.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace ctp {
+
+using q16_16_sat = fixed_point<std::int32_t, 16, overflow_saturating>;
+using q32_32_sat = fixed_point<std::int64_t, 32, overflow_saturating>;
+
+static_assert(ValueLayoutStrongType<q16_16>);
+static_assert(ValueLayoutStrongType<q32_32_sat>);
+static_assert(sizeof(q16_16) == 4);
+
+// Conversions use the number, not the raw integer.
+static_assert(q16_16{1}.raw() == 65536);
+static_assert(q16_16{-2}.raw() == -2 * 65536);
+static_assert(q16_16{0.5}.raw() == 32768);
+static_assert(q16_16{0.5f} == q16_16::from_raw(32768));
+static_assert(static_cast<double>(q16_16{2.25}) == 2.25);
+static_assert(static_cast<int>(q16_16{2.75}) == 2);
+static_assert(static_cast<int>(q16_16{-2.75}) == -2);
+static_assert(static_cast<float>(q32_32{-3}) == -3.0f);
+
+// Floating-point rounds to the nearest, and saturates.
+static_assert(q16_16{1.0 / 65536 * 0.49}.raw() == 0);
+static_assert(q16_16{1.0 / 65536 * 0.51}.raw() == 1);
+static_assert(q16_16{1e10} == q16_16::max());
+static_assert(q16_16{-1e10} == q16_16::lowest());
+static_assert(q16_16{std::numeric_limits<double>::quiet_NaN()} == q16_16{});
+static_assert(q32_32{1e30} == q32_32::max());
+
+// Integers wrap or saturate.
+static_assert(q16_16{32768} == q16_16{-32768});
+static_assert(q16_16_sat{32768} == q16_16_sat::max());
+static_assert(q16_16_sat{-40000} == q16_16_sat::lowest());
+static_assert(q16_16_sat{std::numeric_limits<std::uint64_t>::max()} == q16_16_sat::max());
+
+constexpr bool arithmetic_constexpr() {
+	q16_16 a{1.5};
+	const q16_16 b{-0.25};
+	a += b;
+	++a;
+	return a == q16_16{2.25}
+		&& a * b == q16_16{-0.5625}
+		&& a / b == q16_16{-9}
+		&& a - b == q16_16{2.5}
+		&& -a == q16_16{-2.25}
+		&& a % q16_16{1} == q16_16{0.25}
+		&& q32_32{7} / q32_32{2} == q32_32{3.5}
+		&& q32_32{-1.5} * q32_32{-1.5} == q32_32{2.25};
+}
+static_assert(arithmetic_constexpr());
+
+// Products truncate towards negative infinity, quotients towards zero.
+static_assert(q16_16::epsilon() * q16_16{0.5} == q16_16{});
+static_assert(-q16_16::epsilon() * q16_16{0.5} == -q16_16::epsilon());
+static_assert(q16_16::epsilon() / q16_16{-2} == q16_16{});
+
+// Overflow.
+static_assert(q16_16::max() + q16_16::epsilon() == q16_16::lowest());
+static_assert(q16_16_sat::max() + q16_16_sat::epsilon() == q16_16_sat::max());
+static_assert(q16_16_sat::lowest() - q16_16_sat::epsilon() == q16_16_sat::lowest());
+static_assert(-q16_16_sat::lowest() == q16_16_sat::max());
+static_assert(q16_16_sat{200} * q16_16_sat{200} == q16_16_sat::max());
+static_assert(q16_16_sat{200} * q16_16_sat{-200} == q16_16_sat::lowest());
+static_assert(q32_32_sat{1 << 20} * q32_32_sat{1 << 20} == q32_32_sat::max());
+static_assert(q32_32_sat{-(1 << 20)} * q32_32_sat{1 << 20} == q32_32_sat::lowest());
+static_assert(q32_32_sat{1 << 15} * q32_32_sat{1 << 15} == q32_32_sat{1 << 30});
+static_assert(q16_16{20000} / q16_16{0.25} == q16_16::max());
+static_assert(q32_32{1 << 30} / q32_32::epsilon() == q32_32::max());
+static_assert(q32_32{-(1 << 30)} / q32_32{0.5} == q32_32::lowest());
+static_assert(q16_16_sat{3} / q16_16_sat{} == q16_16_sat::max());
+static_assert(q16_16_sat{-3} / q16_16_sat{} == q16_16_sat::lowest());
+static_assert(q16_16::lowest() % -q16_16::epsilon() == q16_16{});
+static_assert(q32_32_sat::lowest() % -q32_32_sat::epsilon() == q32_32_sat{});
+
+// Approximations.
+static_assert(fast_reciprocal(q16_16{1}) == q16_16{1});
+static_assert(fast_reciprocal(q16_16{-4}) == q16_16{-0.25});
+static_assert(fast_reciprocal(q32_32{0.125}) == q32_32{8});
+static_assert(fast_reciprocal(q16_16::epsilon()) == q16_16::max());
+static_assert(fast_sqrt(q16_16{4}) == q16_16{2});
+static_assert(fast_sqrt(q16_16{0.25}) == q16_16{0.5});
+static_assert(fast_sqrt(q32_32{1 << 30}) == q32_32{1 << 15});
+static_assert(fast_sqrt(q16_16{}) == q16_16{});
+static_assert(fast_sqrt(q16_16_sat{-1}) == q16_16_sat{});
+
+} // ctp
+
+namespace {
+
+// Within epsilons of the exact result, and a relative error for doubles that can't represent it.
+template <typename Fixed>
+bool near(const Fixed actual, const double expected, const int epsilons) {
+	const double eps = static_cast<double>(Fixed::epsilon());
+	return std::abs(static_cast<double>(actual) - expected) <= epsilons * eps + std::abs(expected) * 0x1p-50;
+}
+
+template <typename Fixed>
+void check_random_operations() {
+	using I = typename Fixed::value_type;
+	std::mt19937_64 rng{Fixed::frac_bits};
+	// Around 1, so that most products and quotients fit.
+	constexpr int RangeBits = std::numeric_limits<I>::digits / 2;
+	for (int i = 0; i < 20000; ++i) {
+		const auto shift = static_cast<int>(rng() % RangeBits);
+		const Fixed a = Fixed::from_raw(static_cast<I>(static_cast<I>(rng()) >> shift));
+		const Fixed b = Fixed::from_raw(static_cast<I>(static_cast<I>(rng()) >> (RangeBits + rng() % RangeBits)));
+		const double da = static_cast<double>(a);
+		const double db = static_cast<double>(b);
+
+		const double product = da * db;
+		if (std::abs(product) < static_cast<double>(Fixed::max()))
+			CHECK(near(a * b, product, 1));
+		if (b != Fixed{} && std::abs(da / db) < static_cast<double>(Fixed::max()))
+			CHECK(near(a / b, da / db, 1));
+		if (a != Fixed{} && std::abs(1 / da) < static_cast<double>(Fixed::max()))
+			CHECK(near(fast_reciprocal(a), 1 / da, 2));
+		CHECK(near(fast_sqrt(a < Fixed{} ? -a : a), std::sqrt(std::abs(da)), 2));
+	}
+}
+
+} // namespace
+
+TEST_CASE("Fixed point matches doubles.", "[fixed_point]")
+{
+	using namespace ctp;
+	check_random_operations<q16_16>();
+	check_random_operations<q32_32>();
+	check_random_operations<fixed_point<std::int32_t, 8>>();
+	check_random_operations<fixed_point<std::int64_t, 48>>();
+	check_random_operations<fixed_point<std::int16_t, 8>>();
+
+	// Divisors the compiler can't see, so the remainders are computed at run time.
+	volatile std::int32_t minusEpsilon32 = -1;
+	CHECK(q16_16::lowest() % q16_16::from_raw(minusEpsilon32) == q16_16{});
+	volatile std::int64_t minusEpsilon64 = -1;
+	CHECK(q32_32::lowest() % q32_32::from_raw(minusEpsilon64) == q32_32{});
+}
+
+TEST_CASE("Fixed point span operations.", "[fixed_point]")
+{
+	using namespace ctp;
+
+	auto test = [] {
+		std::vector<q16_16> lhs;
+		std::vector<q16_16> rhs;
+		for (int i = 0; i < 37; ++i) {
+			lhs.push_back(q16_16{i - 18} / q16_16{4});
+			rhs.push_back(q16_16{i % 5 + 1} / q16_16{3});
+		}
+		std::vector<q16_16> out(lhs.size());
+		multiply_values<q16_16>(lhs, rhs, out);
+		for (std::size_t i = 0; i < out.size(); ++i)
+			CTP_CHECK(out[i] == lhs[i] * rhs[i]);
+		divide_values<q16_16>(lhs, rhs, out);
+		for (std::size_t i = 0; i < out.size(); ++i)
+			CTP_CHECK(out[i] == lhs[i] / rhs[i]);
+
+		// The StrongType ones wrap, so the saturating types have their own.
+		std::vector<q32_32_sat> big(20, q32_32_sat::max() / q32_32_sat{4});
+		std::vector<q32_32_sat> bigOut(big.size());
+		CTP_CHECK(sum_values(std::span{big}) == q32_32_sat::max());
+		big.back() = q32_32_sat::lowest();
+		CTP_CHECK(sum_values(std::span{big}) == q32_32_sat::max());
+		add_values<q32_32_sat>(big, big, bigOut);
+		CTP_CHECK(bigOut[0] == big[0] + big[0]);
+		CTP_CHECK(bigOut.back() == q32_32_sat::lowest());
+		subtract_values<q32_32_sat>(big, big, bigOut);
+		CTP_CHECK(bigOut[0] == q32_32_sat{});
+		scale_values<q32_32_sat>(big, 8, bigOut);
+		CTP_CHECK(bigOut[0] == q32_32_sat::max());
+		scale_values<q32_32_sat>(big, 2, bigOut);
+		CTP_CHECK(bigOut[0] == big[0] + big[0]);
+
+		std::vector<q16_16_sat> small(100, q16_16_sat{500});
+		CTP_CHECK(sum_values(std::span{small}) == q16_16_sat::max());
+		small.resize(50);
+		CTP_CHECK(sum_values(std::span{small}) == q16_16_sat{25000});
+
+		// Partial sums don't saturate, only the total.
+		std::vector<q16_16_sat> mixed{q16_16_sat{30000}, q16_16_sat{30000}, q16_16_sat{-30000}};
+		CTP_CHECK(sum_values(std::span{mixed}) == q16_16_sat{30000});
+		std::vector<q16_16> wrapped{q16_16{30000}, q16_16{30000}};
+		CTP_CHECK(sum_values(std::span{wrapped}) == q16_16{30000} + q16_16{30000});
+		std::vector<q16_16> wrappedOut(wrapped.size());
+		add_values<q16_16>(wrapped, wrapped, wrappedOut);
+		CTP_CHECK(wrappedOut[0] == q16_16{30000} + q16_16{30000});
+		subtract_values<q16_16>(std::vector{q16_16::lowest()}, std::vector{q16_16::epsilon()}, std::span{wrappedOut}.first(1));
+		CTP_CHECK(wrappedOut[0] == q16_16::max());
+		scale_values<q16_16>(wrapped, 3, wrappedOut);
+		CTP_CHECK(wrappedOut[0] == q16_16{30000} + q16_16{30000} + q16_16{30000});
+
+		return true;
+	};
+
+	TEST_CONSTEXPR bool RunConstexpr = test();
+	test();
+}
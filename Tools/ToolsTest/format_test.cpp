@@ -0,0 +1,93 @@
+#include <catch.hpp>
+
+#include <Tools/test/catch_test_helpers.hpp>
+#include <Tools/format.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+
+using namespace std::literals;
+
+namespace ctp {
+
+// Sizes come from the types, not the values.
+static_assert(max_format_size_v<"id {}", std::int32_t> == 3 + 11);
+static_assert(max_format_size_v<"{}/{}", std::uint8_t, char> == 1 + 3 + 1);
+static_assert(max_format_size_v<"{{{}}}", double> == 2 + 24);
+static_assert(max_format_size_v<"{} {}", bool, fixed_string<10>> == 1 + 5 + 10);
+static_assert(max_format_size_v<"[{}]", char[6]> == 2 + 5);
+
+// Formats parse once, with escapes resolved.
+static_assert(format_detail::count_args("{}{{}}{}") == 2);
+static_assert(format_detail::count_text("{}{{}}{}") == 2);
+static_assert(!format_detail::is_valid("{"));
+static_assert(!format_detail::is_valid("}"));
+static_assert(!format_detail::is_valid("{0}"));
+static_assert(!format_detail::is_valid("{:x}"));
+static_assert(format_detail::is_valid("{{}}"));
+
+// Constant arguments give a string that fits.
+static_assert(format_constant<"asset_{}_{}", 12, 'b'>() == "asset_12_b"sv);
+static_assert(format_constant<"asset_{}_{}", 12, 'b'>().size() == 10);
+
+} // ctp
+
+TEST_CASE("Format.", "[format]")
+{
+	using namespace ctp;
+
+	auto test = [] {
+		CTP_CHECK(format<"">() == ""sv);
+		CTP_CHECK(format<"no args">() == "no args"sv);
+		CTP_CHECK(format<"{}">(42) == "42"sv);
+		CTP_CHECK(format<"{} + {} = {}">(1, -2, -1) == "1 + -2 = -1"sv);
+		CTP_CHECK(format<"{{{}}}">(7u) == "{7}"sv);
+		CTP_CHECK(format<"}}{{">() == "}{"sv);
+
+		// Integers of every size.
+		CTP_CHECK(format<"{}">(std::numeric_limits<std::int8_t>::min()) == "-128"sv);
+		CTP_CHECK(format<"{}">(std::numeric_limits<std::uint16_t>::max()) == "65535"sv);
+		CTP_CHECK(format<"{}">(std::numeric_limits<std::int32_t>::min()) == "-2147483648"sv);
+		CTP_CHECK(format<"{}">(std::numeric_limits<std::int64_t>::min()) == "-9223372036854775808"sv);
+		CTP_CHECK(format<"{}">(std::numeric_limits<std::uint64_t>::max()) == "18446744073709551615"sv);
+
+		// Floats are the shortest that round-trips.
+		CTP_CHECK(format<"{}">(0.1) == "0.1"sv);
+		CTP_CHECK(format<"{}">(2.5f) == "2.5"sv);
+		CTP_CHECK(format<"{}">(1e22) == "1e+22"sv);
+		CTP_CHECK(format<"{}">(-0.0) == "-0"sv);
+
+		CTP_CHECK(format<"{} {}">(true, false) == "true false"sv);
+		CTP_CHECK(format<"{}{}{}">('a', 'b', 'c') == "abc"sv);
+
+		// Strings with a bounded size.
+		const fixed_string<16> name{"sword"};
+		CTP_CHECK(format<"items/{}/{}.json">(name, 3) == "items/sword/3.json"sv);
+		CTP_CHECK(format<"{}:{}">("key", 1) == "key:1"sv);
+
+		// The string is big enough for any values of the types.
+		const auto str = format<"{}">(std::int16_t{1});
+		CTP_CHECK(str.size() == 1);
+		CTP_CHECK(str.max_size() == 6);
+
+		return true;
+	};
+
+	TEST_CONSTEXPR bool RunConstexpr = test();
+	test();
+}
+
+TEST_CASE("Format matches std::to_string.", "[format]")
+{
+	using namespace ctp;
+
+	std::mt19937_64 rng{2468};
+	for (int i = 0; i < 10000; ++i) {
+		const auto wide = static_cast<std::int64_t>(rng() >> (rng() % 64));
+		const auto narrow = static_cast<std::int32_t>(rng());
+		const auto expected = "[" + std::to_string(wide) + "," + std::to_string(narrow) + "]";
+		CHECK(format<"[{},{}]">(wide, narrow) == std::string_view{expected});
+	}
+}
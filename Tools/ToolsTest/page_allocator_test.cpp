@@ -0,0 +1,125 @@
+#include <catch.hpp>
+
+#include <Tools/page_allocator.hpp>
+#include <Tools/trivial_allocator_adapter.hpp>
+
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+using namespace ctp;
+
+namespace {
+
+using trivial_huge_allocator = trivial_init_allocator<std::uint64_t, huge_page_allocator<std::uint64_t>>;
+
+// Rebinding the adapter rebinds what it adapts.
+static_assert(std::is_same_v<
+	std::allocator_traits<trivial_huge_allocator>::rebind_alloc<int>,
+	trivial_init_allocator<int, huge_page_allocator<int>>>);
+static_assert(std::is_same_v<std::allocator_traits<trivial_huge_allocator>::rebind_alloc<std::uint64_t>, trivial_huge_allocator>);
+
+constexpr bool constexpr_allocations() {
+	huge_page_allocator<int> huge;
+	numa_local_allocator<int> numa{0};
+	int* const a = huge.allocate(4);
+	const auto b = numa.allocate_at_least(3);
+	a[3] = 1;
+	b.ptr[2] = 2;
+	const bool ok = b.count == 3 && a[3] + b.ptr[2] == 3;
+	huge.deallocate(a, 4);
+	numa.deallocate(b.ptr, b.count);
+	return ok;
+}
+static_assert(constexpr_allocations());
+
+static_assert(huge_page_allocator<int>{} == huge_page_allocator<long>{});
+static_assert(numa_local_allocator<int>{1} == numa_local_allocator<long>{1});
+static_assert(numa_local_allocator<int>{1} != numa_local_allocator<int>{});
+
+// Writes to every page, and checks it reads back.
+template <typename T>
+bool write_pages(T* const ptr, const std::size_t count) {
+	const std::size_t step = page_size() / sizeof(T);
+	for (std::size_t i = 0; i < count; i += step)
+		ptr[i] = static_cast<T>(i);
+	ptr[count - 1] = 1;
+	for (std::size_t i = 0; i + 1 < count; i += step) {
+		if (ptr[i] != static_cast<T>(i))
+			return false;
+	}
+	return ptr[count - 1] == 1;
+}
+
+} // namespace
+
+TEST_CASE("Page sizes", "[Tools][page_allocator]") {
+	CHECK(page_size() >= 4096);
+	CHECK(std::has_single_bit(page_size()));
+	CHECK(huge_page_size() >= page_size());
+	CHECK(huge_page_size() % page_size() == 0);
+	CHECK(numa_node_count() >= 1);
+	CHECK(current_numa_node() >= 0);
+	CHECK(current_numa_node() < numa_node_count());
+}
+
+TEST_CASE("huge_page_allocator", "[Tools][page_allocator]") {
+	huge_page_allocator<std::uint64_t> alloc;
+
+	SECTION("Rounds large allocations up to whole huge pages.") {
+		const std::size_t hugeItems = huge_page_size() / sizeof(std::uint64_t);
+		const auto result = alloc.allocate_at_least(hugeItems + 1);
+		REQUIRE(result.ptr);
+		CHECK(result.count == 2 * hugeItems);
+		CHECK(reinterpret_cast<std::uintptr_t>(result.ptr) % page_size() == 0);
+		// Fresh pages are zeroed.
+		CHECK(result.ptr[hugeItems] == 0);
+		CHECK(write_pages(result.ptr, result.count));
+		alloc.deallocate(result.ptr, result.count);
+
+		// And can be freed with what was asked for.
+		std::uint64_t* const ptr = alloc.allocate(hugeItems + 1);
+		CHECK(write_pages(ptr, hugeItems + 1));
+		alloc.deallocate(ptr, hugeItems + 1);
+	}
+
+	SECTION("Small allocations are exact.") {
+		const auto result = alloc.allocate_at_least(10);
+		REQUIRE(result.ptr);
+		CHECK(result.count == 10);
+		alloc.deallocate(result.ptr, result.count);
+	}
+
+	SECTION("Composes with trivial_init_allocator.") {
+		const std::size_t count = 3 * huge_page_size() / sizeof(std::uint64_t);
+		std::vector<std::uint64_t, trivial_huge_allocator> values(count);
+		CHECK(write_pages(values.data(), values.size()));
+		values.resize(2 * count);
+		CHECK(write_pages(values.data(), values.size()));
+		values.clear();
+		values.shrink_to_fit();
+	}
+}
+
+TEST_CASE("numa_local_allocator", "[Tools][page_allocator]") {
+	SECTION("First touch.") {
+		numa_local_allocator<int> alloc;
+		CHECK(alloc.node() == -1);
+		const std::size_t count = 5 * page_size() / sizeof(int) + 3;
+		const auto result = alloc.allocate_at_least(count);
+		REQUIRE(result.ptr);
+		CHECK(result.count == 6 * page_size() / sizeof(int));
+		CHECK(write_pages(result.ptr, result.count));
+		alloc.deallocate(result.ptr, result.count);
+	}
+
+	SECTION("On the current node.") {
+		const auto alloc = numa_local_allocator<double>::current();
+		CHECK(alloc.node() >= 0);
+		std::vector<double, trivial_init_allocator<double, numa_local_allocator<double>>> values(100000, alloc);
+		CHECK(values.get_allocator().node() == alloc.node());
+		CHECK(write_pages(values.data(), values.size()));
+	}
+}
@@ -0,0 +1,75 @@
+#include <catch.hpp>
+
+#include <Tools/perf_counters.hpp>
+
+#include <array>
+#include <cstdint>
+
+using namespace ctp;
+
+namespace {
+
+std::uint64_t Spin(const std::uint64_t n) {
+	volatile std::uint64_t sum = 0;
+	for (std::uint64_t i = 0; i < n; ++i)
+		sum = sum + i;
+	return sum;
+}
+
+} // namespace
+
+TEST_CASE("perf_counters names", "[Tools][perf_counters]") {
+	for (const perf_event event : AllPerfEvents)
+		CHECK(!name(event).empty());
+	CHECK(name(perf_event::instructions) == "instructions");
+}
+
+TEST_CASE("perf_counters count or degrade", "[Tools][perf_counters]") {
+	perf_counters counters;
+
+	if (!counters.available()) {
+		// No PMU access, such as in a container. Everything still works, with nothing counted.
+		counters.start();
+		Spin(1000);
+		counters.stop();
+		for (const perf_event event : AllPerfEvents) {
+			CHECK(!counters.counts(event));
+			CHECK(!counters.value(event));
+		}
+		return;
+	}
+
+	if (!counters.counts(perf_event::instructions))
+		return;
+
+	counters.start();
+	Spin(1000);
+	counters.stop();
+	const auto few = counters.value(perf_event::instructions);
+
+	counters.start();
+	Spin(100'000);
+	counters.stop();
+	const auto many = counters.value(perf_event::instructions);
+
+	// Left out if the group was never scheduled.
+	if (!few || !many)
+		return;
+	CHECK(*few >= 1000);
+	CHECK(*many > *few);
+}
+
+TEST_CASE("perf_counters subset", "[Tools][perf_counters]") {
+	constexpr std::array events{perf_event::branch_misses};
+	perf_counters counters{events};
+
+	CHECK(!counters.counts(perf_event::cycles));
+	CHECK(!counters.value(perf_event::cycles));
+	// Nothing read yet.
+	CHECK(!counters.value(perf_event::branch_misses));
+	CHECK(counters.available() == counters.counts(perf_event::branch_misses));
+
+	// Opened only when asked for.
+	const perf_counters defaults;
+	CHECK(!defaults.counts(perf_event::dtlb_misses));
+}
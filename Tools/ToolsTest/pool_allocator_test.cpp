@@ -0,0 +1,160 @@
+#include <catch.hpp>
+
+#include <Tools/pool_allocator.hpp>
+#include <Tools/small_vector.hpp>
+#include <Tools/trivial_allocator_adapter.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace ctp;
+
+namespace {
+
+using pool_vector = small_vector<int, 8, trivial_init_allocator<int, pool_allocator<int>>>;
+
+constexpr bool size_classes_increase() {
+	using namespace pool_detail;
+	for (std::size_t i = 0; i < SizeClassCount; ++i) {
+		const std::size_t bytes = SizeClasses.bytes[i];
+		const std::size_t previous = i == 0 ? 0 : SizeClasses.bytes[i - 1];
+		if (bytes % Granularity != 0 || bytes <= previous)
+			return false;
+		if (size_class_of(bytes) != i || size_class_of(previous + 1) != i)
+			return false;
+	}
+	return SizeClasses.bytes[SizeClassCount - 1] == MaxPooledBytes;
+}
+static_assert(size_classes_increase());
+
+constexpr bool constexpr_allocations() {
+	pool_allocator<int> alloc;
+	int* const a = alloc.allocate(4);
+	const auto b = alloc.allocate_at_least(3);
+	a[3] = 1;
+	b.ptr[2] = 2;
+	const bool ok = b.count == 3 && a[3] + b.ptr[2] == 3;
+	alloc.deallocate(a, 4);
+	alloc.deallocate(b.ptr, b.count);
+	return ok;
+}
+static_assert(constexpr_allocations());
+
+static_assert(pool_allocator<int>{} == pool_allocator<double>{});
+
+} // namespace
+
+TEST_CASE("pool_allocator", "[Tools][pool_allocator]") {
+	pool_allocator<std::uint32_t> alloc;
+
+	SECTION("Rounds up to the size class.") {
+		const auto result = alloc.allocate_at_least(13);
+		REQUIRE(result.ptr);
+		CHECK(result.count == 16);
+		CHECK(reinterpret_cast<std::uintptr_t>(result.ptr) % pool_detail::Granularity == 0);
+		std::fill_n(result.ptr, result.count, 7u);
+		alloc.deallocate(result.ptr, result.count);
+
+		// Freed blocks are reused first, and can be freed with what was asked for.
+		std::uint32_t* const ptr = alloc.allocate(10);
+		CHECK(ptr == result.ptr);
+		alloc.deallocate(ptr, 10);
+	}
+
+	SECTION("Large allocations are exact.") {
+		const std::size_t count = pool_detail::MaxPooledBytes / sizeof(std::uint32_t) + 1;
+		const auto result = alloc.allocate_at_least(count);
+		REQUIRE(result.ptr);
+		CHECK(result.count == count);
+		std::fill_n(result.ptr, result.count, 7u);
+		alloc.deallocate(result.ptr, result.count);
+	}
+
+	SECTION("Blocks don't overlap.") {
+		std::vector<std::pair<std::uint32_t*, std::size_t>> blocks;
+		for (std::uint32_t i = 0; i < 5000; ++i) {
+			const auto result = alloc.allocate_at_least(i % 300 + 1);
+			std::fill_n(result.ptr, result.count, i);
+			blocks.emplace_back(result.ptr, result.count);
+		}
+		bool intact = true;
+		for (std::uint32_t i = 0; i < blocks.size(); ++i) {
+			const auto [ptr, count] = blocks[i];
+			intact &= std::all_of(ptr, ptr + count, [i](const std::uint32_t value) { return value == i; });
+			alloc.deallocate(ptr, count);
+		}
+		CHECK(intact);
+	}
+}
+
+TEST_CASE("pool_allocator frees on other threads", "[Tools][pool_allocator]") {
+	pool_allocator<double> alloc;
+	constexpr std::size_t Blocks = 200;
+	constexpr std::size_t Count = 100;
+
+	std::vector<double*> allocated;
+	for (std::size_t i = 0; i < Blocks; ++i)
+		allocated.push_back(alloc.allocate(Count));
+
+	// Returned to this thread's pool by the time the other thread exits.
+	std::thread{[&] {
+		for (double* const ptr : allocated)
+			alloc.deallocate(ptr, Count);
+	}}.join();
+
+	// Blocks already free on this thread come first.
+	std::vector<double*> reused;
+	std::size_t found = 0;
+	while (found < Blocks && reused.size() < 10000) {
+		reused.push_back(alloc.allocate(Count));
+		found += std::ranges::count(allocated, reused.back());
+	}
+	CHECK(found == Blocks);
+	for (double* const ptr : reused)
+		alloc.deallocate(ptr, Count);
+}
+
+TEST_CASE("pool_allocator with small_vector", "[Tools][pool_allocator]") {
+	SECTION("Spills into size classes.") {
+		pool_vector values{1, 2, 3, 4, 5, 6, 7, 8};
+		values.push_back(9);
+		// Grown to 13, rounded up to the 64 byte class.
+		CHECK(values.capacity() == 16);
+		for (int i = 10; i <= 1000; ++i)
+			values.push_back(i);
+		CHECK(values.size() == 1000);
+		CHECK(values.back() == 1000);
+	}
+
+	SECTION("Handed between threads.") {
+		std::vector<pool_vector> made(100);
+		std::thread{[&] {
+			for (int i = 0; i < 100; ++i) {
+				for (int j = 0; j < i; ++j)
+					made[i].push_back(j);
+			}
+		}}.join();
+
+		bool intact = true;
+		for (int i = 0; i < 100; ++i) {
+			intact &= made[i].size() == static_cast<std::size_t>(i);
+			for (int j = 0; j < i; ++j)
+				intact &= made[i][j] == j;
+		}
+		CHECK(intact);
+		// Frees the other thread's blocks into the pool it left behind.
+		made.clear();
+
+		int last = 0;
+		std::thread{[&] {
+			pool_vector values;
+			for (int i = 0; i < 500; ++i)
+				values.push_back(i);
+			last = values[499];
+		}}.join();
+		CHECK(last == 499);
+	}
+}
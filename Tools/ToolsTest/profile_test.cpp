@@ -0,0 +1,126 @@
+#include <catch.hpp>
+
+#include <Tools/profile.hpp>
+
+#include <algorithm>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ctp;
+
+namespace {
+
+struct TraceEvent {
+	std::string name;
+	double ts;
+	double dur;
+	int tid;
+};
+
+// Parse the complete events written by write_chrome_trace.
+std::vector<TraceEvent> parse_events(const std::string& json) {
+	static const std::regex EventRegex{R"re(\{"name":"((?:[^"\\]|\\.)*)","ph":"X","ts":(-?[0-9.]+),"dur":([0-9.]+),"pid":1,"tid":([0-9]+)\})re"};
+	std::vector<TraceEvent> events;
+	for (auto it = std::sregex_iterator{json.begin(), json.end(), EventRegex}; it != std::sregex_iterator{}; ++it)
+		events.push_back({(*it)[1], std::stod((*it)[2]), std::stod((*it)[3]), std::stoi((*it)[4])});
+	return events;
+}
+
+const TraceEvent* find(const std::vector<TraceEvent>& events, const std::string& name) {
+	const auto it = std::ranges::find(events, name, &TraceEvent::name);
+	return it == events.end() ? nullptr : &*it;
+}
+
+} // namespace
+
+TEST_CASE("profile zones export as Chrome trace", "[Tools][profile]") {
+	profile::clear();
+	{
+		const auto outer = profile::zone("outer");
+		{
+			const auto inner = profile::zone("inner \"quoted\"");
+			std::this_thread::sleep_for(std::chrono::milliseconds{1});
+		}
+		std::thread other{[] {
+			const auto zone = profile::zone("other thread");
+		}};
+		other.join();
+	}
+	// Past a block's worth of zones.
+	for (std::uint32_t i = 0; i < profile::detail::BlockEvents + 10; ++i)
+		const auto zone = profile::zone("many");
+
+	std::ostringstream out;
+	profile::write_chrome_trace(out);
+	const std::string json = out.str();
+
+	REQUIRE(json.starts_with("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["));
+	REQUIRE(json.ends_with("\n]}\n"));
+	CHECK(std::ranges::count(json, '{') == std::ranges::count(json, '}'));
+	CHECK(json.find("\"ph\":\"M\"") != std::string::npos);
+
+	const auto events = parse_events(json);
+	const TraceEvent* outer = find(events, "outer");
+	const TraceEvent* inner = find(events, "inner \\\"quoted\\\"");
+	const TraceEvent* other = find(events, "other thread");
+	REQUIRE(outer);
+	REQUIRE(inner);
+	REQUIRE(other);
+
+	// Nested zones are contained by their parents, on the same thread.
+	CHECK(outer->tid == inner->tid);
+	CHECK(outer->tid != other->tid);
+	CHECK(outer->ts <= inner->ts);
+	CHECK(inner->ts + inner->dur <= outer->ts + outer->dur);
+	CHECK(inner->dur >= 900.0);
+	CHECK(other->ts >= inner->ts + inner->dur);
+
+	CHECK(profile::detail::BlockEvents + 10 == std::ranges::count(events, "many", &TraceEvent::name));
+
+	// Clearing drops recorded zones, and recording carries on.
+	profile::clear();
+	{
+		const auto zone = profile::zone("after clear");
+	}
+	out.str({});
+	profile::write_chrome_trace(out);
+	const auto cleared = parse_events(out.str());
+	REQUIRE(1 == cleared.size());
+	CHECK("after clear" == cleared[0].name);
+}
+
+TEST_CASE("profile reuses the buffers of exited threads", "[Tools][profile]") {
+	profile::clear();
+	std::ostringstream out;
+	profile::write_chrome_trace(out);
+	const auto threadCount = [&out] {
+		const std::string json = out.str();
+		std::ptrdiff_t count = 0;
+		for (auto pos = json.find("\"ph\":\"M\""); pos != std::string::npos; pos = json.find("\"ph\":\"M\"", pos + 1))
+			++count;
+		return count;
+	};
+	const auto before = threadCount();
+
+	// Each thread exits, and its zones are exported, before the next one starts.
+	for (int i = 0; i < 8; ++i) {
+		std::thread{[] { const auto zone = profile::zone("churn"); }}.join();
+		out.str({});
+		profile::write_chrome_trace(out);
+	}
+	CHECK(threadCount() <= before + 1);
+	CHECK(8 == std::ranges::count(parse_events(out.str()), "churn", &TraceEvent::name));
+}
+
+TEST_CASE("profile zone macro", "[Tools][profile]") {
+	profile::clear();
+	{
+		CTP_PROFILE_ZONE("macro zone");
+	}
+	std::ostringstream out;
+	profile::write_chrome_trace(out);
+	CHECK((out.str().find("\"macro zone\"") != std::string::npos) == CTP_PROFILING);
+}
@@ -0,0 +1,185 @@
+#include <catch.hpp>
+
+#include <Tools/test/catch_test_helpers.hpp>
+
+#include <Tools/sparse_enum_map.hpp>
+
+#include <string>
+
+using namespace ctp;
+using namespace std::literals;
+
+namespace {
+
+enum class E1 {
+	One,
+	Two,
+	Three,
+	Four,
+};
+
+// More values than fit in one presence word.
+enum class Large {
+	V0, V1, V2, V3, V4, V5, V6, V7, V8, V9,
+	V10, V11, V12, V13, V14, V15, V16, V17, V18, V19,
+	V20, V21, V22, V23, V24, V25, V26, V27, V28, V29,
+	V30, V31, V32, V33, V34, V35, V36, V37, V38, V39,
+	V40, V41, V42, V43, V44, V45, V46, V47, V48, V49,
+	V50, V51, V52, V53, V54, V55, V56, V57, V58, V59,
+	V60, V61, V62, V63, V64, V65, V66, V67, V68, V69,
+	V70, V71, V72, V73, V74, V75, V76, V77, V78, V79,
+	V80, V81, V82, V83, V84, V85, V86, V87, V88, V89,
+	V90, V91, V92, V93, V94, V95, V96, V97, V98, V99,
+};
+
+// A value whose comparison may throw.
+struct ThrowingEquals {
+	int value;
+	friend bool operator==(const ThrowingEquals&, const ThrowingEquals&) noexcept(false) { return true; }
+};
+
+static_assert(noexcept(std::declval<const sparse_enum_map<E1, int>&>() == std::declval<const sparse_enum_map<E1, int>&>()));
+static_assert(!noexcept(std::declval<const sparse_enum_map<E1, ThrowingEquals>&>() == std::declval<const sparse_enum_map<E1, ThrowingEquals>&>()));
+
+} // namespace
+
+TEST_CASE("sparse_enum_map construction", "[Tools][sparse_enum_map]") {
+	auto test = [] {
+		{
+			const sparse_enum_map<E1, int> map;
+			CTP_CHECK(map.empty());
+			CTP_CHECK(!map.contains(E1::One));
+			CTP_CHECK(nullptr == map.try_get(E1::One));
+		}
+		{
+			const sparse_enum_map<E1, int> map(
+				enum_arg<E1::Three>(3),
+				enum_arg<E1::One>(1));
+
+			CTP_CHECK(2 == map.size());
+			CTP_CHECK(map.contains(E1::One));
+			CTP_CHECK(!map.contains(E1::Two));
+			CTP_CHECK(map.contains(E1::Three));
+			CTP_CHECK(1 == map[E1::One]);
+			CTP_CHECK(3 == map.at(E1::Three));
+		}
+		{
+			// Keys that are not given read as the default without being present.
+			const sparse_enum_map<E1, int> map(enum_default(7), enum_arg<E1::Two>(2));
+			CTP_CHECK(1 == map.size());
+			CTP_CHECK(7 == map[E1::One]);
+			CTP_CHECK(2 == map[E1::Two]);
+			CTP_CHECK(!map.contains(E1::Four));
+			CTP_CHECK(7 == map[E1::Four]);
+		}
+		{
+			const sparse_enum_map<E1, int> map{std::pair{E1::Four, 4}, std::pair{E1::Two, 2}};
+			CTP_CHECK(2 == map.size());
+			CTP_CHECK(2 == map[E1::Two]);
+			CTP_CHECK(4 == map[E1::Four]);
+		}
+		{
+			const sparse_enum_map<E1, int> map{enum_default(0)};
+			CTP_CHECK(map.empty());
+			CTP_CHECK(0 == map[E1::Three]);
+		}
+		return true;
+	};
+
+	TEST_CONSTEXPR bool RunConstexpr = test();
+	test();
+}
+
+TEST_CASE("sparse_enum_map modifiers", "[Tools][sparse_enum_map]") {
+	auto test = [] {
+		sparse_enum_map<Large, int> map;
+		CTP_CHECK((map.emplace(Large::V99, 99).second));
+		CTP_CHECK((map.emplace(Large::V3, 3).second));
+		CTP_CHECK((map.emplace(Large::V64, 64).second));
+		CTP_CHECK((map.emplace(Large::V63, 63).second));
+		CTP_CHECK((!map.emplace(Large::V63, -1).second));
+		CTP_CHECK(4 == map.size());
+
+		// Values are packed in key order.
+		CTP_CHECK(3 == map.values()[0]);
+		CTP_CHECK(63 == map.values()[1]);
+		CTP_CHECK(64 == map.values()[2]);
+		CTP_CHECK(99 == map.values()[3]);
+		CTP_CHECK(63 == map[Large::V63]);
+		CTP_CHECK(64 == map[Large::V64]);
+		CTP_CHECK(99 == map[Large::V99]);
+
+		CTP_CHECK((!map.insert_or_assign(Large::V64, 640).second));
+		CTP_CHECK(640 == map[Large::V64]);
+		CTP_CHECK((map.insert_or_assign(Large::V98, 98).second));
+		CTP_CHECK(98 == map[Large::V98]);
+
+		CTP_CHECK(1 == map.erase(Large::V3));
+		CTP_CHECK(0 == map.erase(Large::V3));
+		CTP_CHECK(!map.contains(Large::V3));
+		CTP_CHECK(63 == map[Large::V63]);
+		CTP_CHECK(99 == map[Large::V99]);
+		CTP_CHECK(98 == map[Large::V98]);
+
+		// Non-const operator[] inserts.
+		map[Large::V0] = 5;
+		CTP_CHECK(map.contains(Large::V0));
+		CTP_CHECK(5 == map.values()[0]);
+		CTP_CHECK(0 == map[Large::V1]);
+		CTP_CHECK(6 == map.size());
+
+		map.clear();
+		CTP_CHECK(map.empty());
+		CTP_CHECK(!map.contains(Large::V99));
+		return true;
+	};
+
+	TEST_CONSTEXPR bool RunConstexpr = test();
+	test();
+}
+
+TEST_CASE("sparse_enum_map iteration", "[Tools][sparse_enum_map]") {
+	auto test = [] {
+		sparse_enum_map<Large, int> map{std::pair{Large::V90, 90}, std::pair{Large::V1, 1}, std::pair{Large::V70, 70}};
+
+		std::size_t count = 0;
+		int last = -1;
+		for (auto [key, value] : map) {
+			CTP_CHECK(static_cast<int>(key) == value);
+			CTP_CHECK(last < value);
+			last = value;
+			value *= 2;
+			++count;
+		}
+		CTP_CHECK(3 == count);
+		CTP_CHECK(140 == map[Large::V70]);
+
+		const auto& constMap = map;
+		auto it = constMap.find(Large::V70);
+		CTP_CHECK(Large::V70 == (*it).first);
+		CTP_CHECK(140 == (*it).second);
+		++it;
+		CTP_CHECK(Large::V90 == (*it).first);
+		++it;
+		CTP_CHECK(it == constMap.end());
+		CTP_CHECK(constMap.find(Large::V2) == constMap.end());
+		return true;
+	};
+
+	TEST_CONSTEXPR bool RunConstexpr = test();
+	test();
+}
+
+TEST_CASE("sparse_enum_map non-trivial values", "[Tools][sparse_enum_map]") {
+	sparse_enum_map<E1, std::string> map{enum_default("none"s), enum_arg<E1::Two>("two"s)};
+	map[E1::Four] += "!";
+	CHECK("none!" == map[E1::Four]);
+	CHECK("two" == map[E1::Two]);
+	CHECK(2 == map.size());
+
+	const auto copy = map;
+	CHECK(copy == map);
+	map.erase(E1::Two);
+	CHECK(copy != map);
+	CHECK("none" == std::as_const(map)[E1::Two]);
+}
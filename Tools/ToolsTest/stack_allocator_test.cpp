@@ -0,0 +1,164 @@
+#include <catch.hpp>
+
+#include <Tools/array.hpp>
+#include <Tools/small_string.hpp>
+#include <Tools/small_vector.hpp>
+#include <Tools/stack_allocator.hpp>
+#include <Tools/trivial_allocator_adapter.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+
+using namespace ctp;
+
+namespace {
+
+using arena_256 = stack_arena<256>;
+template <typename T>
+using arena_allocator = trivial_init_allocator<T, stack_allocator<T, arena_256>>;
+
+static_assert(std::is_same_v<std::allocator_traits<arena_allocator<int>>::rebind_alloc<char>, arena_allocator<char>>);
+
+constexpr bool constexpr_allocations() {
+	arena_256 arena;
+	stack_allocator<int, arena_256> alloc{arena};
+	int* const ptr = alloc.allocate(4);
+	ptr[3] = 3;
+	const bool ok = ptr[3] == 3;
+	alloc.deallocate(ptr, 4);
+	return ok;
+}
+static_assert(constexpr_allocations());
+
+} // namespace
+
+TEST_CASE("stack_arena", "[Tools][stack_allocator]") {
+	stack_arena<64> arena;
+	CHECK(arena.capacity() == 64);
+	CHECK(arena.used() == 0);
+
+	void* const a = arena.allocate(3, 1);
+	REQUIRE(a);
+	CHECK(arena.owns(a));
+	CHECK(arena.used() == 3);
+
+	// Aligned, after the last.
+	void* const b = arena.allocate(8, 8);
+	REQUIRE(b);
+	CHECK(reinterpret_cast<std::uintptr_t>(b) % 8 == 0);
+	CHECK(arena.used() == 16);
+
+	// Full.
+	CHECK(arena.allocate(64, 1) == nullptr);
+	CHECK(arena.used() == 16);
+
+	// Only the last allocation gives its memory back.
+	arena.deallocate(a, 3);
+	CHECK(arena.used() == 16);
+	arena.deallocate(b, 8);
+	CHECK(arena.used() == 8);
+	CHECK(arena.allocate(56, 1) != nullptr);
+	CHECK(arena.used() == 64);
+
+	int local = 0;
+	CHECK(!arena.owns(&local));
+	arena.reset();
+	CHECK(arena.used() == 0);
+}
+
+TEST_CASE("stack_allocator", "[Tools][stack_allocator]") {
+	arena_256 arena;
+	stack_allocator<std::uint64_t, arena_256> alloc{arena};
+	const stack_allocator<char, arena_256> other{alloc};
+	CHECK(alloc == other);
+	arena_256 otherArena;
+	CHECK(alloc != stack_allocator<std::uint64_t, arena_256>{otherArena});
+
+	SECTION("From the arena until it's full.") {
+		std::uint64_t* const a = alloc.allocate(16);
+		CHECK(arena.owns(a));
+		std::uint64_t* const b = alloc.allocate(16);
+		CHECK(arena.owns(b));
+		std::uint64_t* const c = alloc.allocate(1);
+		CHECK(!arena.owns(c));
+		alloc.deallocate(c, 1);
+		alloc.deallocate(b, 16);
+		CHECK(arena.used() == 128);
+		alloc.deallocate(a, 16);
+		CHECK(arena.used() == 0);
+	}
+
+	SECTION("Aligns types over-aligned for the buffer.") {
+		struct alignas(64) over_aligned {
+			std::uint64_t value;
+		};
+		stack_allocator<over_aligned, arena_256> overAligned{alloc};
+		static_cast<void>(alloc.allocate(1));
+		over_aligned* const a = overAligned.allocate(1);
+		over_aligned* const b = overAligned.allocate(1);
+		CHECK(arena.owns(a));
+		CHECK(arena.owns(b));
+		CHECK(reinterpret_cast<std::uintptr_t>(a) % 64 == 0);
+		CHECK(reinterpret_cast<std::uintptr_t>(b) % 64 == 0);
+		arena.reset();
+	}
+
+	SECTION("Too large for the arena at all.") {
+		std::uint64_t* const ptr = alloc.allocate(1000);
+		CHECK(!arena.owns(ptr));
+		CHECK(arena.used() == 0);
+		alloc.deallocate(ptr, 1000);
+	}
+}
+
+TEST_CASE("stack_allocator with small_vector", "[Tools][stack_allocator]") {
+	arena_256 arena;
+	small_vector<int, 8, arena_allocator<int>> values{arena};
+
+	const auto owned = [&] { return arena.owns(values.data()); };
+
+	for (int i = 0; i < 8; ++i)
+		values.push_back(i);
+	CHECK(arena.used() == 0);
+
+	// Spills into the arena, growing to 13 then 21.
+	for (int i = 8; i < 21; ++i)
+		values.push_back(i);
+	CHECK(owned());
+	CHECK(arena.used() == (13 + 21) * sizeof(int));
+
+	// And then the heap.
+	for (int i = 21; i < 200; ++i)
+		values.push_back(i);
+	CHECK(!owned());
+
+	bool intact = true;
+	for (int i = 0; i < 200; ++i)
+		intact &= values[static_cast<std::size_t>(i)] == i;
+	CHECK(intact);
+
+	// Copies share the arena.
+	const auto copy = values;
+	CHECK(copy.get_allocator() == values.get_allocator());
+}
+
+TEST_CASE("stack_allocator with small_string and array", "[Tools][stack_allocator]") {
+	using namespace std::string_view_literals;
+	arena_256 arena;
+
+	small_string<16, arena_allocator<char>> str{arena};
+	str = "short"sv;
+	CHECK(arena.used() == 0);
+	str += " and then long enough to spill"sv;
+	CHECK(arena.owns(str.data()));
+	CHECK(str.view() == "short and then long enough to spill"sv);
+
+	// Only passes the allocator to its items, so the arena is untouched.
+	const std::size_t used = arena.used();
+	ctp::array<int, 4, arena_allocator<int>> items{arena_allocator<int>{arena}};
+	items[3] = 3;
+	CHECK(items[3] == 3);
+	CHECK(arena.used() == used);
+}
@@ -1,8 +1,18 @@
 #ifndef INCLUDE_CTP_TOOLS_BIT_ENUM_HPP
 #define INCLUDE_CTP_TOOLS_BIT_ENUM_HPP
 
+#include "config.hpp"
+#include "debug.hpp"
 #include "type_traits.hpp"
 
+#include <bit>
+#include <cstdint>
+#include <span>
+
+#if CTP_AVX2
+#include <immintrin.h>
+#endif
+
 namespace ctp {
 
 // Wrapper class for bitfield-like enums to enable bit ops.
@@ -82,6 +92,231 @@ struct BitEnum {
 };
 template <typename... Ops> BitEnum(Ops...) -> BitEnum<typename first_element<Ops...>::type>;
 
+// ------------------ operations over many BitEnums ------------------
+// These take the flags as a span and the mask as a BitEnum, which decides the enum type.
+// With AVX2 they test 32 bytes of flags at once, with a scalar loop for the rest.
+
+namespace bit_enum_detail {
+
+#if CTP_AVX2
+template <typename U>
+inline __m256i broadcast(U val) noexcept {
+	if constexpr (sizeof(U) == 1) return _mm256_set1_epi8(static_cast<char>(val));
+	else if constexpr (sizeof(U) == 2) return _mm256_set1_epi16(static_cast<short>(val));
+	else if constexpr (sizeof(U) == 4) return _mm256_set1_epi32(static_cast<int>(val));
+	else return _mm256_set1_epi64x(static_cast<long long>(val));
+}
+
+template <typename U>
+inline __m256i cmpeq(__m256i a, __m256i b) noexcept {
+	if constexpr (sizeof(U) == 1) return _mm256_cmpeq_epi8(a, b);
+	else if constexpr (sizeof(U) == 2) return _mm256_cmpeq_epi16(a, b);
+	else if constexpr (sizeof(U) == 4) return _mm256_cmpeq_epi32(a, b);
+	else return _mm256_cmpeq_epi64(a, b);
+}
+
+// One bit per lane of a comparison result, lowest lane first.
+template <typename U>
+inline std::uint32_t lane_bits(__m256i cmp) noexcept {
+	if constexpr (sizeof(U) == 1) {
+		return static_cast<std::uint32_t>(_mm256_movemask_epi8(cmp));
+	} else if constexpr (sizeof(U) == 2) {
+		// Narrow each lane to a byte. Packing works within 128 bit halves, so gather the two halves' results.
+		const __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi16(cmp, cmp), 0b1000);
+		return static_cast<std::uint32_t>(_mm256_movemask_epi8(packed)) & 0xFFFF;
+	} else if constexpr (sizeof(U) == 4) {
+		return static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(cmp)));
+	} else {
+		return static_cast<std::uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(cmp)));
+	}
+}
+
+// Number of flags in one vector.
+template <typename U>
+inline constexpr std::size_t BlockLanes = 32 / sizeof(U);
+#endif // CTP_AVX2
+
+// Calls f(i, bits) for each full block of flags starting at i, where bit j of bits is set if flags[i + j]
+// matches the mask. Returns how many flags were covered; the caller tests the rest one at a time.
+template <bool AllOf, typename Enum, typename F>
+inline std::size_t match_blocks([[maybe_unused]] std::span<const BitEnum<Enum>> flags,
+	[[maybe_unused]] BitEnum<Enum> mask, [[maybe_unused]] F&& f) noexcept
+{
+#if CTP_AVX2
+	using U = std::underlying_type_t<Enum>;
+	constexpr std::size_t Lanes = BlockLanes<U>;
+	const __m256i vmask = broadcast(mask.underlying());
+	const std::size_t end = flags.size() - flags.size() % Lanes;
+	for (std::size_t i = 0; i < end; i += Lanes) {
+		const __m256i vals = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(flags.data() + i));
+		const __m256i masked = _mm256_and_si256(vals, vmask);
+		if constexpr (AllOf) {
+			f(i, lane_bits<U>(cmpeq<U>(masked, vmask)));
+		} else {
+			constexpr std::uint32_t AllLanes = Lanes == 32 ? ~std::uint32_t{0} : (std::uint32_t{1} << Lanes) - 1;
+			f(i, ~lane_bits<U>(cmpeq<U>(masked, _mm256_setzero_si256())) & AllLanes);
+		}
+	}
+	return end;
+#else
+	return 0;
+#endif
+}
+
+template <bool AllOf, typename Enum>
+constexpr bool matches(BitEnum<Enum> flags, BitEnum<Enum> mask) noexcept {
+	if constexpr (AllOf)
+		return (flags & mask) == mask;
+	else
+		return (flags & mask) != BitEnum<Enum>{};
+}
+
+template <bool AllOf, typename Enum>
+constexpr std::size_t count(std::span<const BitEnum<Enum>> flags, BitEnum<Enum> mask) noexcept {
+	std::size_t count = 0;
+	std::size_t i = 0;
+	if CTP_NOT_CONSTEVAL {
+		i = match_blocks<AllOf>(flags, mask, [&count](std::size_t, std::uint32_t bits) {
+			count += static_cast<std::size_t>(std::popcount(bits));
+		});
+	}
+	for (; i < flags.size(); ++i)
+		count += matches<AllOf>(flags[i], mask);
+	return count;
+}
+
+template <bool AllOf, typename Enum>
+constexpr std::size_t select(std::span<const BitEnum<Enum>> flags, BitEnum<Enum> mask, std::span<std::uint32_t> indices) noexcept {
+	ctpExpects(indices.size() >= flags.size());
+	std::size_t count = 0;
+	std::size_t i = 0;
+	if CTP_NOT_CONSTEVAL {
+		i = match_blocks<AllOf>(flags, mask, [&count, indices](std::size_t base, std::uint32_t bits) {
+			for (; bits != 0; bits &= bits - 1)
+				indices[count++] = static_cast<std::uint32_t>(base + static_cast<std::size_t>(std::countr_zero(bits)));
+		});
+	}
+	for (; i < flags.size(); ++i) {
+		if (matches<AllOf>(flags[i], mask))
+			indices[count++] = static_cast<std::uint32_t>(i);
+	}
+	return count;
+}
+
+template <bool AllOf, typename Enum>
+constexpr std::size_t select_bits(std::span<const BitEnum<Enum>> flags, BitEnum<Enum> mask, std::span<std::uint64_t> bits) noexcept {
+	ctpExpects(bits.size() >= (flags.size() + 63) / 64);
+	for (std::uint64_t& word : bits)
+		word = 0;
+	std::size_t count = 0;
+	std::size_t i = 0;
+	if CTP_NOT_CONSTEVAL {
+		// Blocks never straddle a word, since their size divides 64.
+		i = match_blocks<AllOf>(flags, mask, [&count, bits](std::size_t base, std::uint32_t blockBits) {
+			bits[base / 64] |= std::uint64_t{blockBits} << (base % 64);
+			count += static_cast<std::size_t>(std::popcount(blockBits));
+		});
+	}
+	for (; i < flags.size(); ++i) {
+		if (matches<AllOf>(flags[i], mask)) {
+			bits[i / 64] |= std::uint64_t{1} << (i % 64);
+			++count;
+		}
+	}
+	return count;
+}
+
+// Set or unset the bits of the mask in every flag.
+template <bool Set, typename Enum>
+constexpr void modify(std::span<BitEnum<Enum>> flags, BitEnum<Enum> mask) noexcept {
+	std::size_t i = 0;
+	if CTP_NOT_CONSTEVAL {
+#if CTP_AVX2
+		using U = std::underlying_type_t<Enum>;
+		constexpr std::size_t Lanes = BlockLanes<U>;
+		const __m256i vmask = broadcast(mask.underlying());
+		const std::size_t end = flags.size() - flags.size() % Lanes;
+		for (; i < end; i += Lanes) {
+			auto* p = reinterpret_cast<__m256i*>(flags.data() + i);
+			const __m256i vals = _mm256_loadu_si256(p);
+			if constexpr (Set)
+				_mm256_storeu_si256(p, _mm256_or_si256(vals, vmask));
+			else
+				_mm256_storeu_si256(p, _mm256_andnot_si256(vmask, vals));
+		}
+#endif
+	}
+	const BitEnum<Enum> keep = ~mask;
+	for (; i < flags.size(); ++i) {
+		if constexpr (Set)
+			flags[i] |= mask;
+		else
+			flags[i] &= keep;
+	}
+}
+
+} // bit_enum_detail
+
+// Number of flags with any bit of the mask set.
+template <typename Enum>
+[[nodiscard]] constexpr std::size_t count_any_of(std::type_identity_t<std::span<const BitEnum<Enum>>> flags, BitEnum<Enum> mask) noexcept {
+	return bit_enum_detail::count<false>(flags, mask);
+}
+
+// Number of flags with all bits of the mask set.
+template <typename Enum>
+[[nodiscard]] constexpr std::size_t count_all_of(std::type_identity_t<std::span<const BitEnum<Enum>>> flags, BitEnum<Enum> mask) noexcept {
+	return bit_enum_detail::count<true>(flags, mask);
+}
+
+// Write the indices of flags with any bit of the mask set, in ascending order.
+// indices must be at least as large as flags. Returns the number written.
+template <typename Enum>
+constexpr std::size_t select_any_of(std::type_identity_t<std::span<const BitEnum<Enum>>> flags, BitEnum<Enum> mask,
+	std::span<std::uint32_t> indices) noexcept
+{
+	return bit_enum_detail::select<false>(flags, mask, indices);
+}
+
+// Write the indices of flags with all bits of the mask set, in ascending order.
+// indices must be at least as large as flags. Returns the number written.
+template <typename Enum>
+constexpr std::size_t select_all_of(std::type_identity_t<std::span<const BitEnum<Enum>>> flags, BitEnum<Enum> mask,
+	std::span<std::uint32_t> indices) noexcept
+{
+	return bit_enum_detail::select<true>(flags, mask, indices);
+}
+
+// Set bit i of bits if flags[i] has any bit of the mask set; other bits are cleared.
+// bits must hold at least one bit per flag. Returns the number of bits set.
+template <typename Enum>
+constexpr std::size_t select_any_of(std::type_identity_t<std::span<const BitEnum<Enum>>> flags, BitEnum<Enum> mask,
+	std::span<std::uint64_t> bits) noexcept
+{
+	return bit_enum_detail::select_bits<false>(flags, mask, bits);
+}
+
+// Set bit i of bits if flags[i] has all bits of the mask set; other bits are cleared.
+// bits must hold at least one bit per flag. Returns the number of bits set.
+template <typename Enum>
+constexpr std::size_t select_all_of(std::type_identity_t<std::span<const BitEnum<Enum>>> flags, BitEnum<Enum> mask,
+	std::span<std::uint64_t> bits) noexcept
+{
+	return bit_enum_detail::select_bits<true>(flags, mask, bits);
+}
+
+// Set the bits of the mask in every flag.
+template <typename Enum>
+constexpr void set_all(std::type_identity_t<std::span<BitEnum<Enum>>> flags, BitEnum<Enum> mask) noexcept {
+	bit_enum_detail::modify<true>(flags, mask);
+}
+
+// Unset the bits of the mask in every flag.
+template <typename Enum>
+constexpr void unset_all(std::type_identity_t<std::span<BitEnum<Enum>>> flags, BitEnum<Enum> mask) noexcept {
+	bit_enum_detail::modify<false>(flags, mask);
+}
+
 } // namespace ctp
 
 #endif // INCLUDE_CTP_TOOLS_BIT_ENUM_HPP
@@ -1,9 +1,15 @@
 #ifndef INCLUDE_CTP_TOOLS_STRONG_TYPE_HPP
 #define INCLUDE_CTP_TOOLS_STRONG_TYPE_HPP
 
+#include "config.hpp"
 #include "CrtpHelper.hpp"
+#include "debug.hpp"
 #include "type_traits.hpp"
 
+#include <algorithm>
+#include <array>
+#include <span>
+
 namespace ctp {
 
 // StrongTypes can be used to prevent accidental interop of one StrongType with another StrongType,
@@ -77,6 +83,9 @@ struct ValueOperable {
 template <typename Strictness = strictness_relaxed>
 struct ValueArithmetic : Arithmetic, ValueOperable<Strictness> {};
 
+// Defines its own explicit conversions to other types, rather than converting the value, like fixed_point.
+struct CustomConversions {};
+
 // Can implicitly convert to the value_type. Useful for index types wtih STL.
 // Needs to use CRTP to work with operator[] properly, otherwise is mixed in the same as the rest.
 template <typename Derived, typename ConstructFrom = Derived>
@@ -157,10 +166,14 @@ struct StrongType : CrtpHelper<Derived, StrongType<Derived, T, ConstructFrom>> {
 
 	// Conversions.
 
-	template <typename D = Derived, std::enable_if_t<!has_base_template_v<D, ImplicitlyConvertible>, int> = 0>
+	template <typename D = Derived, std::enable_if_t<std::conjunction_v<
+		std::negation<has_base_template<D, ImplicitlyConvertible>>,
+		std::negation<std::is_base_of<CustomConversions, D>>>, int> = 0>
 	explicit constexpr operator value_type() const noexcept { return value; }
 
-	template <typename U, std::enable_if_t<!detail::is_strong_type_v<U>, int> = 0>
+	template <typename U, typename D = Derived, std::enable_if_t<std::conjunction_v<
+		std::negation<detail::is_strong_type<U>>,
+		std::negation<std::is_base_of<CustomConversions, D>>>, int> = 0>
 	explicit constexpr operator U() const noexcept { return static_cast<U>(value); }
 
 	// Cast from a StrongType to another type.
@@ -170,6 +183,8 @@ struct StrongType : CrtpHelper<Derived, StrongType<Derived, T, ConstructFrom>> {
 	{
 		if constexpr (std::conjunction_v<detail::is_strong_type<U>, is_detected<has_convert, U, Derived>>)
 			return U::convert(this->derived());
+		else if constexpr (std::conjunction_v<std::negation<detail::is_strong_type<U>>, std::is_base_of<CustomConversions, Derived>>)
+			return static_cast<U>(this->derived());
 		else
 			return static_cast<U>(value);
 	}
@@ -567,6 +582,216 @@ constexpr R getCompatibleValue(const MaybeStrongType& maybeStrongType) noexcept
 	}
 }
 } // detail
+
+// Spans of StrongTypes.
+
+// A StrongType laid out exactly like its value_type, so a span of them can be used as a span of values.
+template <typename S>
+concept ValueLayoutStrongType =
+	detail::is_strong_type_v<std::remove_const_t<S>> &&
+	std::is_standard_layout_v<std::remove_const_t<S>> &&
+	std::is_trivially_copyable_v<std::remove_const_t<S>> &&
+	sizeof(S) == sizeof(typename S::value_type) &&
+	alignof(S) == alignof(typename S::value_type);
+
+// View a span of StrongTypes as a span of their values, to hand to code that only knows the value_type.
+template <typename S, std::size_t Extent>
+[[nodiscard]] inline auto as_values(const std::span<S, Extent> strong) noexcept
+{
+	static_assert(ValueLayoutStrongType<S>,
+		CTP_STRONG_TYPE_STATIC_ASSERT_FAIL_HEADER
+		"Only StrongTypes with the same layout as their value_type can be viewed as values. Check that the "
+		"StrongType and its mixins add no members or virtual functions, and that it's trivially copyable."
+		CTP_STRONG_TYPE_STATIC_ASSERT_FAIL_FOOTER);
+	using V = std::conditional_t<std::is_const_v<S>, const typename S::value_type, typename S::value_type>;
+	return std::span<V, Extent>{reinterpret_cast<V*>(strong.data()), strong.size()};
+}
+
+// View a span of values as a span of StrongType S.
+template <typename S, typename V, std::size_t Extent>
+	requires std::is_same_v<std::remove_const_t<V>, typename S::value_type>
+[[nodiscard]] inline auto as_strong(const std::span<V, Extent> values) noexcept
+{
+	static_assert(ValueLayoutStrongType<S>,
+		CTP_STRONG_TYPE_STATIC_ASSERT_FAIL_HEADER
+		"Only StrongTypes with the same layout as their value_type can view values."
+		CTP_STRONG_TYPE_STATIC_ASSERT_FAIL_FOOTER);
+	using R = std::conditional_t<std::is_const_v<V>, const S, S>;
+	return std::span<R, Extent>{reinterpret_cast<R*>(values.data()), values.size()};
+}
+
+namespace detail {
+template <typename T>
+constexpr auto& value_of(T& item) noexcept
+{
+	if constexpr (is_strong_type_v<std::remove_const_t<T>>)
+		return item.value;
+	else
+		return item;
+}
+
+// Enough accumulators to fill a couple of vector registers. A single accumulator is a dependency chain the
+// compiler can't split for floating-point types, since it would change the result.
+template <typename T>
+inline constexpr std::size_t ReductionLanes = std::max<std::size_t>(1, 64 / sizeof(T));
+
+// Items are StrongTypes at compile time, and their values at runtime, so the loops only see the value_type.
+template <typename T, typename Item, typename Op>
+constexpr T reduce_lanes(const std::span<Item> items, const T init, Op op) noexcept
+{
+	constexpr std::size_t Lanes = ReductionLanes<T>;
+	std::array<T, Lanes> lanes;
+	lanes.fill(init);
+	const std::size_t end = items.size() - items.size() % Lanes;
+	std::size_t i = 0;
+	for (; i < end; i += Lanes) {
+		for (std::size_t j = 0; j < Lanes; ++j)
+			lanes[j] = op(lanes[j], detail::value_of(items[i + j]));
+	}
+	for (; i < items.size(); ++i)
+		lanes[0] = op(lanes[0], detail::value_of(items[i]));
+	for (std::size_t width = Lanes / 2; width > 0; width /= 2) {
+		for (std::size_t j = 0; j < width; ++j)
+			lanes[j] = op(lanes[j], lanes[j + width]);
+	}
+	return lanes[0];
+}
+
+// Sets the result's value rather than constructing from it, since a StrongType may interpret a value_type, like
+// fixed_point does.
+template <typename S, typename Op>
+constexpr S reduce_strong(const std::span<const S> strong, const typename S::value_type init, Op op) noexcept
+{
+	S result;
+	if CTP_IS_CONSTEVAL {
+		result.value = detail::reduce_lanes(strong, init, op);
+	} else {
+		result.value = detail::reduce_lanes(as_values(strong), init, op);
+	}
+	return result;
+}
+
+template <typename Out, typename Lhs, typename Rhs, typename Op>
+constexpr void transform_lanes(const std::span<Lhs> lhs, const std::span<Rhs> rhs, const std::span<Out> out, Op op) noexcept
+{
+	for (std::size_t i = 0; i < out.size(); ++i)
+		detail::value_of(out[i]) = op(detail::value_of(lhs[i]), detail::value_of(rhs[i]));
+}
+
+template <typename S, typename Op>
+constexpr void transform_strong(const std::span<const S> lhs, const std::span<const S> rhs, const std::span<S> out, Op op) noexcept
+{
+	ctpExpects(lhs.size() == out.size() && rhs.size() == out.size());
+	if CTP_IS_CONSTEVAL {
+		detail::transform_lanes(lhs, rhs, out, op);
+	} else {
+		detail::transform_lanes(as_values(lhs), as_values(rhs), as_values(out), op);
+	}
+}
+
+// The type to do integer arithmetic in so that it wraps rather than overflows: unsigned, and at least as wide as
+// unsigned int so that it isn't promoted back to int.
+template <typename T, bool = std::is_integral_v<T> && !std::is_same_v<T, bool>>
+struct wrapping {
+	using type = T;
+};
+template <typename T>
+struct wrapping<T, true> {
+	using type = std::common_type_t<std::make_unsigned_t<T>, unsigned int>;
+};
+template <typename T>
+using wrapping_t = typename wrapping<T>::type;
+
+template <typename T>
+constexpr T wrapping_add(const T lhs, const T rhs) noexcept
+{
+	return static_cast<T>(static_cast<wrapping_t<T>>(lhs) + static_cast<wrapping_t<T>>(rhs));
+}
+
+template <typename T>
+constexpr T wrapping_subtract(const T lhs, const T rhs) noexcept
+{
+	return static_cast<T>(static_cast<wrapping_t<T>>(lhs) - static_cast<wrapping_t<T>>(rhs));
+}
+
+template <typename T>
+constexpr T wrapping_multiply(const T lhs, const T rhs) noexcept
+{
+	return static_cast<T>(static_cast<wrapping_t<T>>(lhs) * static_cast<wrapping_t<T>>(rhs));
+}
+
+template <typename S>
+concept ArithmeticStrongType = ValueLayoutStrongType<S> && std::is_arithmetic_v<typename S::value_type>;
+
+template <typename S>
+concept SummableStrongType = ArithmeticStrongType<S> && is_summable_v<S>;
+
+template <typename S>
+concept MultipliableStrongType = ArithmeticStrongType<S> && is_multipliable_v<S>;
+} // detail
+
+// Vectorized operations over spans of StrongTypes, which work on the values so that they vectorize like loops
+// over raw arrays, and give back StrongTypes. Integer values wrap on overflow, like unsigned integers.
+
+// Sum of all the values. Floating-point sums are added in several interleaved partial sums, so may differ from
+// adding them in order in the last bits.
+template <typename S, std::size_t Extent>
+	requires detail::SummableStrongType<std::remove_const_t<S>>
+[[nodiscard]] constexpr std::remove_const_t<S> sum_values(const std::span<S, Extent> strong) noexcept
+{
+	using Strong = std::remove_const_t<S>;
+	using T = typename Strong::value_type;
+	return detail::reduce_strong(std::span<const Strong>{strong}, T{}, [](const T lhs, const T rhs) { return detail::wrapping_add(lhs, rhs); });
+}
+
+// The smallest value. strong must not be empty.
+template <typename S, std::size_t Extent>
+	requires detail::ArithmeticStrongType<std::remove_const_t<S>>
+[[nodiscard]] constexpr std::remove_const_t<S> min_value(const std::span<S, Extent> strong) noexcept
+{
+	ctpExpects(!strong.empty());
+	using Strong = std::remove_const_t<S>;
+	using T = typename Strong::value_type;
+	return detail::reduce_strong(std::span<const Strong>{strong}, strong[0].value, [](const T lhs, const T rhs) { return rhs < lhs ? rhs : lhs; });
+}
+
+// The largest value. strong must not be empty.
+template <typename S, std::size_t Extent>
+	requires detail::ArithmeticStrongType<std::remove_const_t<S>>
+[[nodiscard]] constexpr std::remove_const_t<S> max_value(const std::span<S, Extent> strong) noexcept
+{
+	ctpExpects(!strong.empty());
+	using Strong = std::remove_const_t<S>;
+	using T = typename Strong::value_type;
+	return detail::reduce_strong(std::span<const Strong>{strong}, strong[0].value, [](const T lhs, const T rhs) { return lhs < rhs ? rhs : lhs; });
+}
+
+// out[i] = lhs[i] + rhs[i]. All the spans must be the same size, and out may be one of the inputs.
+template <typename S>
+	requires detail::SummableStrongType<S>
+constexpr void add_values(std::type_identity_t<std::span<const S>> lhs, std::type_identity_t<std::span<const S>> rhs, const std::span<S> out) noexcept
+{
+	using T = typename S::value_type;
+	detail::transform_strong(lhs, rhs, out, [](const T l, const T r) { return detail::wrapping_add(l, r); });
+}
+
+// out[i] = lhs[i] - rhs[i]. All the spans must be the same size, and out may be one of the inputs.
+template <typename S>
+	requires detail::SummableStrongType<S>
+constexpr void subtract_values(std::type_identity_t<std::span<const S>> lhs, std::type_identity_t<std::span<const S>> rhs, const std::span<S> out) noexcept
+{
+	using T = typename S::value_type;
+	detail::transform_strong(lhs, rhs, out, [](const T l, const T r) { return detail::wrapping_subtract(l, r); });
+}
+
+// out[i] = strong[i] * factor. The spans must be the same size, and out may be strong.
+template <typename S>
+	requires detail::MultipliableStrongType<S>
+constexpr void scale_values(std::type_identity_t<std::span<const S>> strong, const typename S::value_type factor, const std::span<S> out) noexcept
+{
+	using T = typename S::value_type;
+	detail::transform_strong(strong, strong, out, [factor](const T value, T) { return detail::wrapping_multiply(value, factor); });
+}
 } // ctp
 
 #undef CTP_STRONG_TYPE_STATIC_ASSERT_FAIL_HEADER
@@ -0,0 +1,249 @@
+#ifndef INCLUDE_CTP_TOOLS_BINARY_LOG_HPP
+#define INCLUDE_CTP_TOOLS_BINARY_LOG_HPP
+
+#include "clock.hpp"
+#include "config.hpp"
+
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Deferred formatting log. A call only writes the id of its call site, a timestamp and the raw bytes
+// of its arguments into a thread local buffer, which is written to a file when full. Formatting
+// happens offline, with decode or the BinLogDecoder tool. Cheap enough to keep enabled in Release.
+//
+// Format strings use fmt syntax, and are checked to have one replacement field per argument:
+//   ctpBinLog(ctp::binlog::level::info, "moved {} to ({}, {})", id, x, y);
+//
+// Supported arguments are bools, characters, integers, enums, floating point, pointers, and strings
+// (anything convertible to std::string_view), which are copied.
+
+namespace ctp::binlog {
+
+enum class level : std::uint8_t {
+	info,
+	warn,
+	error,
+};
+
+enum class arg_type : std::uint8_t {
+	boolean,
+	character,
+	i32,
+	u32,
+	i64,
+	u64,
+	f64,
+	string,
+	pointer,
+};
+
+// A call site. Lives in static storage, and is given an id the first time it logs.
+struct site {
+	const char* file;
+	int line;
+	level lvl;
+	const char* format;
+	std::atomic<std::uint32_t> id{0};
+};
+
+// Layout of a log file. All values are little endian, as written by the host.
+//
+// File header: Magic, then u64 cpu_ticks and u64 steady_ns at open, to calibrate ticks.
+// Then any number of chunks, each written by one thread:
+//   Chunk header: u32 bytes of records, u32 thread number, u64 ticks and u64 nanoseconds at write.
+//   Records, each starting with a u32 id:
+//     With SiteFlag set, defines a site: u32 line, u8 level, u8 argument count, an arg_type per
+//     argument, then file and format as strings.
+//     Otherwise, a log from the site with that id: u64 ticks, then the arguments.
+//   Strings are a u32 size followed by the characters. Other arguments are their arg_type's size.
+namespace file_format {
+inline constexpr std::array<char, 8> Magic{'C', 'T', 'P', 'B', 'L', 'O', 'G', '1'};
+inline constexpr std::size_t FileHeaderBytes = Magic.size() + 16;
+inline constexpr std::size_t ChunkHeaderBytes = 24;
+inline constexpr std::uint32_t SiteFlag = 0x8000'0000;
+} // file_format
+
+// Start logging to a new file. Returns false if it could not be opened.
+bool open(const std::string& path) noexcept;
+// Write out the calling thread's buffer and close the file. Other threads should flush first.
+void close() noexcept;
+// Write out the calling thread's buffer. Threads also do this when their buffer is full, and when they exit.
+void flush() noexcept;
+
+// Render a binary log as text, a line per log in timestamp order. Returns false if the data is not a valid log.
+bool decode(std::span<const char> data, std::ostream& out);
+// Render a binary log file as text, a line per log in timestamp order. Returns false if the file is not a valid log.
+bool decode_file(const std::string& path, std::ostream& out);
+
+namespace detail {
+
+template <class T>
+consteval arg_type arg_type_of() {
+	using U = std::remove_cvref_t<T>;
+	if constexpr (std::is_same_v<U, bool>)
+		return arg_type::boolean;
+	else if constexpr (std::is_same_v<U, char>)
+		return arg_type::character;
+	else if constexpr (std::is_enum_v<U>)
+		return arg_type_of<std::underlying_type_t<U>>();
+	else if constexpr (std::is_integral_v<U>)
+		return sizeof(U) <= 4
+			? (std::is_signed_v<U> ? arg_type::i32 : arg_type::u32)
+			: (std::is_signed_v<U> ? arg_type::i64 : arg_type::u64);
+	else if constexpr (std::is_floating_point_v<U>)
+		return arg_type::f64;
+	else if constexpr (std::is_convertible_v<const U&, std::string_view>)
+		return arg_type::string;
+	else if constexpr (std::is_pointer_v<U> || std::is_null_pointer_v<U>)
+		return arg_type::pointer;
+	else
+		static_assert(sizeof(U) == 0, "Unsupported binary log argument type.");
+}
+
+template <class... Args>
+inline constexpr std::array<arg_type, sizeof...(Args)> ArgTypes{arg_type_of<Args>()...};
+
+consteval std::size_t fixed_size(arg_type type) {
+	switch (type) {
+	case arg_type::boolean:
+	case arg_type::character:
+		return 1;
+	case arg_type::i32:
+	case arg_type::u32:
+		return 4;
+	case arg_type::string:
+		// Just the size prefix.
+		return 4;
+	default:
+		return 8;
+	}
+}
+
+// Count fmt replacement fields, skipping escaped braces.
+consteval std::size_t count_fields(std::string_view format) {
+	std::size_t count = 0;
+	for (std::size_t i = 0; i < format.size(); ++i) {
+		if (format[i] == '{') {
+			if (i + 1 < format.size() && format[i + 1] == '{')
+				++i;
+			else
+				++count;
+		} else if (format[i] == '}' && i + 1 < format.size() && format[i + 1] == '}') {
+			++i;
+		}
+	}
+	return count;
+}
+
+template <class... Args>
+constexpr auto count_args(const Args&...) noexcept { return std::integral_constant<std::size_t, sizeof...(Args)>{}; }
+
+// Where the calling thread writes records. Trivial, so it is cheap to access.
+struct buffer_cursor {
+	char* pos = nullptr;
+	char* end = nullptr;
+};
+inline thread_local constinit buffer_cursor LocalCursor{};
+inline constinit std::atomic<bool> Enabled{false};
+
+// Make room for a record in the calling thread's buffer. Returns false if logging is disabled or it can never fit.
+bool reserve_slow(std::size_t bytes) noexcept;
+// Give a site an id, and write its definition.
+std::uint32_t register_site(site& s, std::span<const arg_type> types) noexcept;
+
+template <class T>
+inline char* put(char* p, const T& value) noexcept {
+	std::memcpy(p, &value, sizeof(T));
+	return p + sizeof(T);
+}
+
+template <class T>
+inline std::size_t variable_size(const T& arg) noexcept {
+	if constexpr (arg_type_of<T>() == arg_type::string)
+		return std::string_view{arg}.size();
+	else
+		return 0;
+}
+
+template <class T>
+inline char* put_arg(char* p, const T& arg) noexcept {
+	constexpr arg_type type = arg_type_of<T>();
+	if constexpr (type == arg_type::boolean || type == arg_type::character) {
+		return put(p, static_cast<std::uint8_t>(arg));
+	} else if constexpr (type == arg_type::i32) {
+		return put(p, static_cast<std::int32_t>(arg));
+	} else if constexpr (type == arg_type::u32) {
+		return put(p, static_cast<std::uint32_t>(arg));
+	} else if constexpr (type == arg_type::i64) {
+		return put(p, static_cast<std::int64_t>(arg));
+	} else if constexpr (type == arg_type::u64) {
+		return put(p, static_cast<std::uint64_t>(arg));
+	} else if constexpr (type == arg_type::f64) {
+		return put(p, static_cast<double>(arg));
+	} else if constexpr (type == arg_type::string) {
+		const std::string_view str{arg};
+		p = put(p, static_cast<std::uint32_t>(str.size()));
+		std::memcpy(p, str.data(), str.size());
+		return p + str.size();
+	} else {
+		return put(p, static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(arg)));
+	}
+}
+
+} // detail
+
+// Log from a site. Use ctpBinLog instead, which makes the site.
+template <class... Args>
+inline void write(site& s, const Args&... args) noexcept {
+	if (!detail::Enabled.load(std::memory_order_relaxed))
+		return;
+
+	std::uint32_t id = s.id.load(std::memory_order_relaxed);
+	if (id == 0) [[unlikely]] {
+		id = detail::register_site(s, detail::ArgTypes<Args...>);
+		if (id == 0)
+			return;
+	}
+
+	constexpr std::size_t FixedBytes = sizeof(std::uint32_t) + sizeof(std::uint64_t) + (detail::fixed_size(detail::arg_type_of<Args>()) + ... + 0);
+	const std::size_t bytes = FixedBytes + (detail::variable_size(args) + ... + 0);
+
+	auto& cursor = detail::LocalCursor;
+	if (static_cast<std::size_t>(cursor.end - cursor.pos) < bytes) [[unlikely]] {
+		if (!detail::reserve_slow(bytes))
+			return;
+	}
+
+	char* p = detail::put(cursor.pos, id);
+	p = detail::put(p, cpu_ticks());
+	((p = detail::put_arg(p, args)), ...);
+	cursor.pos = p;
+}
+
+} // ctp::binlog
+
+// Log to the binary log. The format string must be a literal with a replacement field per argument.
+#define ctpBinLog(level, format, ...) do { \
+	static_assert(::ctp::binlog::detail::count_fields(format) == \
+		decltype(::ctp::binlog::detail::count_args(__VA_ARGS__))::value, \
+		"Binary log format needs one replacement field per argument."); \
+	static constinit ::ctp::binlog::site ctpBinLogSite_{__FILE__, __LINE__, level, format}; \
+	::ctp::binlog::write(ctpBinLogSite_ __VA_OPT__(,) __VA_ARGS__); \
+} while (0)
+
+// Log to the binary log.
+#define ctpBinLogi(format, ...) ctpBinLog(::ctp::binlog::level::info, format __VA_OPT__(,) __VA_ARGS__)
+// Log to the binary log.
+#define ctpBinLogw(format, ...) ctpBinLog(::ctp::binlog::level::warn, format __VA_OPT__(,) __VA_ARGS__)
+// Log to the binary log.
+#define ctpBinLoge(format, ...) ctpBinLog(::ctp::binlog::level::error, format __VA_OPT__(,) __VA_ARGS__)
+
+#endif // INCLUDE_CTP_TOOLS_BINARY_LOG_HPP
@@ -4,11 +4,20 @@
 #include "config.hpp"
 #include "small_string.hpp"
 
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <charconv>
+#include <compare>
 #include <concepts>
+#include <cstdint>
+#include <cstring>
 #include <limits>
+#include <optional>
+#include <span>
 #include <string_view>
+#include <system_error>
+#include <type_traits>
 
 namespace ctp {
 
@@ -27,8 +36,536 @@ std::integral<I> && std::integral<U> &&
 !std::is_same_v<I, bool> && !std::is_same_v<U, bool>&&
 max_char_digits_10_v<U> <= max_char_digits_10_v<I>;
 
+// The floating point types with shortest round-trip conversions.
+template <typename F>
+concept IsCharconvFloat = std::same_as<F, float> || std::same_as<F, double>;
+
+// Get the maximum number of chars in the shortest representation of a floating point type that round-trips, like
+// "-2.2250738585072014e-308".
+template <IsCharconvFloat F>
+struct max_chars_shortest {
+	static constexpr int value = 1 + std::numeric_limits<F>::max_digits10 + 1 + 2 + (std::numeric_limits<F>::max_exponent10 >= 100 ? 3 : 2);
+};
+
+template <IsCharconvFloat F>
+static constexpr auto max_chars_shortest_v = max_chars_shortest<F>::value;
+
+namespace charconv_detail {
+
+// ---------------------------------------- Shortest floating point ----------------------------------------
+
+template <IsCharconvFloat F>
+struct float_traits;
+
+template <>
+struct float_traits<float> {
+	using bits_type = std::uint32_t;
+	static constexpr int mantissa_bits = 23;
+	static constexpr int exponent_bits = 8;
+	static constexpr int exponent_bias = 127;
+};
+
+template <>
+struct float_traits<double> {
+	using bits_type = std::uint64_t;
+	static constexpr int mantissa_bits = 52;
+	static constexpr int exponent_bits = 11;
+	static constexpr int exponent_bias = 1023;
+};
+
+// Just enough of an arbitrary precision unsigned integer for exact digit generation in constant evaluation, where
+// the scaled values for a double reach about 2^1140. Words past the size are always zero.
+class big_uint {
+public:
+	static constexpr std::size_t MaxWords = 40;
+
+	constexpr big_uint() noexcept = default;
+	constexpr explicit big_uint(const std::uint64_t value) noexcept {
+		words_[0] = static_cast<std::uint32_t>(value);
+		words_[1] = static_cast<std::uint32_t>(value >> 32);
+		size_ = words_[1] != 0 ? 2 : words_[0] != 0 ? 1 : 0;
+	}
+
+	[[nodiscard]] constexpr bool is_zero() const noexcept { return size_ == 0; }
+
+	constexpr big_uint& shift_left(const int bits) noexcept {
+		if (size_ == 0)
+			return *this;
+		const auto wordShift = static_cast<std::size_t>(bits / 32);
+		const int bitShift = bits % 32;
+		const std::size_t newSize = size_ + wordShift + 1;
+		for (std::size_t i = newSize; i-- > wordShift;) {
+			const std::size_t from = i - wordShift;
+			std::uint32_t word = from < size_ ? words_[from] << bitShift : 0;
+			if (bitShift != 0 && from > 0)
+				word |= words_[from - 1] >> (32 - bitShift);
+			words_[i] = word;
+		}
+		std::fill_n(words_.begin(), wordShift, 0u);
+		size_ = newSize;
+		trim();
+		return *this;
+	}
+
+	constexpr big_uint& multiply(const std::uint32_t factor) noexcept {
+		std::uint64_t carry = 0;
+		for (std::size_t i = 0; i < size_; ++i) {
+			const std::uint64_t product = std::uint64_t{words_[i]} * factor + carry;
+			words_[i] = static_cast<std::uint32_t>(product);
+			carry = product >> 32;
+		}
+		if (carry != 0)
+			words_[size_++] = static_cast<std::uint32_t>(carry);
+		trim();
+		return *this;
+	}
+
+	constexpr big_uint& multiply_pow10(int exponent) noexcept {
+		for (; exponent >= 9; exponent -= 9)
+			multiply(1000000000);
+		std::uint32_t factor = 1;
+		for (; exponent > 0; --exponent)
+			factor *= 10;
+		return multiply(factor);
+	}
+
+	constexpr big_uint& operator+=(const big_uint& other) noexcept {
+		const std::size_t size = std::max(size_, other.size_);
+		std::uint64_t carry = 0;
+		for (std::size_t i = 0; i < size; ++i) {
+			const std::uint64_t sum = std::uint64_t{words_[i]} + other.words_[i] + carry;
+			words_[i] = static_cast<std::uint32_t>(sum);
+			carry = sum >> 32;
+		}
+		size_ = size;
+		if (carry != 0)
+			words_[size_++] = static_cast<std::uint32_t>(carry);
+		return *this;
+	}
+
+	// The other must be no more than this.
+	constexpr big_uint& operator-=(const big_uint& other) noexcept {
+		std::uint64_t borrow = 0;
+		for (std::size_t i = 0; i < size_; ++i) {
+			const std::uint64_t difference = std::uint64_t{words_[i]} - other.words_[i] - borrow;
+			words_[i] = static_cast<std::uint32_t>(difference);
+			borrow = difference >> 63;
+		}
+		trim();
+		return *this;
+	}
+
+	[[nodiscard]] friend constexpr big_uint operator+(big_uint lhs, const big_uint& rhs) noexcept { return lhs += rhs; }
+
+	// Divides by the divisor, and returns the remainder.
+	constexpr std::uint32_t divide(const std::uint32_t divisor) noexcept {
+		std::uint64_t remainder = 0;
+		for (std::size_t i = size_; i-- > 0;) {
+			const std::uint64_t value = (remainder << 32) | words_[i];
+			words_[i] = static_cast<std::uint32_t>(value / divisor);
+			remainder = value % divisor;
+		}
+		trim();
+		return static_cast<std::uint32_t>(remainder);
+	}
+
+	[[nodiscard]] friend constexpr bool operator==(const big_uint& lhs, const big_uint& rhs) noexcept = default;
+	[[nodiscard]] friend constexpr std::strong_ordering operator<=>(const big_uint& lhs, const big_uint& rhs) noexcept {
+		if (lhs.size_ != rhs.size_)
+			return lhs.size_ <=> rhs.size_;
+		for (std::size_t i = lhs.size_; i-- > 0;) {
+			if (lhs.words_[i] != rhs.words_[i])
+				return lhs.words_[i] <=> rhs.words_[i];
+		}
+		return std::strong_ordering::equal;
+	}
+
+private:
+	constexpr void trim() noexcept {
+		while (size_ > 0 && words_[size_ - 1] == 0)
+			--size_;
+	}
+
+	std::array<std::uint32_t, MaxWords> words_{};
+	std::size_t size_ = 0;
+};
+
+// Digits with a value of 0.d1d2...dn * 10^exponent.
+struct decimal_digits {
+	std::array<char, 17> digits{};
+	int count = 0;
+	int exponent = 0;
+};
+
+// The shortest digits that round to mantissa * 2^exponent, nearest to it, with ties going to even digits, like
+// Ryu's output. This is Steele & White's free-format printing with Burger & Dybvig's scaling, which is slow but
+// exact, and only needs integers, so it works in constant expressions.
+constexpr decimal_digits shortest_digits(const std::uint64_t mantissa, const int exponent, const bool unequalGaps) noexcept {
+	// Rounding to nearest even includes the bounds of the interval when the mantissa is even.
+	const bool even = mantissa % 2 == 0;
+	// r / s is the value, and the interval that rounds to it is (r - mMinus, r + mPlus) / s. The gap above a power
+	// of two is twice the one below it.
+	const int gapShift = unequalGaps ? 1 : 0;
+	big_uint r{mantissa};
+	big_uint s{1};
+	big_uint mPlus{1};
+	big_uint mMinus{1};
+	if (exponent >= 0) {
+		r.shift_left(exponent + 1 + gapShift);
+		s.shift_left(1 + gapShift);
+		mPlus.shift_left(exponent + gapShift);
+		mMinus.shift_left(exponent);
+	} else {
+		r.shift_left(1 + gapShift);
+		s.shift_left(1 - exponent + gapShift);
+		mPlus.shift_left(gapShift);
+	}
+
+	// Estimate the decimal exponent from the binary one, as ceil(log10(2^floorLog2)). It can be one too low.
+	const int floorLog2 = exponent + static_cast<int>(std::bit_width(mantissa)) - 1;
+	int k = floorLog2 == 0 ? 0 : ((floorLog2 * 78913) >> 18) + 1;
+	if (k >= 0) {
+		s.multiply_pow10(k);
+	} else {
+		r.multiply_pow10(-k);
+		mPlus.multiply_pow10(-k);
+		mMinus.multiply_pow10(-k);
+	}
+
+	const auto reachesHigh = [&] { return even ? r + mPlus >= s : r + mPlus > s; };
+	if (reachesHigh()) {
+		++k;
+	} else {
+		r.multiply(10);
+		mPlus.multiply(10);
+		mMinus.multiply(10);
+	}
+
+	decimal_digits result;
+	result.exponent = k;
+	while (true) {
+		int digit = 0;
+		while (r >= s) {
+			r -= s;
+			++digit;
+		}
+		const bool low = even ? r <= mMinus : r < mMinus;
+		const bool high = reachesHigh();
+		if (!low && !high) {
+			result.digits[static_cast<std::size_t>(result.count++)] = static_cast<char>('0' + digit);
+			r.multiply(10);
+			mPlus.multiply(10);
+			mMinus.multiply(10);
+			continue;
+		}
+
+		if (low && high) {
+			// Either digit round-trips, so take the nearer, or the even one on a tie.
+			const auto twice = r + r;
+			if (twice > s || (twice == s && digit % 2 != 0))
+				++digit;
+		} else if (high) {
+			++digit;
+		}
+		result.digits[static_cast<std::size_t>(result.count++)] = static_cast<char>('0' + digit);
+		return result;
+	}
+}
+
+// Writes the digits the way std::to_chars does without a format: fixed or scientific, whichever is shorter,
+// preferring fixed.
+constexpr char* write_shortest(char* out, const decimal_digits& decimal, const std::uint64_t mantissa, const int exponent) noexcept {
+	const char* const digits = decimal.digits.data();
+	const int n = decimal.count;
+	const int k = decimal.exponent;
+
+	const int scientificExponent = k - 1;
+	const int absExponent = scientificExponent < 0 ? -scientificExponent : scientificExponent;
+	const int scientificLength = n + (n > 1 ? 1 : 0) + 2 + (absExponent >= 100 ? 3 : 2);
+	const int fixedLength = k <= 0 ? 2 - k + n : k < n ? n + 1 : k;
+
+	if (fixedLength > scientificLength) {
+		*out++ = digits[0];
+		if (n > 1) {
+			*out++ = '.';
+			out = std::copy_n(digits + 1, n - 1, out);
+		}
+		*out++ = 'e';
+		*out++ = scientificExponent < 0 ? '-' : '+';
+		if (absExponent >= 100)
+			*out++ = static_cast<char>('0' + absExponent / 100);
+		*out++ = static_cast<char>('0' + absExponent / 10 % 10);
+		*out++ = static_cast<char>('0' + absExponent % 10);
+		return out;
+	}
+
+	if (k <= 0) {
+		*out++ = '0';
+		*out++ = '.';
+		out = std::fill_n(out, -k, '0');
+		return std::copy_n(digits, n, out);
+	}
+	if (k < n) {
+		out = std::copy_n(digits, k, out);
+		*out++ = '.';
+		return std::copy_n(digits + k, n - k, out);
+	}
+	if (exponent > 0) {
+		// Write the exact integer, like std::to_chars, rather than the digits padded with zeros.
+		big_uint value{mantissa};
+		value.shift_left(exponent);
+		std::array<char, 310> reversed{};
+		std::size_t size = 0;
+		while (!value.is_zero())
+			reversed[size++] = static_cast<char>('0' + value.divide(10));
+		return std::reverse_copy(reversed.data(), reversed.data() + size, out);
+	}
+	out = std::copy_n(digits, n, out);
+	return std::fill_n(out, k - n, '0');
+}
+
+// The shortest representation that round-trips, exactly as std::to_chars(first, last, value) writes it, but usable in
+// constant expressions. Returns the end of what was written, which is at most max_chars_shortest_v<F> chars.
+template <IsCharconvFloat F>
+constexpr char* shortest_to_chars_exact(char* out, const F value) noexcept {
+	using traits = float_traits<F>;
+	using bits_type = typename traits::bits_type;
+	constexpr int MaxBiasedExponent = (1 << traits::exponent_bits) - 1;
+
+	const auto bits = std::bit_cast<bits_type>(value);
+	const auto fraction = static_cast<std::uint64_t>(bits & ((bits_type{1} << traits::mantissa_bits) - 1));
+	const auto biasedExponent = static_cast<int>((bits >> traits::mantissa_bits) & static_cast<bits_type>(MaxBiasedExponent));
+
+	if ((bits >> (std::numeric_limits<bits_type>::digits - 1)) != 0)
+		*out++ = '-';
+	if (biasedExponent == MaxBiasedExponent) {
+		const std::string_view special = fraction == 0 ? "inf" : "nan";
+		return std::copy(special.begin(), special.end(), out);
+	}
+	if (biasedExponent == 0 && fraction == 0) {
+		*out++ = '0';
+		return out;
+	}
+
+	std::uint64_t mantissa = fraction;
+	int exponent = 1 - traits::exponent_bias - traits::mantissa_bits;
+	if (biasedExponent != 0) {
+		mantissa |= std::uint64_t{1} << traits::mantissa_bits;
+		exponent = biasedExponent - traits::exponent_bias - traits::mantissa_bits;
+	}
+	const bool unequalGaps = fraction == 0 && biasedExponent > 1;
+	return write_shortest(out, shortest_digits(mantissa, exponent, unequalGaps), mantissa, exponent);
+}
+
+// The shortest representation that round-trips, using the standard library's Ryu implementation at runtime.
+template <IsCharconvFloat F>
+constexpr char* shortest_to_chars(char* first, char* last, const F value) noexcept {
+	if CTP_IS_CONSTEVAL {
+		return shortest_to_chars_exact(first, value);
+	} else {
+		return std::to_chars(first, last, value).ptr;
+	}
+}
+
+// ---------------------------------------- Parsing ----------------------------------------
+
+[[nodiscard]] constexpr bool is_digit(const char c) noexcept { return static_cast<unsigned char>(c - '0') < 10; }
+
+// Eight chars as an integer, the first in the lowest byte.
+[[nodiscard]] constexpr std::uint64_t load_eight(const char* chars) noexcept {
+	if CTP_IS_CONSTEVAL {
+		std::uint64_t value = 0;
+		for (int i = 0; i < 8; ++i)
+			value |= std::uint64_t{static_cast<unsigned char>(chars[i])} << (8 * i);
+		return value;
+	} else {
+		std::uint64_t value;
+		std::memcpy(&value, chars, sizeof(value));
+		if constexpr (std::endian::native == std::endian::big)
+			value = std::byteswap(value);
+		return value;
+	}
+}
+
+// Whether all eight chars are digits: adding 0x46 carries into the top bit of a byte above '9', and subtracting 0x30
+// borrows into it below '0'.
+[[nodiscard]] constexpr bool is_eight_digits(const std::uint64_t chars) noexcept {
+	return (((chars + 0x4646464646464646) | (chars - 0x3030303030303030)) & 0x8080808080808080) == 0;
+}
+
+// The value of eight digits, combining pairs, then pairs of pairs, then the two halves, a multiply each.
+[[nodiscard]] constexpr std::uint32_t parse_eight_digits(std::uint64_t chars) noexcept {
+	constexpr std::uint64_t Mask = 0x000000FF000000FF;
+	constexpr std::uint64_t Multiplier1 = 100 + (1000000ull << 32);
+	constexpr std::uint64_t Multiplier2 = 1 + (10000ull << 32);
+	chars -= 0x3030303030303030;
+	chars = chars * 10 + (chars >> 8);
+	chars = (((chars & Mask) * Multiplier1) + (((chars >> 16) & Mask) * Multiplier2)) >> 32;
+	return static_cast<std::uint32_t>(chars);
+}
+
+// Appends the digits at the start of [first, last) to value, eight at a time while it can, and returns the end of
+// them. The value wraps if there are more than 19 digits.
+constexpr const char* accumulate_digits(const char* first, const char* const last, std::uint64_t& value) noexcept {
+	while (last - first >= 8) {
+		const auto chars = load_eight(first);
+		if (!is_eight_digits(chars))
+			break;
+		value = value * 100000000 + parse_eight_digits(chars);
+		first += 8;
+	}
+	for (; first != last && is_digit(*first); ++first)
+		value = value * 10 + static_cast<std::uint64_t>(*first - '0');
+	return first;
+}
+
+template <std::integral T>
+constexpr std::from_chars_result parse_integer(const char* const first, const char* const last, T& value) noexcept {
+	using U = std::make_unsigned_t<T>;
+
+	const char* p = first;
+	bool negative = false;
+	if constexpr (std::is_signed_v<T>) {
+		negative = p != last && *p == '-';
+		if (negative)
+			++p;
+	}
+
+	const char* const digits = p;
+	while (p != last && *p == '0')
+		++p;
+	const char* const significant = p;
+	std::uint64_t magnitude = 0;
+	p = accumulate_digits(p, last, magnitude);
+	if (p == digits)
+		return {first, std::errc::invalid_argument};
+
+	// 20 digits can still fit, so redo them without wrapping.
+	constexpr std::uint64_t MaxTenth = std::numeric_limits<std::uint64_t>::max() / 10;
+	bool inRange = p - significant < 20;
+	if (p - significant == 20) {
+		std::uint64_t tenth = 0;
+		accumulate_digits(significant, significant + 19, tenth);
+		const auto lastDigit = static_cast<std::uint64_t>(significant[19] - '0');
+		inRange = tenth < MaxTenth || (tenth == MaxTenth && lastDigit <= std::numeric_limits<std::uint64_t>::max() % 10);
+		magnitude = tenth * 10 + lastDigit;
+	}
+
+	const std::uint64_t limit = static_cast<std::uint64_t>(std::numeric_limits<T>::max()) + negative;
+	if (!inRange || magnitude > limit)
+		return {p, std::errc::result_out_of_range};
+
+	const auto result = static_cast<U>(magnitude);
+	value = static_cast<T>(negative ? static_cast<U>(0 - result) : result);
+	return {p, std::errc{}};
+}
+
+// Eisel-Lemire, with a fast path for exact values and std::from_chars for anything it can't do.
+std::from_chars_result parse_float(const char* first, const char* last, float& value) noexcept;
+std::from_chars_result parse_float(const char* first, const char* last, double& value) noexcept;
+
+// ---------------------------------------- Bulk formatting ----------------------------------------
+
+inline constexpr char DigitPairs[] =
+	"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+	"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+// Number of digits in base 10.
+[[nodiscard]] constexpr int count_digits(const std::uint64_t value) noexcept {
+	constexpr std::uint64_t Powers[] = {
+		1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull, 1000000000ull,
+		10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull, 100000000000000ull,
+		1000000000000000ull, 10000000000000000ull, 100000000000000000ull, 1000000000000000000ull,
+		10000000000000000000ull,
+	};
+	// floor(log10(2^(bit width))), which is the digits or one more.
+	const int estimate = (static_cast<int>(std::bit_width(value | 1)) * 1233) >> 12;
+	return estimate + 1 - ((value | 1) < Powers[estimate]);
+}
+
+// The eight digits of a value below 10^8 as chars, the first in the lowest byte. Splits it into halves, quarters,
+// then digits, a multiply by a reciprocal each, across all the lanes at once.
+[[nodiscard]] constexpr std::uint64_t encode_eight(const std::uint32_t value) noexcept {
+	std::uint64_t merged = (value / 10000) | (std::uint64_t{value % 10000} << 32);
+	std::uint64_t tens = ((merged * 10486) >> 20) & 0x0000007F0000007F;
+	merged = tens | ((merged - tens * 100) << 16);
+	tens = ((merged * 103) >> 10) & 0x000F000F000F000F;
+	merged = tens | ((merged - tens * 10) << 8);
+	return merged + 0x3030303030303030;
+}
+
+// Stores eight chars, of which the last digits are the value's. Needs eight chars of room.
+inline char* store_eight(char* out, const std::uint32_t value, const int digits) noexcept {
+	auto chars = encode_eight(value);
+	if constexpr (std::endian::native == std::endian::little)
+		chars >>= 8 * (8 - digits);
+	else
+		chars = std::byteswap(chars) << (8 * (8 - digits));
+	std::memcpy(out, &chars, sizeof(chars));
+	return out + digits;
+}
+
+// Writes the digits eight at a time, which can write up to eight chars past them.
+inline char* write_digits_wide(char* out, const std::uint64_t value, const int digits) noexcept {
+	if (digits <= 8)
+		return store_eight(out, static_cast<std::uint32_t>(value), digits);
+	const auto low = static_cast<std::uint32_t>(value % 100000000);
+	const auto high = value / 100000000;
+	if (digits <= 16) {
+		out = store_eight(out, static_cast<std::uint32_t>(high), digits - 8);
+	} else {
+		out = store_eight(out, static_cast<std::uint32_t>(high / 100000000), digits - 16);
+		out = store_eight(out, static_cast<std::uint32_t>(high % 100000000), 8);
+	}
+	return store_eight(out, low, 8);
+}
+
+// Writes the digits two at a time from the end, without writing past them.
+constexpr char* write_digits_exact(char* out, std::uint64_t value, const int digits) noexcept {
+	char* const end = out + digits;
+	char* p = end;
+	while (value >= 100) {
+		const auto pair = static_cast<std::size_t>(value % 100) * 2;
+		value /= 100;
+		*--p = DigitPairs[pair + 1];
+		*--p = DigitPairs[pair];
+	}
+	if (value >= 10) {
+		*--p = DigitPairs[value * 2 + 1];
+		*--p = DigitPairs[value * 2];
+	} else {
+		*--p = static_cast<char>('0' + value);
+	}
+	return end;
+}
+
+template <std::integral I>
+[[nodiscard]] constexpr bool is_negative(const I value) noexcept {
+	if constexpr (std::is_signed_v<I>)
+		return value < 0;
+	else
+		return false;
+}
+
+template <std::integral I>
+[[nodiscard]] constexpr std::uint64_t magnitude(const I value) noexcept {
+	using U = std::make_unsigned_t<I>;
+	if constexpr (std::is_signed_v<I>)
+		return value < 0 ? static_cast<U>(0 - static_cast<U>(value)) : static_cast<U>(value);
+	else
+		return value;
+}
+
+} // charconv_detail
+
+// ---------------------------------------- ToChars ----------------------------------------
+
+template <typename T>
+struct ToCharsConverter;
+
 template <std::integral I>
-struct ToCharsConverter {
+struct ToCharsConverter<I> {
 	std::array<char, max_char_digits_10_v<I>> mem;
 	std::size_t size;
 	constexpr ToCharsConverter() noexcept = default; // Value-initialize for use in constant expressions.
@@ -55,6 +592,140 @@ struct ToCharsConverter {
 	constexpr operator std::string_view() const noexcept { return view(); }
 };
 
+// The shortest representation that round-trips, as std::to_chars writes it, also in constant expressions.
+template <IsCharconvFloat F>
+struct ToCharsConverter<F> {
+	std::array<char, max_chars_shortest_v<F>> mem;
+	std::size_t size;
+	constexpr ToCharsConverter() noexcept = default; // Value-initialize for use in constant expressions.
+	constexpr ToCharsConverter(F f) noexcept {
+		if CTP_IS_CONSTEVAL {
+			mem = {};
+		}
+		convert(f);
+	}
+
+	constexpr void convert(F f) noexcept {
+		size = static_cast<std::size_t>(charconv_detail::shortest_to_chars(mem.data(), mem.data() + mem.size(), f) - mem.data());
+	}
+
+	constexpr std::string_view operator()(F f) noexcept {
+		convert(f);
+		return view();
+	}
+
+	[[nodiscard]] constexpr std::string_view view() const noexcept { return std::string_view{mem.data(), size}; }
+	constexpr operator std::string_view() const noexcept { return view(); }
+};
+
+template <std::integral I>
+ToCharsConverter(I) -> ToCharsConverter<I>;
+template <IsCharconvFloat F>
+ToCharsConverter(F) -> ToCharsConverter<F>;
+
+// Appends a number as ToCharsConverter writes it to a string, like a small_string or fixed_string. It writes straight
+// into the string when there's room, so it doesn't make a small string large just for the worst case.
+template <class String, typename T>
+	requires std::integral<T> || IsCharconvFloat<T>
+constexpr String& AppendChars(String& str, const T value) {
+	constexpr std::size_t MaxChars = std::tuple_size_v<decltype(ToCharsConverter<T>::mem)>;
+	const std::size_t oldSize = str.size();
+	if (str.capacity() - oldSize < MaxChars) {
+		const ToCharsConverter<T> converter{value};
+		str.append(converter.view());
+		return str;
+	}
+
+	str.resize(oldSize + MaxChars);
+	char* const first = str.data() + oldSize;
+	char* last;
+	if constexpr (std::integral<T>)
+		last = std::to_chars(first, first + MaxChars, value).ptr;
+	else
+		last = charconv_detail::shortest_to_chars(first, first + MaxChars, value);
+	str.resize(static_cast<std::size_t>(last - str.data()));
+	return str;
+}
+
+// ---------------------------------------- Bulk ToChars ----------------------------------------
+
+// The number of chars format_integers writes for the values.
+template <std::integral I>
+[[nodiscard]] constexpr std::size_t format_integers_size(const std::span<const I> values) noexcept {
+	std::size_t size = values.empty() ? 0 : values.size() - 1;
+	for (const I value : values)
+		size += static_cast<std::size_t>(charconv_detail::count_digits(charconv_detail::magnitude(value))) + charconv_detail::is_negative(value);
+	return size;
+}
+
+// Writes the values in base 10 like std::to_chars, with the separator between them, and returns the end. The buffer
+// needs format_integers_size(values) chars. Much faster than a std::to_chars per value, since all but the last few
+// are written eight digits a time without checking for room.
+template <std::integral I>
+	requires (!std::is_same_v<I, bool>)
+char* format_integers(const std::span<const I> values, const char separator, const std::span<char> buffer) noexcept {
+	// The most one value can write, with the digits it can write past itself.
+	constexpr std::ptrdiff_t MaxWideWrite = 1 + 20 + 8;
+
+	char* out = buffer.data();
+	char* const last = buffer.data() + buffer.size();
+	bool first = true;
+	for (const I value : values) {
+		if (!first)
+			*out++ = separator;
+		first = false;
+		// Mixed signs would mispredict.
+		*out = '-';
+		out += charconv_detail::is_negative(value) ? 1 : 0;
+		const auto absolute = charconv_detail::magnitude(value);
+		const int digits = charconv_detail::count_digits(absolute);
+		if (last - out >= MaxWideWrite)
+			out = charconv_detail::write_digits_wide(out, absolute, digits);
+		else
+			out = charconv_detail::write_digits_exact(out, absolute, digits);
+	}
+	return out;
+}
+
+// Appends the values to a string, like a small_string, sizing it once.
+template <class String, std::integral I>
+	requires (!std::is_same_v<I, bool>) && requires (String& str) { str.resize(std::size_t{}); str.data(); }
+String& format_integers(const std::span<const I> values, const char separator, String& str) {
+	const std::size_t oldSize = str.size();
+	const std::size_t size = format_integers_size(values);
+	str.resize(oldSize + size);
+	format_integers(values, separator, std::span<char>{str.data() + oldSize, size});
+	return str;
+}
+
+// ---------------------------------------- FromChars ----------------------------------------
+
+template <typename T>
+concept IsFromCharsCompatible = (std::integral<T> && !std::is_same_v<T, bool>) || IsCharconvFloat<T>;
+
+// Parses numbers like std::from_chars, in base 10 or the general floating point format, but faster: integers take
+// eight digits a step, and floats use Eisel-Lemire. Integers can be parsed in constant expressions.
+template <IsFromCharsCompatible T>
+struct FromCharsParser {
+	// The value is only set on success, and ptr is past the number matched, even when it's out of range.
+	constexpr std::from_chars_result parse(const char* first, const char* last, T& value) const noexcept {
+		if constexpr (std::integral<T>)
+			return charconv_detail::parse_integer(first, last, value);
+		else
+			return charconv_detail::parse_float(first, last, value);
+	}
+
+	// The whole string as a number, or nothing if it isn't one or is out of range.
+	[[nodiscard]] constexpr std::optional<T> operator()(const std::string_view str) const noexcept {
+		T value{};
+		const char* const last = str.data() + str.size();
+		const auto [ptr, ec] = parse(str.data(), last, value);
+		if (ec != std::errc{} || ptr != last)
+			return std::nullopt;
+		return value;
+	}
+};
+
 namespace detail {
 // From tests, this only helps MSVC.
 template <std::size_t ReducedSize, std::size_t FullSize>
@@ -63,7 +734,8 @@ consteval auto ShrinkToFit(const std::array<char, FullSize>& arr) {
 }
 } // detail
 
-template <std::integral auto num>
+template <auto num>
+	requires std::integral<decltype(num)> || IsCharconvFloat<decltype(num)>
 [[nodiscard]] consteval auto ToConstantString() {
 	constexpr ToCharsConverter converter{num};
 	return detail::ShrinkToFit<converter.size>(converter.mem);
@@ -0,0 +1,55 @@
+#ifndef INCLUDE_CTP_TOOLS_CLOCK_HPP
+#define INCLUDE_CTP_TOOLS_CLOCK_HPP
+
+#include "config.hpp"
+
+#include <chrono>
+#include <cstdint>
+
+#if CTP_SSE2
+#if CTP_WINDOWS
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace ctp {
+
+// Cheapest available timestamp, for instrumentation. The time stamp counter where there is one,
+// otherwise steady clock nanoseconds. Convert to time with a pair of readings of both clocks.
+inline std::uint64_t cpu_ticks() noexcept {
+#if CTP_SSE2
+	return __rdtsc();
+#else
+	return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// Steady clock time in nanoseconds.
+inline std::uint64_t steady_ns() noexcept {
+	return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Maps cpu_ticks to steady_ns, fitted from two readings of both clocks.
+struct tick_calibration {
+	std::uint64_t baseTicks = 0;
+	std::uint64_t baseNs = 0;
+	double nsPerTick = 1.0;
+
+	constexpr tick_calibration() noexcept = default;
+	constexpr tick_calibration(std::uint64_t ticks0, std::uint64_t ns0, std::uint64_t ticks1, std::uint64_t ns1) noexcept
+		: baseTicks{ticks0}
+		, baseNs{ns0}
+		, nsPerTick{ticks1 > ticks0 && ns1 > ns0 ? double(ns1 - ns0) / double(ticks1 - ticks0) : 1.0} {}
+
+	// Nanoseconds since the first reading.
+	constexpr double ns_since_base(std::uint64_t ticks) const noexcept {
+		const double deltaTicks = ticks >= baseTicks ? double(ticks - baseTicks) : -double(baseTicks - ticks);
+		return deltaTicks * nsPerTick;
+	}
+};
+
+} // ctp
+
+#endif // INCLUDE_CTP_TOOLS_CLOCK_HPP
@@ -10,6 +10,25 @@
 #define CTP_RELEASE 1
 #endif
 
+/* -------------------- logging --------------------- */
+// Debug builds always log, since assertions do. Define CTP_LOGGING to 1 to log in Release.
+#if CTP_DEBUG
+#undef CTP_LOGGING
+#define CTP_LOGGING 1
+#elif !defined CTP_LOGGING
+#define CTP_LOGGING 0
+#endif
+
+// Least severe log stream compiled in: 0 logs, 1 warnings, 2 errors, 3 nothing but assertions.
+#ifndef CTP_LOG_LEVEL
+#define CTP_LOG_LEVEL 0
+#endif
+
+// Define to 1 to compile in CTP_PROFILE_ZONE.
+#ifndef CTP_PROFILING
+#define CTP_PROFILING 0
+#endif
+
 /* -------------------- platform -------------------- */
 
 #ifdef __linux__
@@ -32,6 +51,27 @@
 #define CTP_WINDOWS 0
 #endif
 
+/* ---------------------- cpu ----------------------- */
+
+#if defined __AVX2__
+#define CTP_AVX2 1
+#endif
+
+#if defined __SSE2__ || defined _M_X64
+#define CTP_SSE2 1
+#elif defined _M_IX86_FP
+ #if _M_IX86_FP >= 2
+ #define CTP_SSE2 1
+ #endif
+#endif
+
+#ifndef CTP_AVX2
+#define CTP_AVX2 0
+#endif
+#ifndef CTP_SSE2
+#define CTP_SSE2 0
+#endif
+
 /* -------------------- compiler -------------------- */
 #ifdef __clang__
 
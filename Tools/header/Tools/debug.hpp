@@ -4,10 +4,17 @@
 #include "config.hpp"
 
 
-// TODO: option to keep some logs in Release mode
+// Logs are compiled in when CTP_LOGGING is set (always in Debug), and pruned at compile time by
+// CTP_LOG_LEVEL. SetLogLevel filters further at runtime.
+// For cheaper logs to keep in Release mode, see binary_log.hpp.
 
-#if CTP_DEBUG
+#if CTP_LOGGING
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <exception>
+#include <limits>
 #include <string_view>
 
 namespace ctp::debug {
@@ -20,6 +27,145 @@ enum class Stream {
 void SetCurrentWorkingDir() CTP_NOEXCEPT_ALLOCS;
 void Log(Stream stream, std::string_view action, std::string_view expr, std::string_view file, int line, std::string_view message = {}) CTP_NOEXCEPT_ALLOCS;
 
+// Switch Log to asynchronous mode. Each logging thread formats its message into its own ring buffer,
+// and a background thread writes them out in batches. Also writes out what is buffered on terminate
+// and at exit.
+void StartAsyncLogging() noexcept(CTP_NOTHROW_ALLOCS);
+// Write out what is buffered and switch Log back to writing synchronously.
+// Expects other threads to have stopped logging.
+void StopAsyncLogging() noexcept;
+// Write out everything logged so far by all threads before returning. In asynchronous mode this
+// waits a bounded time for the background thread, then writes out the buffers regardless if it does
+// not respond, which may repeat some messages.
+void FlushLog() noexcept;
+
+namespace detail {
+inline constinit std::atomic<Stream> MinimumStream{Stream::Log};
+} // detail
+
+// If logs to a stream are compiled in, according to CTP_LOG_LEVEL.
+constexpr bool IsLogCompiledIn(Stream stream) noexcept { return static_cast<int>(stream) >= CTP_LOG_LEVEL; }
+
+// Only log to streams at least as severe as minimum. Assertions and failures always log.
+inline void SetLogLevel(Stream minimum) noexcept { detail::MinimumStream.store(minimum, std::memory_order_relaxed); }
+inline Stream GetLogLevel() noexcept { return detail::MinimumStream.load(std::memory_order_relaxed); }
+inline bool IsLogEnabled(Stream stream) noexcept { return stream >= GetLogLevel(); }
+
+// Token bucket, refilled at perSecond up to burst tokens. Kept as the time the bucket will be full,
+// so a throttled call is a relaxed load and a clock read.
+class RateLimiter {
+public:
+	constexpr RateLimiter(double perSecond, std::uint32_t burst) noexcept
+		: intervalNs_{static_cast<std::int64_t>(1e9 / perSecond)}
+		, toleranceNs_{intervalNs_ * ((std::max)(burst, 1u) - 1)} {}
+
+	// Take a token if there is one.
+	bool TryAcquire() noexcept {
+		return TryAcquire(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	// Take a token if there is one at a time in nanoseconds.
+	bool TryAcquire(std::int64_t nowNs) noexcept {
+		std::int64_t full = fullNs_.load(std::memory_order_relaxed);
+		for (;;) {
+			if (nowNs + toleranceNs_ < full)
+				return false;
+			const std::int64_t next = (std::max)(full, nowNs) + intervalNs_;
+			if (fullNs_.compare_exchange_weak(full, next, std::memory_order_relaxed))
+				return true;
+		}
+	}
+
+private:
+	std::int64_t intervalNs_;
+	std::int64_t toleranceNs_;
+	std::atomic<std::int64_t> fullNs_{(std::numeric_limits<std::int64_t>::min)() / 2};
+};
+
+} // namespace ctp::debug
+
+// Initialize the default logger.
+#define ctpInitDebugLogging() do { \
+	::ctp::debug::SetCurrentWorkingDir(); \
+} while (0)
+
+// Initialize the default logger in asynchronous mode.
+#define ctpInitAsyncDebugLogging() do { \
+	::ctp::debug::SetCurrentWorkingDir(); \
+	::ctp::debug::StartAsyncLogging(); \
+} while (0)
+
+// Log a message to the default logger. Ignored in constexpr contexts.
+#define ctpLogStream(stream, message) do { \
+	if constexpr (::ctp::debug::IsLogCompiledIn(stream)) \
+		if (::ctp::debug::IsLogEnabled(stream)) \
+			::ctp::debug::Log(stream, "", "", __FILE__, __LINE__, message); \
+} while (0)
+
+// Log a message to the default logger if a condition is true.
+#define ctpLogIfStream(stream, expression, message) do { \
+	if constexpr (::ctp::debug::IsLogCompiledIn(stream)) \
+		if (!static_cast<bool>(expression) && ::ctp::debug::IsLogEnabled(stream)) \
+			::ctp::debug::Log(stream, "condition met", #expression, __FILE__, __LINE__, message); \
+} while(0)
+
+// Log a message to the default logger the first time this is reached.
+#define ctpLogOnceStream(stream, message) do { \
+	if constexpr (::ctp::debug::IsLogCompiledIn(stream)) { \
+		static constinit ::std::atomic<bool> ctpLogged_{false}; \
+		if (!ctpLogged_.load(::std::memory_order_relaxed) && ::ctp::debug::IsLogEnabled(stream) \
+			&& !ctpLogged_.exchange(true, ::std::memory_order_relaxed)) \
+			::ctp::debug::Log(stream, "", "", __FILE__, __LINE__, message); \
+	} \
+} while (0)
+
+// Log a message to the default logger every n times this is reached. Counts loosely when threads share it.
+// Each call has to count, so a skipped call is a relaxed load and store of the counter, not just a load.
+#define ctpLogEveryNStream(stream, n, message) do { \
+	if constexpr (::ctp::debug::IsLogCompiledIn(stream)) { \
+		static constinit ::std::atomic<::std::uint32_t> ctpLogCount_{0}; \
+		if (::ctp::debug::IsLogEnabled(stream)) { \
+			const ::std::uint32_t ctpCount_ = ctpLogCount_.load(::std::memory_order_relaxed); \
+			ctpLogCount_.store(ctpCount_ + 1, ::std::memory_order_relaxed); \
+			if (ctpCount_ % (n) == 0) \
+				::ctp::debug::Log(stream, "", "", __FILE__, __LINE__, message); \
+		} \
+	} \
+} while (0)
+
+// Log a message to the default logger at most perSecond times a second, in bursts of up to burst.
+// perSecond and burst must be constants. A throttled call reads steady_clock as well as the bucket, and the
+// clock read is most of its cost.
+#define ctpLogRateLimitedStream(stream, perSecond, burst, message) do { \
+	if constexpr (::ctp::debug::IsLogCompiledIn(stream)) { \
+		static constinit ::ctp::debug::RateLimiter ctpLogLimiter_{perSecond, burst}; \
+		if (::ctp::debug::IsLogEnabled(stream) && ctpLogLimiter_.TryAcquire()) \
+			::ctp::debug::Log(stream, "", "", __FILE__, __LINE__, message); \
+	} \
+} while (0)
+
+#else
+// Disabled, noop macro definitions.
+
+// Initialize the default logger.
+#define ctpInitDebugLogging() do {} while(0)
+// Initialize the default logger in asynchronous mode.
+#define ctpInitAsyncDebugLogging() do {} while(0)
+// Log a message to the default logger. Ignored in constexpr contexts.
+#define ctpLogStream(stream, message)  do {} while(0)
+// Log a message to the default logger if a condition is true.
+#define ctpLogIfStream(stream, expression, message) do {} while(0)
+// Log a message to the default logger the first time this is reached.
+#define ctpLogOnceStream(stream, message) do {} while(0)
+// Log a message to the default logger every n times this is reached.
+#define ctpLogEveryNStream(stream, n, message) do {} while(0)
+// Log a message to the default logger at most perSecond times a second, in bursts of up to burst.
+#define ctpLogRateLimitedStream(stream, perSecond, burst, message) do {} while(0)
+#endif // CTP_LOGGING
+
+#if CTP_DEBUG
+namespace ctp::debug {
+
 constexpr void BreakMsg(Stream stream, std::string_view file, int line, std::string_view message) noexcept {
 	if CTP_NOT_CONSTEVAL {
 		::ctp::debug::Log(stream, "debug break", "", file, line, message);
@@ -38,6 +184,7 @@ constexpr void Fail(std::string_view msg) noexcept {
 		false ? void(0) : detail::ConstexprAssertFailed();
 	} else {
 		::ctp::debug::Log(ctp::debug::Stream::Error, "program failure", "", __FILE__, __LINE__, msg);
+		::ctp::debug::FlushLog();
 		CTP_BREAK_INTO_DEBUGGER;
 		::std::terminate();
 	}
@@ -49,6 +196,7 @@ constexpr void AssertFail(std::string_view expr, std::string_view msg) noexcept
 		false ? void(0) : detail::ConstexprAssertFailed();
 	} else {
 		::ctp::debug::Log(ctp::debug::Stream::Error, "assertion failed", expr, __FILE__, __LINE__, msg);
+		::ctp::debug::FlushLog();
 		CTP_BREAK_INTO_DEBUGGER;
 	}
 }
@@ -58,11 +206,6 @@ void WaitForDebugger() noexcept;
 
 } // namespace ctp::debug
 
-// Initialize the default logger.
-#define ctpInitDebugLogging() do { \
-	::ctp::debug::SetCurrentWorkingDir(); \
-} while (0)
-
 // Assert a condition is true.
 #define ctpAssertMsg(expression, message) do { \
 	if (!static_cast<bool>(expression)) [[unlikely]] \
@@ -87,20 +230,9 @@ void WaitForDebugger() noexcept;
 			CTP_BREAK_INTO_DEBUGGER; \
 } while(0)
 
-// Log a message to the default logger. Ignored in constexpr contexts.
-#define ctpLogStream(stream, message) do { ::ctp::debug::Log(stream, "", "", __FILE__, __LINE__, message); } while (0)
-
-// Log a message to the default logger if a condition is true.
-#define ctpLogIfStream(stream, expression, message) do { \
-	if (!static_cast<bool>(expression)) \
-		::ctp::debug::Log(stream, "condition met", #expression, __FILE__, __LINE__, message); \
-} while(0)
-
 #else
 // Disabled, noop macro definitions.
 
-// Initialize the default logger.
-#define ctpInitDebugLogging() do {} while(0)
 // Assert a condition is true.
 #define ctpAssertMsg(expression, message) do {} while(0)
 // Indicate a failure state.
@@ -111,10 +243,6 @@ void WaitForDebugger() noexcept;
 #define ctpBreakMsgStream(stream, message) do {} while(0)
 // Break into the debugger if one is detected. Ignored in constexpr contexts.
 #define ctpBreakIfDebuggerAttached() do {} while(0)
-// Log a message to the default logger. Ignored in constexpr contexts.
-#define ctpLogStream(stream, message)  do {} while(0)
-// Log a message to the default logger if a condition is true.
-#define ctpLogIfStream(stream, expression, message) do {} while(0)
 #endif // CTP_DEBUG
 
 // Expect a precondition is true.
@@ -153,4 +281,31 @@ void WaitForDebugger() noexcept;
 // Log to the default logger if a condition is true.
 #define ctpLogIf(expression) ctpLogIfStream(::ctp::debug::Stream::Log, expression, {})
 
+// Log a message to the default logger the first time this is reached.
+#define ctpLogOncei(message) ctpLogOnceStream(::ctp::debug::Stream::Log, message)
+// Log a message to the default logger the first time this is reached.
+#define ctpLogOncew(message) ctpLogOnceStream(::ctp::debug::Stream::Warn, message)
+// Log a message to the default logger the first time this is reached.
+#define ctpLogOncee(message) ctpLogOnceStream(::ctp::debug::Stream::Error, message)
+// Log a message to the default logger the first time this is reached.
+#define ctpLogOnce(message) ctpLogOncei(message)
+
+// Log a message to the default logger every n times this is reached.
+#define ctpLogEveryNi(n, message) ctpLogEveryNStream(::ctp::debug::Stream::Log, n, message)
+// Log a message to the default logger every n times this is reached.
+#define ctpLogEveryNw(n, message) ctpLogEveryNStream(::ctp::debug::Stream::Warn, n, message)
+// Log a message to the default logger every n times this is reached.
+#define ctpLogEveryNe(n, message) ctpLogEveryNStream(::ctp::debug::Stream::Error, n, message)
+// Log a message to the default logger every n times this is reached.
+#define ctpLogEveryN(n, message) ctpLogEveryNi(n, message)
+
+// Log a message to the default logger at most perSecond times a second, in bursts of up to burst.
+#define ctpLogRateLimitedi(perSecond, burst, message) ctpLogRateLimitedStream(::ctp::debug::Stream::Log, perSecond, burst, message)
+// Log a message to the default logger at most perSecond times a second, in bursts of up to burst.
+#define ctpLogRateLimitedw(perSecond, burst, message) ctpLogRateLimitedStream(::ctp::debug::Stream::Warn, perSecond, burst, message)
+// Log a message to the default logger at most perSecond times a second, in bursts of up to burst.
+#define ctpLogRateLimitede(perSecond, burst, message) ctpLogRateLimitedStream(::ctp::debug::Stream::Error, perSecond, burst, message)
+// Log a message to the default logger at most perSecond times a second, in bursts of up to burst.
+#define ctpLogRateLimited(perSecond, burst, message) ctpLogRateLimitedi(perSecond, burst, message)
+
 #endif // INCLUDE_CTP_TOOLS_DEBUG_HPP
@@ -0,0 +1,65 @@
+#ifndef INCLUDE_CTP_TOOLS_ENUM_DISPATCH_HPP
+#define INCLUDE_CTP_TOOLS_ENUM_DISPATCH_HPP
+
+#include "debug.hpp"
+#include "enum_reflection.hpp"
+
+#include <array>
+#include <type_traits>
+#include <utility>
+
+namespace ctp {
+
+namespace enum_detail {
+
+template <enums::Enum E, std::size_t I, class Visitor>
+using dispatch_result_at_t = decltype(std::declval<Visitor>().template operator()<enums::values<E>()[I]>());
+
+template <enums::Enum E, class Visitor, class Indices = std::make_index_sequence<enums::size<E>()>>
+struct dispatch_result;
+
+template <enums::Enum E, class Visitor, std::size_t... Is>
+struct dispatch_result<E, Visitor, std::index_sequence<Is...>> {
+	using type = dispatch_result_at_t<E, 0, Visitor>;
+	static constexpr bool all_same = (std::is_same_v<type, dispatch_result_at_t<E, Is, Visitor>> && ...);
+};
+
+// One entry of the table: calls the visitor with the enum value as a template argument.
+template <auto Value, class R, class Visitor>
+constexpr R dispatch_one(Visitor&& visitor) {
+	return std::forward<Visitor>(visitor).template operator()<Value>();
+}
+
+template <enums::Enum E, class R, class Visitor, std::size_t... Is>
+constexpr auto make_dispatch_table(std::index_sequence<Is...>) noexcept {
+	return std::array<R(*)(Visitor&&), sizeof...(Is)>{&dispatch_one<enums::values<E>()[Is], R, Visitor>...};
+}
+
+// Function pointers for each value of E, in the order of enums::values<E>().
+template <enums::Enum E, class R, class Visitor>
+inline constexpr auto dispatch_table = make_dispatch_table<E, R, Visitor>(std::make_index_sequence<enums::size<E>()>{});
+
+} // enum_detail
+
+// Call visitor.template operator()<e>() for a value e only known at run time, like a switch over
+// every value of E. Each value gets its own instantiation of the visitor, and is called through
+// a table of function pointers indexed by enums::index, instead of a chain of branches.
+//
+// The visitor must return the same type for every value.
+// Expects e to be a named value.
+//
+// Example:
+//   enum_dispatch(op, []<Op op>() { return apply<op>(x); });
+template <enums::Enum E, class Visitor>
+	requires (enums::size<E>() > 0)
+constexpr decltype(auto) enum_dispatch(E e, Visitor&& visitor) {
+	using result = enum_detail::dispatch_result<E, Visitor&&>;
+	static_assert(result::all_same, "enum_dispatch visitor must return the same type for every value");
+
+	ctpExpects(enums::try_get_index(e));
+	return enum_detail::dispatch_table<E, typename result::type, Visitor&&>[enums::index(e)](std::forward<Visitor>(visitor));
+}
+
+} // ctp
+
+#endif // INCLUDE_CTP_TOOLS_ENUM_DISPATCH_HPP
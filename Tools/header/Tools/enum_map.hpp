@@ -5,12 +5,15 @@
 #include "concepts.hpp"
 #include "config.hpp"
 #include "enum_reflection.hpp"
+#include "enum_set.hpp"
 #include "iterator.hpp"
 #include "reverse_iterator.hpp"
 #include "uninitialized_storage.hpp"
 
 #include <fmt/format.h>
 
+#include <compare>
+#include <ranges>
 #include <type_traits>
 #include <utility>
 
@@ -549,6 +552,406 @@ public:
 	}
 };
 
+namespace enum_detail {
+// Proxy reference to one bit of a bit-packed enum_map<E, bool>.
+class enum_map_bit_reference {
+	enum_set_word_type* word_ = nullptr;
+	enum_set_word_type mask_ = 0;
+public:
+	constexpr enum_map_bit_reference(enum_set_word_type* word, enum_set_word_type mask) noexcept
+		: word_{word}
+		, mask_{mask}
+	{}
+	constexpr enum_map_bit_reference(const enum_map_bit_reference&) noexcept = default;
+
+	constexpr operator bool() const noexcept { return (*word_ & mask_) != 0; }
+
+	constexpr const enum_map_bit_reference& operator=(bool value) const noexcept {
+		if (value)
+			*word_ |= mask_;
+		else
+			*word_ &= ~mask_;
+		return *this;
+	}
+	constexpr const enum_map_bit_reference& operator=(const enum_map_bit_reference& o) const noexcept {
+		return *this = static_cast<bool>(o);
+	}
+
+	constexpr void flip() const noexcept { *word_ ^= mask_; }
+};
+
+template <enums::Enum E, bool IsConst>
+class enum_map_bit_iterator_t :
+	public iterator_t<
+	enum_map_bit_iterator_t<E, IsConst>,
+	std::pair<E, std::conditional_t<IsConst, bool, enum_map_bit_reference>>,
+	std::random_access_iterator_tag,
+	std::ptrdiff_t,
+	// peek returns a by-value proxy.
+	std::pair<E, std::conditional_t<IsConst, bool, enum_map_bit_reference>>
+	> {
+	using word_type = std::conditional_t<IsConst, const enum_set_word_type, enum_set_word_type>;
+
+	// Start of the enum_set's words.
+	word_type* words_ = nullptr;
+	std::size_t index_ = static_cast<std::size_t>(-1);
+
+	friend iterator_accessor;
+	constexpr std::size_t& get_index() noexcept { return index_; }
+	constexpr bool equals(const enum_map_bit_iterator_t& o) const noexcept {
+		return words_ == o.words_ && index_ == o.index_;
+	}
+	constexpr auto peek() const noexcept {
+		word_type& word = words_[index_ / EnumSetWordBits];
+		const auto mask = enum_set_word_type{1} << (index_ % EnumSetWordBits);
+		if constexpr (IsConst)
+			return std::pair<E, bool>{enums::values<E>()[index_], (word & mask) != 0};
+		else
+			return std::pair<E, enum_map_bit_reference>{enums::values<E>()[index_], enum_map_bit_reference{&word, mask}};
+	}
+
+	// Allow construction of const iterators from nonconst iterators.
+	friend class enum_map_bit_iterator_t<E, true>;
+	using nonconst_t = std::conditional_t<IsConst, enum_map_bit_iterator_t<E, false>, nonesuch>;
+public:
+	template <typename NonConstT = nonconst_t, std::enable_if_t<!std::is_same_v<NonConstT, nonesuch>, int> = 0>
+	constexpr enum_map_bit_iterator_t(const nonconst_t& other) noexcept
+		: words_{other.words_}
+		, index_{other.index_}
+	{}
+
+	constexpr enum_map_bit_iterator_t() noexcept = default;
+	constexpr enum_map_bit_iterator_t(word_type* words, std::size_t index) noexcept
+		: words_{words}
+		, index_{index}
+	{}
+};
+
+// Indexes the bits of a bit-packed enum_map<E, bool> like a bool*, giving proxy references.
+template <bool IsConst>
+class enum_map_bit_pointer {
+	using word_type = std::conditional_t<IsConst, const enum_set_word_type, enum_set_word_type>;
+
+	word_type* words_ = nullptr;
+
+	using nonconst_t = std::conditional_t<IsConst, enum_map_bit_pointer<false>, nonesuch>;
+public:
+	// Allow construction of const pointers from nonconst pointers.
+	template <typename NonConstT = nonconst_t, std::enable_if_t<!std::is_same_v<NonConstT, nonesuch>, int> = 0>
+	constexpr enum_map_bit_pointer(const nonconst_t& other) noexcept
+		: words_{other.words()}
+	{}
+
+	constexpr enum_map_bit_pointer() noexcept = default;
+	constexpr explicit enum_map_bit_pointer(word_type* words) noexcept : words_{words} {}
+
+	[[nodiscard]] constexpr word_type* words() const noexcept { return words_; }
+
+	[[nodiscard]] constexpr auto operator[](std::size_t i) const noexcept {
+		const auto mask = enum_set_word_type{1} << (i % EnumSetWordBits);
+		if constexpr (IsConst)
+			return (words_[i / EnumSetWordBits] & mask) != 0;
+		else
+			return enum_map_bit_reference{&words_[i / EnumSetWordBits], mask};
+	}
+	[[nodiscard]] constexpr auto operator*() const noexcept { return (*this)[0]; }
+
+	friend constexpr bool operator==(enum_map_bit_pointer, enum_map_bit_pointer) noexcept = default;
+};
+} // enum_detail
+
+// Bit-packed enum_map for bool values, backed by an enum_set.
+// operator[], iteration and data() give proxy references, like std::vector<bool>, and values() gives the bools
+// by value. Allocator is unused, since the bits are always stored inline.
+template <enums::Enum E, typename Allocator>
+class enum_map<E, bool, Allocator> {
+	using this_type = enum_map<E, bool, Allocator>;
+
+	enum_set<E> set_;
+
+	constexpr void set(E e, bool value) noexcept {
+		if (value)
+			set_.insert(e);
+		else
+			set_.erase(e);
+	}
+
+	template <typename... Args>
+	constexpr void construct_with_default(bool defaultValue, Args&&... args) noexcept {
+		if (defaultValue)
+			set_ = enum_set<E>::all();
+		(set(args.first, static_cast<bool>(args.second)), ...);
+	}
+public:
+	using key_type = E;
+	using mapped_type = bool;
+	using mapped_type_reference = enum_detail::enum_map_bit_reference;
+	using mapped_type_const_reference = bool;
+	using value_type = std::pair<const key_type, mapped_type_reference>;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+	using key_compare = std::less<key_type>;
+	using allocator_type = Allocator;
+	using reference = value_type;
+	using const_reference = const value_type;
+	using pointer = enum_detail::enum_map_bit_pointer<false>;
+	using const_pointer = enum_detail::enum_map_bit_pointer<true>;
+
+	using iterator = enum_detail::enum_map_bit_iterator_t<E, false>;
+	using const_iterator = enum_detail::enum_map_bit_iterator_t<E, true>;
+	using reverse_iterator = ctp::reverse_iterator<iterator>;
+	using const_reverse_iterator = ctp::reverse_iterator<const_iterator>;
+
+	static constexpr std::size_t Size = enums::size<E>();
+
+	[[nodiscard]] static constexpr std::size_t size() noexcept { return Size; }
+	[[nodiscard]] static constexpr std::size_t max_size() noexcept { return Size; }
+	[[nodiscard]] static constexpr bool empty() noexcept { return Size == 0; }
+	[[nodiscard]] static constexpr bool is_empty() noexcept { return empty(); }
+
+	// Explicitly not allowed. All values must be initialized.
+	constexpr enum_map() = delete;
+
+	template <E e>
+	using arg_type = enum_arg_pair<e, bool>;
+
+	// ---------- construct with a default value ----------
+
+	// Construct an enum map with a default value.
+	constexpr enum_map(bool defaultArg) noexcept { construct_with_default(defaultArg); }
+	// Construct an enum map with a default value.
+	constexpr enum_map(const Allocator&, bool defaultArg) noexcept { construct_with_default(defaultArg); }
+	// Construct an enum map with a default value.
+	constexpr enum_map(const enum_default_arg<bool>& defaultArg) noexcept { construct_with_default(defaultArg.value); }
+	// Construct an enum map with a default value.
+	constexpr enum_map(const Allocator&, const enum_default_arg<bool>& defaultArg) noexcept {
+		construct_with_default(defaultArg.value);
+	}
+
+	// Construct from the values in a set being true.
+	constexpr explicit enum_map(const enum_set<E>& set) noexcept : set_{set} {}
+
+	// ------------- construct with enum_arg -------------
+
+	// Construct an enum map with given enum_arg<E::value>(bool)
+	// Can verify at compile time that all needed values are present.
+	template <enum_detail::EnumArg<this_type>... Args>
+		requires enum_detail::IsArgList<this_type, Size, Args...>
+	constexpr enum_map(Args&&... args) noexcept { construct_with_default(false, args...); }
+
+	// Construct an enum map with given enum_arg<E::value>(bool)
+	// Can verify at compile time that all needed values are present.
+	template <enum_detail::EnumArg<this_type>... Args>
+		requires enum_detail::IsArgList<this_type, Size, Args...>
+	constexpr enum_map(const Allocator&, Args&&... args) noexcept { construct_with_default(false, args...); }
+
+	// Construct an enum map with given enum_arg<E::value>(bool)
+	// Can verify at compile time that there are no duplicates present.
+	// Takes an explicit default.
+	template <enum_detail::EnumArg<this_type>... Args>
+		requires enum_detail::IsPartialArgList<this_type, Size, Args...>
+	constexpr enum_map(const enum_default_arg<bool>& defaultArg, Args&&... args) noexcept {
+		construct_with_default(defaultArg.value, args...);
+	}
+
+	// Construct an enum map with given enum_arg<E::value>(bool)
+	// Can verify at compile time that there are no duplicates present.
+	// Takes an explicit default argument.
+	template <enum_detail::EnumArg<this_type>... Args>
+		requires enum_detail::IsPartialArgList<this_type, Size, Args...>
+	constexpr enum_map(const Allocator&, const enum_default_arg<bool>& defaultArg, Args&&... args) noexcept {
+		construct_with_default(defaultArg.value, args...);
+	}
+
+	// ------------- construct with std::pair -------------
+
+	// Constructing with pairs can take variable arguments at run time, but loses the ability to guarantee
+	// correctness at compile time.
+	template <std::same_as<std::pair<E, bool>>... Pairs>
+		requires (sizeof...(Pairs) == Size)
+	constexpr enum_map(Pairs&&... pairs) noexcept {
+		// Sanity check that we weren't given one enum value twice.
+		ctpExpects(enum_detail::unique_pairs_check(pairs...));
+		construct_with_default(false, pairs...);
+	}
+	// Constructing with pairs can take variable arguments at run time, but loses the ability to guarantee
+	// correctness at compile time.
+	template <std::same_as<std::pair<E, bool>>... Pairs>
+		requires (sizeof...(Pairs) == Size)
+	constexpr enum_map(const Allocator&, Pairs&&... pairs) noexcept {
+		// Sanity check that we weren't given one enum value twice.
+		ctpExpects(enum_detail::unique_pairs_check(pairs...));
+		construct_with_default(false, pairs...);
+	}
+
+	// Constructing with pairs can take variable arguments at run time, but loses the ability to guarantee
+	// correctness at compile time. Takes an explicit default argument.
+	template <std::same_as<std::pair<E, bool>>... Pairs>
+		requires (sizeof...(Pairs) <= Size)
+	constexpr enum_map(const enum_default_arg<bool>& defaultArg, Pairs&&... pairs) noexcept {
+		// Sanity check that we weren't given one enum value twice.
+		ctpExpects(enum_detail::unique_pairs_check(pairs...));
+		construct_with_default(defaultArg.value, pairs...);
+	}
+	// Constructing with pairs can take variable arguments at run time, but loses the ability to guarantee
+	// correctness at compile time. Takes an explicit default argument.
+	template <std::same_as<std::pair<E, bool>>... Pairs>
+		requires (sizeof...(Pairs) <= Size)
+	constexpr enum_map(const Allocator&, const enum_default_arg<bool>& defaultArg, Pairs&&... pairs) noexcept {
+		// Sanity check that we weren't given one enum value twice.
+		ctpExpects(enum_detail::unique_pairs_check(pairs...));
+		construct_with_default(defaultArg.value, pairs...);
+	}
+
+	constexpr enum_map(const enum_map&) noexcept = default;
+	template <typename A2>
+	constexpr enum_map(const enum_map<E, bool, A2>& o) noexcept : set_{o.as_set()} {}
+
+	constexpr enum_map& operator=(const enum_map&) noexcept = default;
+	template <typename A2>
+	constexpr enum_map& operator=(const enum_map<E, bool, A2>& o) noexcept {
+		set_ = o.as_set();
+		return *this;
+	}
+
+	constexpr allocator_type get_allocator() const noexcept { return allocator_type{}; }
+
+	// The keys whose values are true.
+	[[nodiscard]] constexpr const enum_set<E>& as_set() const noexcept { return set_; }
+	// The keys whose values are true.
+	[[nodiscard]] constexpr enum_set<E>& as_set() noexcept { return set_; }
+
+	// The values in key order, by value.
+	[[nodiscard]] constexpr auto values() const noexcept {
+		return std::views::iota(std::size_t{0}, Size) | std::views::transform([this](const std::size_t i) { return (*this)[i]; });
+	}
+	// Indexes the values in key order.
+	[[nodiscard]] constexpr pointer data() noexcept { return pointer{set_.words().data()}; }
+	// Indexes the values in key order.
+	[[nodiscard]] constexpr const_pointer data() const noexcept { return const_pointer{set_.words().data()}; }
+
+	constexpr void fill(bool value) noexcept { set_ = value ? enum_set<E>::all() : enum_set<E>{}; }
+	constexpr void swap(enum_map& o) noexcept { std::swap(set_, o.set_); }
+
+	[[nodiscard]] static constexpr const auto& keys() noexcept { return enums::values<E>(); }
+
+	[[nodiscard]] constexpr iterator begin() noexcept { return {set_.words().data(), 0}; }
+	[[nodiscard]] constexpr const_iterator begin() const noexcept { return {set_.words().data(), 0}; }
+	[[nodiscard]] constexpr const_iterator cbegin() const noexcept { return begin(); }
+	[[nodiscard]] constexpr iterator end() noexcept { return {set_.words().data(), Size}; }
+	[[nodiscard]] constexpr const_iterator end() const noexcept { return {set_.words().data(), Size}; }
+	[[nodiscard]] constexpr const_iterator cend() const noexcept { return end(); }
+
+	[[nodiscard]] constexpr reverse_iterator rbegin() noexcept { return reverse_iterator{end()}; }
+	[[nodiscard]] constexpr const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator{cend()}; }
+	[[nodiscard]] constexpr const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+	[[nodiscard]] constexpr reverse_iterator rend() noexcept { return reverse_iterator{begin()}; }
+	[[nodiscard]] constexpr const_reverse_iterator rend() const noexcept { return const_reverse_iterator{cbegin()}; }
+	[[nodiscard]] constexpr const_reverse_iterator crend() const noexcept { return rend(); }
+
+	// Get iterator to the last element.
+	[[nodiscard]] constexpr iterator last() noexcept { return {set_.words().data(), Size - 1}; }
+	// Get iterator to the last element.
+	[[nodiscard]] constexpr const_iterator last() const noexcept { return {set_.words().data(), Size - 1}; }
+
+	[[nodiscard]] constexpr mapped_type_reference operator[](key_type e) noexcept {
+		ctpExpects(enums::try_get_index(e));
+		return bit(enums::index(e));
+	}
+
+	[[nodiscard]] constexpr mapped_type_const_reference operator[](key_type e) const noexcept {
+		return set_.contains(e);
+	}
+
+	[[nodiscard]] constexpr mapped_type_reference at(key_type e) noexcept { return (*this)[e]; }
+	[[nodiscard]] constexpr mapped_type_const_reference at(key_type e) const noexcept { return (*this)[e]; }
+
+	[[nodiscard]] constexpr std::size_t count(key_type e) const noexcept {
+		ctpExpects(enums::try_get_index(e));
+		return 1;
+	}
+	[[nodiscard]] constexpr iterator find(key_type e) noexcept {
+		ctpExpects(enums::try_get_index(e));
+		return {set_.words().data(), enums::index(e)};
+	}
+	[[nodiscard]] constexpr const_iterator find(key_type e) const noexcept {
+		ctpExpects(enums::try_get_index(e));
+		return {set_.words().data(), enums::index(e)};
+	}
+	[[nodiscard]] constexpr bool contains(key_type e) const noexcept {
+		ctpExpects(enums::try_get_index(e));
+		return true;
+	}
+
+	[[nodiscard]] constexpr iterator lower_bound(key_type e) noexcept {
+		ctpExpects(enums::try_get_index(e));
+		return {set_.words().data(), enums::index(e)};
+	}
+	[[nodiscard]] constexpr const_iterator lower_bound(key_type e) const noexcept {
+		ctpExpects(enums::try_get_index(e));
+		return {set_.words().data(), enums::index(e)};
+	}
+	[[nodiscard]] constexpr iterator upper_bound(key_type e) noexcept {
+		ctpExpects(enums::try_get_index(e));
+		return {set_.words().data(), enums::index(e) + 1};
+	}
+	[[nodiscard]] constexpr const_iterator upper_bound(key_type e) const noexcept {
+		ctpExpects(enums::try_get_index(e));
+		return {set_.words().data(), enums::index(e) + 1};
+	}
+	[[nodiscard]] constexpr std::pair<iterator, iterator> equal_range(key_type e) noexcept {
+		ctpExpects(enums::try_get_index(e));
+		const auto idx = enums::index(e);
+		return {iterator{set_.words().data(), idx}, iterator{set_.words().data(), idx + 1}};
+	}
+	[[nodiscard]] constexpr std::pair<const_iterator, const_iterator> equal_range(key_type e) const noexcept {
+		ctpExpects(enums::try_get_index(e));
+		const auto idx = enums::index(e);
+		return {const_iterator{set_.words().data(), idx}, const_iterator{set_.words().data(), idx + 1}};
+	}
+
+	template <typename A2>
+	friend constexpr bool operator==(const enum_map& lhs, const enum_map<E, bool, A2>& rhs) noexcept {
+		return lhs.set_ == rhs.as_set();
+	}
+	// Compares the values in key order, like the enum_maps of other types.
+	template <typename A2>
+	friend constexpr std::strong_ordering operator<=>(const enum_map& lhs, const enum_map<E, bool, A2>& rhs) noexcept {
+		const auto lhsWords = lhs.set_.words();
+		const auto rhsWords = rhs.as_set().words();
+		for (std::size_t i = 0; i < lhsWords.size(); ++i) {
+			// The lowest differing bit is the first differing value.
+			const auto diff = lhsWords[i] ^ rhsWords[i];
+			if (diff != 0)
+				return (lhsWords[i] & (diff & (0 - diff))) != 0 ? std::strong_ordering::greater : std::strong_ordering::less;
+		}
+		return std::strong_ordering::equal;
+	}
+
+protected:
+	// Gets ith value (i.e. not the underlying value of the enum).
+	[[nodiscard]] constexpr mapped_type_reference operator[](size_type i) noexcept {
+		ctpExpects(i < Size);
+		return bit(i);
+	}
+
+	// Gets ith value (i.e. not the underlying value of the enum).
+	[[nodiscard]] constexpr mapped_type_const_reference operator[](size_type i) const noexcept {
+		ctpExpects(i < Size);
+		return ((set_.words()[i / enum_detail::EnumSetWordBits] >> (i % enum_detail::EnumSetWordBits)) & 1) != 0;
+	}
+
+	// Gets ith value (i.e. not the underlying value of the enum).
+	[[nodiscard]] constexpr mapped_type_reference at(size_type i) noexcept { return (*this)[i]; }
+	// Gets ith value (i.e. not the underlying value of the enum).
+	[[nodiscard]] constexpr mapped_type_const_reference at(size_type i) const noexcept { return (*this)[i]; }
+
+private:
+	constexpr mapped_type_reference bit(std::size_t i) noexcept {
+		return {&set_.words()[i / enum_detail::EnumSetWordBits], enum_detail::enum_set_word_type{1} << (i % enum_detail::EnumSetWordBits)};
+	}
+};
+
 // Same as enum_map, but also supports operator[std::size_t]
 template <enums::Enum E, typename T, typename Allocator = std::allocator<T>>
 class indexible_enum_map : public enum_map<E, T, Allocator> {
@@ -563,6 +966,18 @@ public:
 	using Base::Base::at;
 };
 
+// The bit-packed enum_map has no enum_map_base, and has its indexed operator[] itself.
+template <enums::Enum E, typename Allocator>
+class indexible_enum_map<E, bool, Allocator> : public enum_map<E, bool, Allocator> {
+	using Base = enum_map<E, bool, Allocator>;
+public:
+	using Base::Base;
+
+	// Pull in operator[Enum] and operator[size_type]
+	using Base::operator[];
+	using Base::at;
+};
+
 } // ctp
 
 #endif // INCLUDE_CTP_TOOLS_ENUM_MAP_HPP
@@ -1,11 +1,22 @@
 #ifndef INCLUDE_CTP_ENUM_REFLECTION_HPP
 #define INCLUDE_CTP_ENUM_REFLECTION_HPP
 
+#include "config.hpp"
+#include "debug.hpp"
 #include "zstring_view.hpp"
 #include "type_traits.hpp"
 
 #include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
 #include <optional>
+#include <span>
+#include <string_view>
+
+#if CTP_SSE2
+#include <immintrin.h>
+#endif
 
 // Entry point to magic_enum.
 // Should only inclue this file, not magic_enum directly.
@@ -36,17 +47,43 @@ namespace ctp::enums {
 template <class E>
 concept Enum = std::is_enum_v<E>;
 
+// How index(E) maps a value of a non-contiguous enum to its index.
+enum class index_strategy {
+	// Choose based on the size and density of the enum.
+	automatic,
+	// Linear search of values(), starting from the middle.
+	linear_search,
+	// Table covering the whole value range. Limited to 255 entries.
+	lookup_table,
+	// Branchless binary search of values().
+	binary_search,
+	// Count how many values are less than the given value, comparing against
+	// all of them with SIMD. Limited to 64 values that fit in 32 bits.
+	simd_compare,
+	// Two-level table. The high bits of the value select a block, and the low bits
+	// index into it. All gaps in the value range share one empty block.
+	radix_table,
+};
+
 template <Enum E>
 struct enum_traits {
 	// specialize and override this for your enum if you want
 	// to force use a lookup table.
 	// Still only applies if the enum is not contiguous.
 	static constexpr bool force_enable_lookup_table = false;
+
+	// specialize and override this for your enum if you want
+	// to force a specific index strategy.
+	// Still only applies if the enum is not contiguous.
+	static constexpr index_strategy force_index_strategy = index_strategy::automatic;
 };
 
 template <Enum E>
 using HasForceEnableLookupSetting = decltype(enum_traits<E>::force_enable_lookup_table);
 
+template <Enum E>
+using HasForceIndexStrategySetting = decltype(enum_traits<E>::force_index_strategy);
+
 // Name of the enum class.
 template <Enum E>
 constexpr zstring_view type_name() noexcept {
@@ -77,6 +114,18 @@ constexpr std::size_t index() noexcept {
 	return poison::magic_enum::enum_index<E>();
 }
 
+template <Enum E>
+constexpr E min_val() noexcept {
+	static_assert(size<E>() > 0);
+	return values<E>().front();
+}
+
+template <Enum E>
+constexpr E max_val() noexcept {
+	static_assert(size<E>() > 0);
+	return values<E>().back();
+}
+
 namespace detail {
 // How large the values() array can get before we consider making
 // a lookup table. For small tabels, linear search is fine.
@@ -88,9 +137,40 @@ inline constexpr std::size_t EnumIndexLookupTableMin = 7;
 // be populated with useful values rather than waste.
 inline constexpr float MinDensityForLookupTable = 0.6f;
 
+// Most values simd_compare will search through.
+inline constexpr std::size_t EnumIndexSimdCompareMax = 64;
+
+// Each block of a radix table covers 2^bits values.
+inline constexpr unsigned RadixTableBlockBits = 6;
+inline constexpr std::size_t RadixTableBlockSize = std::size_t{1} << RadixTableBlockBits;
+
+// Largest radix table we will make before falling back to searching.
+// Radix tables beat simd_compare and binary search when hot in cache, so keep them small.
+inline constexpr std::size_t RadixTableMaxBytes = 4 * 1024;
+
+// Smallest unsigned type that can hold Max.
+template <std::size_t Max>
+using index_storage_t =
+	std::conditional_t<Max <= (std::numeric_limits<std::uint8_t>::max)(), std::uint8_t,
+	std::conditional_t<Max <= (std::numeric_limits<std::uint16_t>::max)(), std::uint16_t,
+	std::uint32_t>>;
+
+// Offset of a value from the smallest named value. Well defined for any underlying type.
+template <Enum E>
+constexpr std::size_t offset_from_min(E e) noexcept {
+	using U = std::make_unsigned_t<std::underlying_type_t<E>>;
+	return static_cast<U>(static_cast<U>(std::to_underlying(e)) - static_cast<U>(std::to_underlying(min_val<E>())));
+}
+
+// Number of entries a table spanning every value from min_val to max_val would need.
+template <Enum E>
+constexpr std::size_t value_range_entries() noexcept {
+	return offset_from_min(max_val<E>()) + 1;
+}
+
 template <Enum E>
 constexpr bool is_lookup_table_enabled() {
-	constexpr bool IsTooBig = size<E>() > 255;
+	constexpr bool IsTooBig = value_range_entries<E>() > 255;
 	if constexpr (is_detected_convertible_v<bool, HasForceEnableLookupSetting, E>) {
 		if constexpr (enum_traits<E>::force_enable_lookup_table) {
 			static_assert(!IsTooBig,
@@ -125,61 +205,253 @@ inline constexpr bool is_lookup_table_enabled_v = is_lookup_table_enabled<E>();
 // Note it is not benchmarked so this is merely an assumption and should not be trusted.
 template <Enum E>
 inline constexpr std::array enum_to_index_lookup_table = [] {
-	constexpr auto Minimum = std::to_underlying(min_val<E>());
-	constexpr std::size_t Entries = std::to_underlying(max_val<E>()) - Minimum + 1;
+	constexpr std::size_t Entries = value_range_entries<E>();
 	static_assert(Entries <= 255);
 
 	// By zero initializing, "bad" entries within range will default to the min val.
 	std::array<std::uint8_t, Entries> arr{};
 
 	const auto& vals = values<E>();
+	for (std::size_t i = 0; i < vals.size(); ++i)
+		arr[offset_from_min(vals[i])] = static_cast<std::uint8_t>(i);
+	return arr;
+}();
+
+// simd_compare works on 32 bit keys, so all values must fit.
+template <Enum E>
+constexpr bool fits_simd_key(E e) noexcept {
+	using U = std::underlying_type_t<E>;
+	if constexpr (std::is_signed_v<U>) {
+		const auto val = static_cast<long long>(std::to_underlying(e));
+		return val >= (std::numeric_limits<std::int32_t>::min)() && val <= (std::numeric_limits<std::int32_t>::max)();
+	} else {
+		return static_cast<unsigned long long>(std::to_underlying(e)) <= (std::numeric_limits<std::int32_t>::max)();
+	}
+}
+
+template <Enum E>
+constexpr bool is_simd_compare_possible() {
+	if constexpr (size<E>() > EnumIndexSimdCompareMax) {
+		return false;
+	} else {
+		for (const E e : values<E>()) {
+			if (!fits_simd_key(e))
+				return false;
+		}
+		return true;
+	}
+}
+
+// Keys for simd_compare, padded out to a full AVX2 register.
+// Padding uses the max key, which is never less than a searched for value.
+template <Enum E>
+struct alignas(32) simd_compare_keys_t {
+	static constexpr std::size_t Size = (size<E>() + 7) & ~std::size_t{7};
+	std::array<std::int32_t, Size> keys;
+};
+
+template <Enum E>
+inline constexpr simd_compare_keys_t<E> simd_compare_keys = [] {
+	simd_compare_keys_t<E> out{};
+	out.keys.fill((std::numeric_limits<std::int32_t>::max)());
+	const auto& vals = values<E>();
+	for (std::size_t i = 0; i < vals.size(); ++i)
+		out.keys[i] = static_cast<std::int32_t>(std::to_underlying(vals[i]));
+	return out;
+}();
+
+// Count of radix table blocks that contain at least one value.
+template <Enum E>
+constexpr std::size_t radix_table_used_blocks() noexcept {
+	std::size_t used = 0;
+	std::size_t lastBlock = static_cast<std::size_t>(-1);
+	// Values are in ascending order, so so are their blocks.
+	for (const E e : values<E>()) {
+		const std::size_t block = offset_from_min(e) >> RadixTableBlockBits;
+		if (block != lastBlock) {
+			++used;
+			lastBlock = block;
+		}
+	}
+	return used;
+}
+
+template <Enum E>
+struct radix_table_layout {
+	static constexpr std::size_t NumBlocks = (value_range_entries<E>() + RadixTableBlockSize - 1) >> RadixTableBlockBits;
+	// Block 0 is shared by every block with no values.
+	static constexpr std::size_t NumLeaves = (radix_table_used_blocks<E>() + 1) * RadixTableBlockSize;
+	using block_type = index_storage_t<NumLeaves>;
+	using leaf_type = index_storage_t<size<E>()>;
+	static constexpr std::size_t Bytes = NumBlocks * sizeof(block_type) + NumLeaves * sizeof(leaf_type);
+
+	// Offset into leaves of each block.
+	std::array<block_type, NumBlocks> blocks;
+	// Index of each value in values().
+	std::array<leaf_type, NumLeaves> leaves;
+};
+
+template <Enum E>
+inline constexpr radix_table_layout<E> radix_table = [] {
+	radix_table_layout<E> table{};
+
+	const auto& vals = values<E>();
+	std::size_t nextLeaf = RadixTableBlockSize;
 	for (std::size_t i = 0; i < vals.size(); ++i) {
-		const auto valIdx = std::to_underlying(vals[i]) - Minimum;
-		arr[static_cast<std::size_t>(valIdx)] = static_cast<std::uint8_t>(i);
+		const std::size_t offset = offset_from_min(vals[i]);
+		auto& block = table.blocks[offset >> RadixTableBlockBits];
+		if (block == 0) {
+			block = static_cast<typename radix_table_layout<E>::block_type>(nextLeaf);
+			nextLeaf += RadixTableBlockSize;
+		}
+		table.leaves[block + (offset & (RadixTableBlockSize - 1))] = static_cast<typename radix_table_layout<E>::leaf_type>(i);
 	}
-	return arr;
+	return table;
 }();
+
+template <Enum E>
+constexpr index_strategy forced_index_strategy() {
+	if constexpr (is_detected_convertible_v<index_strategy, HasForceIndexStrategySetting, E>) {
+		return enum_traits<E>::force_index_strategy;
+	} else {
+		return index_strategy::automatic;
+	}
+}
+
+template <Enum E>
+constexpr index_strategy select_index_strategy() {
+	constexpr index_strategy Forced = forced_index_strategy<E>();
+	if constexpr (Forced != index_strategy::automatic) {
+		static_assert(Forced != index_strategy::lookup_table || value_range_entries<E>() <= 255,
+			"This enum has too many entries to use a lookup table.");
+		static_assert(Forced != index_strategy::simd_compare || is_simd_compare_possible<E>(),
+			"This enum has too many values, or values that are too large, to use simd_compare.");
+		return Forced;
+	} else if constexpr (is_lookup_table_enabled_v<E>) {
+		return index_strategy::lookup_table;
+	} else if constexpr (size<E>() < EnumIndexLookupTableMin) {
+		return index_strategy::linear_search;
+	} else if constexpr (radix_table_layout<E>::Bytes <= RadixTableMaxBytes) {
+		return index_strategy::radix_table;
+	} else if constexpr (is_simd_compare_possible<E>()) {
+		return index_strategy::simd_compare;
+	} else {
+		return index_strategy::binary_search;
+	}
+}
+
+// The strategy index(E) uses for a non-contiguous enum.
+template <Enum E>
+inline constexpr index_strategy index_strategy_v = select_index_strategy<E>();
+
+template <Enum E>
+constexpr std::size_t linear_search_index(E e) noexcept {
+	const auto& vals = values<E>();
+
+	// Can still cut the initial search range in half to help.
+	const std::size_t midIdx = vals.size() / 2;
+	const auto mid = vals[midIdx];
+	if (mid <= e) {
+		for (std::size_t i = midIdx; i < vals.size(); ++i) {
+			if (vals[i] == e)
+				return i;
+		}
+	}
+
+	for (std::size_t i = midIdx; i > 0; --i) {
+		if (vals[i - 1] == e)
+			return i - 1;
+	}
+
+	// not found
+	std::terminate();
+}
+
+template <Enum E>
+constexpr std::size_t binary_search_index(E e) noexcept {
+	const auto& vals = values<E>();
+	const E* base = vals.data();
+	// Narrow down to the last value <= e. The loop count only depends on the enum's size,
+	// and the select should compile to a conditional move, so there is nothing to mispredict.
+	for (std::size_t n = vals.size(); n > 1;) {
+		const std::size_t half = n / 2;
+		base = base[half] <= e ? base + half : base;
+		n -= half;
+	}
+	return static_cast<std::size_t>(base - vals.data());
+}
+
+template <Enum E>
+constexpr std::size_t simd_compare_index(E e) noexcept {
+	// The index of a value is the number of values less than it.
+	if CTP_NOT_CONSTEVAL {
+#if CTP_SSE2
+		const auto& keys = simd_compare_keys<E>.keys;
+		const auto key = static_cast<std::int32_t>(std::to_underlying(e));
+		// Comparisons give -1 for true, so subtracting them counts each lane.
+#if CTP_AVX2
+		const __m256i needle = _mm256_set1_epi32(key);
+		__m256i counts = _mm256_setzero_si256();
+		for (std::size_t i = 0; i < keys.size(); i += 8) {
+			const __m256i vals = _mm256_load_si256(reinterpret_cast<const __m256i*>(keys.data() + i));
+			counts = _mm256_sub_epi32(counts, _mm256_cmpgt_epi32(needle, vals));
+		}
+		__m128i sum = _mm_add_epi32(_mm256_castsi256_si128(counts), _mm256_extracti128_si256(counts, 1));
+#else
+		const __m128i needle = _mm_set1_epi32(key);
+		__m128i sum = _mm_setzero_si128();
+		for (std::size_t i = 0; i < keys.size(); i += 4) {
+			const __m128i vals = _mm_load_si128(reinterpret_cast<const __m128i*>(keys.data() + i));
+			sum = _mm_sub_epi32(sum, _mm_cmpgt_epi32(needle, vals));
+		}
+#endif
+		// Horizontal add of the four lanes.
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+		return static_cast<std::size_t>(_mm_cvtsi128_si32(sum));
+#endif // CTP_SSE2
+	}
+
+	std::size_t count = 0;
+	for (const E val : values<E>())
+		count += val < e;
+	return count;
+}
+
+template <Enum E>
+constexpr std::size_t radix_table_index(E e) noexcept {
+	const auto& table = radix_table<E>;
+	const std::size_t offset = offset_from_min(e);
+	return table.leaves[table.blocks[offset >> RadixTableBlockBits] + (offset & (RadixTableBlockSize - 1))];
+}
+
+// Get the index of a named value of a non-contiguous enum with the given strategy.
+template <index_strategy Strategy, Enum E>
+constexpr std::size_t index_with_strategy(E e) noexcept {
+	if constexpr (Strategy == index_strategy::lookup_table) {
+		return enum_to_index_lookup_table<E>[offset_from_min(e)];
+	} else if constexpr (Strategy == index_strategy::binary_search) {
+		return binary_search_index(e);
+	} else if constexpr (Strategy == index_strategy::simd_compare) {
+		return simd_compare_index(e);
+	} else if constexpr (Strategy == index_strategy::radix_table) {
+		return radix_table_index(e);
+	} else if constexpr (Strategy == index_strategy::automatic) {
+		return index_with_strategy<index_strategy_v<E>>(e);
+	} else {
+		return linear_search_index(e);
+	}
+}
 } // detail
 
 // Get the index of an enum member into the values or names array.
 // Value must exist in values().
 template <Enum E>
 constexpr std::size_t index(E e) noexcept {
-	constexpr auto Minimum = std::to_underlying(min_val<E>());
-
-	const auto val = std::to_underlying(e);
 	if constexpr (poison::magic_enum::detail::is_sparse_v<E>) {
-		const auto& vals = values<E>();
-
-		if constexpr (detail::is_lookup_table_enabled_v<E>)
-		{
-			const auto lookupIdx = static_cast<std::size_t>(val - Minimum);
-			return detail::enum_to_index_lookup_table<E>[lookupIdx];
-		} else {
-			// Due to the limitations in magic_enum, I don't expect to have huge
-			// enums where binary search would be a meaningful benefit, and since
-			// the values array is integers linear search should be fast.
-			// Can still cut the initial search range in half to help.
-
-			const std::size_t midIdx = vals.size() / 2;
-			const auto mid = vals[midIdx];
-			if (mid <= e) {
-				for (std::size_t i = midIdx; i < vals.size(); ++i) {
-					if (vals[i] == e)
-						return i;
-				}
-			}
-
-			for (std::size_t i = midIdx; i > 0; --i) {
-				if (vals[i - 1] == e)
-					return i - 1;
-			}
-
-			// not found
-			std::terminate();
-		}
+		return detail::index_with_strategy<detail::index_strategy_v<E>>(e);
 	} else {
-		return static_cast<std::size_t>(val - Minimum);
+		return detail::offset_from_min(e);
 	}
 }
 
@@ -189,18 +461,6 @@ constexpr std::optional<std::size_t> try_get_index(E e) noexcept {
 	return poison::magic_enum::enum_index<E>(e);
 }
 
-template <Enum E>
-constexpr E min_val() noexcept {
-	static_assert(size<E>() > 0);
-	return values<E>().front();
-}
-
-template <Enum E>
-constexpr E max_val() noexcept {
-	static_assert(size<E>() > 0);
-	return values<E>().back();
-}
-
 namespace detail {
 template <Enum E>
 static constexpr auto zstring_names = [] {
@@ -237,6 +497,171 @@ constexpr std::optional<E> try_cast_icase(std::string_view name) noexcept {
 	return poison::magic_enum::enum_cast<E>(name, poison::magic_enum::case_insensitive);
 }
 
+namespace detail {
+// Names indexed by index(E), with an extra empty name at the end for values that are not named.
+template <Enum E>
+inline constexpr auto zstring_names_or_empty = [] {
+	std::array<zstring_view, size<E>() + 1> arr{};
+	for (std::size_t i = 0; i < size<E>(); ++i)
+		arr[i] = zstring_names<E>[i];
+	return arr;
+}();
+
+// Index of a value, or size<E>() if it is not a named value.
+template <Enum E>
+constexpr std::size_t index_or_size(E e) noexcept {
+	if (offset_from_min(e) >= value_range_entries<E>())
+		return size<E>();
+
+	if constexpr (!poison::magic_enum::detail::is_sparse_v<E>) {
+		return offset_from_min(e);
+	} else if constexpr (index_strategy_v<E> == index_strategy::linear_search) {
+		return try_get_index(e).value_or(size<E>());
+	} else {
+		// Every other strategy gives some in-range index for unnamed values, so check we found the right one.
+		const std::size_t i = index_with_strategy<index_strategy_v<E>>(e);
+		return values<E>()[i] == e ? i : size<E>();
+	}
+}
+
+// FNV-1a.
+constexpr std::uint32_t hash_name(std::string_view name) noexcept {
+	std::uint32_t hash = 2166136261u;
+	for (const char c : name) {
+		hash ^= static_cast<unsigned char>(c);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+// Open addressed hash table from name to index.
+template <Enum E>
+struct name_hash_table_t {
+	// At least half the slots are empty to keep probes short.
+	static constexpr std::size_t Slots = std::bit_ceil(size<E>() * 2);
+	using slot_type = index_storage_t<size<E>()>;
+	static constexpr slot_type Empty = static_cast<slot_type>(size<E>());
+
+	std::array<slot_type, Slots> slots;
+};
+
+template <Enum E>
+inline constexpr name_hash_table_t<E> name_hash_table = [] {
+	using table_type = name_hash_table_t<E>;
+	table_type table{};
+	table.slots.fill(table_type::Empty);
+	for (std::size_t i = 0; i < size<E>(); ++i) {
+		std::size_t slot = hash_name(zstring_names<E>[i]) & (table_type::Slots - 1);
+		while (table.slots[slot] != table_type::Empty)
+			slot = (slot + 1) & (table_type::Slots - 1);
+		table.slots[slot] = static_cast<typename table_type::slot_type>(i);
+	}
+	return table;
+}();
+
+// Index of the value with the given name, or size<E>() if there is none.
+template <Enum E>
+constexpr std::size_t index_from_name(std::string_view name) noexcept {
+	using table_type = name_hash_table_t<E>;
+	const auto& table = name_hash_table<E>;
+	for (std::size_t slot = hash_name(name) & (table_type::Slots - 1);; slot = (slot + 1) & (table_type::Slots - 1)) {
+		const std::size_t i = table.slots[slot];
+		if (i == size<E>() || std::string_view{zstring_names<E>[i]} == name)
+			return i;
+	}
+}
+} // detail
+
+// Write the name of each value to out. Values that are not named get an empty string, like name(E).
+// Returns the output iterator one past the last name written.
+template <Enum E, class OutIt>
+constexpr OutIt names_of(std::span<const E> vals, OutIt out) {
+	const auto& table = detail::zstring_names_or_empty<E>;
+	for (const E e : vals) {
+		*out = table[detail::index_or_size(e)];
+		++out;
+	}
+	return out;
+}
+
+// Parse each name into out, which must be at least as large as names.
+// Stops at the first name that is not in the enum, and returns the number of names parsed.
+// All names were parsed if the result equals names.size(); otherwise it is the index of the bad name.
+template <Enum E>
+constexpr std::size_t parse_all(std::span<const std::string_view> names, std::span<E> out) noexcept {
+	ctpExpects(out.size() >= names.size());
+	const auto& vals = values<E>();
+	for (std::size_t i = 0; i < names.size(); ++i) {
+		const std::size_t idx = detail::index_from_name<E>(names[i]);
+		if (idx == size<E>())
+			return i;
+		out[i] = vals[idx];
+	}
+	return names.size();
+}
+
+// Names of an enum packed into one contiguous blob of null terminated strings, for writing out
+// to a file that can be memory mapped and read back with a packed_names_view.
+template <Enum E>
+struct packed_names_t {
+	static constexpr std::size_t Count = size<E>();
+	static constexpr std::size_t BlobSize = [] {
+		std::size_t bytes = 0;
+		for (const zstring_view name : names<E>())
+			bytes += name.size() + 1;
+		return bytes;
+	}();
+
+	// Name i starts at offsets[i]. offsets[Count] is the end of the blob.
+	std::array<std::uint32_t, Count + 1> offsets;
+	std::array<char, BlobSize> blob;
+};
+
+template <Enum E>
+inline constexpr packed_names_t<E> packed_names = [] {
+	static_assert(packed_names_t<E>::BlobSize <= (std::numeric_limits<std::uint32_t>::max)());
+	packed_names_t<E> packed{};
+	std::size_t pos = 0;
+	for (std::size_t i = 0; i < packed_names_t<E>::Count; ++i) {
+		packed.offsets[i] = static_cast<std::uint32_t>(pos);
+		for (const char c : names<E>()[i])
+			packed.blob[pos++] = c;
+		packed.blob[pos++] = '\0';
+	}
+	packed.offsets[packed_names_t<E>::Count] = static_cast<std::uint32_t>(pos);
+	return packed;
+}();
+
+// Read-only view of a packed name table, such as a memory mapped packed_names_t.
+class packed_names_view {
+	std::span<const std::uint32_t> offsets_;
+	const char* blob_ = nullptr;
+public:
+	constexpr packed_names_view() noexcept = default;
+	// offsets has one more entry than there are names, and blob holds offsets.back() chars.
+	constexpr packed_names_view(std::span<const std::uint32_t> offsets, const char* blob) noexcept
+		: offsets_{offsets}
+		, blob_{blob}
+	{
+		ctpExpects(!offsets.empty());
+	}
+
+	template <Enum E>
+	constexpr packed_names_view(const packed_names_t<E>& packed) noexcept
+		: offsets_{packed.offsets}
+		, blob_{packed.blob.data()}
+	{}
+
+	constexpr std::size_t size() const noexcept { return offsets_.empty() ? 0 : offsets_.size() - 1; }
+
+	// Name at index i into values().
+	constexpr zstring_view operator[](std::size_t i) const noexcept {
+		ctpExpects(i < size());
+		// Exclude the null terminator.
+		return zstring_view{zstring_view::null_terminated_tag{}, blob_ + offsets_[i], offsets_[i + 1] - offsets_[i] - 1};
+	}
+};
+
 } // ctp::enums
 
 #endif // INCLUDE_CTP_ENUM_REFLECTION_HPP
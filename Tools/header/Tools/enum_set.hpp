@@ -0,0 +1,253 @@
+#ifndef INCLUDE_CTP_TOOLS_ENUM_SET_HPP
+#define INCLUDE_CTP_TOOLS_ENUM_SET_HPP
+
+#include "BitEnum.hpp"
+#include "config.hpp"
+#include "debug.hpp"
+#include "enum_reflection.hpp"
+#include "iterator.hpp"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+
+namespace ctp {
+
+namespace enum_detail {
+using enum_set_word_type = std::uint64_t;
+inline constexpr std::size_t EnumSetWordBits = 64;
+
+// Iterates the values in an enum_set in ascending order by scanning for set bits.
+template <enums::Enum E, std::size_t NumWords>
+class enum_set_iterator_t : public iterator_t<enum_set_iterator_t<E, NumWords>, E, std::forward_iterator_tag, std::ptrdiff_t, E> {
+	const enum_set_word_type* words_ = nullptr;
+	std::size_t wordIndex_ = NumWords;
+	// Bits of the current word not yet visited.
+	enum_set_word_type remaining_ = 0;
+
+	friend iterator_accessor;
+	constexpr E peek() const noexcept {
+		const auto i = wordIndex_ * EnumSetWordBits + static_cast<std::size_t>(std::countr_zero(remaining_));
+		return enums::values<E>()[i];
+	}
+	constexpr bool equals(const enum_set_iterator_t& o) const noexcept {
+		return wordIndex_ == o.wordIndex_ && remaining_ == o.remaining_;
+	}
+	constexpr enum_set_iterator_t& pre_increment() noexcept {
+		// Clear the lowest set bit.
+		remaining_ &= remaining_ - 1;
+		skip_empty_words();
+		return *this;
+	}
+
+	constexpr void skip_empty_words() noexcept {
+		while (remaining_ == 0 && ++wordIndex_ < NumWords)
+			remaining_ = words_[wordIndex_];
+	}
+public:
+	constexpr enum_set_iterator_t() noexcept = default;
+	// Begin iterator.
+	constexpr explicit enum_set_iterator_t(const enum_set_word_type* words) noexcept
+		: words_{words}
+		, wordIndex_{0}
+		, remaining_{NumWords > 0 ? words[0] : 0}
+	{
+		if constexpr (NumWords > 0)
+			skip_empty_words();
+	}
+	// Iterator to the first value in the set at or after index i of values().
+	constexpr enum_set_iterator_t(const enum_set_word_type* words, std::size_t i) noexcept
+		: words_{words}
+		, wordIndex_{i / EnumSetWordBits}
+	{
+		ctpExpects(i < NumWords * EnumSetWordBits);
+		// Skip the bits before i.
+		remaining_ = words[wordIndex_] & ~((enum_set_word_type{1} << (i % EnumSetWordBits)) - 1);
+		skip_empty_words();
+	}
+};
+} // enum_detail
+
+// A set of named values of an enum, stored as one bit per value indexed by enums::index.
+// Expects that only valid named values are used with it, like enum_map.
+template <enums::Enum E>
+class enum_set {
+public:
+	using word_type = enum_detail::enum_set_word_type;
+	using key_type = E;
+	using value_type = E;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+
+	static constexpr std::size_t Size = enums::size<E>();
+	static constexpr std::size_t NumWords = (Size + enum_detail::EnumSetWordBits - 1) / enum_detail::EnumSetWordBits;
+
+	using iterator = enum_detail::enum_set_iterator_t<E, NumWords>;
+	using const_iterator = iterator;
+
+private:
+	// Bits of the last word that correspond to a value.
+	static constexpr word_type LastWordMask = Size % enum_detail::EnumSetWordBits == 0
+		? ~word_type{0}
+		: (word_type{1} << (Size % enum_detail::EnumSetWordBits)) - 1;
+
+	std::array<word_type, NumWords> words_{};
+
+	static constexpr std::size_t word_of(std::size_t i) noexcept { return i / enum_detail::EnumSetWordBits; }
+	static constexpr word_type mask_of(std::size_t i) noexcept { return word_type{1} << (i % enum_detail::EnumSetWordBits); }
+
+	template <class Op>
+	constexpr enum_set& apply(const enum_set& o, Op op) noexcept {
+		for (std::size_t i = 0; i < NumWords; ++i)
+			words_[i] = op(words_[i], o.words_[i]);
+		return *this;
+	}
+
+public:
+	constexpr enum_set() noexcept = default;
+	constexpr enum_set(std::initializer_list<E> vals) noexcept {
+		for (const E e : vals)
+			insert(e);
+	}
+
+	// A set containing every named value.
+	[[nodiscard]] static constexpr enum_set all() noexcept {
+		enum_set set;
+		set.words_.fill(~word_type{0});
+		if constexpr (NumWords > 0)
+			set.words_.back() = LastWordMask;
+		return set;
+	}
+
+	// --------------------- flag enums ---------------------
+
+	// Make a set from flags. A value is in the set if it is nonzero and all of its bits are set.
+	[[nodiscard]] static constexpr enum_set from_flags(BitEnum<E> flags) noexcept {
+		enum_set set;
+		const auto& vals = enums::values<E>();
+		for (std::size_t i = 0; i < Size; ++i) {
+			const BitEnum<E> val{vals[i]};
+			if (val.underlying() != 0 && (flags & val) == val)
+				set.words_[word_of(i)] |= mask_of(i);
+		}
+		return set;
+	}
+
+	// Combine all values in the set as flags.
+	[[nodiscard]] constexpr BitEnum<E> to_flags() const noexcept {
+		BitEnum<E> flags;
+		for (const E e : *this)
+			flags |= e;
+		return flags;
+	}
+
+	// --------------------- capacity ---------------------
+
+	[[nodiscard]] static constexpr std::size_t max_size() noexcept { return Size; }
+
+	// Number of values in the set.
+	[[nodiscard]] constexpr std::size_t size() const noexcept {
+		std::size_t count = 0;
+		for (const word_type word : words_)
+			count += static_cast<std::size_t>(std::popcount(word));
+		return count;
+	}
+
+	[[nodiscard]] constexpr bool empty() const noexcept {
+		for (const word_type word : words_) {
+			if (word != 0)
+				return false;
+		}
+		return true;
+	}
+	[[nodiscard]] constexpr bool is_empty() const noexcept { return empty(); }
+
+	// --------------------- access ---------------------
+
+	[[nodiscard]] constexpr bool contains(E e) const noexcept {
+		ctpExpects(enums::try_get_index(e));
+		const std::size_t i = enums::index(e);
+		return (words_[word_of(i)] & mask_of(i)) != 0;
+	}
+	[[nodiscard]] constexpr std::size_t count(E e) const noexcept { return contains(e) ? 1 : 0; }
+
+	// Underlying bits, where bit i is values()[i].
+	[[nodiscard]] constexpr std::span<word_type, NumWords> words() noexcept { return words_; }
+	// Underlying bits, where bit i is values()[i].
+	[[nodiscard]] constexpr std::span<const word_type, NumWords> words() const noexcept { return words_; }
+
+	[[nodiscard]] constexpr iterator begin() const noexcept { return iterator{words_.data()}; }
+	[[nodiscard]] constexpr iterator cbegin() const noexcept { return begin(); }
+	[[nodiscard]] constexpr iterator end() const noexcept { return iterator{}; }
+	[[nodiscard]] constexpr iterator cend() const noexcept { return end(); }
+
+	// --------------------- modifiers ---------------------
+
+	// Returns true if the value was not already in the set.
+	constexpr bool insert(E e) noexcept {
+		ctpExpects(enums::try_get_index(e));
+		const std::size_t i = enums::index(e);
+		const bool inserted = (words_[word_of(i)] & mask_of(i)) == 0;
+		words_[word_of(i)] |= mask_of(i);
+		return inserted;
+	}
+
+	// Returns the number of values erased.
+	constexpr std::size_t erase(E e) noexcept {
+		ctpExpects(enums::try_get_index(e));
+		const std::size_t i = enums::index(e);
+		const bool erased = (words_[word_of(i)] & mask_of(i)) != 0;
+		words_[word_of(i)] &= ~mask_of(i);
+		return erased ? 1 : 0;
+	}
+
+	constexpr enum_set& flip(E e) noexcept {
+		ctpExpects(enums::try_get_index(e));
+		const std::size_t i = enums::index(e);
+		words_[word_of(i)] ^= mask_of(i);
+		return *this;
+	}
+
+	constexpr void clear() noexcept { words_.fill(0); }
+
+	// --------------------- set operations ---------------------
+
+	constexpr enum_set& operator|=(const enum_set& o) noexcept { return apply(o, [](word_type a, word_type b) { return a | b; }); }
+	constexpr enum_set& operator&=(const enum_set& o) noexcept { return apply(o, [](word_type a, word_type b) { return a & b; }); }
+	constexpr enum_set& operator^=(const enum_set& o) noexcept { return apply(o, [](word_type a, word_type b) { return a ^ b; }); }
+	// Difference.
+	constexpr enum_set& operator-=(const enum_set& o) noexcept { return apply(o, [](word_type a, word_type b) { return a & ~b; }); }
+
+	[[nodiscard]] friend constexpr enum_set operator|(enum_set lhs, const enum_set& rhs) noexcept { return lhs |= rhs; }
+	[[nodiscard]] friend constexpr enum_set operator&(enum_set lhs, const enum_set& rhs) noexcept { return lhs &= rhs; }
+	[[nodiscard]] friend constexpr enum_set operator^(enum_set lhs, const enum_set& rhs) noexcept { return lhs ^= rhs; }
+	// Difference.
+	[[nodiscard]] friend constexpr enum_set operator-(enum_set lhs, const enum_set& rhs) noexcept { return lhs -= rhs; }
+
+	// Complement. Only contains named values.
+	[[nodiscard]] constexpr enum_set operator~() const noexcept { return all() - *this; }
+
+	[[nodiscard]] constexpr bool intersects(const enum_set& o) const noexcept {
+		for (std::size_t i = 0; i < NumWords; ++i) {
+			if ((words_[i] & o.words_[i]) != 0)
+				return true;
+		}
+		return false;
+	}
+
+	[[nodiscard]] constexpr bool is_subset_of(const enum_set& o) const noexcept {
+		for (std::size_t i = 0; i < NumWords; ++i) {
+			if ((words_[i] & ~o.words_[i]) != 0)
+				return false;
+		}
+		return true;
+	}
+
+	friend constexpr bool operator==(const enum_set& lhs, const enum_set& rhs) noexcept = default;
+};
+
+} // ctp
+
+#endif // INCLUDE_CTP_TOOLS_ENUM_SET_HPP
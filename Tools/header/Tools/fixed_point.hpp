@@ -0,0 +1,622 @@
+#ifndef INCLUDE_CTP_TOOLS_FIXED_POINT_HPP
+#define INCLUDE_CTP_TOOLS_FIXED_POINT_HPP
+
+#include "config.hpp"
+#include "debug.hpp"
+#include "StrongType.hpp"
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#if !defined __SIZEOF_INT128__ && defined _M_X64
+#include <intrin.h>
+#endif
+
+namespace ctp {
+
+// What a fixed_point does when a result doesn't fit.
+struct overflow_wrapping {}; // Wrap around like unsigned integers. The fastest.
+struct overflow_saturating {}; // Clamp to the largest or lowest value.
+
+// A signed fixed-point number with FracBits of its integer type I after the point, for arithmetic that gives the
+// same results on every machine. All the Arithmetic operations work between the same fixed_point types:
+// * and / truncate like integers do, towards negative infinity and zero respectively.
+// Overflow wraps or saturates depending on the Overflow policy, except that division and conversions from
+// floating-point always saturate, since there's no meaningful result to wrap.
+template <std::signed_integral I, int FracBits, typename Overflow = overflow_wrapping>
+struct fixed_point;
+
+using q16_16 = fixed_point<std::int32_t, 16>;
+using q32_32 = fixed_point<std::int64_t, 32>;
+
+namespace fixed_detail {
+
+template <typename T>
+struct is_fixed_point : std::false_type {};
+template <typename I, int FracBits, typename Overflow>
+struct is_fixed_point<fixed_point<I, FracBits, Overflow>> : std::true_type {};
+
+struct uint128 {
+	std::uint64_t high;
+	std::uint64_t low;
+};
+
+// Two's complement.
+struct int128 {
+	std::int64_t high;
+	std::uint64_t low;
+};
+
+constexpr uint128 multiply_wide(const std::uint64_t a, const std::uint64_t b) noexcept
+{
+#if defined __SIZEOF_INT128__
+	const auto product = static_cast<unsigned __int128>(a) * b;
+	return {static_cast<std::uint64_t>(product >> 64), static_cast<std::uint64_t>(product)};
+#else
+	if CTP_NOT_CONSTEVAL {
+#if defined _M_X64
+		uint128 product;
+		product.low = _umul128(a, b, &product.high);
+		return product;
+#endif
+	}
+	const std::uint64_t aLow = a & 0xFFFFFFFF;
+	const std::uint64_t aHigh = a >> 32;
+	const std::uint64_t bLow = b & 0xFFFFFFFF;
+	const std::uint64_t bHigh = b >> 32;
+	const std::uint64_t lowLow = aLow * bLow;
+	const std::uint64_t highLow = aHigh * bLow;
+	const std::uint64_t lowHigh = aLow * bHigh;
+	const std::uint64_t middle = (lowLow >> 32) + (highLow & 0xFFFFFFFF) + lowHigh;
+	return {aHigh * bHigh + (highLow >> 32) + (middle >> 32), (middle << 32) | (lowLow & 0xFFFFFFFF)};
+#endif
+}
+
+constexpr int128 multiply_wide(const std::int64_t a, const std::int64_t b) noexcept
+{
+#if defined __SIZEOF_INT128__
+	const auto product = static_cast<__int128>(a) * b;
+	return {static_cast<std::int64_t>(product >> 64), static_cast<std::uint64_t>(product)};
+#else
+	if CTP_NOT_CONSTEVAL {
+#if defined _M_X64
+		int128 product;
+		product.low = static_cast<std::uint64_t>(_mul128(a, b, &product.high));
+		return product;
+#endif
+	}
+	// The unsigned product, less b * 2^64 if a is negative and a * 2^64 if b is.
+	const uint128 product = multiply_wide(static_cast<std::uint64_t>(a), static_cast<std::uint64_t>(b));
+	std::uint64_t high = product.high;
+	if (a < 0)
+		high -= static_cast<std::uint64_t>(b);
+	if (b < 0)
+		high -= static_cast<std::uint64_t>(a);
+	return {static_cast<std::int64_t>(high), product.low};
+#endif
+}
+
+// The high half of a * b, for the approximations, which work in 32 bits where that's enough.
+constexpr std::uint32_t multiply_high(const std::uint32_t a, const std::uint32_t b) noexcept
+{
+	return static_cast<std::uint32_t>((static_cast<std::uint64_t>(a) * b) >> 32);
+}
+
+constexpr std::uint64_t multiply_high(const std::uint64_t a, const std::uint64_t b) noexcept
+{
+	return multiply_wide(a, b).high;
+}
+
+// numerator / divisor, where numerator.high < divisor so the quotient fits.
+constexpr std::uint64_t divide_wide(const uint128 numerator, const std::uint64_t divisor) noexcept
+{
+#if defined __SIZEOF_INT128__
+	return static_cast<std::uint64_t>(((static_cast<unsigned __int128>(numerator.high) << 64) | numerator.low) / divisor);
+#else
+	if CTP_NOT_CONSTEVAL {
+#if defined _M_X64
+		std::uint64_t remainder;
+		return _udiv128(numerator.high, numerator.low, divisor, &remainder);
+#endif
+	}
+	// Long division, a bit at a time.
+	std::uint64_t remainder = numerator.high;
+	std::uint64_t quotient = 0;
+	for (int i = 63; i >= 0; --i) {
+		const bool carry = (remainder >> 63) != 0;
+		remainder = (remainder << 1) | ((numerator.low >> i) & 1);
+		quotient <<= 1;
+		if (carry || remainder >= divisor) {
+			remainder -= divisor;
+			quotient |= 1;
+		}
+	}
+	return quotient;
+#endif
+}
+
+struct wide_quotient {
+	std::int64_t quotient;
+	bool overflow;
+};
+
+// numerator / denominator truncated towards zero, or overflow if it doesn't fit in 64 bits.
+constexpr wide_quotient divide_wide(const int128 numerator, const std::int64_t denominator) noexcept
+{
+	const bool negative = (numerator.high < 0) != (denominator < 0);
+	uint128 magnitude{static_cast<std::uint64_t>(numerator.high), numerator.low};
+	if (numerator.high < 0)
+		magnitude = {~magnitude.high + (magnitude.low == 0 ? 1 : 0), 0 - magnitude.low};
+	const std::uint64_t divisor = denominator < 0 ? 0 - static_cast<std::uint64_t>(denominator) : static_cast<std::uint64_t>(denominator);
+	if (magnitude.high >= divisor)
+		return {0, true};
+
+	const std::uint64_t quotient = divide_wide(magnitude, divisor);
+	const std::uint64_t limit = static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max()) + (negative ? 1 : 0);
+	if (quotient > limit)
+		return {0, true};
+	return {static_cast<std::int64_t>(negative ? 0 - quotient : quotient), false};
+}
+
+// Raw operations on the integers of a fixed_point.
+
+template <typename I, bool Saturate>
+constexpr I narrow(const std::int64_t value) noexcept
+{
+	if constexpr (Saturate) {
+		if (value > std::numeric_limits<I>::max())
+			return std::numeric_limits<I>::max();
+		if (value < std::numeric_limits<I>::lowest())
+			return std::numeric_limits<I>::lowest();
+	}
+	return static_cast<I>(value);
+}
+
+template <typename I, bool Saturate>
+constexpr I add(const I a, const I b) noexcept
+{
+	using U = std::make_unsigned_t<I>;
+	const auto sum = static_cast<I>(static_cast<U>(static_cast<U>(a) + static_cast<U>(b)));
+	if constexpr (Saturate) {
+		// Overflowed if the sum's sign differs from both of theirs.
+		if (((a ^ sum) & (b ^ sum)) < 0)
+			return a < 0 ? std::numeric_limits<I>::lowest() : std::numeric_limits<I>::max();
+	}
+	return sum;
+}
+
+template <typename I, bool Saturate>
+constexpr I subtract(const I a, const I b) noexcept
+{
+	using U = std::make_unsigned_t<I>;
+	const auto difference = static_cast<I>(static_cast<U>(static_cast<U>(a) - static_cast<U>(b)));
+	if constexpr (Saturate) {
+		// Overflowed if the signs differ, and the difference's sign differs from a's.
+		if (((a ^ b) & (a ^ difference)) < 0)
+			return a < 0 ? std::numeric_limits<I>::lowest() : std::numeric_limits<I>::max();
+	}
+	return difference;
+}
+
+// a * b >> Shift, which for Shift 0 multiplies by an integer.
+template <typename I, int Shift, bool Saturate>
+constexpr I multiply(const I a, const I b) noexcept
+{
+	if constexpr (sizeof(I) <= 4) {
+		return narrow<I, Saturate>((static_cast<std::int64_t>(a) * b) >> Shift);
+	} else {
+		const int128 product = multiply_wide(static_cast<std::int64_t>(a), static_cast<std::int64_t>(b));
+		if constexpr (Shift == 0) {
+			if constexpr (Saturate) {
+				if (product.high != (static_cast<std::int64_t>(product.low) >> 63))
+					return product.high < 0 ? std::numeric_limits<I>::lowest() : std::numeric_limits<I>::max();
+			}
+			return static_cast<I>(product.low);
+		} else {
+			if constexpr (Saturate) {
+				// Fits if the bits above the result are all the same as its sign bit.
+				const std::int64_t top = product.high >> (Shift - 1);
+				if (top != 0 && top != -1)
+					return product.high < 0 ? std::numeric_limits<I>::lowest() : std::numeric_limits<I>::max();
+			}
+			return static_cast<I>((static_cast<std::uint64_t>(product.high) << (64 - Shift)) | (product.low >> Shift));
+		}
+	}
+}
+
+// (a << Shift) / b. b must not be 0.
+template <typename I, int Shift>
+constexpr I divide(const I a, const I b) noexcept
+{
+	if constexpr (sizeof(I) <= 4) {
+		return narrow<I, true>(static_cast<std::int64_t>(a) * (std::int64_t{1} << Shift) / b);
+	} else {
+		const int128 numerator{static_cast<std::int64_t>(a) >> (64 - Shift), static_cast<std::uint64_t>(a) << Shift};
+		const wide_quotient result = divide_wide(numerator, static_cast<std::int64_t>(b));
+		if (result.overflow)
+			return (a < 0) != (b < 0) ? std::numeric_limits<I>::lowest() : std::numeric_limits<I>::max();
+		return static_cast<I>(result.quotient);
+	}
+}
+
+// The word the approximations use for I, the smallest that holds the magnitude of any I.
+template <typename I>
+using approximation_word = std::conditional_t<(sizeof(I) <= 4), std::uint32_t, std::uint64_t>;
+
+// Shifts right with rounding, for the approximations. Shift may be negative.
+template <typename U>
+constexpr U shift_round(const U value, const int shift) noexcept
+{
+	if (shift <= 0)
+		return static_cast<U>(value << -shift);
+	if (shift >= std::numeric_limits<U>::digits)
+		return 0;
+	// Rounds in the last bit, which the approximations leave room for, with one variable shift since they're slow.
+	return static_cast<U>(static_cast<U>((value >> (shift - 1)) + 1) >> 1);
+}
+
+// floor(sqrt(value)), a bit at a time, for the tables.
+constexpr std::uint64_t integer_sqrt(std::uint64_t value) noexcept
+{
+	std::uint64_t root = 0;
+	for (std::uint64_t bit = std::uint64_t{1} << 62; bit != 0; bit >>= 2) {
+		if (value >= root + bit) {
+			value -= root + bit;
+			root = (root >> 1) + bit;
+		} else {
+			root >>= 1;
+		}
+	}
+	return root;
+}
+
+// The seeds for the approximations, in Q1.15, each just under the exact value for anything in its range of m so
+// that Newton-Raphson converges from below. They're indexed by the 9 bits at the top of m, and within 2^-8 of it.
+
+// 1 / m for m in [0.5, 1).
+inline constexpr std::array<std::uint16_t, 256> reciprocal_table = [] {
+	std::array<std::uint16_t, 256> table{};
+	for (std::uint32_t i = 0; i < table.size(); ++i)
+		table[i] = static_cast<std::uint16_t>((std::uint32_t{1} << 24) / (256 + i + 1));
+	return table;
+}();
+
+// 1 / sqrt(m) for m in [0.25, 1).
+inline constexpr std::array<std::uint16_t, 384> reciprocal_sqrt_table = [] {
+	std::array<std::uint16_t, 384> table{};
+	for (std::uint32_t i = 0; i < table.size(); ++i)
+		table[i] = static_cast<std::uint16_t>(integer_sqrt((std::uint64_t{1} << 39) / (128 + i + 1)));
+	return table;
+}();
+
+// Approximately 1 / m in Q2.(N-2), for m in [0.5, 1) in Q0.N, where N is the number of bits in U.
+template <typename U>
+constexpr U reciprocal_normalized(const U m, const int iterations) noexcept
+{
+	constexpr int Bits = std::numeric_limits<U>::digits;
+	constexpr U One = U{1} << (Bits - 2);
+	U y = static_cast<U>(static_cast<U>(reciprocal_table[(m >> (Bits - 9)) - 256]) << (Bits - 17));
+	// Newton-Raphson, y += y (1 - m y), which squares the error each time, and stays below 1 / m.
+	for (int i = 0; i < iterations; ++i)
+		y = static_cast<U>(y + (multiply_high(y, static_cast<U>(One - multiply_high(m, y))) << 2));
+	return y;
+}
+
+// Approximately sqrt(m) in Q3.(N-3), for m in [0.25, 1) in Q0.N, where N is the number of bits in U.
+template <typename U>
+constexpr U sqrt_normalized(const U m, const int iterations) noexcept
+{
+	constexpr int Bits = std::numeric_limits<U>::digits;
+	constexpr U Three = U{3} << (Bits - 3);
+	// 1 / sqrt(m) first, since it needs no division.
+	U y = static_cast<U>(static_cast<U>(reciprocal_sqrt_table[(m >> (Bits - 9)) - 128]) << (Bits - 18));
+	// Newton-Raphson, y = y (3 - m y^2) / 2, which about squares the error each time, and stays below 1 / sqrt(m).
+	for (int i = 0; i < iterations; ++i) {
+		const auto myy = static_cast<U>(multiply_high(multiply_high(m, y), y) << 3);
+		y = static_cast<U>(multiply_high(y, static_cast<U>(Three - myy)) << 2);
+	}
+	return multiply_high(m, y);
+}
+
+} // fixed_detail
+
+template <typename T>
+concept IsFixedPoint = fixed_detail::is_fixed_point<std::remove_const_t<T>>::value;
+
+template <std::signed_integral I, int FracBits, typename Overflow /*= overflow_wrapping*/>
+struct fixed_point : StrongType<fixed_point<I, FracBits, Overflow>, I>, Arithmetic, CustomConversions {
+	static_assert(FracBits > 0 && FracBits < std::numeric_limits<I>::digits, "Needs at least one bit on each side of the point.");
+	static_assert(std::disjunction_v<
+		std::is_same<Overflow, overflow_wrapping>,
+		std::is_same<Overflow, overflow_saturating>>, "Use one of the provided types above.");
+
+	using Base = StrongType<fixed_point, I>;
+	using overflow_policy = Overflow;
+	static constexpr int frac_bits = FracBits;
+	static constexpr bool is_saturating = std::is_same_v<Overflow, overflow_saturating>;
+
+	// Constructors, from the number they represent.
+
+	constexpr fixed_point() noexcept : Base{I{0}} {}
+
+	template <std::integral J>
+	explicit constexpr fixed_point(const J integer) noexcept : Base{from_integer(integer)} {}
+
+	// Rounds to the nearest, and saturates values out of range.
+	template <std::floating_point F>
+	explicit constexpr fixed_point(const F number) noexcept : Base{from_floating(number)} {}
+
+	[[nodiscard]] static constexpr fixed_point from_raw(const I raw) noexcept
+	{
+		fixed_point result;
+		result.value = raw;
+		return result;
+	}
+
+	[[nodiscard]] constexpr I raw() const noexcept { return this->value; }
+
+	[[nodiscard]] static constexpr fixed_point max() noexcept { return from_raw(std::numeric_limits<I>::max()); }
+	[[nodiscard]] static constexpr fixed_point lowest() noexcept { return from_raw(std::numeric_limits<I>::lowest()); }
+	// The smallest step between two values.
+	[[nodiscard]] static constexpr fixed_point epsilon() noexcept { return from_raw(I{1}); }
+	[[nodiscard]] static constexpr fixed_point one() noexcept { return from_raw(Scale); }
+
+	// Integers are truncated towards zero, like from floating-point.
+	template <typename U>
+		requires std::is_arithmetic_v<U>
+	explicit constexpr operator U() const noexcept
+	{
+		if constexpr (std::is_floating_point_v<U>)
+			return static_cast<U>(this->value) / static_cast<U>(Scale);
+		else
+			return static_cast<U>(this->value / Scale);
+	}
+
+	// Arithmetic.
+
+	[[nodiscard]] friend constexpr fixed_point operator+(const fixed_point lhs, const fixed_point rhs) noexcept
+	{
+		return from_raw(fixed_detail::add<I, is_saturating>(lhs.value, rhs.value));
+	}
+	[[nodiscard]] friend constexpr fixed_point operator-(const fixed_point lhs, const fixed_point rhs) noexcept
+	{
+		return from_raw(fixed_detail::subtract<I, is_saturating>(lhs.value, rhs.value));
+	}
+	[[nodiscard]] friend constexpr fixed_point operator-(const fixed_point rhs) noexcept
+	{
+		return from_raw(fixed_detail::subtract<I, is_saturating>(I{0}, rhs.value));
+	}
+	[[nodiscard]] friend constexpr fixed_point operator*(const fixed_point lhs, const fixed_point rhs) noexcept
+	{
+		return from_raw(fixed_detail::multiply<I, FracBits, is_saturating>(lhs.value, rhs.value));
+	}
+	// rhs must not be zero, unless saturating, where it gives the largest or lowest value.
+	[[nodiscard]] friend constexpr fixed_point operator/(const fixed_point lhs, const fixed_point rhs) noexcept
+	{
+		if constexpr (is_saturating) {
+			if (rhs.value == 0)
+				return lhs.value < 0 ? lowest() : lhs.value > 0 ? max() : fixed_point{};
+		} else {
+			ctpExpects(rhs.value != 0);
+		}
+		return from_raw(fixed_detail::divide<I, FracBits>(lhs.value, rhs.value));
+	}
+
+	// The remainder of truncated division, like std::fmod. rhs must not be zero.
+	[[nodiscard]] friend constexpr fixed_point operator%(const fixed_point lhs, const fixed_point rhs) noexcept
+	{
+		ctpExpects(rhs.value != 0);
+		// Every value is a multiple of epsilon, and lowest() % -epsilon() would overflow, trapping on x86.
+		if (rhs.value == -1)
+			return fixed_point{};
+		return from_raw(static_cast<I>(lhs.value % rhs.value));
+	}
+
+	constexpr fixed_point& operator+=(const fixed_point rhs) noexcept { return *this = *this + rhs; }
+	constexpr fixed_point& operator-=(const fixed_point rhs) noexcept { return *this = *this - rhs; }
+	constexpr fixed_point& operator*=(const fixed_point rhs) noexcept { return *this = *this * rhs; }
+	constexpr fixed_point& operator/=(const fixed_point rhs) noexcept { return *this = *this / rhs; }
+	constexpr fixed_point& operator%=(const fixed_point rhs) noexcept { return *this = *this % rhs; }
+
+	// By one, not by epsilon.
+	constexpr fixed_point& operator++() noexcept { return *this += one(); }
+	constexpr fixed_point operator++(int) noexcept
+	{
+		const fixed_point temp = *this;
+		*this += one();
+		return temp;
+	}
+	constexpr fixed_point& operator--() noexcept { return *this -= one(); }
+	constexpr fixed_point operator--(int) noexcept
+	{
+		const fixed_point temp = *this;
+		*this -= one();
+		return temp;
+	}
+
+private:
+	static constexpr I Scale = I{1} << FracBits;
+
+	template <std::integral J>
+	static constexpr I from_integer(const J integer) noexcept
+	{
+		using U = std::make_unsigned_t<I>;
+		if constexpr (is_saturating) {
+			if (std::cmp_greater(integer, std::numeric_limits<I>::max() >> FracBits))
+				return std::numeric_limits<I>::max();
+			if (std::cmp_less(integer, std::numeric_limits<I>::lowest() >> FracBits))
+				return std::numeric_limits<I>::lowest();
+		}
+		return static_cast<I>(static_cast<U>(static_cast<U>(integer) << FracBits));
+	}
+
+	template <std::floating_point F>
+	static constexpr I from_floating(const F number) noexcept
+	{
+		// Exact bounds, since powers of two.
+		constexpr F Max = static_cast<F>(std::uint64_t{1} << (std::numeric_limits<I>::digits - FracBits));
+		if (!(number == number))
+			return I{0};
+		if (number >= Max)
+			return std::numeric_limits<I>::max();
+		if (number <= -Max)
+			return std::numeric_limits<I>::lowest();
+		const F scaled = number * static_cast<F>(Scale);
+		const F rounded = scaled < 0 ? scaled - F{0.5} : scaled + F{0.5};
+		// Rounding can only carry past the top for I too big for F to represent its max, so check again.
+		if (rounded >= static_cast<F>(std::numeric_limits<I>::max()))
+			return std::numeric_limits<I>::max();
+		return static_cast<I>(rounded);
+	}
+};
+
+// Approximately 1 / x, to within an epsilon or two, without dividing. Saturates if the result doesn't fit. x must
+// not be zero, unless saturating, where it gives the largest value.
+template <typename I, int FracBits, typename Overflow>
+[[nodiscard]] constexpr fixed_point<I, FracBits, Overflow> fast_reciprocal(const fixed_point<I, FracBits, Overflow> x) noexcept
+{
+	using Fixed = fixed_point<I, FracBits, Overflow>;
+	if constexpr (!Fixed::is_saturating)
+		ctpExpects(x.raw() != 0);
+	if (x.raw() == 0)
+		return Fixed::max();
+
+	using U = fixed_detail::approximation_word<I>;
+	constexpr int Bits = std::numeric_limits<U>::digits;
+	const bool negative = x.raw() < 0;
+	const auto magnitude = static_cast<U>(negative ? U{0} - static_cast<U>(x.raw()) : static_cast<U>(x.raw()));
+	const int shift = std::countl_zero(magnitude);
+	// Enough iterations for all the bits of the result.
+	constexpr int Iterations = Bits == 32 ? 2 : 3;
+	const U y = fixed_detail::reciprocal_normalized(static_cast<U>(magnitude << shift), Iterations);
+
+	// x = m 2^(Bits - shift - FracBits), so 1 / x = y 2^(shift + FracBits - Bits - (Bits - 2)).
+	const int resultShift = 2 * Bits - 2 - shift - 2 * FracBits;
+	const U limit = static_cast<U>(static_cast<U>(std::numeric_limits<I>::max()) + (negative ? 1 : 0));
+	if (resultShift < 0)
+		return negative ? Fixed::lowest() : Fixed::max();
+	const U result = fixed_detail::shift_round(y, resultShift);
+	if (result > limit)
+		return negative ? Fixed::lowest() : Fixed::max();
+	return Fixed::from_raw(static_cast<I>(negative ? U{0} - result : result));
+}
+
+// Approximately the square root of x, to within an epsilon or two, without dividing. x must not be negative, unless
+// saturating, where it gives zero.
+template <typename I, int FracBits, typename Overflow>
+[[nodiscard]] constexpr fixed_point<I, FracBits, Overflow> fast_sqrt(const fixed_point<I, FracBits, Overflow> x) noexcept
+{
+	using Fixed = fixed_point<I, FracBits, Overflow>;
+	if constexpr (!Fixed::is_saturating)
+		ctpExpects(x.raw() >= 0);
+	if (x.raw() <= 0)
+		return Fixed{};
+
+	using U = fixed_detail::approximation_word<I>;
+	constexpr int Bits = std::numeric_limits<U>::digits;
+	const auto magnitude = static_cast<U>(x.raw());
+	// Normalize so that the exponent is even, which leaves m in [0.25, 1). The top bit is never set, so there's room.
+	int shift = std::countl_zero(magnitude);
+	shift -= (shift + FracBits) & 1;
+	constexpr int Iterations = Bits == 32 ? 2 : 3;
+	const U root = fixed_detail::sqrt_normalized(static_cast<U>(magnitude << shift), Iterations);
+
+	// x = m 2^(Bits - shift - FracBits), so sqrt(x) = sqrt(m) 2^((Bits - shift - FracBits) / 2).
+	const int exponent = (Bits - shift + FracBits) / 2;
+	return Fixed::from_raw(static_cast<I>(fixed_detail::shift_round(root, Bits - 3 - exponent)));
+}
+
+// Batch operations over spans of fixed_point, which work on the raw integers so they vectorize where the platform
+// can. The StrongType span operations work too, wrapping like overflow_wrapping, and these overloads of them keep
+// saturating types saturating.
+
+// out[i] = lhs[i] * rhs[i]. All the spans must be the same size, and out may be one of the inputs.
+template <typename S>
+	requires IsFixedPoint<S>
+constexpr void multiply_values(std::type_identity_t<std::span<const S>> lhs, std::type_identity_t<std::span<const S>> rhs, const std::span<S> out) noexcept
+{
+	using I = typename S::value_type;
+	detail::transform_strong(lhs, rhs, out, [](const I l, const I r) { return fixed_detail::multiply<I, S::frac_bits, S::is_saturating>(l, r); });
+}
+
+// out[i] = lhs[i] / rhs[i]. All the spans must be the same size, and out may be one of the inputs. Nothing in rhs
+// may be zero. Division doesn't vectorize, but it saves the checks for zero.
+template <typename S>
+	requires IsFixedPoint<S>
+constexpr void divide_values(std::type_identity_t<std::span<const S>> lhs, std::type_identity_t<std::span<const S>> rhs, const std::span<S> out) noexcept
+{
+	using I = typename S::value_type;
+	detail::transform_strong(lhs, rhs, out, [](const I l, const I r) { return fixed_detail::divide<I, S::frac_bits>(l, r); });
+}
+
+template <typename S>
+concept SaturatingFixedPoint = IsFixedPoint<S> && std::remove_const_t<S>::is_saturating;
+
+// Saturating overloads of the StrongType span operations.
+
+// Saturates the total, not each partial sum.
+template <typename S, std::size_t Extent>
+	requires detail::SummableStrongType<std::remove_const_t<S>> && SaturatingFixedPoint<S>
+[[nodiscard]] constexpr std::remove_const_t<S> sum_values(const std::span<S, Extent> fixed) noexcept
+{
+	using Fixed = std::remove_const_t<S>;
+	using I = typename Fixed::value_type;
+	const std::span<const Fixed> items{fixed};
+	if constexpr (sizeof(I) <= 4) {
+		// Can't overflow 64 bits.
+		std::int64_t total;
+		if CTP_IS_CONSTEVAL {
+			total = detail::reduce_lanes(items, std::int64_t{0}, [](const std::int64_t lhs, const std::int64_t rhs) { return lhs + rhs; });
+		} else {
+			total = detail::reduce_lanes(as_values(items), std::int64_t{0}, [](const std::int64_t lhs, const std::int64_t rhs) { return lhs + rhs; });
+		}
+		return Fixed::from_raw(fixed_detail::narrow<I, true>(total));
+	} else {
+		// 128 bits.
+		std::int64_t high = 0;
+		std::uint64_t low = 0;
+		for (const Fixed& item : items) {
+			const std::uint64_t sum = low + static_cast<std::uint64_t>(item.raw());
+			high += (item.raw() < 0 ? -1 : 0) + (sum < low ? 1 : 0);
+			low = sum;
+		}
+		if (high != (static_cast<std::int64_t>(low) >> 63))
+			return high < 0 ? Fixed::lowest() : Fixed::max();
+		return Fixed::from_raw(static_cast<I>(low));
+	}
+}
+
+template <typename S>
+	requires detail::SummableStrongType<S> && SaturatingFixedPoint<S>
+constexpr void add_values(std::type_identity_t<std::span<const S>> lhs, std::type_identity_t<std::span<const S>> rhs, const std::span<S> out) noexcept
+{
+	using I = typename S::value_type;
+	detail::transform_strong(lhs, rhs, out, [](const I l, const I r) { return fixed_detail::add<I, true>(l, r); });
+}
+
+template <typename S>
+	requires detail::SummableStrongType<S> && SaturatingFixedPoint<S>
+constexpr void subtract_values(std::type_identity_t<std::span<const S>> lhs, std::type_identity_t<std::span<const S>> rhs, const std::span<S> out) noexcept
+{
+	using I = typename S::value_type;
+	detail::transform_strong(lhs, rhs, out, [](const I l, const I r) { return fixed_detail::subtract<I, true>(l, r); });
+}
+
+// Scales by an integer factor.
+template <typename S>
+	requires detail::MultipliableStrongType<S> && SaturatingFixedPoint<S>
+constexpr void scale_values(std::type_identity_t<std::span<const S>> fixed, const typename S::value_type factor, const std::span<S> out) noexcept
+{
+	using I = typename S::value_type;
+	detail::transform_strong(fixed, fixed, out, [factor](const I value, I) { return fixed_detail::multiply<I, 0, true>(value, factor); });
+}
+
+} // ctp
+
+#endif // INCLUDE_CTP_TOOLS_FIXED_POINT_HPP
@@ -0,0 +1,230 @@
+#ifndef INCLUDE_CTP_TOOLS_FORMAT_HPP
+#define INCLUDE_CTP_TOOLS_FORMAT_HPP
+
+#include "charconv.hpp"
+#include "small_string.hpp"
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace ctp {
+
+// A string literal as a template argument, for format.
+template <std::size_t N>
+struct format_literal {
+	std::array<char, N - 1> chars{};
+
+	consteval format_literal(const char (&str)[N]) noexcept { std::copy_n(str, N - 1, chars.begin()); }
+	[[nodiscard]] constexpr std::string_view view() const noexcept { return {chars.data(), chars.size()}; }
+};
+
+// How format writes an argument of type T: max_size is the most chars any value takes, and write(out, value) writes
+// the value and returns the end. Specialize it to format other types.
+template <class T>
+struct format_arg;
+
+template <std::integral I>
+	requires (!std::is_same_v<I, bool> && !std::is_same_v<I, char>)
+struct format_arg<I> {
+	static constexpr std::size_t max_size = max_char_digits_10_v<I>;
+
+	static constexpr char* write(char* out, const I value) noexcept {
+		if (charconv_detail::is_negative(value))
+			*out++ = '-';
+		const auto absolute = charconv_detail::magnitude(value);
+		return charconv_detail::write_digits_exact(out, absolute, charconv_detail::count_digits(absolute));
+	}
+};
+
+template <IsCharconvFloat F>
+struct format_arg<F> {
+	static constexpr std::size_t max_size = max_chars_shortest_v<F>;
+
+	static constexpr char* write(char* out, const F value) noexcept {
+		return charconv_detail::shortest_to_chars(out, out + max_size, value);
+	}
+};
+
+template <>
+struct format_arg<bool> {
+	static constexpr std::size_t max_size = 5;
+
+	static constexpr char* write(char* out, const bool value) noexcept {
+		const std::string_view str = value ? "true" : "false";
+		return std::copy(str.begin(), str.end(), out);
+	}
+};
+
+template <>
+struct format_arg<char> {
+	static constexpr std::size_t max_size = 1;
+
+	static constexpr char* write(char* out, const char value) noexcept {
+		*out++ = value;
+		return out;
+	}
+};
+
+// Strings that can't be larger than their local storage, like fixed_string.
+template <std::size_t NumChars, bool IsNullTerminated, class Traits, class Alloc, class Options>
+	requires (!Options::has_large_mode)
+struct format_arg<basic_small_string<char, NumChars, IsNullTerminated, Traits, Alloc, Options>> {
+	static constexpr std::size_t max_size = NumChars;
+
+	static constexpr char* write(char* out, const basic_small_string<char, NumChars, IsNullTerminated, Traits, Alloc, Options>& value) noexcept {
+		return std::copy(value.begin(), value.end(), out);
+	}
+};
+
+// String literals and char arrays, up to the first null.
+template <std::size_t N>
+struct format_arg<char[N]> {
+	static constexpr std::size_t max_size = N - 1;
+
+	static constexpr char* write(char* out, const char (&value)[N]) noexcept {
+		return std::copy(value, std::find(value, value + max_size, '\0'), out);
+	}
+};
+
+namespace format_detail {
+
+// Whether every { and } is either an escaped {{ or }}, or an argument {}.
+consteval bool is_valid(const std::string_view format) {
+	for (std::size_t i = 0; i < format.size(); ++i) {
+		if (format[i] == '{') {
+			if (i + 1 >= format.size() || (format[i + 1] != '{' && format[i + 1] != '}'))
+				return false;
+			++i;
+		} else if (format[i] == '}') {
+			if (i + 1 >= format.size() || format[i + 1] != '}')
+				return false;
+			++i;
+		}
+	}
+	return true;
+}
+
+// The number of {} in a valid format.
+consteval std::size_t count_args(const std::string_view format) {
+	std::size_t count = 0;
+	for (std::size_t i = 0; i + 1 < format.size(); ++i) {
+		if (format[i] == '{' || format[i] == '}') {
+			count += format[i] == '{' && format[i + 1] == '}' ? 1 : 0;
+			++i;
+		}
+	}
+	return count;
+}
+
+// The chars of a valid format that aren't arguments, with escapes resolved.
+consteval std::size_t count_text(const std::string_view format) {
+	std::size_t size = 0;
+	for (std::size_t i = 0; i < format.size(); ++i) {
+		if (format[i] == '{' || format[i] == '}') {
+			// {{ and }} are a brace, and {} is an argument.
+			size += format[i] == '}' || format[i + 1] != '}' ? 1 : 0;
+			++i;
+		} else {
+			++size;
+		}
+	}
+	return size;
+}
+
+struct piece {
+	std::size_t offset = 0;
+	std::size_t size = 0;
+};
+
+// The text between the arguments of a format, parsed once per format.
+template <format_literal Format>
+struct parsed {
+	static constexpr std::string_view View = Format.view();
+	static_assert(is_valid(View), "Invalid format: use {} for an argument, and {{ and }} for braces.");
+
+	static constexpr std::size_t ArgCount = count_args(View);
+	static constexpr std::size_t TextSize = count_text(View);
+
+	struct layout {
+		std::array<char, TextSize> text{};
+		// Before each argument, and after the last.
+		std::array<piece, ArgCount + 1> pieces{};
+	};
+
+	static constexpr layout Layout = [] {
+		layout result;
+		std::size_t size = 0;
+		std::size_t arg = 0;
+		result.pieces[0].offset = 0;
+		for (std::size_t i = 0; i < View.size(); ++i) {
+			if (View[i] == '{' && View[i + 1] == '}') {
+				result.pieces[arg].size = size - result.pieces[arg].offset;
+				result.pieces[++arg].offset = size;
+			} else {
+				result.text[size++] = View[i];
+			}
+			if (View[i] == '{' || View[i] == '}')
+				++i;
+		}
+		result.pieces[arg].size = size - result.pieces[arg].offset;
+		return result;
+	}();
+};
+
+template <class T>
+using arg_t = format_arg<std::remove_cvref_t<T>>;
+
+template <class T>
+concept IsFormattable = requires { arg_t<T>::max_size; };
+
+template <class Parsed, std::size_t I>
+constexpr char* write_piece(char* out) noexcept {
+	constexpr piece Piece = Parsed::Layout.pieces[I];
+	return std::copy_n(Parsed::Layout.text.data() + Piece.offset, Piece.size, out);
+}
+
+template <class Parsed, std::size_t... Is, class... Args>
+constexpr char* write_all(char* out, std::index_sequence<Is...>, const Args&... args) noexcept {
+	((out = write_piece<Parsed, Is>(out), out = arg_t<Args>::write(out, args)), ...);
+	return write_piece<Parsed, sizeof...(Args)>(out);
+}
+
+} // format_detail
+
+// The most chars format<Format> writes for the argument types.
+template <format_literal Format, format_detail::IsFormattable... Args>
+inline constexpr std::size_t max_format_size_v = format_detail::parsed<Format>::TextSize + (std::size_t{0} + ... + format_detail::arg_t<Args>::max_size);
+
+// Formats the arguments into a fixed_string big enough for any values of their types, like format("{} of {}", 1, 2),
+// but without allocating. The format is parsed at compile time, and only supports {} and escaped braces. Arguments
+// are written like std::to_chars, and there's a format_arg for numbers, chars, bools, fixed_string and char arrays.
+// Constant arguments give a constant string.
+template <format_literal Format, format_detail::IsFormattable... Args>
+[[nodiscard]] constexpr auto format(const Args&... args) noexcept {
+	using parsed = format_detail::parsed<Format>;
+	static_assert(parsed::ArgCount == sizeof...(Args), "The number of {} in the format doesn't match the arguments.");
+
+	constexpr std::size_t MaxSize = max_format_size_v<Format, Args...>;
+	fixed_string<MaxSize> result;
+	result.resize(MaxSize);
+	char* const first = result.data();
+	char* const last = format_detail::write_all<parsed>(first, std::index_sequence_for<Args...>{}, args...);
+	result.resize(static_cast<std::size_t>(last - first));
+	return result;
+}
+
+// Like format, with constant arguments, in a fixed_string just big enough for the result.
+template <format_literal Format, auto... args>
+[[nodiscard]] consteval auto format_constant() {
+	constexpr auto full = format<Format>(args...);
+	return fixed_string<full.size()>{full.data(), full.size()};
+}
+
+} // ctp
+
+#endif // INCLUDE_CTP_TOOLS_FORMAT_HPP
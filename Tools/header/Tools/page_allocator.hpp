@@ -0,0 +1,179 @@
+#ifndef INCLUDE_CTP_TOOLS_PAGE_ALLOCATOR_HPP
+#define INCLUDE_CTP_TOOLS_PAGE_ALLOCATOR_HPP
+
+#include "config.hpp"
+
+#include <cstddef>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+// Allocators that take whole pages from the OS, for large arrays that are accessed randomly.
+// Compose them with trivial_init_allocator so that containers don't touch the pages until they're used:
+//   small_vector<T, N, trivial_init_allocator<T, huge_page_allocator<T>>>
+// Allocations too small to benefit come from the heap instead. Both work in constant evaluation, with std::allocator.
+
+namespace ctp {
+
+// The OS's page sizes in bytes. huge_page_size is the same as page_size if it has no huge pages.
+[[nodiscard]] std::size_t page_size() noexcept;
+[[nodiscard]] std::size_t huge_page_size() noexcept;
+
+// The number of NUMA nodes, which is 1 without NUMA, and the node the calling thread is running on.
+[[nodiscard]] int numa_node_count() noexcept;
+[[nodiscard]] int current_numa_node() noexcept;
+
+#ifdef __cpp_lib_allocate_at_least
+template <typename T>
+using page_allocation_result = std::allocation_result<T*>;
+#else
+template <typename T>
+struct page_allocation_result {
+	T* ptr;
+	std::size_t count;
+};
+#endif
+
+namespace page_detail {
+
+// Let a NUMA allocation go wherever it's first written.
+inline constexpr int FirstTouch = -1;
+
+// Maps bytes, a multiple of the page size, or of the huge page size if huge, of zeroed memory. Uses huge pages if
+// it can, otherwise transparent huge pages, otherwise normal ones. Puts it on node, unless FirstTouch. Null if the
+// OS is out of memory.
+[[nodiscard]] void* map_pages(std::size_t bytes, bool huge, int node) noexcept;
+void unmap_pages(void* ptr, std::size_t bytes) noexcept;
+
+[[noreturn]] inline void allocation_failed() {
+#if CTP_USE_EXCEPTIONS
+	throw std::bad_alloc();
+#else
+	std::terminate();
+#endif
+}
+
+// Allocates n items in whole pages, or from the heap if that's less than one page.
+template <typename T>
+[[nodiscard]] constexpr page_allocation_result<T> allocate_pages(const std::size_t n, const bool huge, const int node) CTP_NOEXCEPT(false) {
+	if CTP_IS_CONSTEVAL {
+		return {std::allocator<T>{}.allocate(n), n};
+	} else {
+		const std::size_t granularity = huge ? huge_page_size() : page_size();
+		if (n > (std::numeric_limits<std::size_t>::max() - granularity) / sizeof(T))
+			allocation_failed();
+		const std::size_t bytes = n * sizeof(T);
+		if (bytes < granularity)
+			return {std::allocator<T>{}.allocate(n), n};
+
+		const std::size_t mapped = (bytes + granularity - 1) / granularity * granularity;
+		void* const ptr = map_pages(mapped, huge, node);
+		if (!ptr)
+			allocation_failed();
+		return {static_cast<T*>(ptr), mapped / sizeof(T)};
+	}
+}
+
+// n is either what was allocated, or what allocate_pages returned as its count.
+template <typename T>
+constexpr void deallocate_pages(T* const ptr, const std::size_t n, const bool huge) noexcept {
+	if CTP_IS_CONSTEVAL {
+		std::allocator<T>{}.deallocate(ptr, n);
+	} else {
+		const std::size_t granularity = huge ? huge_page_size() : page_size();
+		const std::size_t bytes = n * sizeof(T);
+		if (bytes < granularity)
+			std::allocator<T>{}.deallocate(ptr, n);
+		else
+			unmap_pages(ptr, (bytes + granularity - 1) / granularity * granularity);
+	}
+}
+
+} // page_detail
+
+// Allocates in huge pages, to save on TLB misses when accessing large arrays randomly. Uses explicitly reserved
+// huge pages where there are some, then transparent huge pages, then falls back to normal pages. Allocations less
+// than a huge page come from the heap.
+template <typename T>
+class huge_page_allocator {
+public:
+	using value_type = T;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+	using propagate_on_container_move_assignment = std::true_type;
+	using is_always_equal = std::true_type;
+
+	constexpr huge_page_allocator() noexcept = default;
+	template <typename U>
+	constexpr huge_page_allocator(const huge_page_allocator<U>&) noexcept {}
+
+	[[nodiscard]] constexpr T* allocate(const std::size_t n) CTP_NOEXCEPT(false) {
+		return page_detail::allocate_pages<T>(n, true, page_detail::FirstTouch).ptr;
+	}
+
+	// Rounds up to whole huge pages, so containers can use the rest.
+	[[nodiscard]] constexpr page_allocation_result<T> allocate_at_least(const std::size_t n) CTP_NOEXCEPT(false) {
+		return page_detail::allocate_pages<T>(n, true, page_detail::FirstTouch);
+	}
+
+	constexpr void deallocate(T* const ptr, const std::size_t n) noexcept {
+		page_detail::deallocate_pages(ptr, n, true);
+	}
+
+	template <typename U>
+	friend constexpr bool operator==(const huge_page_allocator&, const huge_page_allocator<U>&) noexcept { return true; }
+};
+
+// Allocates pages on a NUMA node, so that the threads running there access them locally. By default, pages go
+// wherever they're first written, which with trivial_init_allocator is the thread that first uses them rather than
+// the one that allocated them. Allocations less than a page come from the heap.
+template <typename T>
+class numa_local_allocator {
+public:
+	using value_type = T;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+	using propagate_on_container_copy_assignment = std::true_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+	using is_always_equal = std::false_type;
+
+	constexpr numa_local_allocator() noexcept = default;
+	// Prefers node, while it has memory free.
+	explicit constexpr numa_local_allocator(const int node) noexcept : node_{node} {}
+	template <typename U>
+	constexpr numa_local_allocator(const numa_local_allocator<U>& other) noexcept : node_{other.node()} {}
+
+	// Prefers the node the calling thread is running on now.
+	[[nodiscard]] static numa_local_allocator current() noexcept { return numa_local_allocator{current_numa_node()}; }
+
+	// The preferred node, or -1 for wherever it's first written.
+	[[nodiscard]] constexpr int node() const noexcept { return node_; }
+
+	[[nodiscard]] constexpr T* allocate(const std::size_t n) CTP_NOEXCEPT(false) {
+		return page_detail::allocate_pages<T>(n, false, node_).ptr;
+	}
+
+	// Rounds up to whole pages, so containers can use the rest.
+	[[nodiscard]] constexpr page_allocation_result<T> allocate_at_least(const std::size_t n) CTP_NOEXCEPT(false) {
+		return page_detail::allocate_pages<T>(n, false, node_);
+	}
+
+	constexpr void deallocate(T* const ptr, const std::size_t n) noexcept {
+		page_detail::deallocate_pages(ptr, n, false);
+	}
+
+	template <typename U>
+	friend constexpr bool operator==(const numa_local_allocator& lhs, const numa_local_allocator<U>& rhs) noexcept {
+		return lhs.node_ == rhs.node();
+	}
+
+private:
+	int node_ = page_detail::FirstTouch;
+};
+
+} // ctp
+
+#endif // INCLUDE_CTP_TOOLS_PAGE_ALLOCATOR_HPP
@@ -0,0 +1,95 @@
+#ifndef INCLUDE_CTP_TOOLS_PERF_COUNTERS_HPP
+#define INCLUDE_CTP_TOOLS_PERF_COUNTERS_HPP
+
+#include "config.hpp"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace ctp {
+
+// Hardware events counted by perf_counters.
+enum class perf_event : std::uint8_t {
+	cycles,
+	instructions,
+	branch_misses,
+	l1d_misses,
+	llc_misses,
+	dtlb_misses,
+};
+
+inline constexpr std::size_t PerfEventCount = 6;
+
+inline constexpr std::array<perf_event, PerfEventCount> AllPerfEvents{
+	perf_event::cycles,
+	perf_event::instructions,
+	perf_event::branch_misses,
+	perf_event::l1d_misses,
+	perf_event::llc_misses,
+	perf_event::dtlb_misses,
+};
+
+// What perf_counters opens unless told otherwise. Few enough to be scheduled as one group on common CPUs,
+// where only about four events can be counted at once besides cycles and instructions.
+inline constexpr std::array DefaultPerfEvents{
+	perf_event::cycles,
+	perf_event::instructions,
+	perf_event::branch_misses,
+	perf_event::l1d_misses,
+	perf_event::llc_misses,
+};
+
+// Name of an event, as used for benchmark counters.
+constexpr std::string_view name(perf_event event) noexcept {
+	switch (event) {
+	case perf_event::cycles: return "cycles";
+	case perf_event::instructions: return "instructions";
+	case perf_event::branch_misses: return "branch_misses";
+	case perf_event::l1d_misses: return "l1d_misses";
+	case perf_event::llc_misses: return "llc_misses";
+	case perf_event::dtlb_misses: return "dtlb_misses";
+	}
+	return {};
+}
+
+// Counts hardware events on the calling thread, in user space, between start and stop.
+// Uses perf_event_open on Linux. Events that can't be opened, such as in containers or VMs without
+// access to the PMU, or on other platforms, are just not counted.
+class perf_counters {
+public:
+	explicit perf_counters(std::span<const perf_event> events = DefaultPerfEvents) noexcept;
+	~perf_counters();
+
+	perf_counters(const perf_counters&) = delete;
+	perf_counters& operator=(const perf_counters&) = delete;
+
+	// If any event is counted.
+	bool available() const noexcept { return leader_ != -1; }
+	bool counts(perf_event event) const noexcept { return fds_[static_cast<std::size_t>(event)] != -1; }
+
+	// Zero the counts, and start counting.
+	void start() noexcept;
+	// Stop counting, and read the counts.
+	void stop() noexcept;
+
+	// The count between the last start and stop, scaled up if the kernel had to multiplex counters.
+	// Empty if the event isn't counted, or the counters couldn't be read or were never scheduled.
+	std::optional<std::uint64_t> value(perf_event event) const noexcept;
+
+private:
+	std::array<int, PerfEventCount> fds_;
+	// Position of each event in a group read.
+	std::array<std::uint8_t, PerfEventCount> slots_{};
+	std::array<std::uint64_t, PerfEventCount> values_{};
+	int leader_ = -1;
+	std::uint8_t opened_ = 0;
+	// If values_ holds counts from the last stop.
+	bool read_ = false;
+};
+
+} // ctp
+
+#endif // INCLUDE_CTP_TOOLS_PERF_COUNTERS_HPP
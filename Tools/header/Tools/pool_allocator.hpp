@@ -0,0 +1,189 @@
+#ifndef INCLUDE_CTP_TOOLS_POOL_ALLOCATOR_HPP
+#define INCLUDE_CTP_TOOLS_POOL_ALLOCATOR_HPP
+
+#include "config.hpp"
+#include "small_storage.hpp"
+#include "warnings.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+// An allocator for the many small, short-lived allocations of containers that spill out of local storage.
+// Each thread keeps free lists of a few size classes, spaced like the default small_storage growth policy, so
+// a small_vector growing from its allocate_at_least capacity steps from one class to the next. Frees on the
+// allocating thread are a push onto its list; frees on other threads are returned to it in batches.
+//   small_vector<T, N, trivial_init_allocator<T, pool_allocator<T>>>
+// Memory freed to the pools stays there for reuse, it isn't returned to the OS. Larger allocations and
+// over-aligned types go to the heap. Works in constant evaluation, with std::allocator.
+
+namespace ctp {
+
+#ifdef __cpp_lib_allocate_at_least
+template <typename T>
+using pool_allocation_result = std::allocation_result<T*>;
+#else
+template <typename T>
+struct pool_allocation_result {
+	T* ptr;
+	std::size_t count;
+};
+#endif
+
+namespace pool_detail {
+
+// Every size class is a multiple of this, and so aligned to it.
+inline constexpr std::size_t Granularity = 16;
+// Larger allocations go to the heap.
+inline constexpr std::size_t MaxPooledBytes = 8 * 1024;
+// Blocks are cut from slabs of this size, aligned to it, so a block can find its slab's header.
+inline constexpr std::size_t SlabBytes = 64 * 1024;
+
+struct size_class_table {
+	std::size_t count = 0;
+	std::size_t bytes[32]{};
+	// The class for each number of granules.
+	std::uint8_t classOfGranules[MaxPooledBytes / Granularity + 1]{};
+};
+
+// Each class is what the default growth policy grows the last to, rounded up to the granularity.
+consteval size_class_table make_size_classes() {
+	using growth_policy = small_storage::default_options::growth_policy;
+	size_class_table table;
+	std::size_t bytes = Granularity;
+	for (;;) {
+		table.bytes[table.count++] = bytes;
+		if (bytes == MaxPooledBytes)
+			break;
+		const std::size_t grown = growth_policy::apply(bytes, bytes + Granularity, MaxPooledBytes);
+		bytes = (grown + Granularity - 1) / Granularity * Granularity;
+	}
+	std::size_t sizeClass = 0;
+	for (std::size_t granules = 0; granules <= MaxPooledBytes / Granularity; ++granules) {
+		if (granules * Granularity > table.bytes[sizeClass])
+			++sizeClass;
+		table.classOfGranules[granules] = static_cast<std::uint8_t>(sizeClass);
+	}
+	return table;
+}
+
+inline constexpr size_class_table SizeClasses = make_size_classes();
+inline constexpr std::size_t SizeClassCount = SizeClasses.count;
+
+[[nodiscard]] constexpr std::size_t size_class_of(const std::size_t bytes) noexcept {
+	return SizeClasses.classOfGranules[(bytes + Granularity - 1) / Granularity];
+}
+
+struct free_block {
+	free_block* next;
+};
+
+struct thread_pool;
+
+// At the start of every slab, and never changed once it's cut. Padded to a cache line, which the blocks start after.
+CTP_WARNING_PUSH
+CTP_WARNING_ALIGNMENT_PADDING
+struct alignas(64) slab_header {
+	thread_pool* owner;
+	std::size_t sizeClass;
+	slab_header* next;
+};
+CTP_WARNING_POP
+
+// Blocks freed back to this thread, ready to reuse. The rest of the pool is in pool_allocator.cpp.
+struct thread_pool {
+	free_block* free[SizeClassCount]{};
+};
+
+// Null until the thread's first allocation or remote free.
+inline thread_local constinit thread_pool* LocalPool = nullptr;
+
+// Takes a block of sizeClass, from other threads' frees or a new slab, making the calling thread's pool if needed.
+[[nodiscard]] void* refill(std::size_t sizeClass) CTP_NOEXCEPT(false);
+// Returns a block to the pool that allocated it, batched with other blocks for the same pool.
+void free_remote(void* ptr) noexcept;
+
+[[nodiscard]] inline slab_header* slab_of(void* const ptr) noexcept {
+	return reinterpret_cast<slab_header*>(reinterpret_cast<std::uintptr_t>(ptr) & ~(SlabBytes - 1));
+}
+
+[[nodiscard]] inline void* allocate_block(const std::size_t sizeClass) CTP_NOEXCEPT(false) {
+	if (thread_pool* const pool = LocalPool) {
+		if (free_block* const block = pool->free[sizeClass]) {
+			pool->free[sizeClass] = block->next;
+			return block;
+		}
+	}
+	return refill(sizeClass);
+}
+
+inline void deallocate_block(void* const ptr) noexcept {
+	thread_pool* const pool = LocalPool;
+	const slab_header* const slab = slab_of(ptr);
+	if (slab->owner != pool) {
+		free_remote(ptr);
+		return;
+	}
+	auto* const block = static_cast<free_block*>(ptr);
+	block->next = pool->free[slab->sizeClass];
+	pool->free[slab->sizeClass] = block;
+}
+
+} // pool_detail
+
+// Allocates from the calling thread's pool, in size classes matched to how small_storage containers grow.
+// Can be freed on any thread.
+template <typename T>
+class pool_allocator {
+public:
+	using value_type = T;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+	using propagate_on_container_move_assignment = std::true_type;
+	using is_always_equal = std::true_type;
+
+	constexpr pool_allocator() noexcept = default;
+	template <typename U>
+	constexpr pool_allocator(const pool_allocator<U>&) noexcept {}
+
+	[[nodiscard]] constexpr T* allocate(const std::size_t n) CTP_NOEXCEPT(false) {
+		return allocate_at_least(n).ptr;
+	}
+
+	// Rounds up to the size class, so containers can use the rest.
+	[[nodiscard]] constexpr pool_allocation_result<T> allocate_at_least(const std::size_t n) CTP_NOEXCEPT(false) {
+		if CTP_IS_CONSTEVAL {
+			return {std::allocator<T>{}.allocate(n), n};
+		} else {
+			if (!is_pooled(n))
+				return {std::allocator<T>{}.allocate(n), n};
+			const std::size_t sizeClass = pool_detail::size_class_of(n * sizeof(T));
+			return {static_cast<T*>(pool_detail::allocate_block(sizeClass)), pool_detail::SizeClasses.bytes[sizeClass] / sizeof(T)};
+		}
+	}
+
+	// n is either what was allocated, or what allocate_at_least returned as its count.
+	constexpr void deallocate(T* const ptr, const std::size_t n) noexcept {
+		if CTP_IS_CONSTEVAL {
+			std::allocator<T>{}.deallocate(ptr, n);
+		} else {
+			if (is_pooled(n))
+				pool_detail::deallocate_block(ptr);
+			else
+				std::allocator<T>{}.deallocate(ptr, n);
+		}
+	}
+
+	template <typename U>
+	friend constexpr bool operator==(const pool_allocator&, const pool_allocator<U>&) noexcept { return true; }
+
+private:
+	[[nodiscard]] static constexpr bool is_pooled(const std::size_t n) noexcept {
+		return alignof(T) <= pool_detail::Granularity && n <= pool_detail::MaxPooledBytes / sizeof(T);
+	}
+};
+
+} // ctp
+
+#endif // INCLUDE_CTP_TOOLS_POOL_ALLOCATOR_HPP
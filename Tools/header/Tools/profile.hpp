@@ -0,0 +1,99 @@
+#ifndef INCLUDE_CTP_TOOLS_PROFILE_HPP
+#define INCLUDE_CTP_TOOLS_PROFILE_HPP
+
+#include "clock.hpp"
+#include "config.hpp"
+#include "scope.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+// Scoped profiling zones. A zone stamps cpu_ticks on entry and exit, and appends the pair to a buffer
+// owned by the calling thread, so recording takes no locks. Export as Chrome trace JSON, which
+// chrome://tracing and Perfetto can open.
+//
+//   void update() {
+//       CTP_PROFILE_ZONE("update");
+//       ...
+//   }
+//
+// Zones are compiled in when CTP_PROFILING is set to 1. Recorded zones are kept until clear is called. A thread that
+// exits leaves its buffer to the next new thread, once its zones have been exported or cleared.
+
+namespace ctp::profile {
+
+struct event {
+	// Must outlive the export, normally a string literal.
+	const char* name;
+	std::uint64_t begin;
+	std::uint64_t end;
+};
+
+// Write everything recorded so far as Chrome trace JSON. Safe while other threads record zones.
+void write_chrome_trace(std::ostream& out);
+// Write everything recorded so far to a Chrome trace JSON file. Returns false if the file could not be written.
+bool write_chrome_trace(const std::string& path);
+// Drop everything recorded so far. Expects no other thread to be recording zones.
+void clear() noexcept;
+
+namespace detail {
+
+inline constexpr std::uint32_t BlockEvents = 4096;
+
+struct block {
+	// Events written so far. Only the owning thread writes.
+	std::atomic<std::uint32_t> count{0};
+	std::atomic<block*> next{nullptr};
+	event events[BlockEvents]{};
+};
+
+struct thread_buffer {
+	block* tail;
+	block* head;
+};
+
+// Full, so the first zone on a thread goes to next_block to set up its buffer.
+inline constinit block FullBlock{BlockEvents};
+inline constinit thread_buffer NoBuffer{&FullBlock, &FullBlock};
+inline thread_local constinit thread_buffer* LocalBuffer = &NoBuffer;
+
+// A block with room in the calling thread's buffer, appending one, and making or taking over the buffer if needed.
+// Null if out of memory, or the thread is exiting.
+block* next_block() noexcept;
+
+inline void record(const char* name, std::uint64_t begin, std::uint64_t end) noexcept {
+	block* b = LocalBuffer->tail;
+	std::uint32_t n = b->count.load(std::memory_order_relaxed);
+	if (n == BlockEvents) [[unlikely]] {
+		b = next_block();
+		if (!b)
+			return;
+		// A buffer taken over from an exited thread may have events already.
+		n = b->count.load(std::memory_order_relaxed);
+	}
+	b->events[n] = event{name, begin, end};
+	b->count.store(n + 1, std::memory_order_release);
+}
+
+} // detail
+
+// Record a zone from now until the returned object leaves scope.
+[[nodiscard]] inline auto zone(const char* name) noexcept {
+	return ScopeExit{[name, begin = cpu_ticks()]() noexcept { detail::record(name, begin, cpu_ticks()); }};
+}
+
+} // ctp::profile
+
+#if CTP_PROFILING
+#define CTP_PROFILE_ZONE_CAT_IMPL(a, b) a##b
+#define CTP_PROFILE_ZONE_CAT(a, b) CTP_PROFILE_ZONE_CAT_IMPL(a, b)
+// Record a zone from here to the end of the scope.
+#define CTP_PROFILE_ZONE(name) const auto CTP_PROFILE_ZONE_CAT(ctpProfileZone_, __LINE__) = ::ctp::profile::zone(name)
+#else
+// Record a zone from here to the end of the scope.
+#define CTP_PROFILE_ZONE(name) static_cast<void>(0)
+#endif // CTP_PROFILING
+
+#endif // INCLUDE_CTP_TOOLS_PROFILE_HPP
@@ -381,10 +381,16 @@ constexpr auto do_allocate(Allocator& alloc, std::size_t n) CTP_NOEXCEPT_ALLOCS
 	return std::allocator_traits<Allocator>::allocate_at_least(alloc, n);
 #else
 	struct allocation_result {
-		T* ptr;
+		typename std::allocator_traits<Allocator>::pointer ptr;
 		std::size_t count;
 	};
-	return allocation_result{std::allocator_traits<Allocator>::allocate(alloc, n), n};
+	// Use the allocator's own allocate_at_least even if allocator_traits doesn't have it yet.
+	if constexpr (requires { alloc.allocate_at_least(n); }) {
+		const auto [ptr, count] = alloc.allocate_at_least(n);
+		return allocation_result{ptr, count};
+	} else {
+		return allocation_result{std::allocator_traits<Allocator>::allocate(alloc, n), n};
+	}
 #endif
 }
 
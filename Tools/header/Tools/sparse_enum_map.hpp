@@ -0,0 +1,335 @@
+#ifndef INCLUDE_CTP_TOOLS_SPARSE_ENUM_MAP_HPP
+#define INCLUDE_CTP_TOOLS_SPARSE_ENUM_MAP_HPP
+
+#include "config.hpp"
+#include "debug.hpp"
+#include "enum_map.hpp"
+#include "enum_reflection.hpp"
+#include "enum_set.hpp"
+#include "iterator.hpp"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace ctp {
+
+namespace enum_detail {
+
+template <enums::Enum E, typename T, bool IsConst>
+class sparse_enum_map_iterator_t :
+	public iterator_t<
+	sparse_enum_map_iterator_t<E, T, IsConst>,
+	std::pair<E, std::conditional_t<IsConst, const T&, T&>>,
+	std::forward_iterator_tag,
+	std::ptrdiff_t,
+	// peek returns a by-value proxy.
+	std::pair<E, std::conditional_t<IsConst, const T&, T&>>
+	> {
+	using value_pointer = std::conditional_t<IsConst, const T*, T*>;
+
+	typename enum_set<E>::iterator key_;
+	// Values are stored in key order, so they advance together.
+	value_pointer value_ = nullptr;
+
+	friend iterator_accessor;
+	constexpr auto peek() const noexcept {
+		return std::pair<E, std::conditional_t<IsConst, const T&, T&>>{*key_, *value_};
+	}
+	constexpr bool equals(const sparse_enum_map_iterator_t& o) const noexcept { return key_ == o.key_; }
+	constexpr sparse_enum_map_iterator_t& pre_increment() noexcept {
+		++key_;
+		++value_;
+		return *this;
+	}
+
+	// Allow construction of const iterators from nonconst iterators.
+	friend class sparse_enum_map_iterator_t<E, T, true>;
+	using nonconst_t = std::conditional_t<IsConst, sparse_enum_map_iterator_t<E, T, false>, nonesuch>;
+public:
+	template <typename NonConstT = nonconst_t, std::enable_if_t<!std::is_same_v<NonConstT, nonesuch>, int> = 0>
+	constexpr sparse_enum_map_iterator_t(const nonconst_t& other) noexcept
+		: key_{other.key_}
+		, value_{other.value_}
+	{}
+
+	constexpr sparse_enum_map_iterator_t() noexcept = default;
+	constexpr sparse_enum_map_iterator_t(typename enum_set<E>::iterator key, value_pointer value) noexcept
+		: key_{key}
+		, value_{value}
+	{}
+};
+
+} // enum_detail
+
+// sparse_enum_map, a map keyed by an enum that only stores values for keys that are present.
+// Presence is kept in an enum_set, and values are packed densely in key order. A key's position
+// in the packed values is its rank: the number of present keys before it, found with popcount.
+// Suited to large enums where only a few keys have values.
+//
+// Optionally takes a default value, which is given for keys that are not present.
+template <enums::Enum E, typename T, typename Allocator = std::allocator<T>>
+class sparse_enum_map {
+	using this_type = sparse_enum_map<E, T, Allocator>;
+	using word_type = typename enum_set<E>::word_type;
+	static constexpr std::size_t NumWords = enum_set<E>::NumWords;
+	static constexpr std::size_t WordBits = enum_detail::EnumSetWordBits;
+
+	enum_set<E> keys_;
+	// Number of present keys in all words before each word.
+	std::array<enums::detail::index_storage_t<enums::size<E>()>, NumWords> wordRanks_{};
+	std::vector<T, Allocator> values_;
+	std::optional<T> default_;
+
+	// Position in values_ that the key at index i has, or would have if it was present.
+	constexpr std::size_t rank(std::size_t i) const noexcept {
+		const std::size_t word = i / WordBits;
+		const word_type below = (word_type{1} << (i % WordBits)) - 1;
+		return wordRanks_[word] + static_cast<std::size_t>(std::popcount(keys_.words()[word] & below));
+	}
+
+	constexpr void adjust_word_ranks(std::size_t i, int delta) noexcept {
+		for (std::size_t word = i / WordBits + 1; word < NumWords; ++word)
+			wordRanks_[word] = static_cast<enums::detail::index_storage_t<enums::size<E>()>>(wordRanks_[word] + delta);
+	}
+
+	template <typename... Args>
+	constexpr void construct_with_args(Args&&... args) {
+		values_.reserve(sizeof...(Args));
+		(emplace(args.first, std::forward<Args>(args).second), ...);
+	}
+public:
+	using key_type = E;
+	using mapped_type = T;
+	using value_type = std::pair<const key_type, mapped_type&>;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+	using key_compare = std::less<key_type>;
+	using allocator_type = Allocator;
+
+	using iterator = enum_detail::sparse_enum_map_iterator_t<E, T, false>;
+	using const_iterator = enum_detail::sparse_enum_map_iterator_t<E, T, true>;
+
+	template <E e>
+	using arg_type = enum_arg_pair<e, T>;
+
+	// Empty, with no default value.
+	constexpr sparse_enum_map() = default;
+	// Empty, with no default value.
+	constexpr explicit sparse_enum_map(const Allocator& alloc) noexcept : values_(alloc) {}
+
+	// Empty, with a default value for keys that are not present.
+	constexpr sparse_enum_map(const enum_default_arg<T>& defaultArg) : default_{defaultArg.value} {}
+	// Empty, with a default value for keys that are not present.
+	constexpr sparse_enum_map(const Allocator& alloc, const enum_default_arg<T>& defaultArg)
+		: values_(alloc)
+		, default_{defaultArg.value}
+	{}
+
+	// ------------- construct with enum_arg -------------
+
+	// Construct with given enum_arg<E::value>(T). Keys that are not given are not present.
+	// Can verify at compile time that there are no duplicates present.
+	template <enum_detail::EnumArg<this_type>... Args>
+		requires (sizeof...(Args) > 0 && enum_detail::IsPartialArgList<this_type, enums::size<E>(), Args...>)
+	constexpr sparse_enum_map(Args&&... args) {
+		construct_with_args(std::forward<Args>(args)...);
+	}
+
+	// Construct with given enum_arg<E::value>(T). Keys that are not given are not present.
+	// Can verify at compile time that there are no duplicates present.
+	template <enum_detail::EnumArg<this_type>... Args>
+		requires (sizeof...(Args) > 0 && enum_detail::IsPartialArgList<this_type, enums::size<E>(), Args...>)
+	constexpr sparse_enum_map(const Allocator& alloc, Args&&... args) : values_(alloc) {
+		construct_with_args(std::forward<Args>(args)...);
+	}
+
+	// Construct with given enum_arg<E::value>(T), and a default for keys that are not given.
+	// The default is not stored per key: those keys are not present, but read as the default.
+	template <enum_detail::EnumArg<this_type>... Args>
+		requires (sizeof...(Args) > 0 && enum_detail::IsPartialArgList<this_type, enums::size<E>(), Args...>)
+	constexpr sparse_enum_map(const enum_default_arg<T>& defaultArg, Args&&... args) : default_{defaultArg.value} {
+		construct_with_args(std::forward<Args>(args)...);
+	}
+
+	// Construct with given enum_arg<E::value>(T), and a default for keys that are not given.
+	// The default is not stored per key: those keys are not present, but read as the default.
+	template <enum_detail::EnumArg<this_type>... Args>
+		requires (sizeof...(Args) > 0 && enum_detail::IsPartialArgList<this_type, enums::size<E>(), Args...>)
+	constexpr sparse_enum_map(const Allocator& alloc, const enum_default_arg<T>& defaultArg, Args&&... args)
+		: values_(alloc)
+		, default_{defaultArg.value}
+	{
+		construct_with_args(std::forward<Args>(args)...);
+	}
+
+	// ------------- construct with std::pair -------------
+
+	// Constructing with pairs can take variable arguments at run time, but loses the ability to guarantee
+	// correctness at compile time.
+	template <std::same_as<std::pair<E, T>>... Pairs>
+		requires (sizeof...(Pairs) > 0 && sizeof...(Pairs) <= enums::size<E>())
+	constexpr sparse_enum_map(Pairs&&... pairs) {
+		// Sanity check that we weren't given one enum value twice.
+		ctpExpects(enum_detail::unique_pairs_check(pairs...));
+		construct_with_args(std::forward<Pairs>(pairs)...);
+	}
+
+	// Constructing with pairs can take variable arguments at run time, but loses the ability to guarantee
+	// correctness at compile time. Takes an explicit default argument.
+	template <std::same_as<std::pair<E, T>>... Pairs>
+		requires (sizeof...(Pairs) > 0 && sizeof...(Pairs) <= enums::size<E>())
+	constexpr sparse_enum_map(const enum_default_arg<T>& defaultArg, Pairs&&... pairs) : default_{defaultArg.value} {
+		// Sanity check that we weren't given one enum value twice.
+		ctpExpects(enum_detail::unique_pairs_check(pairs...));
+		construct_with_args(std::forward<Pairs>(pairs)...);
+	}
+
+	constexpr allocator_type get_allocator() const noexcept { return values_.get_allocator(); }
+
+	// --------------------- capacity ---------------------
+
+	// Number of present keys.
+	[[nodiscard]] constexpr std::size_t size() const noexcept { return values_.size(); }
+	[[nodiscard]] static constexpr std::size_t max_size() noexcept { return enums::size<E>(); }
+	[[nodiscard]] constexpr bool empty() const noexcept { return values_.empty(); }
+	[[nodiscard]] constexpr bool is_empty() const noexcept { return empty(); }
+
+	constexpr void reserve(std::size_t n) { values_.reserve(n); }
+	constexpr void shrink_to_fit() { values_.shrink_to_fit(); }
+
+	// --------------------- access ---------------------
+
+	// The present keys.
+	[[nodiscard]] constexpr const enum_set<E>& keys() const noexcept { return keys_; }
+	// The present values, in key order.
+	[[nodiscard]] constexpr const std::vector<T, Allocator>& values() const noexcept { return values_; }
+
+	[[nodiscard]] constexpr const std::optional<T>& default_value() const noexcept { return default_; }
+
+	[[nodiscard]] constexpr bool contains(key_type e) const noexcept { return keys_.contains(e); }
+	[[nodiscard]] constexpr std::size_t count(key_type e) const noexcept { return keys_.count(e); }
+
+	// Get a pointer to the value for a key, or nullptr if it is not present.
+	[[nodiscard]] constexpr T* try_get(key_type e) noexcept {
+		return keys_.contains(e) ? &values_[rank(enums::index(e))] : nullptr;
+	}
+	// Get a pointer to the value for a key, or nullptr if it is not present.
+	[[nodiscard]] constexpr const T* try_get(key_type e) const noexcept {
+		return keys_.contains(e) ? &values_[rank(enums::index(e))] : nullptr;
+	}
+
+	// Get the value for a key, or the default value if it is not present.
+	// Expects the key to be present or a default value to have been given.
+	[[nodiscard]] constexpr const T& operator[](key_type e) const noexcept {
+		if (const T* value = try_get(e))
+			return *value;
+		ctpExpects(default_.has_value());
+		return *default_;
+	}
+
+	// Get the value for a key. If it is not present, it is inserted as a copy of the
+	// default value, or value initialized if there is no default.
+	[[nodiscard]] constexpr T& operator[](key_type e) {
+		if (T* value = try_get(e))
+			return *value;
+		if (default_)
+			return emplace(e, *default_).first->second;
+		return emplace(e).first->second;
+	}
+
+	// Get the value for a key, which must be present.
+	[[nodiscard]] constexpr T& at(key_type e) noexcept {
+		ctpExpects(contains(e));
+		return values_[rank(enums::index(e))];
+	}
+	// Get the value for a key, which must be present.
+	[[nodiscard]] constexpr const T& at(key_type e) const noexcept {
+		ctpExpects(contains(e));
+		return values_[rank(enums::index(e))];
+	}
+
+	[[nodiscard]] constexpr iterator find(key_type e) noexcept {
+		if (!contains(e))
+			return end();
+		const std::size_t i = enums::index(e);
+		return {typename enum_set<E>::iterator{keys_.words().data(), i}, values_.data() + rank(i)};
+	}
+	[[nodiscard]] constexpr const_iterator find(key_type e) const noexcept {
+		if (!contains(e))
+			return end();
+		const std::size_t i = enums::index(e);
+		return {typename enum_set<E>::iterator{keys_.words().data(), i}, values_.data() + rank(i)};
+	}
+
+	[[nodiscard]] constexpr iterator begin() noexcept { return {keys_.begin(), values_.data()}; }
+	[[nodiscard]] constexpr const_iterator begin() const noexcept { return {keys_.begin(), values_.data()}; }
+	[[nodiscard]] constexpr const_iterator cbegin() const noexcept { return begin(); }
+	[[nodiscard]] constexpr iterator end() noexcept { return {keys_.end(), values_.data() + values_.size()}; }
+	[[nodiscard]] constexpr const_iterator end() const noexcept { return {keys_.end(), values_.data() + values_.size()}; }
+	[[nodiscard]] constexpr const_iterator cend() const noexcept { return end(); }
+
+	// --------------------- modifiers ---------------------
+
+	// Construct a value for a key if it is not present.
+	// Returns an iterator to the key's value, and whether it was inserted.
+	template <typename... Args>
+	constexpr std::pair<iterator, bool> emplace(key_type e, Args&&... args) {
+		if (contains(e))
+			return {find(e), false};
+		const std::size_t i = enums::index(e);
+		values_.emplace(values_.begin() + static_cast<std::ptrdiff_t>(rank(i)), std::forward<Args>(args)...);
+		keys_.insert(e);
+		adjust_word_ranks(i, 1);
+		return {find(e), true};
+	}
+
+	// Set the value for a key, inserting it if it is not present.
+	template <typename V>
+	constexpr std::pair<iterator, bool> insert_or_assign(key_type e, V&& value) {
+		if (T* existing = try_get(e)) {
+			*existing = std::forward<V>(value);
+			return {find(e), false};
+		}
+		return emplace(e, std::forward<V>(value));
+	}
+
+	// Remove a key. Returns the number of keys removed.
+	constexpr std::size_t erase(key_type e) {
+		if (!contains(e))
+			return 0;
+		const std::size_t i = enums::index(e);
+		values_.erase(values_.begin() + static_cast<std::ptrdiff_t>(rank(i)));
+		keys_.erase(e);
+		adjust_word_ranks(i, -1);
+		return 1;
+	}
+
+	// Remove all keys. Keeps the default value.
+	constexpr void clear() noexcept {
+		keys_.clear();
+		wordRanks_.fill(0);
+		values_.clear();
+	}
+
+	constexpr void swap(sparse_enum_map& o) noexcept {
+		std::swap(keys_, o.keys_);
+		std::swap(wordRanks_, o.wordRanks_);
+		values_.swap(o.values_);
+		default_.swap(o.default_);
+	}
+
+	// Equal if the same keys are present with the same values. Default values are not compared.
+	[[nodiscard]] friend constexpr bool operator==(const sparse_enum_map& lhs, const sparse_enum_map& rhs)
+		noexcept(noexcept(std::declval<const T&>() == std::declval<const T&>())) {
+		return lhs.keys_ == rhs.keys_ && lhs.values_ == rhs.values_;
+	}
+};
+
+} // ctp
+
+#endif // INCLUDE_CTP_TOOLS_SPARSE_ENUM_MAP_HPP
@@ -0,0 +1,114 @@
+#ifndef INCLUDE_CTP_TOOLS_STACK_ALLOCATOR_HPP
+#define INCLUDE_CTP_TOOLS_STACK_ALLOCATOR_HPP
+
+#include "config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+// A buffer on the caller's stack, for scratch containers in hot functions to spill into before the heap.
+// With small_vector or small_string that gives three tiers: local storage, then the arena, then the heap.
+//
+//   stack_arena<1024> arena;
+//   small_vector<int, 8, trivial_init_allocator<int, stack_allocator<int, stack_arena<1024>>>> scratch{arena};
+//
+// The arena must outlive the containers using it. ctp::array only constructs with its allocator, so there it
+// just passes the arena along. Works in constant evaluation, with std::allocator.
+
+namespace ctp {
+
+// Hands out memory from an inline buffer in order, until it runs out. Freeing the last allocation gives its memory
+// back, so scratch containers used one after another reuse the same memory; freeing any other keeps it until reset.
+template <std::size_t Bytes>
+class stack_arena {
+public:
+	stack_arena() noexcept = default;
+	stack_arena(const stack_arena&) = delete;
+	stack_arena& operator=(const stack_arena&) = delete;
+
+	// Null if there's no room left. Aligns the address rather than the offset, so any alignment works.
+	[[nodiscard]] void* allocate(const std::size_t bytes, const std::size_t alignment) noexcept {
+		const auto address = reinterpret_cast<std::uintptr_t>(buffer_ + used_);
+		const std::size_t offset = used_ + static_cast<std::size_t>(((address + alignment - 1) & ~(alignment - 1)) - address);
+		if (offset > Bytes || bytes > Bytes - offset)
+			return nullptr;
+		used_ = offset + bytes;
+		return buffer_ + offset;
+	}
+
+	// Expects ptr to be from this arena.
+	void deallocate(void* const ptr, const std::size_t bytes) noexcept {
+		if (static_cast<std::byte*>(ptr) + bytes == buffer_ + used_)
+			used_ = static_cast<std::size_t>(static_cast<std::byte*>(ptr) - buffer_);
+	}
+
+	[[nodiscard]] bool owns(const void* const ptr) const noexcept {
+		const auto address = reinterpret_cast<std::uintptr_t>(ptr);
+		const auto begin = reinterpret_cast<std::uintptr_t>(buffer_);
+		return address >= begin && address < begin + Bytes;
+	}
+
+	// Makes all of it free again. Expects nothing allocated from it to be used afterwards.
+	void reset() noexcept { used_ = 0; }
+
+	[[nodiscard]] static constexpr std::size_t capacity() noexcept { return Bytes; }
+	[[nodiscard]] std::size_t used() const noexcept { return used_; }
+
+private:
+	std::size_t used_ = 0;
+	alignas(std::max_align_t) std::byte buffer_[Bytes];
+};
+
+// Allocates from an arena, falling back to the heap when it's full. Copies share the arena, and containers keep
+// theirs when assigned or swapped, like std::pmr allocators.
+template <typename T, typename Arena>
+class stack_allocator {
+public:
+	using value_type = T;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+	using propagate_on_container_copy_assignment = std::false_type;
+	using propagate_on_container_move_assignment = std::false_type;
+	using propagate_on_container_swap = std::false_type;
+	using is_always_equal = std::false_type;
+
+	constexpr stack_allocator(Arena& arena) noexcept : arena_{&arena} {}
+	template <typename U>
+	constexpr stack_allocator(const stack_allocator<U, Arena>& other) noexcept : arena_{&other.arena()} {}
+
+	[[nodiscard]] constexpr Arena& arena() const noexcept { return *arena_; }
+
+	[[nodiscard]] constexpr T* allocate(const std::size_t n) CTP_NOEXCEPT(false) {
+		if CTP_NOT_CONSTEVAL {
+			if (n <= Arena::capacity() / sizeof(T)) {
+				if (void* const ptr = arena_->allocate(n * sizeof(T), alignof(T)))
+					return static_cast<T*>(ptr);
+			}
+		}
+		return std::allocator<T>{}.allocate(n);
+	}
+
+	constexpr void deallocate(T* const ptr, const std::size_t n) noexcept {
+		if CTP_NOT_CONSTEVAL {
+			if (arena_->owns(ptr)) {
+				arena_->deallocate(ptr, n * sizeof(T));
+				return;
+			}
+		}
+		std::allocator<T>{}.deallocate(ptr, n);
+	}
+
+	template <typename U>
+	friend constexpr bool operator==(const stack_allocator& lhs, const stack_allocator<U, Arena>& rhs) noexcept {
+		return lhs.arena_ == &rhs.arena();
+	}
+
+private:
+	Arena* arena_;
+};
+
+} // ctp
+
+#endif // INCLUDE_CTP_TOOLS_STACK_ALLOCATOR_HPP
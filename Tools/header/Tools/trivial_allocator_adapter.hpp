@@ -12,6 +12,15 @@ template <typename T, typename Alloc = std::allocator<T>>
 class trivial_init_allocator : public Alloc {
 public:
 	using Alloc::Alloc;
+	constexpr trivial_init_allocator() = default;
+	// Adapt an allocator that has state.
+	constexpr trivial_init_allocator(const Alloc& alloc) noexcept : Alloc(alloc) {}
+
+	// Rebind the adapted allocator too, so it allocates the rebound type.
+	template <typename U>
+	struct rebind {
+		using other = trivial_init_allocator<U, typename std::allocator_traits<Alloc>::template rebind_alloc<U>>;
+	};
 
 	// With no args, do default initialization in non-constexpr contexts.
 	template <typename U>
@@ -0,0 +1,445 @@
+#include <Tools/binary_log.hpp>
+
+#include <fmt/args.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <vector>
+
+using namespace std::literals;
+
+namespace {
+
+namespace ff = ctp::binlog::file_format;
+using ctp::binlog::arg_type;
+
+constexpr std::size_t BufferBytes = 64 * 1024;
+
+std::mutex FileMutex;
+std::FILE* File = nullptr;
+// Incremented by open, so buffers know to drop records meant for a previous file.
+std::atomic<std::uint64_t> Generation{0};
+std::atomic<std::uint32_t> NextThread{0};
+
+// Every site given an id, in id order. Ids are kept across files, so open writes their definitions again.
+struct SiteEntry {
+	ctp::binlog::site* s;
+	std::span<const arg_type> types;
+};
+std::mutex SiteMutex;
+std::vector<SiteEntry> Sites;
+
+template <class T>
+void write_value(const T& value) noexcept {
+	std::fwrite(&value, sizeof(T), 1, File);
+}
+
+void write_string(const std::string_view str) noexcept {
+	write_value(static_cast<std::uint32_t>(str.size()));
+	std::fwrite(str.data(), 1, str.size(), File);
+}
+
+void write_chunk_header(const std::uint32_t bytes, const std::uint32_t thread) noexcept {
+	write_value(bytes);
+	write_value(thread);
+	write_value(ctp::cpu_ticks());
+	write_value(ctp::steady_ns());
+}
+
+// Expects the file mutex to be held.
+void write_site(const std::uint32_t id, const SiteEntry& entry, const std::uint32_t thread) noexcept {
+	const std::string_view file{entry.s->file};
+	const std::string_view format{entry.s->format};
+	const std::size_t bytes = 4 + 4 + 1 + 1 + entry.types.size() + 4 + file.size() + 4 + format.size();
+	write_chunk_header(static_cast<std::uint32_t>(bytes), thread);
+	write_value(id | ff::SiteFlag);
+	write_value(static_cast<std::uint32_t>(entry.s->line));
+	write_value(static_cast<std::uint8_t>(entry.s->lvl));
+	write_value(static_cast<std::uint8_t>(entry.types.size()));
+	std::fwrite(entry.types.data(), 1, entry.types.size(), File);
+	write_string(file);
+	write_string(format);
+}
+
+// Set once the calling thread's buffer is destroyed, for thread_locals destroyed after it that still log.
+thread_local constinit bool LocalDestroyed = false;
+
+// The calling thread's buffer. Chunk header space is kept at the front, and filled in when written out.
+struct LocalBuffer {
+	std::unique_ptr<char[]> data;
+	std::uint64_t generation = 0;
+	std::uint32_t thread = 0;
+
+	LocalBuffer() noexcept : thread{NextThread.fetch_add(1, std::memory_order_relaxed)} {}
+	~LocalBuffer() {
+		write_out();
+		ctp::binlog::detail::LocalCursor = {};
+		LocalDestroyed = true;
+	}
+
+	char* records() const noexcept { return data.get() + ff::ChunkHeaderBytes; }
+
+	void reset() noexcept {
+		ctp::binlog::detail::LocalCursor = {records(), data.get() + BufferBytes};
+	}
+
+	bool allocate() noexcept {
+		if (data)
+			return true;
+		data.reset(new (std::nothrow) char[BufferBytes]);
+		if (!data)
+			return false;
+		generation = Generation.load(std::memory_order_relaxed);
+		reset();
+		return true;
+	}
+
+	// Drop records meant for a previous file.
+	void sync_generation() noexcept {
+		const auto current = Generation.load(std::memory_order_relaxed);
+		if (data && generation != current) {
+			generation = current;
+			reset();
+		}
+	}
+
+	void write_out() noexcept {
+		if (!data)
+			return;
+		const char* const end = ctp::binlog::detail::LocalCursor.pos;
+		const auto bytes = static_cast<std::size_t>(end - records());
+		if (bytes == 0)
+			return;
+
+		{
+			std::scoped_lock lock{FileMutex};
+			if (File && generation == Generation.load(std::memory_order_relaxed)) {
+				write_chunk_header(static_cast<std::uint32_t>(bytes), thread);
+				std::fwrite(records(), 1, bytes, File);
+			}
+		}
+		sync_generation();
+		reset();
+	}
+};
+
+thread_local LocalBuffer Local;
+
+// Reads values from a log, failing once past the end.
+struct Reader {
+	std::span<const char> data;
+	std::size_t pos = 0;
+
+	bool done() const noexcept { return pos == data.size(); }
+
+	template <class T>
+	bool read(T& value) noexcept {
+		if (data.size() - pos < sizeof(T))
+			return false;
+		std::memcpy(&value, data.data() + pos, sizeof(T));
+		pos += sizeof(T);
+		return true;
+	}
+
+	bool read(std::string_view& str) noexcept {
+		std::uint32_t size;
+		if (!read(size) || data.size() - pos < size)
+			return false;
+		str = {data.data() + pos, size};
+		pos += size;
+		return true;
+	}
+
+	bool skip(const std::size_t bytes) noexcept {
+		if (data.size() - pos < bytes)
+			return false;
+		pos += bytes;
+		return true;
+	}
+};
+
+struct SiteInfo {
+	std::string_view file;
+	std::string_view format;
+	std::uint32_t line = 0;
+	ctp::binlog::level lvl{};
+	std::vector<arg_type> types;
+};
+
+struct Record {
+	std::uint64_t ticks;
+	std::uint32_t site;
+	// Offset of the arguments.
+	std::size_t pos;
+};
+
+bool read_site(Reader& reader, std::vector<SiteInfo>& sites, const std::uint32_t id) {
+	SiteInfo info;
+	std::uint8_t lvl;
+	std::uint8_t count;
+	if (!reader.read(info.line) || !reader.read(lvl) || !reader.read(count) || lvl > std::uint8_t(ctp::binlog::level::error))
+		return false;
+	for (std::uint8_t i = 0; i < count; ++i) {
+		std::uint8_t type;
+		if (!reader.read(type) || type > std::uint8_t(arg_type::pointer))
+			return false;
+		info.types.push_back(static_cast<arg_type>(type));
+	}
+	if (!reader.read(info.file) || !reader.read(info.format))
+		return false;
+	info.lvl = static_cast<ctp::binlog::level>(lvl);
+
+	if (id == 0 || id > sites.size() + 1)
+		return false;
+	if (id == sites.size() + 1)
+		sites.push_back(std::move(info));
+	else
+		sites[id - 1] = std::move(info);
+	return true;
+}
+
+using ArgStore = fmt::dynamic_format_arg_store<fmt::format_context>;
+
+template <class T, class Stored = T>
+bool push_arg(Reader& reader, ArgStore& store) {
+	T value{};
+	if (!reader.read(value))
+		return false;
+	if constexpr (std::is_same_v<Stored, const void*>)
+		store.push_back(reinterpret_cast<const void*>(static_cast<std::uintptr_t>(value)));
+	else
+		store.push_back(static_cast<Stored>(value));
+	return true;
+}
+
+// Push a record's arguments into the store. Returns false if they run past the end.
+bool read_args(Reader& reader, const SiteInfo& site, ArgStore& store) {
+	for (const arg_type type : site.types) {
+		bool ok = false;
+		switch (type) {
+		case arg_type::boolean: ok = push_arg<std::uint8_t, bool>(reader, store); break;
+		case arg_type::character: ok = push_arg<char>(reader, store); break;
+		case arg_type::i32: ok = push_arg<std::int32_t>(reader, store); break;
+		case arg_type::u32: ok = push_arg<std::uint32_t>(reader, store); break;
+		case arg_type::i64: ok = push_arg<std::int64_t>(reader, store); break;
+		case arg_type::u64: ok = push_arg<std::uint64_t>(reader, store); break;
+		case arg_type::f64: ok = push_arg<double>(reader, store); break;
+		case arg_type::string: ok = push_arg<std::string_view>(reader, store); break;
+		case arg_type::pointer: ok = push_arg<std::uint64_t, const void*>(reader, store); break;
+		}
+		if (!ok)
+			return false;
+	}
+	return true;
+}
+
+constexpr std::string_view level_name(const ctp::binlog::level lvl) noexcept {
+	switch (lvl) {
+	case ctp::binlog::level::info: return "Info"sv;
+	case ctp::binlog::level::warn: return "Warn"sv;
+	default: return "ERROR"sv;
+	}
+}
+
+} // namespace
+
+namespace ctp::binlog {
+
+bool open(const std::string& path) noexcept {
+	detail::Enabled.store(false, std::memory_order_relaxed);
+	const std::uint32_t thread = LocalDestroyed ? 0 : Local.thread;
+	{
+		// Threads may still write records with ids they read before this, so ids stay the same and the new file
+		// starts with every site's definition. Both locks, so that no site is registered in between.
+		std::scoped_lock lock{SiteMutex, FileMutex};
+		if (File)
+			std::fclose(File);
+#if CTP_WINDOWS
+		if (fopen_s(&File, path.c_str(), "wb") != 0)
+			File = nullptr;
+#else
+		File = std::fopen(path.c_str(), "wb");
+#endif
+		if (!File)
+			return false;
+		std::fwrite(file_format::Magic.data(), 1, file_format::Magic.size(), File);
+		write_value(cpu_ticks());
+		write_value(steady_ns());
+		for (std::size_t i = 0; i < Sites.size(); ++i)
+			write_site(static_cast<std::uint32_t>(i + 1), Sites[i], thread);
+		Generation.fetch_add(1, std::memory_order_relaxed);
+	}
+	detail::Enabled.store(true, std::memory_order_relaxed);
+	return true;
+}
+
+void close() noexcept {
+	flush();
+	detail::Enabled.store(false, std::memory_order_relaxed);
+	std::scoped_lock lock{FileMutex};
+	if (File) {
+		std::fclose(File);
+		File = nullptr;
+	}
+}
+
+void flush() noexcept {
+	if (!LocalDestroyed)
+		Local.write_out();
+	std::scoped_lock lock{FileMutex};
+	if (File)
+		std::fflush(File);
+}
+
+namespace detail {
+
+bool reserve_slow(const std::size_t bytes) noexcept {
+	if (!Enabled.load(std::memory_order_relaxed) || bytes > BufferBytes - file_format::ChunkHeaderBytes || LocalDestroyed)
+		return false;
+	if (!Local.allocate())
+		return false;
+	Local.sync_generation();
+	if (static_cast<std::size_t>(LocalCursor.end - LocalCursor.pos) < bytes)
+		Local.write_out();
+	return true;
+}
+
+std::uint32_t register_site(site& s, const std::span<const arg_type> types) noexcept {
+	if (LocalDestroyed)
+		return 0;
+	Local.sync_generation();
+
+	std::scoped_lock siteLock{SiteMutex};
+	if (const auto id = s.id.load(std::memory_order_relaxed); id != 0)
+		return id;
+
+	try {
+		Sites.push_back({&s, types});
+	} catch (...) {
+		return 0;
+	}
+	const auto id = static_cast<std::uint32_t>(Sites.size());
+
+	// Definitions go straight to the file, so they always come before records that use them.
+	{
+		std::scoped_lock fileLock{FileMutex};
+		if (!File) {
+			Sites.pop_back();
+			return 0;
+		}
+		write_site(id, Sites.back(), Local.thread);
+	}
+
+	s.id.store(id, std::memory_order_relaxed);
+	return id;
+}
+
+} // detail
+
+bool decode(const std::span<const char> data, std::ostream& out) {
+	Reader reader{data};
+
+	std::array<char, file_format::Magic.size()> magic;
+	if (!reader.read(magic) || magic != file_format::Magic)
+		return false;
+
+	std::uint64_t baseTicks;
+	std::uint64_t baseNs;
+	if (!reader.read(baseTicks) || !reader.read(baseNs))
+		return false;
+
+	std::vector<SiteInfo> sites;
+	std::vector<Record> records;
+	std::uint64_t lastTicks = baseTicks;
+	std::uint64_t lastNs = baseNs;
+
+	while (!reader.done()) {
+		std::uint32_t bytes;
+		std::uint32_t thread;
+		std::uint64_t ticks;
+		std::uint64_t ns;
+		if (!reader.read(bytes) || !reader.read(thread) || !reader.read(ticks) || !reader.read(ns))
+			return false;
+		if (ticks > lastTicks) {
+			lastTicks = ticks;
+			lastNs = ns;
+		}
+
+		if (data.size() - reader.pos < bytes)
+			return false;
+		Reader chunk{data.first(reader.pos + bytes), reader.pos};
+		reader.pos += bytes;
+
+		while (!chunk.done()) {
+			std::uint32_t id;
+			if (!chunk.read(id))
+				return false;
+			if (id & file_format::SiteFlag) {
+				if (!read_site(chunk, sites, id & ~file_format::SiteFlag))
+					return false;
+				continue;
+			}
+
+			if (id == 0 || id > sites.size())
+				return false;
+			Record& record = records.emplace_back();
+			record.site = id - 1;
+			if (!chunk.read(record.ticks))
+				return false;
+			record.pos = chunk.pos;
+
+			// Skip the arguments.
+			for (const arg_type type : sites[record.site].types) {
+				std::string_view str;
+				const bool ok = type == arg_type::string ? chunk.read(str)
+					: chunk.skip(type == arg_type::boolean || type == arg_type::character ? 1
+						: type == arg_type::i32 || type == arg_type::u32 ? 4 : 8);
+				if (!ok)
+					return false;
+			}
+		}
+	}
+
+	// Fit ticks to time from the readings at open and at the last write.
+	const tick_calibration clock{baseTicks, baseNs, lastTicks, lastNs};
+
+	std::ranges::stable_sort(records, {}, &Record::ticks);
+
+	ArgStore store;
+	std::string line;
+	for (const Record& record : records) {
+		const SiteInfo& site = sites[record.site];
+		store.clear();
+		Reader args{data, record.pos};
+		if (!read_args(args, site, store))
+			return false;
+
+		line.clear();
+		fmt::format_to(std::back_inserter(line), "{:12.6f} {:<5} {}({}): ", clock.ns_since_base(record.ticks) / 1e9, level_name(site.lvl), site.file, site.line);
+		try {
+			fmt::vformat_to(std::back_inserter(line), fmt::string_view{site.format.data(), site.format.size()}, store);
+		} catch (const fmt::format_error& e) {
+			fmt::format_to(std::back_inserter(line), "<bad format \"{}\": {}>", site.format, e.what());
+		}
+		line += '\n';
+		out << line;
+	}
+	return true;
+}
+
+bool decode_file(const std::string& path, std::ostream& out) {
+	std::ifstream file{path, std::ios::binary};
+	if (!file.is_open())
+		return false;
+	const std::vector<char> data{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+	return decode(data, out);
+}
+
+} // ctp::binlog
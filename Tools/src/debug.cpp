@@ -1,20 +1,36 @@
 #include <Tools/debug.hpp>
 
 #include <Tools/charconv.hpp>
+#include <Tools/stack_allocator.hpp>
+#include <Tools/warnings.hpp>
 #include <Tools/windows.hpp>
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <charconv>
 #include <chrono>
+#include <condition_variable>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
 #include <filesystem>
+#include <initializer_list>
 #include <iostream>
-#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <thread>
 
 #if CTP_WINDOWS
 #include <debugapi.h>
 #endif
 
+#if CTP_LINUX
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
 #if CTP_WINDOWS && CTP_DEBUG
 #define SUPPORTS_DEBUGGER_LOGING 1
 #else
@@ -23,6 +39,8 @@
 
 using namespace std::literals;
 
+#if CTP_LOGGING
+
 namespace {
 #ifdef NO_CONSOLE_COLOUR
 constexpr auto ErrorColour = ""sv;
@@ -43,6 +61,258 @@ constexpr auto ErrorHeader = "ERROR "sv;
 #if SUPPORTS_DEBUGGER_LOGING
 std::atomic<std::shared_ptr<std::filesystem::path>> CurrentDirectory;
 #endif // SUPPORTS_DEBUGGER_LOGING
+
+// ------------------------- async logging -------------------------
+// Each logging thread owns a single producer, single consumer ring of preformatted records.
+// The flusher thread drains all rings and writes the records out in batches. Whoever drains
+// holds the drain mutex, so FlushLog can drain from the calling thread if the flusher is stuck.
+// Nothing waits on a stuck flusher for long: producers fall back to writing synchronously, and
+// FlushLog drains without the mutex, so that crash messages get out.
+
+constexpr std::size_t RingBytes = 64 * 1024;
+constexpr std::size_t MaxRings = 64;
+constexpr std::size_t RecordAlign = 8;
+// Records larger than this are written synchronously.
+constexpr std::size_t MaxRecordBytes = RingBytes / 4;
+constexpr std::size_t MaxBatchChunks = 256;
+constexpr auto FlushPeriod = 2ms;
+// How long FlushLog waits for the drain mutex, and producers for space in a full ring.
+constexpr auto FlushTimeout = 200ms;
+
+// Precedes each record. Records are padded to RecordAlign, so headers never wrap around the ring.
+struct RecordHeader {
+	std::uint32_t size;
+	std::uint32_t toError;
+};
+static_assert(sizeof(RecordHeader) == RecordAlign);
+static_assert(RingBytes % RecordAlign == 0);
+
+// Head and tail on their own cache lines, since different threads write them.
+CTP_WARNING_PUSH
+CTP_WARNING_ALIGNMENT_PADDING
+struct Ring {
+	// Total bytes written, only stored by the owning thread.
+	alignas(64) std::atomic<std::size_t> head{0};
+	// Total bytes consumed, only stored by whoever holds the drain mutex.
+	alignas(64) std::atomic<std::size_t> tail{0};
+	// Whether a thread is using this ring. Rings outlive their threads and are reused.
+	std::atomic<bool> owned{true};
+	std::array<char, RingBytes> data;
+};
+CTP_WARNING_POP
+
+struct AsyncLogState {
+	std::array<std::atomic<Ring*>, MaxRings> rings{};
+	std::atomic<std::size_t> numRings{0};
+	std::atomic<bool> enabled{false};
+	std::atomic<bool> stopping{false};
+	std::timed_mutex drainMutex;
+	std::mutex wakeMutex;
+	std::condition_variable wake;
+	std::thread flusher;
+	std::once_flag installHandlers;
+	std::terminate_handler previousTerminate = nullptr;
+};
+
+// Leaked, so it can be used by thread exit, terminate and atexit handlers in any order.
+AsyncLogState& AsyncState() {
+	static AsyncLogState& state = *new AsyncLogState;
+	return state;
+}
+
+// Releases the thread's ring when it exits, so another thread can take it over.
+struct LocalRingHandle {
+	Ring* ring = nullptr;
+	~LocalRingHandle() {
+		if (ring)
+			ring->owned.store(false, std::memory_order_release);
+	}
+};
+thread_local LocalRingHandle LocalRing;
+
+// Set on the flusher thread, which holds the drain mutex while it writes, and which nothing else drains for.
+thread_local constinit bool IsFlusherThread = false;
+
+Ring* GetLocalRing() noexcept {
+	if (LocalRing.ring)
+		return LocalRing.ring;
+
+	auto& state = AsyncState();
+	const std::size_t count = (std::min)(state.numRings.load(std::memory_order_acquire), MaxRings);
+	for (std::size_t i = 0; i < count; ++i) {
+		Ring* ring = state.rings[i].load(std::memory_order_acquire);
+		bool expected = false;
+		if (ring && ring->owned.compare_exchange_strong(expected, true, std::memory_order_acquire))
+			return LocalRing.ring = ring;
+	}
+
+	const std::size_t index = state.numRings.fetch_add(1, std::memory_order_acq_rel);
+	if (index >= MaxRings)
+		return nullptr;
+	Ring* ring = new (std::nothrow) Ring;
+	state.rings[index].store(ring, std::memory_order_release);
+	return LocalRing.ring = ring;
+}
+
+#if CTP_LINUX
+using Chunk = iovec;
+#else
+struct Chunk {
+	void* iov_base;
+	std::size_t iov_len;
+};
+#endif
+
+void WriteChunks(bool toError, Chunk* chunks, std::size_t count) noexcept {
+	if (count == 0)
+		return;
+#if CTP_LINUX
+	const int fd = toError ? STDERR_FILENO : STDOUT_FILENO;
+	while (count > 0) {
+		const ssize_t written = ::writev(fd, chunks, static_cast<int>(count));
+		if (written < 0)
+			return;
+		// Skip what was written, in case of a partial write.
+		auto remaining = static_cast<std::size_t>(written);
+		while (count > 0 && remaining >= chunks->iov_len) {
+			remaining -= chunks->iov_len;
+			++chunks;
+			--count;
+		}
+		if (count > 0) {
+			chunks->iov_base = static_cast<char*>(chunks->iov_base) + remaining;
+			chunks->iov_len -= remaining;
+		}
+	}
+#else
+	std::FILE* file = toError ? stderr : stdout;
+	for (std::size_t i = 0; i < count; ++i)
+		std::fwrite(chunks[i].iov_base, 1, chunks[i].iov_len, file);
+	std::fflush(file);
+#endif
+}
+
+// Write out everything in a ring. Expects the drain mutex to be held.
+void DrainRing(Ring& ring) noexcept {
+	std::array<Chunk, MaxBatchChunks> out;
+	std::array<Chunk, MaxBatchChunks> err;
+	std::size_t tail = ring.tail.load(std::memory_order_relaxed);
+	for (;;) {
+		const std::size_t head = ring.head.load(std::memory_order_acquire);
+		if (tail == head)
+			return;
+
+		std::size_t numOut = 0;
+		std::size_t numErr = 0;
+		// Each record takes up to two chunks, if it wraps around.
+		while (tail != head && numOut + 2 <= out.size() && numErr + 2 <= err.size()) {
+			RecordHeader header;
+			std::memcpy(&header, ring.data.data() + tail % RingBytes, sizeof(header));
+			const std::size_t start = (tail + sizeof(header)) % RingBytes;
+			const std::size_t first = (std::min)(static_cast<std::size_t>(header.size), RingBytes - start);
+
+			auto& chunks = header.toError ? err : out;
+			auto& num = header.toError ? numErr : numOut;
+			chunks[num++] = {ring.data.data() + start, first};
+			if (first < header.size)
+				chunks[num++] = {ring.data.data(), header.size - first};
+
+			tail += (sizeof(header) + header.size + RecordAlign - 1) / RecordAlign * RecordAlign;
+		}
+
+		WriteChunks(false, out.data(), numOut);
+		WriteChunks(true, err.data(), numErr);
+		// Only give the space back to the producer once it has been written.
+		ring.tail.store(tail, std::memory_order_release);
+	}
+}
+
+// Expects the drain mutex to be held.
+void DrainAll() noexcept {
+	auto& state = AsyncState();
+	const std::size_t count = (std::min)(state.numRings.load(std::memory_order_acquire), MaxRings);
+	for (std::size_t i = 0; i < count; ++i) {
+		if (Ring* ring = state.rings[i].load(std::memory_order_acquire))
+			DrainRing(*ring);
+	}
+}
+
+void WakeFlusher() noexcept {
+	AsyncState().wake.notify_one();
+}
+
+void FlusherMain() noexcept {
+	IsFlusherThread = true;
+	auto& state = AsyncState();
+	while (!state.stopping.load(std::memory_order_acquire)) {
+		{
+			std::unique_lock lock{state.wakeMutex};
+			// Producers notify without the mutex, so a wakeup can be missed. The timeout bounds the delay.
+			state.wake.wait_for(lock, FlushPeriod);
+		}
+		std::lock_guard lock{state.drainMutex};
+		DrainAll();
+	}
+	std::lock_guard lock{state.drainMutex};
+	DrainAll();
+}
+
+// Copy a record made of parts into this thread's ring. Returns false if the record
+// should be written synchronously instead.
+bool TryEnqueue(bool toError, std::initializer_list<std::string_view> parts) noexcept {
+	auto& state = AsyncState();
+	// The flusher would wait on itself.
+	if (!state.enabled.load(std::memory_order_acquire) || IsFlusherThread)
+		return false;
+
+	std::size_t size = 0;
+	for (const auto part : parts)
+		size += part.size();
+	if (size > MaxRecordBytes)
+		return false;
+
+	Ring* ring = GetLocalRing();
+	if (!ring)
+		return false;
+
+	const std::size_t recordBytes = (sizeof(RecordHeader) + size + RecordAlign - 1) / RecordAlign * RecordAlign;
+	const std::size_t head = ring->head.load(std::memory_order_relaxed);
+	// Wait for space if the flusher is behind, but not on a stuck one. This record then goes out before
+	// those still in the ring.
+	if (head + recordBytes - ring->tail.load(std::memory_order_acquire) > RingBytes) {
+		const auto deadline = std::chrono::steady_clock::now() + FlushTimeout;
+		while (head + recordBytes - ring->tail.load(std::memory_order_acquire) > RingBytes) {
+			if (!state.enabled.load(std::memory_order_acquire) || std::chrono::steady_clock::now() > deadline)
+				return false;
+			WakeFlusher();
+			std::this_thread::yield();
+		}
+	}
+
+	const RecordHeader header{static_cast<std::uint32_t>(size), toError ? 1u : 0u};
+	std::memcpy(ring->data.data() + head % RingBytes, &header, sizeof(header));
+	std::size_t pos = head + sizeof(header);
+	for (const auto part : parts) {
+		const std::size_t start = pos % RingBytes;
+		const std::size_t first = (std::min)(part.size(), RingBytes - start);
+		std::memcpy(ring->data.data() + start, part.data(), first);
+		std::memcpy(ring->data.data(), part.data() + first, part.size() - first);
+		pos += part.size();
+	}
+	ring->head.store(head + recordBytes, std::memory_order_release);
+
+	// Get warnings and errors out soon, and don't let the ring fill up.
+	if (toError || head + recordBytes - ring->tail.load(std::memory_order_relaxed) > RingBytes / 2)
+		WakeFlusher();
+	return true;
+}
+
+void OnTerminate() {
+	ctp::debug::FlushLog();
+	if (const auto previous = AsyncState().previousTerminate)
+		previous();
+	std::abort();
+}
 } // namespace
 
 namespace ctp::debug {
@@ -61,10 +331,11 @@ void Log(Stream stream, std::string_view action, std::string_view expr, std::str
 	// TODO: add time to the log header (need clock since app started).
 	// TODO: double check if fwrite is the fastest option to use here
 
-	std::array<std::byte, 512> stackMem;
-	std::pmr::monotonic_buffer_resource memResource{stackMem.data(), stackMem.size()};
-	std::pmr::string out{&memResource};
-	out.reserve(stackMem.size());
+	using Arena = ctp::stack_arena<512>;
+	Arena arena;
+	std::basic_string<char, std::char_traits<char>, ctp::stack_allocator<char, Arena>> out{arena};
+	// Leave room for the terminator.
+	out.reserve(arena.capacity() - 1);
 
 	// Cut leading directories out of file.
 	const auto lastSlash = file.find_last_of("\\/");
@@ -96,7 +367,7 @@ void Log(Stream stream, std::string_view action, std::string_view expr, std::str
 
 	static constexpr auto headerLen = (std::max)({LogHeader.size(), WarningHeader.size(), ErrorHeader.size()});
 	const auto totalSize = clickableFilePathOffset + action.size() + expr.size() + fileName.size() + lineStr.size() + message.size() + headerLen + 16;
-	if (stackMem.size() < totalSize)
+	if (out.capacity() < totalSize)
 		out.reserve(totalSize);
 
 #if SUPPORTS_DEBUGGER_LOGING
@@ -153,12 +424,15 @@ void Log(Stream stream, std::string_view action, std::string_view expr, std::str
 		out += ".\n"sv;
 	}
 
-	logStream->write(colour.data(), colour.size());
-	logStream->write(out.data() + clickableFilePathOffset, out.size() - clickableFilePathOffset);
-	logStream->write(ResetColour.data(), ResetColour.size());
+	const std::string_view text{out.data() + clickableFilePathOffset, out.size() - clickableFilePathOffset};
+	if (!TryEnqueue(stream > Stream::Log, {colour, text, ResetColour})) {
+		logStream->write(colour.data(), colour.size());
+		logStream->write(text.data(), text.size());
+		logStream->write(ResetColour.data(), ResetColour.size());
 
-	if (stream > Stream::Log)
-		logStream->flush();
+		if (stream > Stream::Log)
+			logStream->flush();
+	}
 
 #if SUPPORTS_DEBUGGER_LOGING
 	if (!haveDebugger)
@@ -176,6 +450,60 @@ void Log(Stream stream, std::string_view action, std::string_view expr, std::str
 #endif // SUPPORTS_DEBUGGER_LOGING
 }
 
+void StartAsyncLogging() noexcept(CTP_NOTHROW_ALLOCS) {
+	auto& state = AsyncState();
+	if (state.enabled.load(std::memory_order_acquire))
+		return;
+
+	std::call_once(state.installHandlers, [&state] {
+		state.previousTerminate = std::set_terminate(&OnTerminate);
+		std::atexit([] { StopAsyncLogging(); });
+	});
+
+	// Anything already written synchronously should come first.
+	std::cout.flush();
+	std::clog.flush();
+
+	state.stopping.store(false, std::memory_order_release);
+	state.flusher = std::thread{&FlusherMain};
+	state.enabled.store(true, std::memory_order_release);
+}
+
+void StopAsyncLogging() noexcept {
+	auto& state = AsyncState();
+	if (!state.enabled.exchange(false, std::memory_order_acq_rel))
+		return;
+
+	state.stopping.store(true, std::memory_order_release);
+	WakeFlusher();
+	if (state.flusher.joinable())
+		state.flusher.join();
+}
+
+void FlushLog() noexcept {
+	auto& state = AsyncState();
+	if (!state.enabled.load(std::memory_order_acquire)) {
+		std::cout.flush();
+		std::clog.flush();
+		return;
+	}
+
+	// On the flusher, as when it terminates, the mutex may be held already.
+	if (IsFlusherThread) {
+		DrainAll();
+		return;
+	}
+
+	// Wait out the flusher if it is mid-write, but don't hang a failing program on a stuck flusher. Then
+	// drain without the mutex: some records may be written twice, but none lost.
+	if (state.drainMutex.try_lock_for(FlushTimeout)) {
+		DrainAll();
+		state.drainMutex.unlock();
+	} else {
+		DrainAll();
+	}
+}
+
 #if CTP_DEBUG
 
 bool IsDebuggerAttached() noexcept {
@@ -202,3 +530,5 @@ void WaitForDebugger() noexcept {
 #endif // CTP_DEBUG
 
 } // ctp::debug
+
+#endif // CTP_LOGGING
@@ -0,0 +1,222 @@
+#include <Tools/page_allocator.hpp>
+
+#include <Tools/windows.hpp>
+
+#include <bit>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#if CTP_LINUX
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#if CTP_LINUX
+
+// The first number in a file, or 0.
+std::size_t ReadNumber(const char* path, const char* format) noexcept {
+	std::FILE* const file = std::fopen(path, "r");
+	if (!file)
+		return 0;
+	std::size_t number = 0;
+	char line[128];
+	while (std::fgets(line, sizeof(line), file)) {
+		if (std::sscanf(line, format, &number) == 1)
+			break;
+	}
+	std::fclose(file);
+	return number;
+}
+
+std::size_t FindHugePageSize() noexcept {
+	// The transparent huge page size first, since the default for reserved ones can be 1 GB.
+	if (const std::size_t size = ReadNumber("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", "%zu"))
+		return size;
+	return ReadNumber("/proc/meminfo", "Hugepagesize: %zu kB") * 1024;
+}
+
+// The highest node in a list like "0-3" or "0,2", or 0.
+int FindHighestNode() noexcept {
+	std::FILE* const file = std::fopen("/sys/devices/system/node/possible", "r");
+	if (!file)
+		return 0;
+	int highest = 0;
+	int node = 0;
+	char separator = 0;
+	while (std::fscanf(file, "%d%c", &node, &separator) >= 1) {
+		highest = node > highest ? node : highest;
+		if (separator != ',' && separator != '-')
+			break;
+	}
+	std::fclose(file);
+	return highest;
+}
+
+void* MapAnonymous(const std::size_t bytes, const int flags) noexcept {
+	void* const ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+	return ptr == MAP_FAILED ? nullptr : ptr;
+}
+
+// Reserved huge pages of exactly hugeSize, which fails if none are free.
+void* MapHugeTlb(const std::size_t bytes, [[maybe_unused]] const std::size_t hugeSize) noexcept {
+#ifdef MAP_HUGE_SHIFT
+	return MapAnonymous(bytes, MAP_HUGETLB | (std::countr_zero(hugeSize) << MAP_HUGE_SHIFT));
+#else
+	return nullptr;
+#endif
+}
+
+// Normal pages aligned to hugeSize, which transparent huge pages need, so over-map and trim.
+void* MapAligned(const std::size_t bytes, const std::size_t hugeSize) noexcept {
+	auto* const mapped = static_cast<std::byte*>(MapAnonymous(bytes + hugeSize, 0));
+	if (!mapped)
+		return nullptr;
+	const std::size_t head = (hugeSize - reinterpret_cast<std::uintptr_t>(mapped) % hugeSize) % hugeSize;
+	if (head != 0)
+		munmap(mapped, head);
+	munmap(mapped + head + bytes, hugeSize - head);
+	return mapped + head;
+}
+
+// Prefers node for pages not yet touched.
+void PreferNode(void* const ptr, const std::size_t bytes, const int node) noexcept {
+	constexpr int BitsPerWord = static_cast<int>(sizeof(unsigned long) * 8);
+	unsigned long mask[1024 / BitsPerWord]{};
+	if (node >= 1024)
+		return;
+	mask[node / BitsPerWord] = 1ul << (node % BitsPerWord);
+	syscall(SYS_mbind, ptr, bytes, MPOL_PREFERRED, mask, sizeof(mask) * 8, 0);
+}
+
+#elif CTP_WINDOWS
+
+std::size_t FindPageSize() noexcept {
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwPageSize;
+}
+
+void* VirtualAllocOnNode(const std::size_t bytes, const DWORD type, const int node) noexcept {
+	if (node >= 0)
+		return VirtualAllocExNuma(GetCurrentProcess(), nullptr, bytes, type, PAGE_READWRITE, static_cast<DWORD>(node));
+	return VirtualAlloc(nullptr, bytes, type, PAGE_READWRITE);
+}
+
+#else
+
+constexpr std::size_t DefaultPageSize = 4096;
+
+#endif
+
+} // namespace
+
+namespace ctp {
+
+std::size_t page_size() noexcept {
+#if CTP_LINUX
+	static const auto size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#elif CTP_WINDOWS
+	static const std::size_t size = FindPageSize();
+#else
+	constexpr std::size_t size = DefaultPageSize;
+#endif
+	return size;
+}
+
+std::size_t huge_page_size() noexcept {
+#if CTP_LINUX
+	static const std::size_t size = FindHugePageSize();
+#elif CTP_WINDOWS
+	// Large pages need the lock pages privilege, but round to them anyway in case it's there.
+	static const std::size_t size = GetLargePageMinimum();
+#else
+	constexpr std::size_t size = 0;
+#endif
+	return size > page_size() ? size : page_size();
+}
+
+int numa_node_count() noexcept {
+#if CTP_LINUX
+	static const int count = FindHighestNode() + 1;
+	return count;
+#elif CTP_WINDOWS
+	ULONG highest = 0;
+	if (!GetNumaHighestNodeNumber(&highest))
+		return 1;
+	return static_cast<int>(highest) + 1;
+#else
+	return 1;
+#endif
+}
+
+int current_numa_node() noexcept {
+#if CTP_LINUX
+	unsigned cpu = 0;
+	unsigned node = 0;
+	if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0)
+		return 0;
+	return static_cast<int>(node);
+#elif CTP_WINDOWS
+	PROCESSOR_NUMBER processor;
+	GetCurrentProcessorNumberEx(&processor);
+	USHORT node = 0;
+	if (!GetNumaProcessorNodeEx(&processor, &node))
+		return 0;
+	return node;
+#else
+	return 0;
+#endif
+}
+
+namespace page_detail {
+
+void* map_pages(const std::size_t bytes, [[maybe_unused]] const bool huge, [[maybe_unused]] const int node) noexcept {
+#if CTP_LINUX
+	const std::size_t hugeSize = huge_page_size();
+	void* ptr = nullptr;
+	if (huge && hugeSize > page_size()) {
+		ptr = MapHugeTlb(bytes, hugeSize);
+		if (!ptr) {
+			ptr = MapAligned(bytes, hugeSize);
+			if (ptr)
+				madvise(ptr, bytes, MADV_HUGEPAGE);
+		}
+	} else {
+		ptr = MapAnonymous(bytes, 0);
+	}
+	if (ptr && node >= 0)
+		PreferNode(ptr, bytes, node);
+	return ptr;
+#elif CTP_WINDOWS
+	constexpr DWORD Type = MEM_RESERVE | MEM_COMMIT;
+	if (huge && GetLargePageMinimum() != 0) {
+		if (void* const ptr = VirtualAllocOnNode(bytes, Type | MEM_LARGE_PAGES, node))
+			return ptr;
+	}
+	return VirtualAllocOnNode(bytes, Type, node);
+#else
+	void* const ptr = ::operator new(bytes, std::align_val_t{page_size()}, std::nothrow);
+	if (ptr)
+		std::memset(ptr, 0, bytes);
+	return ptr;
+#endif
+}
+
+void unmap_pages(void* const ptr, [[maybe_unused]] const std::size_t bytes) noexcept {
+#if CTP_LINUX
+	munmap(ptr, bytes);
+#elif CTP_WINDOWS
+	VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+	::operator delete(ptr, std::align_val_t{page_size()});
+#endif
+}
+
+} // page_detail
+
+} // ctp
@@ -0,0 +1,122 @@
+#include <Tools/perf_counters.hpp>
+
+#if CTP_LINUX
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#if CTP_LINUX
+
+struct EventConfig {
+	std::uint32_t type;
+	std::uint64_t config;
+};
+
+constexpr std::uint64_t CacheReadMiss(std::uint64_t cache) noexcept {
+	return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+constexpr EventConfig Configs[ctp::PerfEventCount]{
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+	{PERF_TYPE_HW_CACHE, CacheReadMiss(PERF_COUNT_HW_CACHE_L1D)},
+	{PERF_TYPE_HW_CACHE, CacheReadMiss(PERF_COUNT_HW_CACHE_LL)},
+	{PERF_TYPE_HW_CACHE, CacheReadMiss(PERF_COUNT_HW_CACHE_DTLB)},
+};
+
+int OpenEvent(const EventConfig& event, const int groupFd) noexcept {
+	perf_event_attr attr{};
+	attr.size = sizeof(attr);
+	attr.type = event.type;
+	attr.config = event.config;
+	// The group starts disabled, and members follow the leader.
+	attr.disabled = groupFd == -1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+	return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, PERF_FLAG_FD_CLOEXEC));
+}
+
+#endif // CTP_LINUX
+
+} // namespace
+
+namespace ctp {
+
+perf_counters::perf_counters([[maybe_unused]] std::span<const perf_event> events) noexcept {
+	fds_.fill(-1);
+#if CTP_LINUX
+	for (const perf_event event : events) {
+		const auto i = static_cast<std::size_t>(event);
+		if (fds_[i] != -1)
+			continue;
+		const int fd = OpenEvent(Configs[i], leader_);
+		if (fd == -1)
+			continue;
+		if (leader_ == -1)
+			leader_ = fd;
+		fds_[i] = fd;
+		slots_[i] = opened_++;
+	}
+#endif
+}
+
+perf_counters::~perf_counters() {
+#if CTP_LINUX
+	for (const int fd : fds_) {
+		if (fd != -1)
+			close(fd);
+	}
+#endif
+}
+
+void perf_counters::start() noexcept {
+	values_.fill(0);
+	read_ = false;
+#if CTP_LINUX
+	if (leader_ == -1)
+		return;
+	ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+	ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+void perf_counters::stop() noexcept {
+#if CTP_LINUX
+	if (leader_ == -1)
+		return;
+	ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+	// Group read format: count, time enabled, time running, then a value per event.
+	std::array<std::uint64_t, 3 + PerfEventCount> data{};
+	const auto bytes = ::read(leader_, data.data(), sizeof(data));
+	if (bytes < static_cast<ssize_t>(3 * sizeof(std::uint64_t)) || data[0] != opened_)
+		return;
+
+	const std::uint64_t enabled = data[1];
+	const std::uint64_t running = data[2];
+	// Never scheduled, such as when the PMU has too few counters for the group, so there's nothing to scale.
+	if (running == 0)
+		return;
+	const double scale = running < enabled ? double(enabled) / double(running) : 1.0;
+	for (std::size_t i = 0; i < PerfEventCount; ++i) {
+		if (fds_[i] != -1)
+			values_[i] = static_cast<std::uint64_t>(double(data[3 + slots_[i]]) * scale);
+	}
+	read_ = true;
+#endif
+}
+
+std::optional<std::uint64_t> perf_counters::value(const perf_event event) const noexcept {
+	const auto i = static_cast<std::size_t>(event);
+	if (fds_[i] == -1 || !read_)
+		return std::nullopt;
+	return values_[i];
+}
+
+} // ctp
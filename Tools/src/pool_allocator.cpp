@@ -0,0 +1,187 @@
+#include <Tools/pool_allocator.hpp>
+#include <Tools/warnings.hpp>
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <new>
+
+namespace {
+
+using namespace ctp::pool_detail;
+
+// Remote frees to gather before returning them, enough to make the atomic cheap without holding much back.
+constexpr std::uint32_t RemoteBatch = 64;
+
+CTP_WARNING_PUSH
+CTP_WARNING_ALIGNMENT_PADDING
+struct pool_state : thread_pool {
+	// Every slab cut for this pool.
+	slab_header* slabs = nullptr;
+	pool_state* nextPool = nullptr;
+	pool_state* nextOrphan = nullptr;
+	// Where the current slab of each class has space left.
+	std::byte* next[SizeClassCount]{};
+	std::byte* end[SizeClassCount]{};
+
+	// Blocks this thread has freed for another pool, not yet returned.
+	pool_state* pendingOwner = nullptr;
+	free_block* pendingHead = nullptr;
+	free_block* pendingTail = nullptr;
+	std::uint32_t pendingCount = 0;
+
+	// Blocks other threads have freed, taken all at once by the owner. On its own cache line, since they write it.
+	alignas(64) std::atomic<free_block*> remote{nullptr};
+};
+CTP_WARNING_POP
+
+// Every pool, kept for the life of the program since blocks may still be freed into them, even by static
+// destructors. So these are never destroyed either.
+std::mutex PoolsMutex;
+pool_state* Pools = nullptr;
+// Pools of threads that have exited, for new threads to take over.
+pool_state* Orphans = nullptr;
+
+// Set once the calling thread has started destroying its thread_locals.
+thread_local constinit bool Exiting = false;
+
+[[noreturn]] void allocation_failed() {
+#if CTP_USE_EXCEPTIONS
+	throw std::bad_alloc();
+#else
+	std::terminate();
+#endif
+}
+
+void push_remote(pool_state& owner, free_block* const head, free_block* const tail) noexcept {
+	free_block* old = owner.remote.load(std::memory_order_relaxed);
+	do {
+		tail->next = old;
+	} while (!owner.remote.compare_exchange_weak(old, head, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void flush_pending(pool_state& pool) noexcept {
+	if (pool.pendingCount == 0)
+		return;
+	push_remote(*pool.pendingOwner, pool.pendingHead, pool.pendingTail);
+	pool.pendingOwner = nullptr;
+	pool.pendingHead = nullptr;
+	pool.pendingTail = nullptr;
+	pool.pendingCount = 0;
+}
+
+// Moves what other threads have freed into the free lists.
+void take_remote(pool_state& pool) noexcept {
+	if (!pool.remote.load(std::memory_order_relaxed))
+		return;
+	free_block* block = pool.remote.exchange(nullptr, std::memory_order_acquire);
+	while (block) {
+		free_block* const next = block->next;
+		const std::size_t sizeClass = slab_of(block)->sizeClass;
+		block->next = pool.free[sizeClass];
+		pool.free[sizeClass] = block;
+		block = next;
+	}
+}
+
+// Gives the calling thread's pool to the next thread to need one, when it exits.
+struct LocalPoolOwner {
+	pool_state* pool = nullptr;
+
+	~LocalPoolOwner() {
+		Exiting = true;
+		if (!pool)
+			return;
+		flush_pending(*pool);
+		LocalPool = nullptr;
+		std::scoped_lock lock{PoolsMutex};
+		pool->nextOrphan = Orphans;
+		Orphans = pool;
+	}
+};
+
+thread_local LocalPoolOwner Owner;
+
+// The calling thread's pool, making or adopting one if it has none. Null if out of memory.
+pool_state* local_pool() noexcept {
+	if (LocalPool)
+		return static_cast<pool_state*>(LocalPool);
+
+	pool_state* pool = nullptr;
+	{
+		std::scoped_lock lock{PoolsMutex};
+		if (Orphans) {
+			pool = Orphans;
+			Orphans = pool->nextOrphan;
+		}
+	}
+	if (!pool) {
+		pool = new (std::nothrow) pool_state;
+		if (!pool)
+			return nullptr;
+		std::scoped_lock lock{PoolsMutex};
+		pool->nextPool = Pools;
+		Pools = pool;
+	}
+	// Makes sure the pool is given back when the thread exits. A pool made while exiting is never given back, but
+	// that takes allocating in a thread_local's destructor.
+	if (!Exiting)
+		Owner.pool = pool;
+	LocalPool = pool;
+	return pool;
+}
+
+} // namespace
+
+namespace ctp::pool_detail {
+
+void* refill(const std::size_t sizeClass) CTP_NOEXCEPT(false) {
+	pool_state* const pool = local_pool();
+	if (!pool)
+		allocation_failed();
+	flush_pending(*pool);
+
+	take_remote(*pool);
+	if (free_block* const block = pool->free[sizeClass]) {
+		pool->free[sizeClass] = block->next;
+		return block;
+	}
+
+	const std::size_t bytes = SizeClasses.bytes[sizeClass];
+	if (static_cast<std::size_t>(pool->end[sizeClass] - pool->next[sizeClass]) < bytes) {
+		void* const memory = ::operator new(SlabBytes, std::align_val_t{SlabBytes}, std::nothrow);
+		if (!memory)
+			allocation_failed();
+		auto* const slab = ::new (memory) slab_header{pool, sizeClass, pool->slabs};
+		pool->slabs = slab;
+		pool->next[sizeClass] = reinterpret_cast<std::byte*>(slab + 1);
+		pool->end[sizeClass] = static_cast<std::byte*>(memory) + SlabBytes;
+	}
+	void* const block = pool->next[sizeClass];
+	pool->next[sizeClass] += bytes;
+	return block;
+}
+
+void free_remote(void* const ptr) noexcept {
+	auto* const block = static_cast<free_block*>(ptr);
+	auto* const owner = static_cast<pool_state*>(slab_of(ptr)->owner);
+	// Once the thread is exiting, there's no later chance to return a batch.
+	pool_state* const pool = Exiting ? nullptr : local_pool();
+	if (!pool) {
+		block->next = nullptr;
+		push_remote(*owner, block, block);
+		return;
+	}
+
+	if (pool->pendingOwner != owner) {
+		flush_pending(*pool);
+		pool->pendingOwner = owner;
+		pool->pendingTail = block;
+	}
+	block->next = pool->pendingHead;
+	pool->pendingHead = block;
+	if (++pool->pendingCount == RemoteBatch)
+		flush_pending(*pool);
+}
+
+} // ctp::pool_detail
@@ -0,0 +1,213 @@
+#include <Tools/profile.hpp>
+
+#include <fmt/format.h>
+
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+using namespace std::literals;
+
+namespace {
+
+using ctp::profile::detail::block;
+using ctp::profile::detail::thread_buffer;
+
+// Read at startup, to convert ticks to time at export.
+const std::uint64_t StartTicks = ctp::cpu_ticks();
+const std::uint64_t StartNs = ctp::steady_ns();
+
+struct buffer_state : thread_buffer {
+	buffer_state* nextOrphan = nullptr;
+};
+
+// Buffers of every thread that has recorded a zone. Kept after threads exit, so their zones can be exported.
+std::mutex BuffersMutex;
+std::vector<std::unique_ptr<buffer_state>> Buffers;
+// Buffers of threads that have exited, until their zones have been exported or cleared.
+buffer_state* Exited = nullptr;
+// Buffers of threads that have exited, for new threads to take over, so threads coming and going don't add buffers.
+buffer_state* Orphans = nullptr;
+// Blocks dropped by clear, reused rather than freed so recording again doesn't fault in new pages.
+block* FreeBlocks = nullptr;
+
+block* take_block() noexcept {
+	{
+		std::scoped_lock lock{BuffersMutex};
+		if (block* const b = FreeBlocks) {
+			FreeBlocks = b->next.load(std::memory_order_relaxed);
+			b->next.store(nullptr, std::memory_order_relaxed);
+			b->count.store(0, std::memory_order_relaxed);
+			return b;
+		}
+	}
+	return new (std::nothrow) block;
+}
+
+// Lets new threads take over the buffers of exited threads. Expects BuffersMutex to be held.
+void release_exited() noexcept {
+	while (buffer_state* const buffer = Exited) {
+		Exited = buffer->nextOrphan;
+		buffer->nextOrphan = Orphans;
+		Orphans = buffer;
+	}
+}
+
+// Set once the calling thread has started destroying its thread_locals.
+thread_local constinit bool Exiting = false;
+
+// Gives the calling thread's buffer to a later thread, once its zones have been exported or cleared.
+struct LocalBufferOwner {
+	buffer_state* buffer = nullptr;
+
+	~LocalBufferOwner() {
+		Exiting = true;
+		if (!buffer)
+			return;
+		ctp::profile::detail::LocalBuffer = &ctp::profile::detail::NoBuffer;
+		std::scoped_lock lock{BuffersMutex};
+		buffer->nextOrphan = Exited;
+		Exited = buffer;
+	}
+};
+
+thread_local LocalBufferOwner Owner;
+
+void append_json_string(std::string& out, const std::string_view str) {
+	out += '"';
+	for (const char c : str) {
+		switch (c) {
+		case '"': out += "\\\""sv; break;
+		case '\\': out += "\\\\"sv; break;
+		case '\n': out += "\\n"sv; break;
+		case '\t': out += "\\t"sv; break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20)
+				fmt::format_to(std::back_inserter(out), "\\u{:04x}", static_cast<unsigned>(c));
+			else
+				out += c;
+		}
+	}
+	out += '"';
+}
+
+} // namespace
+
+namespace ctp::profile {
+
+namespace detail {
+
+block* next_block() noexcept {
+	thread_buffer* buffer = LocalBuffer;
+	if (buffer == &NoBuffer) {
+		// Zones are dropped once the thread has given its buffer back.
+		if (Exiting)
+			return nullptr;
+
+		buffer_state* state = nullptr;
+		{
+			std::scoped_lock lock{BuffersMutex};
+			if (Orphans) {
+				state = Orphans;
+				Orphans = state->nextOrphan;
+				state->nextOrphan = nullptr;
+			}
+		}
+		if (!state) {
+			block* const b = take_block();
+			if (!b)
+				return nullptr;
+			try {
+				auto owned = std::make_unique<buffer_state>(thread_buffer{b, b});
+				std::scoped_lock lock{BuffersMutex};
+				Buffers.push_back(std::move(owned));
+				state = Buffers.back().get();
+			} catch (...) {
+				delete b;
+				return nullptr;
+			}
+		}
+		Owner.buffer = state;
+		LocalBuffer = state;
+		if (state->tail->count.load(std::memory_order_relaxed) < BlockEvents)
+			return state->tail;
+		buffer = state;
+	}
+
+	block* const b = take_block();
+	if (!b)
+		return nullptr;
+	buffer->tail->next.store(b, std::memory_order_release);
+	buffer->tail = b;
+	return b;
+}
+
+} // detail
+
+void write_chrome_trace(std::ostream& out) {
+	const tick_calibration clock{StartTicks, StartNs, cpu_ticks(), steady_ns()};
+
+	std::string json;
+	json.reserve(64 * 1024);
+	json += "{\"displayTimeUnit\":\"ns\",\"traceEvents\":["sv;
+
+	bool first = true;
+	std::scoped_lock lock{BuffersMutex};
+	for (std::size_t tid = 0; tid < Buffers.size(); ++tid) {
+		if (!first)
+			json += ',';
+		first = false;
+		fmt::format_to(std::back_inserter(json), "\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"thread {}\"}}}}", tid, tid);
+
+		for (const block* b = Buffers[tid]->head; b; b = b->next.load(std::memory_order_acquire)) {
+			const std::uint32_t count = b->count.load(std::memory_order_acquire);
+			for (std::uint32_t i = 0; i < count; ++i) {
+				const event& e = b->events[i];
+				// Microseconds, to the nanosecond.
+				const double ts = clock.ns_since_base(e.begin) / 1000.0;
+				const double dur = e.end > e.begin ? clock.ns_since_base(e.end) / 1000.0 - ts : 0.0;
+				json += ",\n{\"name\":"sv;
+				append_json_string(json, e.name);
+				fmt::format_to(std::back_inserter(json), ",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":1,\"tid\":{}}}", ts, dur, tid);
+			}
+
+			if (json.size() > 60 * 1024) {
+				out.write(json.data(), static_cast<std::streamsize>(json.size()));
+				json.clear();
+			}
+		}
+	}
+
+	json += "\n]}\n"sv;
+	out.write(json.data(), static_cast<std::streamsize>(json.size()));
+	release_exited();
+}
+
+bool write_chrome_trace(const std::string& path) {
+	std::ofstream out{path, std::ios::out | std::ios::trunc};
+	if (!out.is_open())
+		return false;
+	write_chrome_trace(out);
+	return static_cast<bool>(out);
+}
+
+void clear() noexcept {
+	std::scoped_lock lock{BuffersMutex};
+	for (auto& buffer : Buffers) {
+		if (buffer->tail != buffer->head) {
+			buffer->tail->next.store(FreeBlocks, std::memory_order_relaxed);
+			FreeBlocks = buffer->head->next.load(std::memory_order_relaxed);
+			buffer->head->next.store(nullptr, std::memory_order_relaxed);
+		}
+		buffer->head->count.store(0, std::memory_order_relaxed);
+		buffer->tail = buffer->head;
+	}
+	release_exited();
+}
+
+} // ctp::profile